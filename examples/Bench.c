@@ -0,0 +1,540 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/* This driver benchmarks the techniques of LibOPT. It runs every technique against a set of benchmark functions, dimensions and
+population sizes, with repeated trials whose seeds are fixed, and writes one CSV line per trial with the number of evaluations per second,
+the overhead of the technique per evaluation, the time to reach the target fitness value and the peak resident memory.
+The parameters of each technique are taken from its model file, whose number of agents, dimension, number of iterations and bounds
+are overridden. Each trial is executed by a child process, so that its peak memory is measured on its own and a crash does not stop
+the benchmark. Run "Bench -h" to see the options, or use the bench target of the Makefile. */
+
+#include <getopt.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "function.h"
+#include "telemetry.h"
+#include "pso.h"
+#include "ba.h"
+#include "fpa.h"
+#include "fa.h"
+#include "cs.h"
+#include "gp.h"
+#include "ga.h"
+#include "bha.h"
+#include "wca.h"
+#include "mbo.h"
+#include "abc.h"
+#include "hs.h"
+#include "bso.h"
+#include "loa.h"
+#include "de.h"
+#include "bsa.h"
+#include "jade.h"
+#include "abo.h"
+#include "sa.h"
+#include "cgp.h"
+
+#define MAX_LIST 64 /* maximum number of items of a comma-separated option */
+
+/* Status of a trial */
+#define _BENCH_OK_ 0
+#define _BENCH_INVALID_ 1 /* the search space did not pass CheckSearchSpace */
+#define _BENCH_CRASHED_ 2
+#define _BENCH_TIMEOUT_ 3
+/**************************/
+
+typedef void (*prtRun)(SearchSpace *s, prtFun Evaluate, ...); /* Pointer to the function that runs a technique */
+
+/* It defines a technique */
+typedef struct Technique_{
+    char *name;
+    int opt_id; /* identifier used to read the model file */
+    char *model; /* name of the model file */
+    prtRun run;
+}Technique;
+
+/* It defines a benchmark function */
+typedef struct Benchmark_{
+    char *name;
+    prtFun f;
+    double LB, UB; /* domain of each decision variable */
+    double f_min; /* minimum value of each decision variable's term, i.e., the minimum of the function is n * f_min */
+}Benchmark;
+
+/* It defines the configuration of the benchmark */
+typedef struct BenchConfig_{
+    Technique *technique[MAX_LIST];
+    Benchmark *benchmark[MAX_LIST];
+    int n[MAX_LIST], m[MAX_LIST];
+    int n_techniques, n_benchmarks, n_n, n_m;
+    int iterations, trials, seed, timeout;
+    char verbose; /* if 0, the messages printed by the techniques are discarded */
+    double tolerance; /* the target fitness value is the minimum of the function plus tolerance */
+    char *model_dir, *label;
+}BenchConfig;
+
+/* It defines the outcome of a trial, which the child process hands to its parent */
+typedef struct BenchResult_{
+    int status;
+    int threads;
+    double time; /* wall-clock time spent by the technique, in seconds */
+    IterationRecord last; /* record of the last iteration */
+    IterationRecord hit; /* record of the first iteration that reached the target (hit.iteration = -1 if none) */
+    double target;
+    long peak_rss; /* in kilobytes */
+}BenchResult;
+
+static Technique techniques[] = {
+    {"PSO", _PSO_, "pso_model.txt", runPSO},
+    {"AIWPSO", _PSO_, "pso_model.txt", runAIWPSO},
+    {"BA", _BA_, "ba_model.txt", runBA},
+    {"FPA", _FPA_, "fpa_model.txt", runFPA},
+    {"FA", _FA_, "fa_model.txt", runFA},
+    {"CS", _CS_, "cs_model.txt", runCS},
+    {"GP", _GP_, "gp_model.txt", runGP},
+    {"GA", _GA_, "ga_model.txt", runGA},
+    {"BHA", _BHA_, "bha_model.txt", runBHA},
+    {"WCA", _WCA_, "wca_model.txt", runWCA},
+    {"MBO", _MBO_, "mbo_model.txt", runMBO},
+    {"ABC", _ABC_, "abc_model.txt", runABC},
+    {"HS", _HS_, "hs_model.txt", runHS},
+    {"IHS", _HS_, "hs_model.txt", runIHS},
+    {"PSF-HS", _HS_, "hs_model.txt", runPSF_HS},
+    {"BSO", _BSO_, "bso_model.txt", runBSO},
+    {"LOA", _LOA_, "loa_model.txt", runLOA},
+    {"DE", _DE_, "de_model.txt", runDE},
+    {"BSA", _BSA_, "bsa_model.txt", runBSA},
+    {"JADE", _JADE_, "jade_model.txt", runJADE},
+    {"ABO", _ABO_, "abo_model.txt", runABO},
+    {"SA", _SA_, "sa_model.txt", runSA},
+    {"CGP", _CGP_, "cgp_model.txt", runCGP},
+    {"TGP", _TGP_, "tgp_model.txt", runTGP},
+    {NULL, 0, NULL, NULL}};
+
+static Benchmark benchmarks[] = {
+    {"Sphere", Sphere, -5.12, 5.12, 0},
+    {"Rastrigin", Rastrigin, -5.12, 5.12, 0},
+    {"Rosenbrock", Rosenbrock, -30, 30, 0},
+    {"Ackley_First", Ackley_First, -35, 35, 0},
+    {"Griewank", Griewank, -100, 100, 0},
+    {"Alpine_First", Alpine_First, -10, 10, 0},
+    {"Schumer_Steiglitz", Schumer_Steiglitz, -100, 100, 0},
+    {"Sum_Squares", Sum_Squares, -10, 10, 0},
+    {"Levy", Levy, -10, 10, 0},
+    {"Zakharov", Zakharov, -5, 10, 0},
+    {"Salomon", Salomon, -100, 100, 0},
+    {"Styblinski_Tang", Styblinski_Tang, -5, 5, -39.16616570377142},
+    {NULL, NULL, 0, 0, 0}};
+
+/* It computes the square of the first decision variable, i.e., a fitness function whose cost is negligible, so that the time
+ * of a run measures the overhead of the technique itself (a constant function would stall the techniques that divide by the
+ * differences or the sum of the fitness values)
+Parameters:
+a: agent
+arg: not used */
+static double Trivial(Agent *a, va_list arg)
+{
+    return a->x[0] * a->x[0];
+}
+
+/* It keeps the record of the last iteration and the one of the first iteration that reached the target
+Parameters:
+r: record of the iteration
+arg: trial result (BenchResult) */
+static void Probe(const IterationRecord *r, void *arg)
+{
+    BenchResult *b = (BenchResult *)arg;
+
+    b->last = *r;
+    if ((b->hit.iteration < 0) && (r->fit <= b->target))
+        b->hit = *r;
+}
+
+/* It writes a model file whose number of agents, dimension, number of iterations and bounds are overridden
+ * The parameters of the technique are copied from the original model file up to its first pair of bounds.
+Parameters:
+fp: output file
+model: original model file
+n: number of decision variables
+m: number of agents
+iterations: number of iterations
+f: benchmark function, whose domain defines the bounds */
+static int WriteModelFile(FILE *fp, char *model, int n, int m, int iterations, Benchmark *f)
+{
+    FILE *in = NULL;
+    char line[1024];
+    int j, pos = 0, first = 1;
+
+    in = fopen(model, "r");
+    if (!in)
+    {
+        fprintf(stderr, "\nUnable to open file %s @WriteModelFile.\n", model);
+        return 0;
+    }
+
+    while ((fgets(line, sizeof(line), in)) && (!strstr(line, "<LB>")))
+    {
+        if (first)
+        {
+            sscanf(line, "%*d %*d %*d%n", &pos);
+            fprintf(fp, "%d %d %d%s", m, n, iterations, line + pos);
+            first = 0;
+        }
+        else
+            fputs(line, fp);
+    }
+    for (j = 0; j < n; j++)
+        fprintf(fp, "%.17g %.17g # <LB> <UB> x[%d]\n", f->LB, f->UB, j);
+    fclose(in);
+
+    return 1;
+}
+
+/* It runs a single trial; it is executed by a child process
+Parameters:
+c: benchmark configuration
+o: technique
+f: benchmark function (it defines the bounds and the target)
+Evaluate: fitness function actually minimized
+n: number of decision variables
+m: number of agents
+seed: seed of the random number generator
+b: output trial result */
+static void RunTrial(BenchConfig *c, Technique *o, Benchmark *f, prtFun Evaluate, int n, int m, int seed, BenchResult *b)
+{
+    SearchSpace *s = NULL;
+    char model[1024], tmp[] = "/tmp/libopt_benchXXXXXX";
+    double start;
+    FILE *fp = NULL;
+    int fd;
+
+    b->status = _BENCH_INVALID_;
+    b->hit.iteration = b->last.iteration = -1;
+    b->hit.evaluations = -1;
+    b->target = n * f->f_min + c->tolerance;
+
+    snprintf(model, sizeof(model), "%s/%s", c->model_dir, o->model);
+    fd = mkstemp(tmp);
+    if (fd < 0)
+    {
+        fprintf(stderr, "\nUnable to create a temporary model file @RunTrial.\n");
+        return;
+    }
+    fp = fdopen(fd, "w");
+    if (!WriteModelFile(fp, model, n, m, c->iterations, f))
+    {
+        fclose(fp);
+        unlink(tmp);
+        return;
+    }
+    fclose(fp);
+
+    srandinter(seed);
+    s = ReadSearchSpaceFromFile(tmp, o->opt_id);
+    unlink(tmp);
+    if (!s)
+        return;
+
+    InitializeSearchSpace(s, o->opt_id);
+    if (CheckSearchSpace(s, o->opt_id))
+    {
+        s->observer = Probe;
+        s->observer_arg = b;
+        s->report_every = 1;
+        b->threads = s->n_threads;
+
+        start = GetWallTime();
+        o->run(s, Evaluate);
+        b->time = GetWallTime() - start;
+        b->status = _BENCH_OK_;
+    }
+
+    DestroySearchSpace(&s, o->opt_id);
+}
+
+/* It runs a trial in a child process and measures its peak resident memory
+Parameters: see RunTrial */
+static void ForkTrial(BenchConfig *c, Technique *o, Benchmark *f, prtFun Evaluate, int n, int m, int seed, BenchResult *b)
+{
+    struct rusage usage;
+    int fd[2], status;
+    pid_t pid;
+
+    memset(b, 0, sizeof(BenchResult));
+    b->status = _BENCH_CRASHED_;
+    b->hit.iteration = b->last.iteration = -1;
+    b->hit.evaluations = -1;
+
+    if (pipe(fd))
+    {
+        fprintf(stderr, "\nUnable to create a pipe @ForkTrial.\n");
+        exit(-1);
+    }
+    fflush(NULL);
+
+    pid = fork();
+    if (pid < 0)
+    {
+        fprintf(stderr, "\nUnable to create a child process @ForkTrial.\n");
+        exit(-1);
+    }
+    if (!pid)
+    {
+        close(fd[0]);
+        if (!freopen("/dev/null", "w", stdout)) /* the results may be written to stdout */
+            _exit(-1);
+        if ((!c->verbose) && (!freopen("/dev/null", "w", stderr)))
+            _exit(-1);
+        if (c->timeout > 0)
+            alarm(c->timeout);
+        RunTrial(c, o, f, Evaluate, n, m, seed, b);
+        if (write(fd[1], b, sizeof(BenchResult)) != sizeof(BenchResult))
+            _exit(-1);
+        _exit(0);
+    }
+
+    close(fd[1]);
+    if (read(fd[0], b, sizeof(BenchResult)) != sizeof(BenchResult))
+        b->status = _BENCH_CRASHED_;
+    close(fd[0]);
+
+    wait4(pid, &status, 0, &usage);
+    if ((WIFSIGNALED(status)) && (WTERMSIG(status) == SIGALRM))
+        b->status = _BENCH_TIMEOUT_;
+    b->peak_rss = usage.ru_maxrss;
+}
+
+/* It writes the CSV line of a trial
+Parameters:
+out: output file
+c: benchmark configuration
+o: technique
+f: benchmark function
+n: number of decision variables
+m: number of agents
+trial: trial number
+seed: seed of the trial
+b: result of the trial with the benchmark function
+z: result of the trial with the trivial fitness function */
+static void WriteResult(FILE *out, BenchConfig *c, Technique *o, Benchmark *f, int n, int m, int trial, int seed, BenchResult *b, BenchResult *z)
+{
+    static const char *status[] = {"ok", "invalid", "crashed", "timeout"};
+    double rate = -1, overhead = -1;
+
+    if ((b->status == _BENCH_OK_) && (b->time > 0))
+        rate = b->last.evaluations / b->time;
+    if ((z->status == _BENCH_OK_) && (z->last.evaluations > 0))
+        overhead = z->time / z->last.evaluations;
+
+    fprintf(out, "%s,%s,%s,%d,%d,%d,%d,%d,%d,%s,%ld,%.9g,%.9g,%.9g,%.17g,%.17g,%d,%ld,%.9g,%ld\n", c->label, o->name, f->name, n, m,
+            c->iterations, trial, seed, b->threads, status[b->status], b->last.evaluations, b->time, rate, overhead, b->last.fit,
+            b->target, b->hit.iteration, b->hit.evaluations, b->hit.iteration < 0 ? -1 : b->hit.time, b->peak_rss);
+    fflush(out);
+}
+
+/* It prints the usage of the driver */
+static void Usage()
+{
+    int i;
+
+    fprintf(stderr, "\nusage Bench [options]\n");
+    fprintf(stderr, "  -a list   techniques (default: all)\n");
+    fprintf(stderr, "  -f list   benchmark functions (default: Sphere,Rastrigin,Rosenbrock)\n");
+    fprintf(stderr, "  -n list   dimensions (default: 10,30)\n");
+    fprintf(stderr, "  -m list   numbers of agents (default: 20)\n");
+    fprintf(stderr, "  -i int    number of iterations (default: 100)\n");
+    fprintf(stderr, "  -r int    number of trials (default: 3)\n");
+    fprintf(stderr, "  -s int    seed of the first trial; trial k uses seed + k (default: 1)\n");
+    fprintf(stderr, "  -e float  tolerance of the target, i.e., the target is the minimum of the function plus it (default: 1e-2)\n");
+    fprintf(stderr, "  -T int    time limit of a trial in seconds, 0 for none (default: 0)\n");
+    fprintf(stderr, "  -d dir    directory of the model files (default: examples/model_files)\n");
+    fprintf(stderr, "  -l label  label written to every line, e.g., the name of the build (default: libopt)\n");
+    fprintf(stderr, "  -o file   output CSV file (default: stdout)\n");
+    fprintf(stderr, "  -v        keep the messages printed by the techniques to stderr\n");
+    fprintf(stderr, "Techniques:");
+    for (i = 0; techniques[i].name; i++)
+        fprintf(stderr, " %s", techniques[i].name);
+    fprintf(stderr, "\nFunctions:");
+    for (i = 0; benchmarks[i].name; i++)
+        fprintf(stderr, " %s", benchmarks[i].name);
+    fprintf(stderr, "\n");
+}
+
+/* It parses a comma-separated list of positive integers
+Parameters:
+arg: list
+v: output array
+It returns the number of items */
+static int ParseIntegers(char *arg, int *v)
+{
+    char *tok = NULL;
+    int k = 0;
+
+    for (tok = strtok(arg, ","); (tok) && (k < MAX_LIST); tok = strtok(NULL, ","))
+    {
+        v[k] = atoi(tok);
+        if (v[k] < 1)
+        {
+            fprintf(stderr, "\nInvalid value %s @ParseIntegers.\n", tok);
+            exit(-1);
+        }
+        k++;
+    }
+
+    return k;
+}
+
+/* It parses a comma-separated list of techniques or benchmark functions
+Parameters:
+arg: list
+table: array of items, terminated by an item whose name is NULL
+size: size of each item
+v: output array of pointers to the items
+It returns the number of items */
+static int ParseNames(char *arg, void *table, size_t size, void **v)
+{
+    char *tok = NULL, *item = NULL;
+    int k = 0;
+
+    for (tok = strtok(arg, ","); (tok) && (k < MAX_LIST); tok = strtok(NULL, ","))
+    {
+        for (item = (char *)table; *(char **)item; item += size)
+            if (!strcmp(*(char **)item, tok))
+                break;
+        if (!*(char **)item)
+        {
+            fprintf(stderr, "\nUnknown name %s @ParseNames.\n", tok);
+            Usage();
+            exit(-1);
+        }
+        v[k++] = item;
+    }
+
+    return k;
+}
+
+int main(int argc, char **argv)
+{
+    BenchConfig c;
+    BenchResult b, z;
+    FILE *out = stdout;
+    char functions[] = "Sphere,Rastrigin,Rosenbrock";
+    int i, j, k, l, t, opt, progress;
+
+    memset(&c, 0, sizeof(BenchConfig));
+    c.n[0] = 10;
+    c.n[1] = 30;
+    c.n_n = 2;
+    c.m[0] = 20;
+    c.n_m = 1;
+    c.iterations = 100;
+    c.trials = 3;
+    c.seed = 1;
+    c.tolerance = 1e-2;
+    c.model_dir = "examples/model_files";
+    c.label = "libopt";
+
+    while ((opt = getopt(argc, argv, "a:f:n:m:i:r:s:e:T:d:l:o:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a':
+            c.n_techniques = ParseNames(optarg, techniques, sizeof(Technique), (void **)c.technique);
+            break;
+        case 'f':
+            c.n_benchmarks = ParseNames(optarg, benchmarks, sizeof(Benchmark), (void **)c.benchmark);
+            break;
+        case 'n':
+            c.n_n = ParseIntegers(optarg, c.n);
+            break;
+        case 'm':
+            c.n_m = ParseIntegers(optarg, c.m);
+            break;
+        case 'i':
+            c.iterations = atoi(optarg);
+            break;
+        case 'r':
+            c.trials = atoi(optarg);
+            break;
+        case 's':
+            c.seed = atoi(optarg);
+            break;
+        case 'e':
+            c.tolerance = atof(optarg);
+            break;
+        case 'T':
+            c.timeout = atoi(optarg);
+            break;
+        case 'd':
+            c.model_dir = optarg;
+            break;
+        case 'l':
+            c.label = optarg;
+            break;
+        case 'v':
+            c.verbose = 1;
+            break;
+        case 'o':
+            out = fopen(optarg, "w");
+            if (!out)
+            {
+                fprintf(stderr, "\nUnable to open file %s.\n", optarg);
+                exit(-1);
+            }
+            break;
+        default:
+            Usage();
+            exit(opt == 'h' ? 0 : -1);
+        }
+    }
+
+    if ((c.iterations < 1) || (c.trials < 1) || (c.seed < 1))
+    {
+        fprintf(stderr, "\nThe number of iterations, the number of trials and the seed must be positive.\n");
+        exit(-1);
+    }
+    if (!c.n_techniques)
+        for (; techniques[c.n_techniques].name; c.n_techniques++)
+            c.technique[c.n_techniques] = &techniques[c.n_techniques];
+    if (!c.n_benchmarks)
+        c.n_benchmarks = ParseNames(functions, benchmarks, sizeof(Benchmark), (void **)c.benchmark);
+
+    progress = (out != stdout) && (isatty(STDERR_FILENO)); /* the progress is only shown on a terminal */
+    fprintf(out, "label,technique,function,n,m,iterations,trial,seed,threads,status,evaluations,time,evaluations_per_second,"
+                 "overhead_per_evaluation,best_fit,target,target_iteration,target_evaluations,target_time,peak_rss_kb\n");
+
+    for (i = 0; i < c.n_techniques; i++)
+        for (j = 0; j < c.n_benchmarks; j++)
+            for (k = 0; k < c.n_n; k++)
+                for (l = 0; l < c.n_m; l++)
+                    for (t = 0; t < c.trials; t++)
+                    {
+                        if (progress)
+                            fprintf(stderr, "\r%s %s n=%d m=%d trial %d/%d ...", c.technique[i]->name, c.benchmark[j]->name, c.n[k], c.m[l], t + 1, c.trials);
+                        ForkTrial(&c, c.technique[i], c.benchmark[j], c.benchmark[j]->f, c.n[k], c.m[l], c.seed + t, &b);
+                        ForkTrial(&c, c.technique[i], c.benchmark[j], Trivial, c.n[k], c.m[l], c.seed + t, &z);
+                        WriteResult(out, &c, c.technique[i], c.benchmark[j], c.n[k], c.m[l], t, c.seed + t, &b, &z);
+                    }
+    if (progress)
+        fprintf(stderr, "\n");
+    if (out != stdout)
+        fclose(out);
+
+    return 0;
+}
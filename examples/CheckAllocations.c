@@ -0,0 +1,194 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/* This driver checks that the iterations of the techniques do not allocate memory once they reach their steady state.
+Each technique runs twice with the same seed, for SHORT_RUN and LONG_RUN iterations, and the calls to malloc, calloc and realloc made
+by each run are counted. Since the first SHORT_RUN iterations of both runs are identical, the longer run must not allocate more than
+the shorter one. The counters replace the allocation functions at link time, so this driver must be linked with
+-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (see the check target of the Makefile). It exits with a non-zero status if any
+technique fails. The messages printed by the techniques to stderr are discarded.
+Usage: CheckAllocations [directory of the model files (default: examples/model_files)] */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "common.h"
+#include "function.h"
+#include "pso.h"
+#include "ba.h"
+#include "fpa.h"
+#include "fa.h"
+#include "cs.h"
+#include "gp.h"
+#include "ga.h"
+#include "bha.h"
+#include "wca.h"
+#include "mbo.h"
+#include "abc.h"
+#include "hs.h"
+#include "bso.h"
+#include "loa.h"
+#include "de.h"
+#include "bsa.h"
+#include "jade.h"
+#include "abo.h"
+#include "sa.h"
+#include "cgp.h"
+
+#define SHORT_RUN 10 /* number of iterations of the first run */
+#define LONG_RUN 30 /* number of iterations of the second run */
+#define SEED 7 /* seed of both runs */
+
+typedef void (*prtRun)(SearchSpace *s, prtFun Evaluate, ...); /* Pointer to the function that runs a technique */
+
+/* It defines a technique */
+typedef struct Technique_{
+    char *name;
+    int opt_id; /* identifier used to read the model file */
+    char *model; /* name of the model file */
+    prtRun run;
+    char *allocates; /* why the technique allocates memory at every iteration (NULL if it must not) */
+}Technique;
+
+static Technique techniques[] = {
+    {"PSO", _PSO_, "pso_model.txt", runPSO, NULL},
+    {"AIWPSO", _PSO_, "pso_model.txt", runAIWPSO, NULL},
+    {"BA", _BA_, "ba_model.txt", runBA, NULL},
+    {"FPA", _FPA_, "fpa_model.txt", runFPA, NULL},
+    {"FA", _FA_, "fa_model.txt", runFA, NULL},
+    {"CS", _CS_, "cs_model.txt", runCS, NULL},
+    {"GP", _GP_, "gp_model.txt", runGP, "the trees created by crossover and mutation"},
+    {"GA", _GA_, "ga_model.txt", runGA, NULL},
+    {"BHA", _BHA_, "bha_model.txt", runBHA, NULL},
+    {"WCA", _WCA_, "wca_model.txt", runWCA, NULL},
+    {"MBO", _MBO_, "mbo_model.txt", runMBO, NULL},
+    {"ABC", _ABC_, "abc_model.txt", runABC, NULL},
+    {"HS", _HS_, "hs_model.txt", runHS, NULL},
+    {"IHS", _HS_, "hs_model.txt", runIHS, NULL},
+    {"PSF-HS", _HS_, "hs_model.txt", runPSF_HS, NULL},
+    {"BSO", _BSO_, "bso_model.txt", runBSO, NULL},
+    {"LOA", _LOA_, "loa_model.txt", runLOA, "the prides and nomad groups, which are resized at every iteration"},
+    {"DE", _DE_, "de_model.txt", runDE, NULL},
+    {"BSA", _BSA_, "bsa_model.txt", runBSA, NULL},
+    {"JADE", _JADE_, "jade_model.txt", runJADE, NULL},
+    {"ABO", _ABO_, "abo_model.txt", runABO, NULL},
+    {"SA", _SA_, "sa_model.txt", runSA, NULL},
+    {"CGP", _CGP_, "cgp_model.txt", runCGP, NULL},
+    {"TGP", _TGP_, "tgp_model.txt", runTGP, "the trees created by crossover and mutation"},
+    {NULL, 0, NULL, NULL, NULL}};
+
+static long n_allocations = 0; /* number of calls to malloc, calloc and realloc */
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t size);
+
+/* They count the allocations and forward them to the actual functions (see -Wl,--wrap) */
+void *__wrap_malloc(size_t size)
+{
+    __atomic_fetch_add(&n_allocations, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+    __atomic_fetch_add(&n_allocations, 1, __ATOMIC_RELAXED);
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t size)
+{
+    __atomic_fetch_add(&n_allocations, 1, __ATOMIC_RELAXED);
+    return __real_realloc(p, size);
+}
+/**************************/
+
+/* It runs a technique and returns the number of allocations made by the run itself, i.e., after its search space is initialized
+Parameters:
+o: technique
+model_dir: directory of the model files
+iterations: number of iterations */
+static long CountAllocations(Technique *o, char *model_dir, int iterations)
+{
+    SearchSpace *s = NULL;
+    char model[1024];
+    long before = -1;
+    int err, null;
+
+    /* The messages of the technique are discarded (stderr is restored afterwards) */
+    fflush(stderr);
+    err = dup(STDERR_FILENO);
+    null = open("/dev/null", O_WRONLY);
+    dup2(null, STDERR_FILENO);
+    close(null);
+
+    snprintf(model, sizeof(model), "%s/%s", model_dir, o->model);
+    srandinter(SEED);
+    s = ReadSearchSpaceFromFile(model, o->opt_id);
+    if (s)
+    {
+        s->iterations = iterations;
+        InitializeSearchSpace(s, o->opt_id);
+        if (CheckSearchSpace(s, o->opt_id))
+        {
+            before = __atomic_load_n(&n_allocations, __ATOMIC_RELAXED);
+            o->run(s, Sphere);
+            before = __atomic_load_n(&n_allocations, __ATOMIC_RELAXED) - before;
+        }
+        DestroySearchSpace(&s, o->opt_id);
+    }
+
+    fflush(stderr);
+    dup2(err, STDERR_FILENO);
+    close(err);
+
+    return before;
+}
+
+int main(int argc, char **argv)
+{
+    char *model_dir = argc > 1 ? argv[1] : "examples/model_files";
+    long n_short, n_long;
+    int i, failures = 0;
+
+    for (i = 0; techniques[i].name; i++)
+    {
+        CountAllocations(&techniques[i], model_dir, SHORT_RUN); /* it warms up the buffers kept along the process, e.g., the thread-local ones */
+        n_short = CountAllocations(&techniques[i], model_dir, SHORT_RUN);
+        n_long = CountAllocations(&techniques[i], model_dir, LONG_RUN);
+
+        printf("%-8s %d iterations: %ld allocations, %d iterations: %ld allocations ... ", techniques[i].name, SHORT_RUN, n_short, LONG_RUN, n_long);
+        if ((n_short < 0) || (n_long < 0))
+        {
+            printf("FAILED (invalid search space)\n");
+            failures++;
+        }
+        else if (techniques[i].allocates)
+            printf("not checked (it allocates %s)\n", techniques[i].allocates);
+        else if (n_long > n_short)
+        {
+            printf("FAILED (%.1f allocations per iteration)\n", (double)(n_long - n_short) / (LONG_RUN - SHORT_RUN));
+            failures++;
+        }
+        else
+            printf("OK\n");
+        fflush(stdout);
+    }
+
+    if (failures)
+        fprintf(stderr, "\n%d technique(s) failed @CheckAllocations.\n", failures);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,52 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/* This driver compares every code path of the kernels available on this machine against the functions of function.h (see CheckKernels).
+The numbers of decision variables below include small and odd ones, so the scalar tails of the vectorized paths are also exercised.
+It exits with a non-zero status if any comparison fails.
+Usage: CheckKernels [relative tolerance (default: 1e-10)] */
+
+#include "common.h"
+#include "kernel.h"
+
+#define SEED 7
+
+static const int dimensions[] = {2, 3, 7, 16, 33, 1001, 0}; /* numbers of decision variables to be checked (0 ends the list) */
+
+int main(int argc, char **argv)
+{
+    double tol = argc > 1 ? atof(argv[1]) : 1e-10;
+    int i, errors, failures = 0;
+
+    srandinter(SEED);
+    for (i = 0; dimensions[i]; i++)
+    {
+        errors = CheckKernels(dimensions[i], tol);
+        printf("n = %-5d ... ", dimensions[i]);
+        if (errors)
+        {
+            printf("FAILED (%d comparison(s))\n", errors);
+            failures++;
+        }
+        else
+            printf("OK\n");
+        fflush(stdout);
+    }
+
+    if (failures)
+        fprintf(stderr, "\nThe kernels failed for %d number(s) of decision variables @CheckKernels.\n", failures);
+
+    return failures ? 1 : 0;
+}
@@ -22,6 +22,8 @@ limitations under the License.
 #include "opt.h"
 
 void runABC(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Artificial Bee Colony for function minimization */
+void runABC_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Artificial Bee Colony for function minimization using a reentrant fitness function */
 void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Artificial Bee Colony for function minimization */
+void runTensorABC_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Artificial Bee Colony for function minimization using a reentrant fitness function */
 
 #endif
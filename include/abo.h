@@ -4,5 +4,6 @@
 #include "opt.h"
 
 void runABO(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Artificial Butterfly Optimization for function minimization */
+void runABO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Artificial Butterfly Optimization for function minimization using a reentrant fitness function */
 
 #endif
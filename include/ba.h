@@ -24,6 +24,7 @@ limitations under the License.
 void UpdateBatVelocity(SearchSpace *s, int i); /* It updates the velocity of an agent (bat) */
 void SetBatFrequency(SearchSpace *s, int i); /* It sets the frequency of an agent (bat) */
 void runBA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Bat Algorithm for function minimization */
+void runBA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Bat Algorithm for function minimization using a reentrant fitness function */
 /*************************/
 
 /* TensorBA related functions */
@@ -31,6 +32,7 @@ void UpdateTensorBatVelocity(SearchSpace *s, int i, int tensor_id); /* It update
 void SetTensorBatFrequency(SearchSpace *s, int i); /* It sets the frequency of an tensor (bat) */
 double **GenerateNewBatTensor(SearchSpace *s, int tensor_id); /* It generates a new tensor for BA algorithm */
 void runTensorBA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Bat Algorithm for function minimization */
+void runTensorBA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Bat Algorithm for function minimization using a reentrant fitness function */
 /*************************/
 
 #endif
\ No newline at end of file
@@ -21,6 +21,8 @@ limitations under the License.
 #include "opt.h"
 
 void runBHA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Black Hole Algorithm for function minimization */
+void runBHA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Black Hole Algorithm for function minimization using a reentrant fitness function */
 void runTensorBHA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Black Hole Algorithm for function minimization */
+void runTensorBHA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Black Hole Algorithm for function minimization using a reentrant fitness function */
 
 #endif
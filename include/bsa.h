@@ -20,7 +20,8 @@ limitations under the License.
 
 #include "opt.h"
 
-void runBSA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Harmony Search for function minimization */
+void runBSA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Backtracking Search Optimization Algorithm for function minimization */
+void runBSA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Backtracking Search Optimization Algorithm for function minimization using a reentrant fitness function */
 void InitializeMutation(SearchSpace *s, SearchSpace *OldS, double** Mutation);  /* It initializes the mutation matrix */
 SearchSpace *CrossOverStrategyOfBSA(SearchSpace *s, double** Map, double** Mutation); /* It executes the the BSA cross over strategy */
 void BoundaryControlMechanism(SearchSpace *s,SearchSpace *T);  /* It controls the boundaries of the new Trial-population */
@@ -29,6 +30,7 @@ void InitializeMap(SearchSpace *s,  double** Map);  /* It initializes the map co
 
 /*  Tensor-Based Functions */
 void runTensorBSA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the tensor-based Backtracking Search Optimization Algorithm for function minimization */
+void runTensorBSA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the tensor-based Backtracking Search Optimization Algorithm for function minimization using a reentrant fitness function */
 SearchSpace *CrossOverTensorStrategyOfBSA(SearchSpace *s, double** Map, double*** Mutation, int tensor_id); /* It executes the the tensor-based BSA cross over strategy */
 void InitializeTensorMutation(SearchSpace *s, SearchSpace *oldS, double*** Mutation, int tensor_id); /* It initializes the tensor-based mutation matrix */
 
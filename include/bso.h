@@ -20,10 +20,12 @@ limitations under the License.
 #define BSO_H
 
 #include "opt.h"
+#include "cluster.h"
 
 /* BSO-related functions */
-void k_means(SearchSpace *s, int *best_ideas, int ***ideas_per_cluster); /* It clusters the agents and returns a pointer with the best agent's ID per cluster */
+void k_means(SearchSpace *s, KMeans *km, double **X, double *best_fitness_cluster, int *best_ideas, int **ideas_per_cluster); /* It clusters the agents and returns a pointer with the best agent's ID per cluster */
 void runBSO(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Brain Storm Optimization for function minimization */
+void runBSO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Brain Storm Optimization for function minimization using a reentrant fitness function */
 /*************************/
 
 #endif
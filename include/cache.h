@@ -0,0 +1,111 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/* The fitness cache memoizes the fitness values of decision vectors, so that re-evaluating an unchanged agent (e.g., when the whole
+population is evaluated again at every iteration) does not call the fitness function. It is bounded: once it is full, entries
+are evicted with the clock (second-chance) policy. A decision vector is looked up by its n values, compared exactly (bit by bit)
+unless a quantization step is given, in which case vectors that fall into the same cell of a grid of that step share their fitness.
+The cache must only be enabled when the fitness value depends on the decision vector alone.
+
+The subtree cache hash-conses the subtrees of the GP and TGP trees stored in tree pools (see TreePool). Each distinct subtree
+gets a unique identifier, defined by its function and the identifiers of its sons, and its output array is stored along with it.
+Identical subexpressions, which are frequent since reproduction and crossover copy subtrees verbatim, are then computed only once,
+and their outputs are kept across iterations until the terminals change (the constants are assumed to be fixed: the cache must be
+cleared if they are modified). The outputs are bitwise identical to
+the ones of RunGPProgram. It is bounded: once it is full, entries are evicted with the clock (second-chance) policy. */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "opt.h"
+
+/* It defines a bounded cache of fitness values */
+typedef struct FitnessCache_{
+    int n; /* number of decision variables */
+    int capacity; /* maximum number of entries */
+    int size; /* number of entries in use */
+    double resolution; /* quantization step of the decision variables (0 stands for exact keys) */
+    uint64_t *key; /* keys of the entries (n words each) */
+    uint64_t *hash; /* hash value of each entry */
+    double *fit; /* fitness value of each entry */
+    int *next; /* next entry of the same bucket (-1 ends the list) */
+    int *bucket; /* first entry of each bucket (-1 for empty buckets) */
+    int n_buckets; /* number of buckets (a power of 2) */
+    char *ref; /* reference bits used by the clock eviction */
+    int hand; /* clock hand: next entry to be checked for eviction */
+    uint64_t *tmp; /* key of the vector being looked up */
+    pthread_mutex_t lock; /* it protects the cache, so that it can be shared by concurrent evaluations */
+    long n_lookups; /* number of lookups */
+    long n_hits; /* number of lookups that found the vector */
+    long n_evictions; /* number of entries evicted to make room for new ones */
+}FitnessCache;
+
+/* It defines a bounded cache of the outputs of GP subtrees */
+typedef struct SubtreeCache_{
+    int capacity; /* maximum number of entries */
+    int size; /* number of entries in use */
+    int width; /* number of doubles of each output: n, or n * tensor_dim for tensor-based trees (0 before the first SyncSubtreeCache) */
+    int tensor_dim; /* dimension of the tensors (-1 for real-valued trees) */
+    int n_terminals; /* number of terminals */
+    int n_leaves; /* number of leaves (terminals followed by constants) */
+    double *leaf; /* outputs of the leaves (width doubles each) */
+    char *loaded; /* flag of each constant whose output has been loaded into leaf (constants are loaded on demand) */
+    double *tmp; /* outputs of the terminals being checked by SyncSubtreeCache */
+    int64_t *key; /* keys of the entries (3 words each: function and identifiers of the sons) */
+    int64_t *uid; /* unique identifier of the subtree of each entry */
+    uint64_t *hash; /* hash value of each entry */
+    double *out; /* outputs of the entries (width doubles each) */
+    int *next; /* next entry of the same bucket (-1 ends the list) */
+    int *bucket; /* first entry of each bucket (-1 for empty buckets) */
+    int n_buckets; /* number of buckets (a power of 2) */
+    char *ref; /* reference bits used by the clock eviction */
+    int *pin; /* number of pending uses of each entry (pinned entries are never evicted) */
+    int hand; /* clock hand: next entry to be checked for eviction */
+    int64_t next_uid; /* identifier of the next new subtree (identifiers are never reused) */
+    long n_lookups; /* number of lookups */
+    long n_hits; /* number of lookups that found the subtree */
+    long n_evictions; /* number of entries evicted to make room for new ones */
+}SubtreeCache;
+
+/* Fitness cache-related functions */
+FitnessCache *CreateFitnessCache(int n, int capacity, double resolution); /* It creates a fitness cache */
+void DestroyFitnessCache(FitnessCache **c); /* It deallocates a fitness cache */
+int LookupFitness(FitnessCache *c, const double *x, double *fit); /* It looks up the fitness value of a decision vector */
+void InsertFitness(FitnessCache *c, const double *x, double fit); /* It stores the fitness value of a decision vector */
+void ClearFitnessCache(FitnessCache *c); /* It removes all entries and resets the statistics of a fitness cache */
+double GetFitnessCacheHitRate(FitnessCache *c); /* It returns the fraction of lookups that found the decision vector */
+void ShowFitnessCache(FitnessCache *c); /* It shows the statistics of a fitness cache */
+/**************************/
+
+/* Subtree cache-related functions */
+SubtreeCache *CreateSubtreeCache(int capacity); /* It creates a subtree cache */
+void DestroySubtreeCache(SubtreeCache **c); /* It deallocates a subtree cache */
+void SyncSubtreeCache(SearchSpace *s, SubtreeCache *c, int tensor_dim); /* It updates the outputs of the terminals, and it invalidates the cache if they have changed */
+double *RunCachedTree(SearchSpace *s, SubtreeCache *c, TreePool *p, int i); /* It runs a pooled tree through a subtree cache and outputs its solution array */
+void ClearSubtreeCache(SubtreeCache *c); /* It removes all entries and resets the statistics of a subtree cache */
+double GetSubtreeCacheHitRate(SubtreeCache *c); /* It returns the fraction of lookups that found the subtree */
+void ShowSubtreeCache(SubtreeCache *c); /* It shows the statistics of a subtree cache */
+/**************************/
+
+/* General-purpose functions */
+void SetFitnessCache(SearchSpace *s, int capacity, double resolution); /* It enables (or disables) the fitness cache of a search space */
+void SetSubtreeCache(SearchSpace *s, int capacity); /* It enables (or disables) the subtree cache of a search space */
+/**************************/
+
+#endif
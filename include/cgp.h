@@ -22,6 +22,7 @@ limitations under the License.
 #include "function.h"
 
 void runCGP(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Cartesian Genetic Programming for function minimization */
+void runCGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Cartesian Genetic Programming for function minimization using a reentrant fitness function */
 
 double computeFunc(double x, double y, int op_id) ;
 
@@ -37,6 +38,8 @@ int get_valid_input_index(int n_rows, int levels_back, int n_input_values, int n
 
 void decode_chromossome(Agent *a, int n_columns, int n_rows, int n_input_values, int n);
 
+int decode_chromossome_incremental(Agent *a, Agent *parent, int n_columns, int n_rows, int n_input_values, int n);
+
 void point_mutation(Agent* a, int n_columns, int n_rows, int levels_back, int n_input_values, int n_functions);
 
 #endif /* CGP_H */
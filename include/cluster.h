@@ -0,0 +1,59 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+/* The k-means engine clusters a set of n-dimensional points into k clusters. The centers are seeded with k-means++ at the first call,
+and they are kept in the engine, so that the following calls start from the centers of the previous one (warm start), which is much
+cheaper when the points move little between calls, e.g., the ideas of BSO along the iterations. The Lloyd iterations are pruned with
+Hamerly's bounds: each point keeps an upper bound of the distance to its center and a lower bound of the distance to the second
+nearest one, and the distances to all centers are only computed when the bounds cannot tell that the assignment is unchanged.
+The assignment step runs concurrently with the threads of the search space, and its results do not depend on the number of threads.
+All buffers are allocated once by CreateKMeans. */
+
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include "opt.h"
+
+/* It defines a k-means engine */
+typedef struct KMeans_{
+    int k; /* number of clusters */
+    int n; /* number of dimensions */
+    int capacity; /* maximum number of points */
+    int max_iterations; /* maximum number of Lloyd iterations of each call */
+    int iterations; /* number of Lloyd iterations of the last call */
+    char seeded; /* 1 if the centers come from a previous call, 0 otherwise */
+    double *center; /* centers (k x n doubles) */
+    double **c; /* pointers to the centers */
+    double *sum; /* sum of the points of each cluster (k x n doubles) */
+    int *count; /* number of points of each cluster */
+    double *shift; /* distance moved by each center at the last update */
+    double *half; /* half the distance from each center to the nearest other center */
+    int *label; /* cluster of each point */
+    int *new_label; /* cluster of each point found by the last assignment step */
+    double *upper; /* upper bound of the distance from each point to its center */
+    double *lower; /* lower bound of the distance from each point to its second nearest center */
+    double *d; /* distances to all centers (capacity x k doubles, a row per point, so that points can be assigned concurrently) */
+    double **X; /* points being clustered */
+}KMeans;
+
+/* K-means-related functions */
+KMeans *CreateKMeans(int k, int n, int capacity); /* It creates a k-means engine */
+void DestroyKMeans(KMeans **km); /* It deallocates a k-means engine */
+void ResetKMeans(KMeans *km); /* It discards the centers, so that the next call seeds them again */
+int RunKMeans(SearchSpace *s, KMeans *km, double **X, int m); /* It clusters m points, and it returns the number of Lloyd iterations */
+/**************************/
+
+#endif
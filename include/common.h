@@ -30,6 +30,7 @@ typedef struct _Node{
     char left_son; /* Flag to identify whether the node is a son placed on the left or on the right */
     struct _Node *right, *left, *parent; /* Pointers to the subtrees on the right, left and parent */
     double *val; /* used for Geometric Semantic GP */
+    int n_val; /* number of elements of val */
 }Node;
 
 /* It defines a general-purpose structure */
@@ -44,6 +45,82 @@ typedef struct _CGP_Node {
     int connection1; /* index for the 1th input gene of the node */
 }CGP_Node;
 
+/* It defines an instruction of a GP tree compiled into postfix order */
+typedef struct GPInstruction_{
+    int opcode; /* identifier of the function (see getFUNCTIONid), or -1 if the instruction pushes a leaf onto the stack */
+    int status; /* status of the leaf (TERMINAL|CONSTANT|NEW_TERMINAL) */
+    int id; /* identifier of the leaf (see Node) */
+    int n_args; /* number of values popped by a function (a function node may lack one of its sons) */
+    double *val; /* values of a NEW_TERMINAL leaf */
+}GPInstruction;
+
+/* It defines a GP tree compiled into postfix bytecode, along with the stack used to run it */
+typedef struct GPProgram_{
+    GPInstruction *code; /* instructions in postfix order */
+    int size; /* number of instructions */
+    int capacity; /* capacity of code */
+    int depth; /* maximum number of values on the stack */
+    int tensor_dim; /* dimension of the tensors (-1 for real-valued trees) */
+    int width; /* number of doubles of each value on the stack: n, or n * tensor_dim for tensor-based trees */
+    double *stack; /* stack of values (depth x width doubles) */
+    int stack_size; /* capacity of stack (number of doubles) */
+}GPProgram;
+
+/* It defines a node of a GP tree stored in a TreePool */
+typedef struct TreeNode_{
+    int opcode; /* identifier of the function (see getFUNCTIONid), or -1 for leaves */
+    int status; /* status of the node (FUNCTION|TERMINAL|CONSTANT) */
+    int id; /* identifier of the node (see Node) */
+    int n_args; /* number of sons */
+    int size; /* number of nodes of the subtree rooted at this node */
+}TreeNode;
+
+/* It defines a population of GP trees stored contiguously. The nodes of each tree are laid out in prefix order, so a subtree
+ is a contiguous range of nodes: the first son of the node at position k is at k + 1, and each of the following sons is placed
+ right after the subtree of its previous brother. Trees are referred to by their positions, so copying a tree is a single memcpy,
+ and all trees are removed at once by ClearTreePool. */
+typedef struct TreePool_{
+    TreeNode *node; /* nodes of all trees */
+    int used; /* number of nodes in use */
+    int capacity; /* capacity of node */
+    int m; /* number of trees */
+    int *root; /* position of the root of each tree */
+}TreePool;
+
+/* Operators recorded by the semantic engine of GSGP and BGSGP */
+enum GSGP_OPERATORS {
+  GSGP_REPRODUCTION, /* copy of an individual of the previous generation */
+  GSGP_SGXE, /* SGXE: (T1 * TR) + ((1 - TR) * T2) */
+  GSGP_SGME, /* SGME: same as SGXE, with a transformed random array */
+  GSGP_SGXB, /* SGXB: (T1 AND TR) OR ((NOT TR) AND T2) */
+  GSGP_SGMB_OR, /* SGMB: T OR M */
+  GSGP_SGMB_AND /* SGMB: T AND (NOT M) */
+};
+
+/* It defines how an individual of the semantic engine of GSGP and BGSGP was created */
+typedef struct GSGPRecord_{
+    int op; /* operator (see GSGP_OPERATORS) */
+    int parent[2]; /* positions of the parents in the previous generation (parent[1] is -1 for unary operators) */
+    double *val; /* random array used by the operator (SGXE, SGME and SGMB), or NULL */
+    Node *tree; /* random tree used by the operator (SGXB), or NULL */
+}GSGPRecord;
+
+/* It defines the ancestry log of the semantic engine of GSGP and BGSGP. Since the geometric semantic operators combine their
+ parents linearly (or bitwise), the output of an offspring can be computed from the outputs of its parents in O(n), so the engine
+ only keeps the output (semantics) of each individual. Trees are never built during the search: the log records how each
+ individual was created, and the tree of any individual of the last generation is rebuilt on demand (see GetGSGPTree). */
+typedef struct GSGPLog_{
+    int m; /* number of individuals */
+    int n; /* number of decision variables */
+    Node **T; /* trees of the initial population */
+    GSGPRecord **record; /* record[g][i]: how the i-th individual of generation g+1 was created */
+    int n_generations; /* number of recorded generations */
+    int capacity; /* capacity of record */
+    double *semantics; /* outputs of the individuals of the last generation (m x n doubles) */
+    double *next; /* outputs of the generation being created (m x n doubles) */
+    double *tmp; /* auxiliary array (n doubles) */
+}GSGPLog;
+
 /* It defines the agent (solution) to be used for all optimization techniques */
 typedef struct Agent_{
     /* common definitions */
@@ -51,6 +128,7 @@ typedef struct Agent_{
     double *x; /* position */
     double fit; /* fitness value */
     double **t; /* tensor */
+    char view; /* 1 if x, v and xl are rows of the search space's blocks (they are not owned by the agent), 0 otherwise */
 
     /* PSO */
     double *v; /* velocity */
@@ -83,9 +161,47 @@ typedef struct Agent_{
     CGP_Node* genotype; /* array of nodes */
     double* input_values; /* array of input random values used to feed the agent/graph */
     int* output_nodes; /* array containing the operation nodes output indexes */
+    char* active_mask; /* flag of each node telling whether it is active, i.e., whether the outputs depend on it */
+    int* active; /* indexes of the active nodes in evaluation order */
+    int n_active; /* number of active nodes */
+    double* node_values; /* output of each node, the input values included (only the ones of active nodes are meaningful) */
 
 }Agent;
 
+typedef void (*prtBatchFun)(const double *X, int m, int n, double *fit, void *ctx); /* Pointer to the function used to evaluate m n-dimensional decision vectors stored row by row in X at once */
+
+/* It defines a pool of scratch agents owned by a search space. Agents are borrowed and given back instead of being created and
+deallocated inside the main loops, so that the steady state of an optimization process does not allocate agents at all. */
+typedef struct AgentPool_{
+    int opt_id; /* identifier of the optimization technique the agents have been created for */
+    Agent **agent; /* agents owned by the pool */
+    Agent **available; /* stack of agents that are not borrowed */
+    int size; /* number of agents owned by the pool, i.e., number of agents it has ever created */
+    int n_available; /* number of agents in the stack */
+    int capacity; /* capacity of both arrays above */
+    long n_borrowed; /* number of borrowings since the pool was created */
+}AgentPool;
+
+/* It defines an indexed max-heap of the agents of a search space on their fitness values. The worst agent is found in O(1), and the heap
+is restored in O(log m) after the fitness value of an agent changes, e.g., when a new harmony replaces the worst one. The agents are not moved. */
+typedef struct FitnessHeap_{
+    int m; /* number of agents */
+    int *heap; /* indices of the agents (heap[0] is the worst one) */
+    int *pos; /* position of each agent in heap */
+}FitnessHeap;
+
+/* It defines the record of an iteration handed to the observer of a search space (see telemetry.h) */
+typedef struct IterationRecord_{
+    int iteration; /* current iteration */
+    int iterations; /* number of iterations of the run */
+    double fit; /* best fitness value found so far */
+    long evaluations; /* number of calls to the fitness function since the beginning of the run (cached values are not counted) */
+    double time; /* wall-clock time since the beginning of the run, in seconds */
+    double diversity; /* mean Euclidean distance between the positions of the agents and their centroid (-1 for GP, TGP, CGP and LOA) */
+}IterationRecord;
+
+typedef void (*prtObserver)(const IterationRecord *r, void *arg); /* Pointer to the function called with the record of an iteration */
+
 /* It defines the search space */
 typedef struct SearchSpace_{
     /* common definitions */
@@ -123,6 +239,7 @@ typedef struct SearchSpace_{
     double alpha; /* randomized parameter */
     double beta_0; /* attractiveness */
     double gamma; /* light absorption */
+    char keep_distances; /* 1 if the distances among fireflies are kept along the iterations and updated only for the ones that moved, 0 otherwise (default) */
 
     /* GP and GA */
     double pReproduction; /* probability of reproduction */
@@ -144,6 +261,12 @@ typedef struct SearchSpace_{
     double **constant; /* matrix with the random constants */
     Node **T; /* pointer to the tree */
     double *tree_fit; /* fitness of each tree (in GP, the number of agents is different from the number of trees) */
+    GPProgram *program; /* program used to run the trees (it is created on demand) */
+    Agent **individual; /* m scratch agents holding the outputs of the trees while they are evaluated (they are created on demand) */
+    TreePool *forest; /* trees being evolved by GP and TGP (if set, they are evaluated instead of T) */
+    struct SubtreeCache_ *subtree_cache; /* cache of the outputs of the subtrees of pooled trees (NULL if it is disabled, see SetSubtreeCache) */
+    GSGPLog *gsgp_log; /* ancestry log of the semantic engine of GSGP and BGSGP (NULL if it is disabled, see SetSemanticGSGP) */
+    double *semantics; /* outputs of the trees being evolved by the semantic engine of GSGP and BGSGP (if set, they are evaluated instead of T) */
 
     /* TGP */
     double ***t_constant; /* matrix with the tensor-based random constants */
@@ -222,20 +345,105 @@ typedef struct SearchSpace_{
     int n_columns; /* number of columns a given program will have */
     int n_rows; /* number of rows a given program will have */
     int n_input_values; /* lenght of the input array filled with random numbers */
+    int lambda; /* number of offspring generated from each agent at each iteration */
+
+    /* Parallel evaluation */
+    int n_threads; /* number of threads used to evaluate the agents (1 stands for serial evaluation) */
+    struct ThreadPool_ *pool; /* pool of threads (it is created on demand) */
+
+    /* Structure-of-arrays storage: row i of each m x n block (64-byte aligned) is viewed by agent i upon creation */
+    double *block_x; /* positions */
+    double *block_v; /* velocities (NULL if the technique does not use them) */
+    double *block_xl; /* local bests (NULL if the technique does not use them) */
+    double *block_fit; /* fitness values computed by the last evaluation of the search space */
+    double *block_trial; /* trial vectors (NULL until they are requested) */
+    double **trial; /* trial vector of each agent: row i of block_trial at first, it is exchanged with the agent's position upon acceptance */
+
+    /* Batch evaluation */
+    prtBatchFun batch; /* function used to evaluate all agents at once (NULL if it is not registered) */
+    void *batch_ctx; /* context of the batch function */
+
+    /* Scratch agents */
+    AgentPool *agent_pool; /* pool of scratch agents (it is created on demand) */
+
+    /* Fitness memoization */
+    struct FitnessCache_ *cache; /* cache of fitness values (NULL if it is disabled, see SetFitnessCache) */
+
+    /* Telemetry */
+    prtObserver observer; /* function called with the record of the reported iterations (NULL stands for a silent run, see telemetry.h) */
+    void *observer_arg; /* additional argument of the observer */
+    int report_every; /* the observer is called every report_every iterations, as well as at the last one */
+    double *centroid; /* centroid of the agents used to compute the diversity of the reported iterations (it is created on demand) */
     
 }SearchSpace;
 
 typedef double (*prtFun)(Agent *, va_list arg); /* Pointer to the function used to evaluate agents */
+typedef double (*prtFun_r)(const double *x, int n, void *ctx); /* Pointer to the reentrant function used to evaluate n-dimensional decision vectors */
+
+/* It defines the fitness function used along an optimization process, i.e., either a prtFun with its list of additional arguments, or a prtFun_r with its context.
+If a batch function has been registered in the search space, it takes precedence over both of them. */
+typedef struct Evaluator_{
+    prtFun f; /* agent-based fitness function */
+    va_list arg; /* list of additional arguments of f */
+    prtFun_r f_r; /* reentrant fitness function */
+    void *ctx; /* context of f_r */
+    prtBatchFun f_b; /* batch fitness function */
+    void *ctx_b; /* context of f_b */
+    double *X; /* buffer used to gather the decision vectors of a batch */
+    int size; /* capacity of X (number of doubles) */
+    Agent **miss; /* agents whose fitness values are not cached, gathered by EvaluateAgents */
+    double *f_miss; /* fitness values of the agents in miss */
+    int *index; /* position of each agent of miss in the evaluated array */
+    int miss_size; /* capacity of miss, f_miss and index (number of agents) */
+    struct FitnessCache_ *cache; /* cache of fitness values (NULL if it is disabled) */
+    long evaluations; /* number of calls to the fitness function since the evaluator was initialized */
+    double start; /* wall-clock time at which the evaluator was initialized, in seconds */
+}Evaluator;
 
 /* Agent-related functions */
 Agent *CreateAgent(int n, int opt_id, int tensor_dim); /* It creates an agent */
 void DestroyAgent(Agent **a, int opt_id); /* It deallocates an agent */
 void CheckAgentLimits(SearchSpace *s, Agent *a); /* It checks whether a given agent has excedeed boundaries */
 Agent *CopyAgent(Agent *a, int opt_id, int tensor_dim); /* It copies an agent */
+void CopyAgentInto(Agent *dst, Agent *a, int opt_id); /* It copies an agent into another one that has already been allocated */
+void ResetAgent(Agent *a); /* It resets an agent to the state of a newly created one */
+long GetAgentAllocationCount(); /* It returns the number of agents created so far */
 void EvaluateAgent(SearchSpace *s, Agent *a, int opt_id, prtFun Evaluate, va_list arg); /* It evaluate an agent according to each technique */
+void EvaluateAgentWith(SearchSpace *s, Agent *a, int opt_id, Evaluator *e); /* It evaluate an agent according to each technique using a fitness evaluator */
+void EvaluateAgents(SearchSpace *s, Agent **a, int m, Evaluator *e, double *f); /* It computes the fitness values of a set of agents (concurrently if s->n_threads > 1) */
 Agent *GenerateNewAgent(SearchSpace *s, int opt_id); /* It generates a new agent according to each technique */
 void CopySearchSpaceAgents(SearchSpace *s, SearchSpace *oldS, int opt_id, int tensor_id); /* It copies the agents from s to oldS */
 void Permutation(SearchSpace *s, int opt_id, int tensor_dim); /* It performs a SearchSpace permutation */
+void DrawNewPosition(SearchSpace *s, double *x, int opt_id); /* It draws the decision variables of a newly generated agent into an array */
+/**************************/
+
+/* Agent pool-related functions */
+Agent *BorrowAgent(SearchSpace *s, int opt_id); /* It borrows a scratch agent from the pool of a search space */
+Agent *BorrowAgentCopy(SearchSpace *s, Agent *a, int opt_id); /* It borrows a scratch agent holding a copy of a given agent */
+Agent *BorrowNewAgent(SearchSpace *s, int opt_id); /* It borrows a scratch agent generated as in GenerateNewAgent */
+void ReturnAgent(SearchSpace *s, Agent **a); /* It gives a borrowed agent back to the pool of a search space */
+void ResetAgentPool(SearchSpace *s); /* It gives all borrowed agents back to the pool of a search space at once */
+void DestroyAgentPool(AgentPool **p); /* It deallocates a pool of agents and all agents it owns */
+/**************************/
+
+/* Fitness heap-related functions */
+FitnessHeap *CreateFitnessHeap(SearchSpace *s); /* It creates a max-heap of the agents of a search space on their fitness values */
+void DestroyFitnessHeap(FitnessHeap **h); /* It deallocates a fitness heap */
+int GetWorstAgent(FitnessHeap *h); /* It returns the index of the agent with the largest fitness value */
+void UpdateFitnessHeap(SearchSpace *s, FitnessHeap *h, int i); /* It restores the heap after the fitness value of the i-th agent has changed */
+/**************************/
+
+/* Trial vector-related functions */
+double *GetTrialVector(SearchSpace *s, int i); /* It returns the trial vector of the i-th agent of a search space */
+void SwapTrialVector(SearchSpace *s, Agent *a, int i); /* It exchanges the position of an agent with the i-th trial vector of a search space */
+void RestoreAgentBlocks(SearchSpace *s); /* It moves the positions of the agents back to the rows of the search space's block */
+/**************************/
+
+/* Evaluator-related functions */
+void InitEvaluator(Evaluator *e, SearchSpace *s, prtFun Evaluate, va_list arg); /* It initializes a fitness evaluator with an agent-based function */
+void InitEvaluator_r(Evaluator *e, SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It initializes a fitness evaluator with a reentrant function */
+void DestroyEvaluator(Evaluator *e); /* It releases the resources held by a fitness evaluator */
+double ComputeFitness(Evaluator *e, Agent *a); /* It computes the fitness value of an agent */
 /**************************/
 
 /* Search Space-related functions */
@@ -244,7 +452,10 @@ void DestroySearchSpace(SearchSpace **s, int opt_id); /* It deallocates a search
 void InitializeSearchSpace(SearchSpace *s, int opt_id); /* It initializes an allocated search space */
 void ShowSearchSpace(SearchSpace *s, int opt_id); /* It shows a search space */
 void EvaluateSearchSpace(SearchSpace *s, int opt_id, prtFun Evaluate, va_list arg); /* It evaluates a search space */
+void EvaluateSearchSpace_r(SearchSpace *s, int opt_id, prtFun_r Evaluate, void *ctx); /* It evaluates a search space using a reentrant fitness function */
+void EvaluateSearchSpaceWith(SearchSpace *s, int opt_id, Evaluator *e); /* It evaluates a search space using a fitness evaluator */
 char CheckSearchSpace(SearchSpace *s, int opt_id); /* It checks whether a search space has been properly set or not */
+void SetBatchEvaluation(SearchSpace *s, prtBatchFun Evaluate, void *ctx); /* It registers a function used to evaluate all agents at once */
 
 
 
@@ -252,7 +463,7 @@ char CheckSearchSpace(SearchSpace *s, int opt_id); /* It checks whether a search
 /**************************/
 
 /* General-purpose functions */
-double GenerateUniformRandomNumber(double low, double high); /* It generates a random number drawn from a uniform distribution whithin [low,high] */
+double GenerateUniformRandomNumber(double low, double high); /* It generates a random number drawn from a uniform distribution whithin [low,high) */
 double GenerateGaussianRandomNumber(double mean, double variance); /* It generates a random number drawn from a Gaussian (normal) distribution */
 double GenerateCauchyRandomNumber(double location, double scale); /* It generates a random number drawn from a Cauchy distribution */
 double *GenerateLevyDistribution(int n, double beta); /* It generates an n-dimensional array drawn from a Levy distribution */
@@ -266,6 +477,7 @@ SearchSpace *ReadSearchSpaceFromFile(char *fileName, int opt_id); /* It loads a
 int getFUNCTIONid(char *s); /* It returns the identifier of the function used as input */
 int *RouletteSelection(SearchSpace *s, int k); /* It selects k elements based on the roulette selection method */
 int *RouletteSelectionGA(SearchSpace *s, int k); /* It selects k elements based on the roulette selection method */
+void RouletteSelectionGAInto(SearchSpace *s, int k, int *elem, Data *D, double *accum); /* It selects k elements based on the roulette selection method using arrays that have already been allocated */
 /**************************/
 
 /* Tree-related functions */
@@ -275,6 +487,11 @@ void DestroyTree(Node **T); /* It deallocates a tree */
 void PrintTree2File(SearchSpace *s, Node *T, char *fileName); /* It stores a tree in a text file */
 void PreFixPrintTree4File(SearchSpace *s, Node *T, FILE *fp); /* It performs a prefix search in tree and saves the nodes in a text file */
 double *RunTree(SearchSpace *s, Node *T); /* It runs a given tree and outputs its solution array */
+GPProgram *CreateGPProgram(); /* It creates an empty GP program */
+void DestroyGPProgram(GPProgram **p); /* It deallocates a GP program */
+void CompileTree(SearchSpace *s, Node *T, GPProgram *p); /* It compiles a tree into postfix bytecode */
+void CompileTTree(SearchSpace *s, Node *T, GPProgram *p); /* It compiles a tensor-based tree into postfix bytecode */
+double *RunGPProgram(SearchSpace *s, GPProgram *p); /* It runs a compiled tree and outputs its solution array */
 Node *CopyTree(Node *T); /* It copies a given tree */
 void PreFixTravel4Copy(Node *T, Node *Parent); /* It performs a prefix travel on a tree */
 int getSizeTree(Node *T); /* It returns the size of a tree (number of nodes) */
@@ -287,6 +504,40 @@ Node *SGXE(SearchSpace *s, Node *T1_tmp, Node *T2_tmp); /* It performs the Geome
 Node *SGME(SearchSpace *s, Node *T1_tmp, Node *T2_tmp); /* It performs the Geometric Semantic Genetic Programming mutation operator for real-valued functions */
 /***********************/
 
+/* Tree pool-related functions */
+TreePool *CreateTreePool(int m); /* It creates an empty pool of m trees */
+void DestroyTreePool(TreePool **p); /* It deallocates a pool of trees */
+void ClearTreePool(TreePool *p); /* It removes all trees from a pool */
+void Tree2Pool(TreePool *p, int i, Node *T); /* It stores a tree as the i-th tree of a pool */
+Node *Pool2Tree(SearchSpace *s, TreePool *p, int i); /* It creates a tree from the i-th tree of a pool */
+int getSizePooledTree(TreePool *p, int i); /* It returns the size of the i-th tree of a pool (number of nodes) */
+void GROWIntoPool(SearchSpace *s, TreePool *p, int i, int min_depth, int max_depth); /* It creates a random tree into a pool based on the GROW algorithm */
+void CopyTreeIntoPool(TreePool *dst, int i, TreePool *src, int j); /* It copies a tree from one pool to another */
+void MutationIntoPool(SearchSpace *s, TreePool *dst, int i, TreePool *src, int j, float p); /* It performs the mutation of a pooled tree */
+void CrossoverIntoPool(TreePool *dst, int i, int k, TreePool *src, int father, int mother, float p); /* It performs the crossover between two pooled trees */
+void CompilePooledTree(SearchSpace *s, TreePool *pool, int i, GPProgram *p); /* It compiles a pooled tree into postfix bytecode */
+void CompilePooledTTree(SearchSpace *s, TreePool *pool, int i, GPProgram *p); /* It compiles a pooled tensor-based tree into postfix bytecode */
+double *RunPooledTree(SearchSpace *s, TreePool *pool, int i); /* It runs a pooled tree and outputs its solution array */
+double *RunPooledTTree(SearchSpace *s, TreePool *pool, int i); /* It runs a pooled tensor-based tree and outputs its solution array */
+/***********************/
+
+/* Semantic GSGP-related functions */
+GSGPLog *CreateGSGPLog(int m, int n); /* It creates an empty ancestry log */
+void DestroyGSGPLog(GSGPLog **l); /* It deallocates an ancestry log */
+void ClearGSGPLog(GSGPLog *l); /* It removes all recorded generations and trees from an ancestry log */
+void StartGSGPLog(SearchSpace *s, GSGPLog *l); /* It starts a log from the current trees of a search space */
+void BeginGSGPGeneration(GSGPLog *l); /* It starts recording a new generation */
+void EndGSGPGeneration(GSGPLog *l); /* It makes the generation being recorded the current one */
+void ReproductionSemantics(GSGPLog *l, int i, int j); /* It copies the j-th individual into the i-th position of the new generation */
+void SGXBSemantics(SearchSpace *s, GSGPLog *l, int i, int father, int mother); /* It applies SGXB to the outputs of two individuals */
+void SGMBSemantics(SearchSpace *s, GSGPLog *l, int i, int j); /* It applies SGMB to the output of an individual */
+void SGXESemantics(SearchSpace *s, GSGPLog *l, int i, int father, int mother); /* It applies SGXE to the outputs of two individuals */
+void SGMESemantics(SearchSpace *s, GSGPLog *l, int i, int father, int mother); /* It applies SGME to the outputs of two individuals */
+double getSizeGSGPTree(GSGPLog *l, int i); /* It returns the size of the tree of the i-th individual of the last generation */
+Node *GetGSGPTree(GSGPLog *l, int i); /* It rebuilds the tree of the i-th individual of the last generation */
+void SetSemanticGSGP(SearchSpace *s, int enable); /* It enables or disables the semantic engine of GSGP and BGSGP */
+/***********************/
+
 /* Tensor-related functions */
 double **CreateTensor(int n, int tensor_dim); /* It allocates a new tensor */
 void DestroyTensor(double ***t, int n); /* It deallocates a tensor */
@@ -294,11 +545,14 @@ void InitializeTensorSearchSpace(SearchSpace *s, int tensor_id); /* It initializ
 void ShowTensorSearchSpace(SearchSpace *s, int tensor_id); /* It shows a search space with tensors */
 void CheckTensorLimits(SearchSpace *s, double **t, int tensor_dim); /* It checks whether a given tensor has excedeed boundaries */
 double **CopyTensor(double **t, int n, int tensor_id); /* It copies a given tensor */
+void CopyTensorInto(double **dst, double **t, int n, int tensor_id); /* It copies a given tensor into another one that has already been allocated */
 double **GenerateNewTensor(SearchSpace *s, int tensor_id); /* It generates a new tensor */
 double TensorNorm(double *t, int tensor_dim); /* It computes the norm of a given tensor */
 double TensorSpan(double L, double U, double *t, int tensor_dim); /* It maps the tensor value to a real one bounded by [L,U] */
 double TensorEuclideanDistance(double **t, double **s, int n, int tensor_id); /* It calculates the Euclidean Distance between tensors */
+void MapTensorSearchSpace(SearchSpace *s, int tensor_id); /* It maps the tensors of all agents to their real-valued positions */
 void EvaluateTensorSearchSpace(SearchSpace *s, int opt_id, int tensor_id, prtFun Evaluate, va_list arg); /* It evaluates a tensor-based search space */
+void EvaluateTensorSearchSpaceWith(SearchSpace *s, int opt_id, int tensor_id, Evaluator *e); /* It evaluates a tensor-based search space using a fitness evaluator */
 double **RunTTree(SearchSpace *s, Node *T); /* It runs a given tensor-based tree and outputs its solution array */
 void TensorPermutation(SearchSpace *s, int opt_id, int tensor_dim);  /* It performs a tensor-based SearchSpace permutation */
 /***********************/
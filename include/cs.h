@@ -22,6 +22,8 @@ limitations under the License.
 
 int NestLossParameter(int size, float probability); /* It computes the number of nests that will be replaced, taking into account a probability [0,1] */
 void runCS(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Cuckoo Search for function minimization */
+void runCS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Cuckoo Search for function minimization using a reentrant fitness function */
 void runTensorCS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Cuckoo Search for function minimization */
+void runTensorCS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Cuckoo Search for function minimization using a reentrant fitness function */
 
 #endif
@@ -8,5 +8,6 @@ as well as wikipedia page at https://en.wikipedia.org/wiki/Differential_evolutio
 
 /* DE-related functions */
 void runDE(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Differential evolution for function minimization */
+void runDE_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Differential evolution for function minimization using a reentrant fitness function */
 
 #endif
@@ -21,6 +21,8 @@ limitations under the License.
 #include "opt.h"
 
 void runFA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Firefly Algorithm for function minimization */
+void runFA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Firefly Algorithm for function minimization using a reentrant fitness function */
 void runTensorFA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Firefly Algorithm for function minimization */
+void runTensorFA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Firefly Algorithm for function minimization using a reentrant fitness function */
 
 #endif
\ No newline at end of file
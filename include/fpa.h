@@ -21,6 +21,8 @@ limitations under the License.
 #include "opt.h"
 
 void runFPA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Flower Pollination Algorithm for function minimization */
+void runFPA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Flower Pollination Algorithm for function minimization using a reentrant fitness function */
 void runTensorFPA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Flower Pollination Algorithm for function minimization */
+void runTensorFPA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Flower Pollination Algorithm for function minimization using a reentrant fitness function */
 
 #endif
\ No newline at end of file
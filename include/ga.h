@@ -19,5 +19,6 @@ limitations under the License.
 #include "opt.h"
 
 void runGA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Genetic Algorithm for function minimization */
+void runGA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Genetic Algorithm for function minimization using a reentrant fitness function */
 
 #endif
@@ -22,8 +22,12 @@ limitations under the License.
 techniques either, but the nodes are employed to build the tree-like representation. */
 
 void runBGSGP(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Binary Geometric Semantic Genetic Programming for function minimization */
+void runBGSGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Binary Geometric Semantic Genetic Programming for function minimization using a reentrant fitness function */
 void runGSGP(SearchSpace *s, prtFun Evaluate, ...); /* It executes the standard (real-valued) Geometric Semantic Genetic Programming for function minimization */
+void runGSGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the standard (real-valued) Geometric Semantic Genetic Programming for function minimization using a reentrant fitness function */
 void runGP(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Genetic Programming for function minimization */
+void runGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Genetic Programming for function minimization using a reentrant fitness function */
 void runTGP(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Tensor-based Genetic Programming for function minimization */
+void runTGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Genetic Programming for function minimization using a reentrant fitness function */
 
 #endif
\ No newline at end of file
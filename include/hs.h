@@ -25,13 +25,19 @@ limitations under the License.
 #define PSF_PITCH 2
 
 void runHS(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Harmony Search for function minimization */
+void runHS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Harmony Search for function minimization using a reentrant fitness function */
 void runIHS(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Improved Harmony Search for function minimization */
+void runIHS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Improved Harmony Search for function minimization using a reentrant fitness function */
 void UpdateIndividualHMCR_PAR(SearchSpace *s, char **rehearsal, double *HMCR, double *PAR); /* It updates the individual values of HMCR and PAR concerning PSF-HS */
 void UpdateIndividualTensorHMCR_PAR(SearchSpace *s, int tensor_id, char ***rehearsal, double **HMCR, double **PAR); /* It updates the individual values of HMCR and PAR concerning Tensor-based PSF-HS */
 Agent *GenerateNewPSF(SearchSpace *s, double *HMCR, double *PAR, char *op_type); /* It generates a new PSF agent */
 double **GenerateNewPSFTensor(SearchSpace *s, int tensor_id, double **HMCR, double **PAR, char **op_type); /* It generates a new PSF tensor */
 void runPSF_HS(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Parameter-setting-free Harmony Search for function minimization */
+void runPSF_HS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Parameter-setting-free Harmony Search for function minimization using a reentrant fitness function */
 void runTensorHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Harmony Search for function minimization */
+void runTensorHS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Harmony Search for function minimization using a reentrant fitness function */
 void runTensorIHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Improved Harmony Search for function minimization */
+void runTensorIHS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Improved Harmony Search for function minimization using a reentrant fitness function */
 void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Parameter-setting-free Tensor-based Improved Harmony Search for function minimization */
+void runTensorPSF_HS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Parameter-setting-free Tensor-based Improved Harmony Search for function minimization using a reentrant fitness function */
 #endif
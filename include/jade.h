@@ -22,14 +22,15 @@ limitations under the License.
 
 
 void runJADE(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Adaptive Differential Evolution with Optional External Archive for function minimization */
+void runJADE_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Adaptive Differential Evolution with Optional External Archive for function minimization using a reentrant fitness function */
 
 /* Lists related functions */
 double LehmerMeanList(double* list, int nElements); /* It calculates the Lehmer mean of a given list of doubles */
 double ArithmeticMeanList(double* list, int nElements);  /* It calculates the Arithmetic mean of a given list of doubles */
-double* AddList( double *list, double value, int nElements); /* Insert a double into a predefined list of doubles */
+void AddList( double *list, double value, int nElements); /* Insert a double into a predefined list of doubles */
 
 /* Functions related to the evolutive process */
-double* MutationJade(int i, SearchSpace *s, SearchSpace *A, double Fi, int n_elements_archive); /* It generates a mutate vector */
+void MutationJade(int i, SearchSpace *s, SearchSpace *A, double Fi, int n_elements_archive, double *mutation, Agent **sorted); /* It generates a mutate vector */
 void CrossoverJade(SearchSpace* s, SearchSpace* crossover, int i, double* mutation, double CRi); /* It executes the crossover operation */
 
 /* Archive insert-related functions */
@@ -39,5 +40,5 @@ void SwapArchiveAgent(SearchSpace *A, SearchSpace *s, Agent* a); /* It replaces
 /* Agent selection for mutation functions */
 Agent * Getr2Agent(SearchSpace *s, SearchSpace *A, int i, int r1_index, int n_elements_archive);  /* Randomly choose r2 from current population P union Archive population A */
 Agent * Getr1Agent(SearchSpace *s, int i, int* r1_index); /* Randomly choose r1 from current population P */
-Agent * GetBestPAgent(SearchSpace *s); /* Randomly choose bestP as one of the 100 p% best vectors */
+Agent * GetBestPAgent(SearchSpace *s, Agent **sorted); /* Randomly choose bestP as one of the 100 p% best vectors */
 #endif
@@ -0,0 +1,95 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/* Vectorized versions of the separable benchmark functions of function.h. Each function comes in two forms:
+NAME_r(x, n, ctx) scores a single point (see prtFun_r), and NAME_Batch(X, m, n, fit, ctx) scores a whole population
+in one call (see prtBatchFun and SetBatchEvaluation). The code path (AVX-512, AVX2+FMA or portable C) is chosen once
+at run time according to the CPU, and it can be forced by the environment variable OPT_KERNEL_ISA (scalar, avx2 or avx512).
+The results match the ones of function.h up to rounding errors, since the sums are accumulated in a different order.
+The GP primitives (NAME_Into) compute the functions used by GP and TGP trees into an output array provided by the caller,
+which may be one of the inputs, and they do not allocate memory. They give exactly the same results in every code path.
+The distance kernels compute the distances among the points of a population at once, e.g., the pairwise distances of FA or the
+distances between the ideas and the centers of BSO's clustering. The tensor kernels work on the rows of a tensor allocated by CreateTensor,
+whose n x tensor_dim values are stored in a single block, and they give exactly the same results of TensorNorm, TensorSpan and
+TensorEuclideanDistance in every code path. */
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "common.h"
+
+/* Single-point benchmark functions */
+double Ackley_First_r(const double *x, int n, void *ctx); /* It computes the 1st Ackley's function */
+double Alpine_First_r(const double *x, int n, void *ctx); /* It computes the 1st Alpine's function */
+double Griewank_r(const double *x, int n, void *ctx); /* It computes the Griewank's function */
+double Rastrigin_r(const double *x, int n, void *ctx); /* It computes the Rastrigin's function */
+double Rosenbrock_r(const double *x, int n, void *ctx); /* It computes the Rosenbrock's function */
+double Schumer_Steiglitz_r(const double *x, int n, void *ctx); /* It computes the Schumer Steiglitz's function */
+double Sphere_r(const double *x, int n, void *ctx); /* It computes the Sphere's function */
+double Sum_Squares_r(const double *x, int n, void *ctx); /* It computes the Sum Squares function */
+double Styblinski_Tang_r(const double *x, int n, void *ctx); /* It computes the Styblinski's-Tang function */
+/**************************/
+
+/* Population benchmark functions */
+void Ackley_First_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the 1st Ackley's function of m points */
+void Alpine_First_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the 1st Alpine's function of m points */
+void Griewank_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the Griewank's function of m points */
+void Rastrigin_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the Rastrigin's function of m points */
+void Rosenbrock_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the Rosenbrock's function of m points */
+void Schumer_Steiglitz_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the Schumer Steiglitz's function of m points */
+void Sphere_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the Sphere's function of m points */
+void Sum_Squares_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the Sum Squares function of m points */
+void Styblinski_Tang_Batch(const double *X, int m, int n, double *fit, void *ctx); /* It computes the Styblinski's-Tang function of m points */
+/**************************/
+
+/* GP primitives */
+void RunGPFunction(int func_id, const double *x, const double *y, double *out, int n); /* It applies a GP function elementwise to n-dimensional arrays */
+void f_SUM_Into(const double *x, const double *y, double *out, int n); /* It computes the pointwise sum of two n-dimensional arrays */
+void f_SUB_Into(const double *x, const double *y, double *out, int n); /* It computes the pointwise subtraction of two n-dimensional arrays */
+void f_MUL_Into(const double *x, const double *y, double *out, int n); /* It computes the pointwise multiplication of two n-dimensional arrays */
+void f_DIV_Into(const double *x, const double *y, double *out, int n); /* It computes the pointwise (protected) division of two n-dimensional arrays */
+void f_ABS_Into(const double *x, double *out, int n); /* It computes the absolute value of each element from an n-dimensional array */
+void f_SQRT_Into(const double *x, double *out, int n); /* It computes the squared root of the absolute value of each element from an n-dimensional array */
+void f_EXP_Into(const double *x, double *out, int n); /* It computes the exponential (e) of each element from an n-dimensional array */
+void f_LOG_Into(const double *x, double *out, int n); /* It computes the (protected) natural logarithm of each element from an n-dimensional array */
+void f_AND_Into(const double *x, const double *y, double *out, int n); /* It computes the logical function AND among two n-dimensional arrays */
+void f_OR_Into(const double *x, const double *y, double *out, int n); /* It computes the logical function OR among two n-dimensional arrays */
+void f_XOR_Into(const double *x, const double *y, double *out, int n); /* It computes the logical function XOR among two n-dimensional arrays */
+void f_NOT_Into(const double *x, double *out, int n); /* It computes the logical function NOT of an n-dimensional array */
+void f_TSUM_Into(const double *x, const double *y, double *out, int m, int n); /* It computes the tensor sum of two mxn-dimensional tensors stored row by row */
+void f_TSUB_Into(const double *x, const double *y, double *out, int m, int n); /* It computes the tensor subtraction of two mxn-dimensional tensors stored row by row */
+void f_TMUL_Into(const double *x, const double *y, double *out, int m, int n); /* It computes the tensor multiplication of two mxn-dimensional tensors stored row by row */
+void f_TDIV_Into(const double *x, const double *y, double *out, int m, int n); /* It computes the tensor (protected) division of two mxn-dimensional tensors stored row by row */
+/**************************/
+
+/* Distance kernels */
+void SquaredNorms(double **X, int m, int n, double *norm); /* It computes the squared Euclidean norm of m n-dimensional arrays */
+void SquaredDistanceMatrix(double **X, int m, double **Y, int k, int n, double *D); /* It computes the squared Euclidean distances between m and k n-dimensional arrays */
+void EuclideanDistances(double *x, double **Y, int k, int n, double *d); /* It computes the Euclidean distances between an n-dimensional array and k others */
+double SquaredDistance(const double *x, const double *y, int n); /* It computes the squared Euclidean distance between two n-dimensional arrays */
+/**************************/
+
+/* Tensor kernels */
+void TensorNorms(const double *T, int n, int tensor_dim, double *norm); /* It computes the norms of n tensor_dim-dimensional tensors stored row by row */
+void TensorSpans(const double *L, const double *U, const double *T, int n, int tensor_dim, double *x); /* It maps n tensor_dim-dimensional tensors stored row by row to real values bounded by [L,U] */
+double TensorDistanceSum(const double *T, const double *S, int n, int tensor_dim); /* It sums the Euclidean distances between the rows of two n x tensor_dim tensors stored row by row */
+/**************************/
+
+/* General-purpose functions */
+const char *GetKernelISA(); /* It returns the name of the code path used by the kernels */
+int CheckKernels(int n, double tol); /* It compares every available code path of the kernels against the functions of function.h */
+/**************************/
+
+#endif
@@ -21,10 +21,11 @@ limitations under the License.
 #include "opt.h"
 
 /* MBO-related functions */
-void UpdateNeighbours(SearchSpace *s, int b, int k, prtFun Evaluate, va_list arg); /* It updates the neighbours of a single bird */
+void UpdateNeighbours(SearchSpace *s, int b, int k, Evaluator *e); /* It updates the neighbours of a single bird */
 void ShareNeighbours(SearchSpace *s); /* It shares the neighbours to the following bird */
 void ImproveBirds(SearchSpace *s); /* It tries to replace each bird for its best neighbour */
 void runMBO(SearchSpace *s, prtFun EvaluateFun, ...); /* It executes the Migrating Birds Optimization for function minimization */
+void runMBO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Migrating Birds Optimization for function minimization using a reentrant fitness function */
 /*************************/
 
 #endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/* The thread pool runs parallel loops whose iterations are independent of each other, e.g., the fitness evaluation of all agents in a given iteration.
+The number of threads is taken from the search space (s->n_threads), which defaults to the value of the environment variable OPT_NUM_THREADS (or 1, i.e., serial execution, if it is not set). */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <pthread.h>
+
+#include "opt.h"
+
+typedef void (*prtTask)(int i, void *arg); /* Pointer to the function executed at each iteration of a parallel loop */
+
+/* It defines a pool of worker threads */
+typedef struct ThreadPool_{
+    int n_threads; /* number of threads (the calling thread included) */
+    pthread_t *thread; /* worker threads */
+    pthread_mutex_t lock; /* it protects the fields below */
+    pthread_cond_t work; /* it signals a new loop to the workers */
+    pthread_cond_t done; /* it signals the end of a loop to the calling thread */
+    prtTask task; /* function executed at each iteration of the current loop */
+    void *arg; /* additional argument of the task */
+    int n_tasks; /* number of iterations of the current loop */
+    int next; /* next iteration to be executed */
+    int busy; /* number of workers still running the current loop */
+    int round; /* identifier of the current loop */
+    char stop; /* flag to shut down the workers */
+}ThreadPool;
+
+/* Thread pool-related functions */
+ThreadPool *CreateThreadPool(int n_threads); /* It creates a pool of threads */
+void DestroyThreadPool(ThreadPool **p); /* It deallocates a pool of threads */
+void RunThreadPool(ThreadPool *p, int n_tasks, prtTask task, void *arg); /* It executes task(i, arg) for i = 0, ..., n_tasks-1 using the pool */
+/**************************/
+
+/* General-purpose functions */
+int GetDefaultNumberOfThreads(); /* It returns the number of threads defined by the environment variable OPT_NUM_THREADS */
+void ParallelFor(SearchSpace *s, int n_tasks, prtTask task, void *arg); /* It executes a parallel loop with the threads of a search space */
+/**************************/
+
+#endif
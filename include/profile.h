@@ -0,0 +1,97 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/* The profiler tells where the time of a run goes. The library must be compiled with -DOPT_PROFILE (e.g., make FLAGS="-O2 -DOPT_PROFILE");
+otherwise the PROFILE_* macros expand to nothing and the hot paths are not instrumented at all. Each run* function opens a profile,
+and the hot paths are enclosed by phases: fitness calls, search space evaluation (best updates and, for GP, tree execution), boundary
+checks, sorting, agent copies and bulk random number generation. Phases may be nested, and the self time of a phase excludes the
+time of the phases nested in it, so that the self time of the run itself is spent by the technique's own updates (velocities, positions,
+selection, etc.). The phases executed by worker threads add up their time, so the sum of the self times may exceed the run's wall-clock
+time. The profile also counts fitness evaluations, allocations, bytes copied and random numbers drawn, and, if the environment variable
+OPT_PROFILE_HW is set, it reads hardware counters by perf_event_open (Linux only). The summary is printed to stderr at the end of
+each run, unless the environment variable OPT_PROFILE_QUIET is set, and it can be read by GetProfile. Only one run should be profiled at a time. */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+#include "opt.h"
+
+/* Phases */
+#define _PROFILE_RUN_ 0 /* the run itself, i.e., the technique's own updates */
+#define _PROFILE_FITNESS_ 1 /* calls to the fitness function (EvaluateAgents and ComputeFitness) */
+#define _PROFILE_EVALUATION_ 2 /* evaluation of the search space or an agent, except the fitness calls */
+#define _PROFILE_LIMITS_ 3 /* CheckAgentLimits */
+#define _PROFILE_SORT_ 4 /* sorting of agents */
+#define _PROFILE_COPY_ 5 /* copies of agents and tensors */
+#define _PROFILE_RANDOM_ 6 /* bulk random number generation (the single draws are only counted) */
+#define N_PROFILE_PHASES 7
+/**************************/
+
+/* Counters */
+#define _PROFILE_EVALUATIONS_ 0 /* fitness evaluations */
+#define _PROFILE_ALLOCATIONS_ 1 /* agents, tensors and blocks allocated */
+#define _PROFILE_BYTES_COPIED_ 2 /* bytes copied by CopyAgent, CopyAgentInto and CopyTensor */
+#define _PROFILE_RANDOM_DRAWS_ 3 /* random numbers drawn */
+#define N_PROFILE_COUNTERS 4
+/**************************/
+
+/* Hardware counters */
+#define _PROFILE_CYCLES_ 0
+#define _PROFILE_INSTRUCTIONS_ 1
+#define _PROFILE_CACHE_MISSES_ 2
+#define _PROFILE_BRANCH_MISSES_ 3
+#define N_PROFILE_HW_COUNTERS 4
+/**************************/
+
+#define PROFILE_MAX_DEPTH 16 /* maximum nesting of phases */
+
+/* PROFILE_BEGIN and PROFILE_END must be paired by the same thread, innermost phase first */
+#ifdef OPT_PROFILE
+#define PROFILE_BEGIN(phase) BeginProfilePhase()
+#define PROFILE_END(phase) EndProfilePhase(phase)
+#define PROFILE_COUNT(counter, k) AddProfileCounter(counter, k)
+#define PROFILE_BEGIN_RUN() BeginProfileRun()
+#define PROFILE_END_RUN(name, e) EndProfileRun(name, e)
+#else
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+#define PROFILE_COUNT(counter, k)
+#define PROFILE_BEGIN_RUN()
+#define PROFILE_END_RUN(name, e)
+#endif
+
+/* It defines the profile of a run */
+typedef struct Profile_{
+    const char *name; /* name of the technique */
+    uint64_t calls[N_PROFILE_PHASES]; /* number of times each phase has been executed */
+    uint64_t self[N_PROFILE_PHASES]; /* time spent in each phase, except its nested phases, in nanoseconds */
+    uint64_t total[N_PROFILE_PHASES]; /* time spent in each phase, in nanoseconds */
+    uint64_t counter[N_PROFILE_COUNTERS];
+    int64_t hw[N_PROFILE_HW_COUNTERS]; /* hardware counters (-1 if they are not available) */
+}Profile;
+
+/* Profiler-related functions */
+void BeginProfileRun(); /* It resets the profile and starts the timer of a run */
+void EndProfileRun(const char *name, Evaluator *e); /* It stops the timer of a run and prints its summary */
+void BeginProfilePhase(); /* It starts the timer of a phase */
+void EndProfilePhase(int phase); /* It stops the timer of the latest phase started by the calling thread */
+void AddProfileCounter(int counter, uint64_t k); /* It adds k to a counter */
+const Profile *GetProfile(); /* It returns the profile of the current (or latest) run */
+void PrintProfile(const Profile *p, FILE *fp); /* It prints the summary of a profile */
+/**************************/
+
+#endif
@@ -25,10 +25,12 @@ AIWPSO implementation is based on the paper available at http://ceit.aut.ac.ir/~
 void UpdateParticleVelocity(SearchSpace *s, int i); /* It updates the velocity of an agent (particle) */
 void UpdateParticlePosition(SearchSpace *s, int i); /* It updates the position of an agent (particle) */
 void runPSO(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Particle Swarm Optimization for function minimization */
+void runPSO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Particle Swarm Optimization for function minimization using a reentrant fitness function */
 /*************************/
 
 /* AIWPSO-related functions */
 void runAIWPSO(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization */
+void runAIWPSO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization using a reentrant fitness function */
 double ComputeSuccess(SearchSpace *s); /* It computes the pecentage of success concerning the whole search space */
 /****************************/
 
@@ -36,7 +38,9 @@ double ComputeSuccess(SearchSpace *s); /* It computes the pecentage of success c
 void UpdateTensorParticleVelocity(SearchSpace *s, int i, int tensor_id); /* It updates the velocity of an tensor (particle) */
 void UpdateTensorParticlePosition(SearchSpace *s, int i, int tensor_id); /* It updates the position of an tensor (particle) */
 void runTensorPSO(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Tensor-based Particle Swarm Optimization for function minimization */
+void runTensorPSO_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Tensor-based Particle Swarm Optimization for function minimization using a reentrant fitness function */
 void runTensorAIWPSO(SearchSpace *s, int tensor_id, prtFun Evaluate, ...); /* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization */
+void runTensorAIWPSO_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx); /* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization using a reentrant fitness function */
 /*************************/
 
 #endif
@@ -13,29 +13,50 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+/* Random numbers are generated by xoshiro256** (http://prng.di.unimi.it). Each thread draws from its own stream,
+so parallel code does not share (nor serialize on) a single state. The streams are derived from the seed given to srandinter:
+the i-th stream is the seeded state advanced by i jumps of 2^128 numbers, so that they never overlap.
+Each thread also owns a bulk generator, i.e., RANDOM_LANES xoshiro256** states advanced together with SIMD instructions,
+which the Fill* functions use to draw whole buffers at once. */
+
 #ifndef RANDOM_H
 #define RANDOM_H
 
+#include <stdint.h>
+
 #include "opt.h"
 
-#define IM1 2147483563
-#define IM2 2147483399
-#define AM (1.0/IM1)
-#define IMM1 (IM1-1)
-#define IA1 40014
-#define IA2 40692
-#define IQ1 53668
-#define IQ2 52774
-#define IR1 12211
-#define IR2 3791
-#define NTAB 32
-#define NDIV (1+IMM1/NTAB)
-#define EPS 1.e-14
-#define RNMX (1.0-EPS)
-
-double ran2(int *idum);
+#define RANDOM_LANES 8 /* number of independent xoshiro256** states advanced together by the bulk generator */
+
+/* It defines a stream of random numbers */
+typedef struct RandomStream_{
+    uint64_t state[4]; /* state of xoshiro256** */
+    char has_gaussian; /* 1 if gaussian holds a spare normal deviate */
+    double gaussian; /* spare normal deviate generated by the polar method */
+}RandomStream;
+
+/* Stream-related functions */
+void SeedRandomStream(RandomStream *r, uint64_t seed); /* It initializes a stream of random numbers */
+void JumpRandomStream(RandomStream *r); /* It advances a stream by 2^128 numbers */
+void CreateRandomStreams(RandomStream *r, int n, uint64_t seed); /* It initializes n non-overlapping streams (e.g., one per agent) */
+uint64_t NextRandom(RandomStream *r); /* It returns the next 64-bit random number of a stream */
+double UniformRandom(RandomStream *r, double a, double b); /* It returns a random number uniformly distributed within [a,b) */
+double GaussianRandom(RandomStream *r, double mean, double variance); /* It returns a number drawn from a Gaussian distribution */
+RandomStream *GetRandomStream(); /* It returns the stream of the calling thread */
+/**************************/
+
+/* Bulk generator-related functions */
+void FillUnitBlocks(double *u, int n); /* It fills an array with uniform numbers within [0,1) drawn by the bulk generator (AVX-512, AVX2 or scalar code, all with the same output) */
+/**************************/
+
+/* General-purpose functions */
 int srandinter(int seed); /* It initializes the random number generator */
 double randinter(double a, double b); /* It returns a random number uniformly distributed between a and b */
 double randGaussian(double mean, double variance); /* It returns a number drawn from a Gaussian distribution */
 double randCauchy(double location, double scale); /* It returns a number drawn from a Cauchy distribution */
+void FillUniform(double *x, int n, double lo, double hi); /* It fills an array with random numbers uniformly distributed within [lo,hi) using the bulk generator */
+void FillGaussian(double *x, int n, double mean, double variance); /* It fills an array with numbers drawn from a Gaussian distribution using the bulk generator */
+void FillLevy(double *x, int n, double beta); /* It fills an array with steps drawn from a Levy distribution using the bulk generator */
+/**************************/
+
 #endif
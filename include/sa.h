@@ -29,5 +29,6 @@ double initTemp_boltzmannAnnealing(double t_end, double max_iter);
 double fastScheduleAnnealing(double T, double alpha);
 
 void runSA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Simulated Annealing for function minimization */
+void runSA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Simulated Annealing for function minimization using a reentrant fitness function */
 
 #endif
@@ -0,0 +1,65 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/* The telemetry reports the progress of an optimization process without printing anything by itself. At the end of each iteration,
+the technique calls ReportIteration, which builds an IterationRecord (best fitness value, number of fitness evaluations, wall-clock time
+and diversity of the agents) and hands it to the observer of the search space, every s->report_every iterations. There is no observer
+by default, so the runs are silent and the records are not even built, unless the environment variable OPT_PROGRESS is set to k > 0,
+which prints every k-th iteration to stderr (see PrintIteration). A trace sink is an observer that queues the records and writes them
+to a CSV or binary file from a background thread, so that the optimization process does not wait for the I/O. */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <pthread.h>
+
+#include "opt.h"
+
+/* Trace formats */
+#define _TRACE_CSV_ 0 /* one line per record, preceded by a header */
+#define _TRACE_BINARY_ 1 /* raw IterationRecord structures in the native byte order */
+/**************************/
+
+/* It defines an observer that writes the records to a file from a background thread */
+typedef struct TraceSink_{
+    FILE *fp; /* output file */
+    int format; /* trace format (_TRACE_CSV_ or _TRACE_BINARY_) */
+    IterationRecord *queue; /* circular queue of records waiting to be written */
+    IterationRecord *buffer; /* records being written by the background thread */
+    int capacity; /* capacity of both arrays above */
+    int head; /* position of the oldest record in the queue */
+    int size; /* number of records in the queue */
+    long written; /* number of records written so far */
+    pthread_t thread; /* background thread */
+    pthread_mutex_t lock; /* it protects the fields above */
+    pthread_cond_t not_empty; /* it signals new records to the background thread */
+    pthread_cond_t not_full; /* it signals free room in the queue to the observer */
+    char stop; /* flag to shut down the background thread */
+}TraceSink;
+
+/* Telemetry-related functions */
+void SetDefaultObserver(SearchSpace *s); /* It sets the observer defined by the environment variable OPT_PROGRESS */
+void ReportIteration(SearchSpace *s, int opt_id, Evaluator *e, int t, double fit); /* It hands the record of an iteration to the observer of a search space */
+void PrintIteration(const IterationRecord *r, void *arg); /* It prints the record of an iteration to stderr */
+double GetWallTime(); /* It returns the wall-clock time in seconds */
+/**************************/
+
+/* Trace sink-related functions */
+TraceSink *CreateTraceSink(char *file, int format, int capacity); /* It creates a trace sink and its background thread */
+void DestroyTraceSink(TraceSink **t); /* It writes the pending records and deallocates a trace sink */
+void WriteTrace(const IterationRecord *r, void *arg); /* It queues the record of an iteration into a trace sink */
+/**************************/
+
+#endif
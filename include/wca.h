@@ -19,5 +19,6 @@ limitations under the License.
 #include "opt.h"
 
 void runWCA(SearchSpace *s, prtFun Evaluate, ...); /* It executes the Water Cycle Algorithm for function minimization */
+void runWCA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx); /* It executes the Water Cycle Algorithm for function minimization using a reentrant fitness function */
 
 #endif
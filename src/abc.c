@@ -14,22 +14,20 @@ limitations under the License.
 */
 
 #include "abc.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
-/* It executes the Artificial Bee Colony for function minimization
+/* It executes the Artificial Bee Colony with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runABC(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void ABC(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int i, j, k, t, chosen_param, neighbour, *trial, max_trial_index, limit;
     double max_fitness, r, fitValue, *prob;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runABC.\n");
@@ -40,16 +38,13 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
     trial = (int *)calloc(s->m, sizeof(int));
     prob = (double *)calloc(s->m, sizeof(double));
 
-    EvaluateSearchSpace(s, _ABC_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _ABC_, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         /* Employed Bee step */
         for (i = 0; i < s->m; i++)
         { /* For each food source */
-            va_copy(arg, argtmp);
 
             chosen_param = GenerateUniformRandomNumber(0, s->n - 1); /* Randomly parameter to be used */
             do
@@ -58,16 +53,15 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
             } while (neighbour == i);
             r = GenerateUniformRandomNumber(0, 1);
 
-            tmp = CopyAgent(s->a[i], _ABC_, _NOTENSOR_);
+            tmp = BorrowAgentCopy(s, s->a[i], _ABC_);
             tmp->x[chosen_param] = s->a[i]->x[chosen_param] + (s->a[i]->x[chosen_param] - s->a[neighbour]->x[chosen_param]) * r; /* We now update our currently solution */
             CheckAgentLimits(s, tmp);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent tmp */
             if (fitValue < s->a[i]->fit)
             { /* We accept the new solution */
                 trial[i] = 0;
-                DestroyAgent(&(s->a[i]), _ABC_);
-                s->a[i] = CopyAgent(tmp, _ABC_, _NOTENSOR_);
+                CopyAgentInto(s->a[i], tmp, _ABC_);
                 s->a[i]->fit = fitValue;
             }
             else
@@ -80,7 +74,7 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
                 for (j = 0; j < s->n; j++)
                     s->g[j] = tmp->x[j];
             }
-            DestroyAgent(&tmp, _ABC_);
+            ReturnAgent(s, &tmp);
         }
 
         /* Calculation of new probabilities */
@@ -99,7 +93,6 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
             r = GenerateUniformRandomNumber(0, 1);
             if (r < prob[i])
             {
-                va_copy(arg, argtmp);
                 k++;
                 chosen_param = GenerateUniformRandomNumber(0, s->n - 1); /* Randomly parameter to be used */
                 do
@@ -107,15 +100,14 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
                     neighbour = GenerateUniformRandomNumber(0, s->m - 1); /* Randomly neighbour to be used, which must be different from i */
                 } while (neighbour == i);
 
-                tmp = CopyAgent(s->a[i], _ABC_, _NOTENSOR_);
+                tmp = BorrowAgentCopy(s, s->a[i], _ABC_);
                 tmp->x[chosen_param] = s->a[i]->x[chosen_param] + (s->a[i]->x[chosen_param] - s->a[neighbour]->x[chosen_param]) * r; /* We now update our currently solution */
                 CheckAgentLimits(s, tmp);
-                fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
+                fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent tmp */
                 if (fitValue < s->a[i]->fit)
                 { /* We accept the new solution */
                     trial[i] = 0;
-                    DestroyAgent(&(s->a[i]), _ABC_);
-                    s->a[i] = CopyAgent(tmp, _ABC_, _NOTENSOR_);
+                    CopyAgentInto(s->a[i], tmp, _ABC_);
                     s->a[i]->fit = fitValue;
                 }
                 else
@@ -128,7 +120,7 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
                     for (j = 0; j < s->n; j++)
                         s->g[j] = tmp->x[j];
                 }
-                DestroyAgent(&tmp, _ABC_);
+                ReturnAgent(s, &tmp);
             }
             i++;
             if (i == s->m)
@@ -142,15 +134,13 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
                 max_trial_index = i;
         if (trial[max_trial_index] >= limit)
         {
-            va_copy(arg, argtmp);
             trial[max_trial_index] = 0;
-            tmp = GenerateNewAgent(s, _ABC_);
+            tmp = BorrowNewAgent(s, _ABC_);
             CheckAgentLimits(s, tmp);
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for new created agent */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for new created agent */
             if (fitValue < s->a[max_trial_index]->fit)
             { /* We accept the new solution */
-                DestroyAgent(&(s->a[max_trial_index]), _ABC_);
-                s->a[max_trial_index] = CopyAgent(tmp, _ABC_, _NOTENSOR_);
+                CopyAgentInto(s->a[max_trial_index], tmp, _ABC_);
                 s->a[max_trial_index]->fit = fitValue;
             }
             if (fitValue < s->gfit)
@@ -159,33 +149,63 @@ void runABC(SearchSpace *s, prtFun Evaluate, ...)
                 for (j = 0; j < s->n; j++)
                     s->g[j] = tmp->x[j];
             }
-            DestroyAgent(&tmp, _ABC_);
+            ReturnAgent(s, &tmp);
         }
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _ABC_, e, t, s->gfit);
     }
 
     free(trial);
     free(prob);
-    va_end(arg);
 }
 
-/* It executes the Tensor-based Artificial Bee Colony for function minimization
+/* It executes the Artificial Bee Colony for function minimization
 Parameters:
 s: search space
 Evaluate: pointer to the function used to evaluate particles
 arg: list of additional arguments */
-void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runABC(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    ABC(s, &e);
+    PROFILE_END_RUN("ABC", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Artificial Bee Colony for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runABC_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    ABC(s, &e);
+    PROFILE_END_RUN("ABC", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Tensor-based Artificial Bee Colony with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorABC(SearchSpace *s, int tensor_id, Evaluator *e)
 {
-    va_list arg, argtmp;
     int i, j, k, l, t, chosen_param, neighbour, *trial, max_trial_index, limit;
     double max_fitness, r, fitValue, *prob;
     double **tmp_t = NULL;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runTensorABC.\n");
@@ -196,16 +216,13 @@ void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
     trial = (int *)calloc(s->m, sizeof(int));
     prob = (double *)calloc(s->m, sizeof(double));
 
-    EvaluateTensorSearchSpace(s, _ABC_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _ABC_, tensor_id, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         /* Employed Bee step */
         for (i = 0; i < s->m; i++)
         { /* For each food source */
-            va_copy(arg, argtmp);
 
             chosen_param = GenerateUniformRandomNumber(0, s->n - 1); /* Randomly parameter to be used */
             do
@@ -219,10 +236,9 @@ void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
             for (k = 0; k < tensor_id; k++)
                 tmp_t[chosen_param][k] = s->a[i]->t[chosen_param][k] + (s->a[i]->t[chosen_param][k] - s->a[neighbour]->t[chosen_param][k]) * r; /* We now update our currently solution */
             CheckTensorLimits(s, tmp_t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+            TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent tmp */
             if (fitValue < s->a[i]->fit)
             { /* We accept the new solution */
                 trial[i] = 0;
@@ -264,7 +280,6 @@ void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
             r = GenerateUniformRandomNumber(0, 1);
             if (r < prob[i])
             {
-                va_copy(arg, argtmp);
                 l++;
                 chosen_param = GenerateUniformRandomNumber(0, s->n - 1); /* Randomly parameter to be used */
                 do
@@ -277,10 +292,9 @@ void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 for (k = 0; k < tensor_id; k++)
                     tmp_t[chosen_param][k] = s->a[i]->t[chosen_param][k] + (s->a[i]->t[chosen_param][k] - s->a[neighbour]->t[chosen_param][k]) * r; /* We now update our currently solution */
                 CheckTensorLimits(s, tmp_t, tensor_id);
-                for (j = 0; j < s->n; j++)
-                    tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+                TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
 
-                fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
+                fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent tmp */
                 if (fitValue < s->a[i]->fit)
                 { /* We accept the new solution */
                     trial[i] = 0;
@@ -317,14 +331,12 @@ void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 max_trial_index = i;
         if (trial[max_trial_index] >= limit)
         {
-            va_copy(arg, argtmp);
             trial[max_trial_index] = 0;
             tmp = GenerateNewAgent(s, _ABC_);
             tmp_t = GenerateNewTensor(s, tensor_id);
             CheckTensorLimits(s, tmp_t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for new created agent */
+            TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for new created agent */
             if (fitValue < s->a[max_trial_index]->fit)
             { /* We accept the new solution */
                 DestroyTensor(&s->a[max_trial_index]->t, s->n);
@@ -345,11 +357,46 @@ void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
             DestroyTensor(&tmp_t, s->n);
         }
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _ABC_, e, t, s->gfit);
     }
 
     free(trial);
     free(prob);
+}
+
+/* It executes the Tensor-based Artificial Bee Colony for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runTensorABC(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorABC(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorABC", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Tensor-based Artificial Bee Colony for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorABC_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorABC(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorABC", &e);
+    DestroyEvaluator(&e);
+}
 /*************************/
\ No newline at end of file
@@ -1,19 +1,15 @@
 #include "abo.h"
+#include "telemetry.h"
+#include "profile.h"
 
-/* It executes the Artificial Butterfly Optimization for function minimization
+/* It executes the Artificial Butterfly Optimization with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate agents
-arg: list of additional arguments */
-void runABO(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void ABO(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j, k, sunspot = 0;
     double fitValue, rand, ratio = 0, step = 0, alpha = 0, D = 0;
-    Agent *tmp = NULL;
-
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
 
     if (!s)
     {
@@ -21,21 +17,19 @@ void runABO(SearchSpace *s, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _ABO_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _ABO_, e); /* Initial evaluation of the search space */
 
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all butterflies according to their fitness. First position gets the best sunspot. */
+    PROFILE_END(_PROFILE_SORT_);
 
     for(t = 1; t <= s->iterations; t++){
-        fprintf(stderr, "\nRunning iteration %d/%d ... \n", t, s->iterations);
-
         ratio = 0.9-(0.9-s->ratio_e)*(t/s->iterations);
         sunspot = (int)s->m*ratio;
         
         /* sunspot flight mode */
         for(i = 0; i < sunspot; i++){
 
-            va_copy(arg, argtmp);
-
             rand = round(GenerateUniformRandomNumber(-1, 1));
             k = round(GenerateUniformRandomNumber(0, sunspot - 1));
 
@@ -45,24 +39,16 @@ void runABO(SearchSpace *s, prtFun Evaluate, ...)
 
             CheckAgentLimits(s, s->a[i]);
 
-            tmp = CopyAgent(s->a[i], _ABO_, _NOTENSOR_);
-                
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, s->a[i]); /* It executes the fitness function for agent i at its new position */
             if(fitValue < s->a[i]->fit){ /* We accept the new solution */
-                DestroyAgent(&(s->a[i]), _ABO_);
-                s->a[i] = CopyAgent(tmp, _ABO_, _NOTENSOR_);
                 s->a[i]->fit = fitValue;
             }
-
-            DestroyAgent(&tmp, _ABO_);
         }
 
         /* canopy flight mode */
         step = 1-(1-s->step_e)*(t/s->iterations);
         for(i = sunspot; i < s->m; i++){
             
-            va_copy(arg, argtmp);
-
             rand = round(GenerateUniformRandomNumber(0, 1));
             k = round(GenerateUniformRandomNumber(0, sunspot - 1));
             for(j = 0; j < s->n; j++){
@@ -71,12 +57,8 @@ void runABO(SearchSpace *s, prtFun Evaluate, ...)
 
             CheckAgentLimits(s, s->a[i]);
 
-            tmp = CopyAgent(s->a[i], _ABO_, _NOTENSOR_);
-
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, s->a[i]); /* It executes the fitness function for agent i at its new position */
             if(fitValue < s->a[i]->fit){ /* We accept the new solution */
-                DestroyAgent(&(s->a[i]), _ABO_);
-                s->a[i] = CopyAgent(tmp, _ABO_, _NOTENSOR_);
                 s->a[i]->fit = fitValue;
             }else{
                 alpha = 2-(2-0.1)*(t/s->iterations);
@@ -88,13 +70,47 @@ void runABO(SearchSpace *s, prtFun Evaluate, ...)
                 }
             }
 
-            DestroyAgent(&tmp, _ABO_);
-
         }
 
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all butterflies according to their fitness. First position gets the best sunspot. */
+        PROFILE_END(_PROFILE_SORT_);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->a[0]->fit);
+        ReportIteration(s, _ABO_, e, t, s->a[0]->fit);
     }
+}
+
+/* It executes the Artificial Butterfly Optimization for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate agents
+arg: list of additional arguments */
+void runABO(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    ABO(s, &e);
+    PROFILE_END_RUN("ABO", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Artificial Butterfly Optimization for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runABO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    ABO(s, &e);
+    PROFILE_END_RUN("ABO", &e);
+    DestroyEvaluator(&e);
+}
@@ -14,6 +14,9 @@ limitations under the License.
 */
 
 #include "ba.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
 /* It updates the velocity of an agent (bat)
 Parameters:
@@ -27,10 +30,11 @@ void UpdateBatVelocity(SearchSpace *s, int i)
         exit(-1);
     }
 
+    double *x = s->a[i]->x, *v = s->a[i]->v, f = s->a[i]->f;
     int j;
 
     for (j = 0; j < s->n; j++)
-        s->a[i]->v[j] = s->a[i]->v[j] + (s->a[i]->x[j] - s->g[j]) * s->a[i]->f;
+        v[j] = v[j] + (x[j] - s->g[j]) * f;
 }
 
 /* It sets the frequency of an agent (bat)
@@ -49,21 +53,16 @@ void SetBatFrequency(SearchSpace *s, int i)
     s->a[i]->f = s->f_min + (s->f_min - s->f_max) * beta;
 }
 
-/* It executes the Bat Algorithm for function minimization
+/* It executes the Bat Algorithm with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runBA(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void BA(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j;
     double alpha = 0.9, beta, prob, fitValue;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runBA.\n");
@@ -77,23 +76,19 @@ void runBA(SearchSpace *s, prtFun Evaluate, ...)
         s->a[i]->A = GenerateUniformRandomNumber(0, s->A);
     }
 
-    EvaluateSearchSpace(s, _BA_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _BA_, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         /* for each bat */
         for (i = 0; i < s->m; i++)
         {
-            va_copy(arg, argtmp);
-
             SetBatFrequency(s, i);   /* Equation 1 */
             UpdateBatVelocity(s, i); /* Equation 2 */
 
             /* Equation 3
             Here, we generate a temporary agent (bat) */
-            tmp = CopyAgent(s->a[i], _BA_, _NOTENSOR_);
+            tmp = BorrowAgentCopy(s, s->a[i], _BA_);
             for (j = 0; j < s->n; j++)
                 tmp->x[j] = tmp->x[j] + tmp->v[j];
             /**************/
@@ -101,17 +96,16 @@ void runBA(SearchSpace *s, prtFun Evaluate, ...)
             prob = GenerateUniformRandomNumber(0, 1);
             if (prob > s->a[i]->r)
             {
-                DestroyAgent(&tmp, _BA_);
-                tmp = GenerateNewAgent(s, _BA_);
+                ReturnAgent(s, &tmp);
+                tmp = BorrowNewAgent(s, _BA_);
             }
             CheckAgentLimits(s, tmp);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
             prob = GenerateUniformRandomNumber(0, 1);
             if ((fitValue < s->a[i]->fit) && (prob < s->a[i]->A))
             { /* We accept the new solution */
-                DestroyAgent(&(s->a[i]), _BA_);
-                s->a[i] = CopyAgent(tmp, _BA_, _NOTENSOR_);
+                CopyAgentInto(s->a[i], tmp, _BA_);
                 s->a[i]->fit = fitValue;
                 s->a[i]->r = s->r * (1 - exp(-alpha * t));
                 s->a[i]->A = s->A * alpha;
@@ -124,14 +118,47 @@ void runBA(SearchSpace *s, prtFun Evaluate, ...)
                     s->g[j] = tmp->x[j];
             }
 
-            DestroyAgent(&tmp, _BA_);
+            ReturnAgent(s, &tmp);
         }
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _BA_, e, t, s->gfit);
     }
+}
 
+/* It executes the Bat Algorithm for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runBA(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    BA(s, &e);
+    PROFILE_END_RUN("BA", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Bat Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runBA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    BA(s, &e);
+    PROFILE_END_RUN("BA", &e);
+    DestroyEvaluator(&e);
+}
 /*************************/
 
 /* It updates the velocity of an tensor (bat)
@@ -193,23 +220,18 @@ double **GenerateNewBatTensor(SearchSpace *s, int tensor_id)
     return t;
 }
 
-/* It executes the Tensor-based Bat Algorithm for function minimization
+/* It executes the Tensor-based Bat Algorithm with a given fitness evaluator
 Parameters:
 s: search space
 tensor_id: identifier of tensor's dimension
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runTensorBA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void TensorBA(SearchSpace *s, int tensor_id, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j, k;
     double alpha = 0.9, beta, prob, fitValue;
     double **tmp_t = NULL, **tmp_t_v = NULL;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runTensorBA.\n");
@@ -223,17 +245,13 @@ void runTensorBA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         s->a[i]->A = GenerateUniformRandomNumber(0, s->A);
     }
 
-    EvaluateTensorSearchSpace(s, _BA_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _BA_, tensor_id, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         /* for each bat */
         for (i = 0; i < s->m; i++)
         {
-            va_copy(arg, argtmp);
-
             SetTensorBatFrequency(s, i);              /* Equation 1 */
             UpdateTensorBatVelocity(s, i, tensor_id); /* Equation 2 */
 
@@ -256,10 +274,9 @@ void runTensorBA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 tmp_t = GenerateNewBatTensor(s, tensor_id);
             }
             CheckTensorLimits(s, tmp_t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+            TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
             prob = GenerateUniformRandomNumber(0, 1);
             if ((fitValue < s->a[i]->fit) && (prob < s->a[i]->A))
             { /* We accept the new solution */
@@ -288,9 +305,44 @@ void runTensorBA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
             DestroyTensor(&tmp_t_v, s->n);
         }
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _BA_, e, t, s->gfit);
     }
+}
+
+/* It executes the Tensor-based Bat Algorithm for function minimization
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runTensorBA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
 
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorBA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorBA", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Tensor-based Bat Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorBA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorBA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorBA", &e);
+    DestroyEvaluator(&e);
+}
 /*************************/
\ No newline at end of file
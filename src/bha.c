@@ -14,50 +14,48 @@ limitations under the License.
 */
 
 #include "bha.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
-/* It executes the Black Hole Algorithm for function minimization
+/* It executes the Black Hole Algorithm with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate agents
-arg: list of additional arguments */
-void runBHA(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void BHA(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j;
-    double fitValue, sum, rand, dist, radius;
+    double fitValue, sum, rand, radius;
+    double *dist = NULL, **X = NULL;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runBHA.\n");
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _BHA_, Evaluate, arg); /* Initial evaluation of the search space */
+    dist = (double *)malloc(s->m * sizeof(double));
+    X = (double **)malloc(s->m * sizeof(double *));
+
+    EvaluateSearchSpaceWith(s, _BHA_, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         sum = 0;
 
         /* Changing the position of each star according to Equation 3 */
         for (i = 0; i < s->m; i++)
         {
-            va_copy(arg, argtmp);
-
             rand = GenerateUniformRandomNumber(0, 1);
 
             for (j = 0; j < s->n; j++)
                 s->a[i]->x[j] += rand * (s->g[j] - s->a[i]->x[j]);
 
             CheckAgentLimits(s, s->a[i]);
-            s->a[i]->fit = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+            s->a[i]->fit = ComputeFitness(e, s->a[i]); /* It executes the fitness function for agent i */
 
-            tmp = CopyAgent(s->a[i], _BHA_, _NOTENSOR_);
+            tmp = BorrowAgentCopy(s, s->a[i], _BHA_);
             if (s->a[i]->fit < s->gfit)
             {
                 fitValue = s->gfit;
@@ -70,66 +68,91 @@ void runBHA(SearchSpace *s, prtFun Evaluate, ...)
                     s->a[i]->x[j] = tmp->x[j];
                 }
             }
-            DestroyAgent(&tmp, _BHA_);
+            ReturnAgent(s, &tmp);
             sum = sum + s->a[i]->fit;
         }
 
-        va_copy(arg, argtmp);
-
         /* Event Horizon and evaluating the solutions */
         radius = s->gfit / sum;
+        for (i = 0; i < s->m; i++)
+            X[i] = s->a[i]->x;
+        EuclideanDistances(s->g, X, s->m, s->n, dist); /* It obtains the euclidean distances of all stars at once */
         for (i = 0; i < s->m; i++)
         {
-            dist = EuclideanDistance(s->g, s->a[i]->x, s->n); /* It obtains the euclidean distance */
-            if (dist < radius)
-            {
-                DestroyAgent(&(s->a[i]), _BHA_);
-                s->a[i] = GenerateNewAgent(s, _BHA_);
-            }
+            if (dist[i] < radius)
+                ResetAgent(s->a[i]); /* the star is replaced by a new one */
         }
 
-        EvaluateSearchSpace(s, _BHA_, Evaluate, arg);
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        EvaluateSearchSpaceWith(s, _BHA_, e);
+        ReportIteration(s, _BHA_, e, t, s->gfit);
     }
-    va_end(arg);
+
+    free(dist);
+    free(X);
 }
 
-/* It executes the Tensor-based Black Hole Algorithm for function minimization
+/* It executes the Black Hole Algorithm for function minimization
 Parameters:
 s: search space
-tensor_id: identifier of tensor's dimension
 Evaluate: pointer to the function used to evaluate agents
 arg: list of additional arguments */
-void runTensorBHA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runBHA(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    BHA(s, &e);
+    PROFILE_END_RUN("BHA", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Black Hole Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runBHA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    BHA(s, &e);
+    PROFILE_END_RUN("BHA", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Tensor-based Black Hole Algorithm with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorBHA(SearchSpace *s, int tensor_id, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j, k;
     double fitValue, sum, rand, dist, radius;
     double **tmp_t = NULL;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runTensorBHA.\n");
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _BHA_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _BHA_, tensor_id, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         sum = 0;
 
         /* Changing the position of each star according to Equation 3 */
         for (i = 0; i < s->m; i++)
         {
-            va_copy(arg, argtmp);
-
             rand = GenerateUniformRandomNumber(0, 1);
 
             for (j = 0; j < s->n; j++)
@@ -137,9 +160,8 @@ void runTensorBHA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                     s->a[i]->t[j][k] += rand * (s->t_g[j][k] - s->a[i]->t[j][k]);
 
             CheckTensorLimits(s, s->a[i]->t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                s->a[i]->x[j] = TensorSpan(s->LB[j], s->UB[j], s->a[i]->t[j], tensor_id);
-            s->a[i]->fit = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+            TensorSpans(s->LB, s->UB, s->a[i]->t[0], s->n, tensor_id, s->a[i]->x);
+            s->a[i]->fit = ComputeFitness(e, s->a[i]); /* It executes the fitness function for agent i */
 
             tmp = CopyAgent(s->a[i], _BHA_, _NOTENSOR_);
             tmp_t = CopyTensor(s->a[i]->t, s->n, tensor_id);
@@ -164,8 +186,6 @@ void runTensorBHA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
             sum = sum + s->a[i]->fit;
         }
 
-        va_copy(arg, argtmp);
-
         /* Event Horizon and evaluating the solutions */
         radius = s->gfit / sum;
         for (i = 0; i < s->m; i++)
@@ -180,8 +200,44 @@ void runTensorBHA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
             }
         }
 
-        EvaluateTensorSearchSpace(s, _BHA_, tensor_id, Evaluate, arg);
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        EvaluateTensorSearchSpaceWith(s, _BHA_, tensor_id, e);
+        ReportIteration(s, _BHA_, e, t, s->gfit);
     }
+}
+
+/* It executes the Tensor-based Black Hole Algorithm for function minimization
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate agents
+arg: list of additional arguments */
+void runTensorBHA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorBHA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorBHA", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
+}
+
+/* It executes the Tensor-based Black Hole Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorBHA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorBHA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorBHA", &e);
+    DestroyEvaluator(&e);
 }
\ No newline at end of file
@@ -14,61 +14,206 @@ limitations under the License.
 */
 
 #include "bsa.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
-/* It executes the Backtracking Search Optimization Algorithm for function minimization
+/* It allocates a contiguous m x n matrix, whose rows are given by an array of pointers
+Parameters:
+m: number of rows
+n: number of columns */
+static double **CreateBSAMatrix(int m, int n)
+{
+	double **M = NULL;
+	int i;
+
+	M = (double **)malloc(m * sizeof(double *));
+	M[0] = (double *)calloc(m * n, sizeof(double));
+	for (i = 1; i < m; i++)
+		M[i] = M[0] + i * n;
+
+	return M;
+}
+
+/* It deallocates a matrix allocated by CreateBSAMatrix
+Parameters:
+M: address of the matrix */
+static void DestroyBSAMatrix(double ***M)
+{
+	free((*M)[0]);
+	free(*M);
+	*M = NULL;
+}
+
+/* It allocates m contiguous n x tensor_id tensors
+Parameters:
+m: number of tensors
+n: number of decision variables
+tensor_id: identifier of tensor's dimension */
+static double ***CreateBSATensors(int m, int n, int tensor_id)
+{
+	double ***T = NULL, **rows = NULL, *block = NULL;
+	int i, j;
+
+	T = (double ***)malloc(m * sizeof(double **));
+	rows = (double **)malloc(m * n * sizeof(double *));
+	block = (double *)calloc(m * n * tensor_id, sizeof(double));
+	for (i = 0; i < m; i++)
+	{
+		T[i] = rows + i * n;
+		for (j = 0; j < n; j++)
+			T[i][j] = block + (i * n + j) * tensor_id;
+	}
+
+	return T;
+}
+
+/* It deallocates tensors allocated by CreateBSATensors
+Parameters:
+T: address of the tensors */
+static void DestroyBSATensors(double ****T)
+{
+	free((*T)[0][0]);
+	free((*T)[0]);
+	free(*T);
+	*T = NULL;
+}
+
+/* It draws the map of the cross over strategy, i.e., Map[i][j] is 0 if the j-th decision variable of the i-th trial individual comes from the mutation, and 1 otherwise
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate nests
-arg: list of additional arguments */
-void runBSA(SearchSpace *s, prtFun Evaluate, ...)
+Map: m x n matrix */
+static void DrawBSAMap(SearchSpace *s, double **Map)
+{
+	int i, j, u, MaxU, randi;
+
+	InitializeMap(s, Map);
+
+	/* number of permutations */
+	if (GenerateUniformRandomNumber(0.0, 1.0) < GenerateUniformRandomNumber(0.0, 1.0))
+	{
+		MaxU = ceil(s->mix_rate * s->n * GenerateUniformRandomNumber(0.0, 1.0));
+		for (i = 0; i < s->m; i++)
+			for (j = 1; j <= MaxU; j++)
+			{
+				u = (int)GenerateUniformRandomNumber(0, s->n);
+				Map[i][u] = 0;
+			}
+	}
+	else
+	{
+		for (i = 0; i < s->m; i++)
+		{
+			randi = (int)GenerateUniformRandomNumber(0, s->n);
+			Map[i][randi] = 0;
+		}
+	}
+}
+
+/* It redraws the decision variables of the trial vectors that are out of bounds (see BoundaryControlMechanism)
+Parameters:
+s: search space, whose trial vectors hold the trial population */
+static void BoundaryControlOfTrialVectors(SearchSpace *s)
+{
+	double *x = NULL;
+	int i, j;
+
+	for (i = 0; i < s->m; i++)
+	{
+		x = GetTrialVector(s, i);
+		for (j = 0; j < s->n; j++)
+		{
+			if ((x[j] < s->LB[j]) || (x[j] > s->UB[j]))
+				x[j] = ((s->UB[j] - s->LB[j]) * GenerateUniformRandomNumber(0, 1)) + s->LB[j];
+		}
+	}
+}
+
+/* It replaces each individual by its trial individual whenever the latter is better (selection - II)
+ * The trial individuals are held by the trial vectors of the search space. They are swapped into the population and evaluated at once,
+ * and the rejected ones are swapped back.
+Parameters:
+s: search space
+e: fitness evaluator
+fit: auxiliary array of m fitness values
+accepted: output array of m flags, accepted[i] is 1 if the i-th trial individual replaced the i-th individual (it may be NULL) */
+static void SelectTrialVectors(SearchSpace *s, Evaluator *e, double *fit, char *accepted)
+{
+	int i, j;
+
+	for (i = 0; i < s->m; i++)
+		SwapTrialVector(s, s->a[i], i);
+	EvaluateAgents(s, s->a, s->m, e, fit);
+
+	for (i = 0; i < s->m; i++)
+	{
+		if (fit[i] < s->a[i]->fit)
+		{ /* the trial individual is accepted */
+			s->a[i]->fit = fit[i];
+			if (accepted)
+				accepted[i] = 1;
+		}
+		else
+		{
+			SwapTrialVector(s, s->a[i], i);
+			if (accepted)
+				accepted[i] = 0;
+		}
+
+		if (s->a[i]->fit < s->gfit)
+		{ /* It updates the global best value and position */
+			s->best = i;
+			s->gfit = s->a[i]->fit;
+			for (j = 0; j < s->n; j++)
+				s->g[j] = s->a[i]->x[j];
+		}
+	}
+}
+
+/* It executes the Backtracking Search Optimization Algorithm with a given fitness evaluator
+ * The historical population (oldS), the trial population (the trial vectors of s) and the Map/Mutation matrices are allocated once,
+ * and the selection swaps the positions of the individuals and of their trial individuals instead of copying them.
+Parameters:
+s: search space
+e: fitness evaluator */
+static void BSA(SearchSpace *s, Evaluator *e)
 {
 	/*Initialization*/
-    va_list arg, argtmp;
-    int t, i, j;
-	SearchSpace *T = NULL;
-	SearchSpace *oldS = CreateSearchSpace(s->m, s->n, _BSA_);
+	int t, i, j;
+	double *fit = NULL, *x = NULL;
+	SearchSpace *oldS = NULL;
+	double **Mutation = NULL;
+	double **Map = NULL; /* Matrix representing values to be permuted */
 
-	double** Mutation = NULL;
-	double** Map = NULL; /* Matrix representing values to be permuted */
-    Mutation = (double **)calloc(s->m, sizeof(double *));
-	Map = (double **)calloc(s->m, sizeof(double *));
-    for (i = 0; i < s->m; i++)
+	if (!s)
 	{
-        Mutation[i] = (double *)calloc(s->n, sizeof(double));
-		Map[i] = (double *)calloc(s->n, sizeof(double));
+		fprintf(stderr, "\nSearch space not allocated @runBSA.\n");
+		exit(-1);
 	}
-	for (j=0;j<s->n;j++)
+
+	oldS = CreateSearchSpace(s->m, s->n, _BSA_);
+	if (!oldS)
+	{
+		fprintf(stderr, "\nSearch space not allocated @runBSA.\n");
+		exit(-1);
+	}
+	for (j = 0; j < s->n; j++)
 	{
 		oldS->LB[j] = s->LB[j];
 		oldS->UB[j] = s->UB[j];
 	}
-	
 	InitializeSearchSpace(oldS, _BSA_);
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+	Mutation = CreateBSAMatrix(s->m, s->n);
+	Map = CreateBSAMatrix(s->m, s->n);
+	fit = (double *)malloc(s->m * sizeof(double));
 
-    if (!s)
-    {
-        fprintf(stderr, "\nSearch space not allocated @runBSA.\n");
-        exit(-1);
-    }
-
-    if (!oldS)
-    {
-        fprintf(stderr, "\nSearch space not allocated @runBSA.\n");
-        exit(-1);
-    }
-
-    EvaluateSearchSpace(s, _BSA_, Evaluate, arg); /* Initial evaluation of the search space */
-
-    for (t = 1; t <= s->iterations; t++)
-    {
-		fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-		va_copy(arg, argtmp);
+	EvaluateSearchSpaceWith(s, _BSA_, e); /* Initial evaluation of the search space */
 
+	for (t = 1; t <= s->iterations; t++)
+	{
 		/* SELECTION - I */
-		if(GenerateUniformRandomNumber(0.0, 1.0)<GenerateUniformRandomNumber(0.0, 1.0))
+		if (GenerateUniformRandomNumber(0.0, 1.0) < GenerateUniformRandomNumber(0.0, 1.0))
 			CopySearchSpaceAgents(s, oldS, _BSA_, _NOTENSOR_);
 		Permutation(oldS, _BSA_, _NOTENSOR_);
 
@@ -76,44 +221,62 @@ void runBSA(SearchSpace *s, prtFun Evaluate, ...)
 		/** MUTATION */
 		InitializeMutation(s, oldS, Mutation);
 
-		/** CROSS OVER */			
-		T = CrossOverStrategyOfBSA(s, Map, Mutation); /* Trial-population */
-		BoundaryControlMechanism(s, T);
-
-		/* SELECTION - II */
-		EvaluateSearchSpace(T, _BSA_, Evaluate, arg);
+		/** CROSS OVER */
+		DrawBSAMap(s, Map);
 		for (i = 0; i < s->m; i++)
 		{
-			if ( T->a[i]->fit <s->a[i]->fit)
-			{
-		        DestroyAgent(&(s->a[i]), _BSA_);
-		        s->a[i] = CopyAgent(T->a[i], _BSA_, _NOTENSOR_);
-		        s->a[i]->fit = T->a[i]->fit;
-			}
-
-            if (s->a[i]->fit < s->gfit)
-            { /* It updates the global best value and position */
-                s->best = i;
-                s->gfit = s->a[i]->fit;
-                for (j = 0; j < s->n; j++)
-                    s->g[j] = s->a[i]->x[j];
-            }
+			x = GetTrialVector(s, i); /* Trial-population */
+			for (j = 0; j < s->n; j++)
+				x[j] = Map[i][j] ? s->a[i]->x[j] : Mutation[i][j];
 		}
+		BoundaryControlOfTrialVectors(s);
 
-		DestroySearchSpace(&T, _BSA_);
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
-    }
-
+		/* SELECTION - II */
+		SelectTrialVectors(s, e, fit, NULL);
 
-    for (i = 0; i < s->m; i++)
-	{
-        free(Mutation[i]);
-		free(Map[i]);
+		ReportIteration(s, _BSA_, e, t, s->gfit);
 	}
-    free(Mutation);
-	free(Map);
+
+	RestoreAgentBlocks(s);
+	DestroyBSAMatrix(&Mutation);
+	DestroyBSAMatrix(&Map);
+	free(fit);
 	DestroySearchSpace(&oldS, _BSA_);
-    va_end(arg);
+}
+
+/* It executes the Backtracking Search Optimization Algorithm for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate nests
+arg: list of additional arguments */
+void runBSA(SearchSpace *s, prtFun Evaluate, ...)
+{
+	va_list arg;
+	Evaluator e;
+
+	va_start(arg, Evaluate);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	BSA(s, &e);
+	PROFILE_END_RUN("BSA", &e);
+	DestroyEvaluator(&e);
+	va_end(arg);
+}
+
+/* It executes the Backtracking Search Optimization Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runBSA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+	Evaluator e;
+
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	BSA(s, &e);
+	PROFILE_END_RUN("BSA", &e);
+	DestroyEvaluator(&e);
 }
 
 void BoundaryControlMechanism(SearchSpace *s, SearchSpace *T)
@@ -138,7 +301,7 @@ void BoundaryControlMechanism(SearchSpace *s, SearchSpace *T)
 		{
 			if ((T->a[i]->x[j] < s->LB[j]) || (T->a[i]->x[j] > s->UB[j]))
 			{
-				T->a[i]->x[j] = ( (s->UB[j] - s->LB[j]) * ((double)rand() / RAND_MAX)) + s->LB[j] ;
+				T->a[i]->x[j] = ( (s->UB[j] - s->LB[j]) * GenerateUniformRandomNumber(0, 1)) + s->LB[j] ;
 			}
 		}
 	}
@@ -206,7 +369,7 @@ void InitializeMap(SearchSpace *s, double** Map)
 
 SearchSpace *CrossOverStrategyOfBSA(SearchSpace *s, double** Map, double** Mutation)
 {
-	int i,j, u, MaxU, randi;
+	int i, j;
 	SearchSpace *T = NULL;
 
     if (!s)
@@ -216,28 +379,8 @@ SearchSpace *CrossOverStrategyOfBSA(SearchSpace *s, double** Map, double** Mutat
     }
 
 
-	InitializeMap(s, Map);
+	DrawBSAMap(s, Map);
 
-	/* number of permutations */
-	if(GenerateUniformRandomNumber(0.0, 1.0)<GenerateUniformRandomNumber(0.0, 1.0))
-	{
-		MaxU = ceil(s->mix_rate * s->n * GenerateUniformRandomNumber(0.0, 1.0));
-		for (i = 0; i < s->m; i++)			
-			for (j = 1; j <= MaxU; j++)
-			{
-				u = rand() % s->n;
-				Map[i][u] = 0;
-			}
-	}
-	else
-	{		
-		for (i = 0; i < s->m; i++)
-		{
-			randi = rand() % s->n;
-			Map[i][randi] = 0;
-		}
-	}
-    
 	T = CreateSearchSpace(s->m, s->n, _BSA_);
 	for (j=0;j<s->n;j++)
 	{
@@ -266,7 +409,7 @@ SearchSpace *CrossOverStrategyOfBSA(SearchSpace *s, double** Map, double** Mutat
 
 SearchSpace *CrossOverTensorStrategyOfBSA(SearchSpace *s, double** Map, double*** Mutation, int tensor_id)
 {
-	int i,j, k, u, MaxU, MaxTU, randi;
+	int i, j, k;
 	SearchSpace *T = NULL;
 
     if (!s)
@@ -276,30 +419,8 @@ SearchSpace *CrossOverTensorStrategyOfBSA(SearchSpace *s, double** Map, double**
     }
 
 
-	InitializeMap(s, Map);
+	DrawBSAMap(s, Map);
 
-	/* number of permutations */
-	if(GenerateUniformRandomNumber(0.0, 1.0)<GenerateUniformRandomNumber(0.0, 1.0))
-	{
-		MaxU = ceil(s->mix_rate * s->n * GenerateUniformRandomNumber(0.0, 1.0));
-		for (i = 0; i < s->m; i++)	
-		{		
-			for (j = 1; j <= MaxU; j++)
-			{
-				u = rand() % s->n;
-				Map[i][u] = 0;
-			}
-		}
-	}
-	else
-	{		
-		for (i = 0; i < s->m; i++)
-		{
-			randi = rand() % s->n;
-			Map[i][randi] = 0;
-		}
-	}
-    
 	T = CreateSearchSpace(s->m, s->n, _BSA_);
 
 	for (j=0;j < T->n; j++)
@@ -330,148 +451,158 @@ SearchSpace *CrossOverTensorStrategyOfBSA(SearchSpace *s, double** Map, double**
 }
 
 
-/* It executes the Tensor-based Backtracking Search Optimization Algorithm for function minimization
+/* It executes the tensor-based Backtracking Search Optimization Algorithm with a given fitness evaluator
+ * As in BSA, the populations and matrices are allocated once. The tensors of the trial individuals are kept apart, and they are swapped
+ * with the tensors of the individuals they replace.
 Parameters:
 s: search space
 tensor_id: identifier of tensor's dimension
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runTensorBSA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void TensorBSA(SearchSpace *s, int tensor_id, Evaluator *e)
 {
 	/*Initialization*/
-    va_list arg, argtmp;
-    int t, i, j, k;
-	SearchSpace *T = NULL;
-	SearchSpace *oldS = CreateSearchSpace(s->m, s->n, _BSA_);
+	int t, i, j, k;
+	double *fit = NULL, *x = NULL, **aux = NULL, ***trial_t = NULL, gfit;
+	char *accepted = NULL;
+	SearchSpace *oldS = NULL;
+	double ***Mutation = NULL;
+	double **Map = NULL; /* Matrix representing values to be permuted */
+
+	if (!s)
+	{
+		fprintf(stderr, "\nSearch space not allocated @runTensorBSA.\n");
+		exit(-1);
+	}
 
-	double*** Mutation = NULL;
-	double** Map = NULL; /* Matrix representing values to be permuted */
-    Mutation = (double ***)calloc(s->m, sizeof(double **));
-	Map = (double **)calloc(s->m, sizeof(double *));
-    for (i = 0; i < s->m; i++)
+	oldS = CreateSearchSpace(s->m, s->n, _BSA_);
+	if (!oldS)
 	{
-        Mutation[i] = (double **)calloc(s->n, sizeof(double *));
-		Map[i] = (double *)calloc(s->n, sizeof(double));
-		for (j = 0; j < s->n; j++)
-		    Mutation[i][j] = (double *)calloc(tensor_id, sizeof(double ));
+		fprintf(stderr, "\nSearch space not allocated @runTensorBSA.\n");
+		exit(-1);
 	}
-	for (j=0;j<s->n;j++)
+	for (j = 0; j < s->n; j++)
 	{
 		oldS->LB[j] = s->LB[j];
 		oldS->UB[j] = s->UB[j];
-	}	
-
-    oldS->t_g = CreateTensor(oldS->n, tensor_id);
-    for (i = 0; i < oldS->m; i++)
-        oldS->a[i]->t = CreateTensor(oldS->n, tensor_id); /* It allocates a new tensor for each agent */
-
-    InitializeTensorSearchSpace(oldS, tensor_id); /* It initalizes the search space with tensors */
+	}
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+	oldS->t_g = CreateTensor(oldS->n, tensor_id);
+	for (i = 0; i < oldS->m; i++)
+		oldS->a[i]->t = CreateTensor(oldS->n, tensor_id); /* It allocates a new tensor for each agent */
 
-    if (!s)
-    {
-        fprintf(stderr, "\nSearch space not allocated @runTensorBSA.\n");
-        exit(-1);
-    }
+	InitializeTensorSearchSpace(oldS, tensor_id); /* It initalizes the search space with tensors */
 
-    if (!oldS)
-    {
-
-        fprintf(stderr, "\nSearch space not allocated @runTensorBSA.\n");
-        exit(-1);
-    }
+	Mutation = CreateBSATensors(s->m, s->n, tensor_id);
+	Map = CreateBSAMatrix(s->m, s->n);
+	trial_t = (double ***)malloc(s->m * sizeof(double **));
+	for (i = 0; i < s->m; i++)
+		trial_t[i] = CreateTensor(s->n, tensor_id);
+	fit = (double *)malloc(s->m * sizeof(double));
+	accepted = (char *)malloc(s->m * sizeof(char));
 
 	for (i = 0; i < s->m; i++)
 	{
-	    CheckTensorLimits(s, s->a[i]->t, tensor_id);
-	    for (j = 0; j < s->n; j++)
-	        s->a[i]->x[j] = TensorSpan(s->LB[j], s->UB[j], s->a[i]->t[j], tensor_id);
+		CheckTensorLimits(s, s->a[i]->t, tensor_id);
 	}
 
-    EvaluateTensorSearchSpace(s, _BSA_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
-
-    for (t = 1; t <= s->iterations; t++)
-    {
-		fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-		va_copy(arg, argtmp);
+	EvaluateTensorSearchSpaceWith(s, _BSA_, tensor_id, e); /* Initial evaluation of the search space */
 
+	for (t = 1; t <= s->iterations; t++)
+	{
 		/* SELECTION - I */
-		if(GenerateUniformRandomNumber(0.0, 1.0)<GenerateUniformRandomNumber(0.0, 1.0))
+		if (GenerateUniformRandomNumber(0.0, 1.0) < GenerateUniformRandomNumber(0.0, 1.0))
 			CopySearchSpaceAgents(s, oldS, _BSA_, tensor_id);
-
-
 		TensorPermutation(oldS, _BSA_, tensor_id);
+
 		/* GENERATION OF TRIAL POPULATION */
 		/** MUTATION */
 		InitializeTensorMutation(s, oldS, Mutation, tensor_id);
 
-		/** CROSS OVER */			
-		T = CrossOverTensorStrategyOfBSA(s, Map, Mutation, tensor_id); /* Trial-population */
-
-
-		for (i = 0; i < T->m; i++)
+		/** CROSS OVER */
+		DrawBSAMap(s, Map);
+		for (i = 0; i < s->m; i++)
 		{
-		    CheckTensorLimits(T, T->a[i]->t, tensor_id);
-		    for (j = 0; j < T->n; j++)
-		        T->a[i]->x[j] = TensorSpan(T->LB[j], T->UB[j], T->a[i]->t[j], tensor_id);
+			for (j = 0; j < s->n; j++)
+				for (k = 0; k < tensor_id; k++)
+					trial_t[i][j][k] = Map[i][j] ? s->a[i]->t[j][k] : Mutation[i][j][k];
+
+			CheckTensorLimits(s, trial_t[i], tensor_id);
+			x = GetTrialVector(s, i); /* Trial-population */
+			TensorSpans(s->LB, s->UB, trial_t[i][0], s->n, tensor_id, x);
 		}
-		BoundaryControlMechanism(s, T);
+		BoundaryControlOfTrialVectors(s);
 
 		/* SELECTION - II */
-		EvaluateTensorSearchSpace(T, _BSA_, tensor_id, Evaluate, arg);
+		gfit = s->gfit;
+		SelectTrialVectors(s, e, fit, accepted);
 		for (i = 0; i < s->m; i++)
 		{
-			if ( T->a[i]->fit <s->a[i]->fit)
-			{
-				DestroyTensor(&(s->a[i]->t), s->n);
-		        DestroyAgent(&(s->a[i]), _BSA_);
-		        s->a[i] = CopyAgent(T->a[i], _BSA_, tensor_id);
-				s->a[i]->t = CopyTensor(T->a[i]->t, s->n, tensor_id);
+			if (accepted[i])
+			{ /* the tensor goes along with the position */
+				aux = s->a[i]->t;
+				s->a[i]->t = trial_t[i];
+				trial_t[i] = aux;
 			}
-
-            if (s->a[i]->fit < s->gfit)
-            {
-                s->best = i;
-                s->gfit = s->a[i]->fit;
-                for (j = 0; j < s->n; j++)
-				{
-                    s->g[j] = s->a[i]->x[j];
-                    for (k = 0; k < tensor_id; k++)
-                        s->t_g[j][k] = s->a[i]->t[j][k];
-				}
-            }
 		}
-
-
-
-		DestroyTensor(&(T->t_g), T->n);
-		for (i = 0; i < T->m; i++)
-		    DestroyTensor(&(T->a[i]->t), T->n);  
-
-		DestroySearchSpace(&T, _BSA_);  
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
-
-    }
-
-
-    for (i = 0; i < s->m; i++)
-	{
-		for (j = 0; j < s->n; j++)
+		if (s->gfit < gfit)
 		{
-		    free(Mutation[i][j]);
+			for (j = 0; j < s->n; j++)
+				for (k = 0; k < tensor_id; k++)
+					s->t_g[j][k] = s->a[s->best]->t[j][k];
 		}
-	    free(Mutation[i]);
-		free(Map[i]);
+
+		ReportIteration(s, _BSA_, e, t, s->gfit);
 	}
-    free(Mutation);
-	free(Map);
+
+	RestoreAgentBlocks(s);
+	DestroyBSATensors(&Mutation);
+	DestroyBSAMatrix(&Map);
+	for (i = 0; i < s->m; i++)
+		DestroyTensor(&trial_t[i], s->n);
+	free(trial_t);
+	free(fit);
+	free(accepted);
 	DestroyTensor(&oldS->t_g, oldS->n);
 	for (i = 0; i < oldS->m; i++)
-	    DestroyTensor(&oldS->a[i]->t, oldS->n); /* It deallocates the tensor for each agent */
+		DestroyTensor(&oldS->a[i]->t, oldS->n); /* It deallocates the tensor for each agent */
 
 	DestroySearchSpace(&oldS, _BSA_); /* It deallocates the search space */
-    va_end(arg);
+}
+
+/* It executes the Tensor-based Backtracking Search Optimization Algorithm for function minimization
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runTensorBSA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+	va_list arg;
+	Evaluator e;
+
+	va_start(arg, Evaluate);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	TensorBSA(s, tensor_id, &e);
+	PROFILE_END_RUN("TensorBSA", &e);
+	DestroyEvaluator(&e);
+	va_end(arg);
+}
+
+/* It executes the tensor-based Backtracking Search Optimization Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorBSA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+	Evaluator e;
+
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	TensorBSA(s, tensor_id, &e);
+	PROFILE_END_RUN("TensorBSA", &e);
+	DestroyEvaluator(&e);
 }
 
@@ -14,162 +14,72 @@ limitations under the License.
 */
 
 #include "bso.h"
+#include "telemetry.h"
+#include "profile.h"
 #include "function.h"
+#include "cluster.h"
 
 /* BSO-related functions */
 
 /* It clusters the agents and returns a pointer with the best agent's ID per cluster.
 Parameters:
 s: search space
-best_ideas: pointer to the ids of the best ideas per cluster (k-sized array)
-ideas_per_cluster: pointer to the ids of the ideas per cluster (k x (Y_i)+1-sized array)
-where Y_i stands for the number of ideas in cluster i. Notice we have one more column (the first one)
-that stores the number of ideas that belongs to cluster i. */
-void k_means(SearchSpace *s, int *best_ideas, int ***ideas_per_cluster)
+km: k-means engine (s->k clusters of s->n-dimensional points, room for s->m points), which keeps the centers from one call to the next
+X: array with room for s->m pointers, used to gather the positions of the ideas
+best_fitness_cluster: array with room for s->k fitness values, used to find the best idea per cluster
+best_ideas: pointer to the ids of the best ideas per cluster (k-sized array). The best idea of an empty cluster is the best one of the whole population.
+ideas_per_cluster: pointer to the ids of the ideas per cluster (k x (m+1)-sized array). Notice we have one more column (the first one)
+that stores the number of ideas that belongs to cluster i, and the ids of these ideas follow it. */
+void k_means(SearchSpace *s, KMeans *km, double **X, double *best_fitness_cluster, int *best_ideas, int **ideas_per_cluster)
 {
-	int *nearest = NULL, *ctr = NULL, i, j, r;
-	char *is_chosen = NULL, OK;
-	double **center = NULL, old_error, error = DBL_MAX, min_distance, distance;
-	double **center_mean = NULL, *best_fitness_cluster = NULL;
+	int i, c, best = 0;
 
-	if ((!s) || (!best_ideas) || (!ideas_per_cluster))
+	if ((!s) || (!km) || (!X) || (!best_fitness_cluster) || (!best_ideas) || (!ideas_per_cluster))
 	{
 		fprintf(stderr, "\nSearch space and/or input arrays not allocated @k_means.\n");
 		exit(-1);
 	}
 
-	best_fitness_cluster = (double *)malloc(s->k * sizeof(double));
-	nearest = (int *)malloc(s->m * sizeof(int));
-	ctr = (int *)calloc(s->k, sizeof(int));
-	center = (double **)malloc(s->k * sizeof(double *));
-	center_mean = (double **)malloc(s->k * sizeof(double *));
-	is_chosen = (char *)calloc(s->m, sizeof(char));
-
-	/* initializing k centers with samples choosen at random */
-	for (i = 0; i < s->k; i++)
+	for (i = 0; i < s->m; i++)
 	{
-		center[i] = (double *)malloc(s->n * sizeof(double));
-		center_mean[i] = (double *)calloc(s->n, sizeof(double));
-		OK = j = 0;
-		do
-		{
-			j++;
-			r = (int)GenerateUniformRandomNumber(0, s->m);
-			if (!is_chosen[r])
-			{
-				is_chosen[r] = 1;
-				OK = 1;
-			}
-		} while ((!OK) && (j <= s->m));
-		if (j > s->m)
-		{
-			fprintf(stderr, "\nProblems initializing the k centers @k_means. Probably k is too large.\n");
-			exit(-1);
-		}
-		for (j = 0; j < s->n; j++)
-			center[i][j] = s->a[r]->x[j];
+		X[i] = s->a[i]->x;
+		if (s->a[i]->fit < s->a[best]->fit)
+			best = i;
 	}
 
-	/* main algorithm */
-	do
-	{
-		old_error = error;
-		error = 0;
-
-		for (i = 0; i < s->k; i++)
-		{
-			ctr[i] = 0;
-			for (j = 0; j < s->n; j++)
-				center_mean[i][j] = 0;
-		}
-
-		/* for each idea, it finds the nearest center */
-		for (i = 0; i < s->m; i++)
-		{
-			min_distance = DBL_MAX;
-
-			for (j = 0; j < s->k; j++)
-			{
-				distance = EuclideanDistance(s->a[i]->x, center[j], s->n);
-				if (distance < min_distance)
-				{
-					nearest[i] = j;
-					min_distance = distance;
-				}
-			}
-
-			/* after finding the nearest center, we accumulate
-	    the idea's coordinates at this center */
-			for (j = 0; j < s->n; j++)
-				center_mean[nearest[i]][j] += s->a[i]->x[j];
-
-			ctr[nearest[i]]++;
-			error += min_distance;
-		}
-		error /= s->m;
-
-		/* updating the centers */
-		for (i = 0; i < s->k; i++)
-		{
-			for (j = 0; j < s->n; j++)
-			{
-				if (ctr[i])
-					center[i][j] = center_mean[i][j] / ctr[i];
-				else
-					center[i][j] = center_mean[i][j];
-			}
-		}
-	} while (fabs(error - old_error) > 1e-5);
+	RunKMeans(s, km, X, s->m);
 
 	/* identifying the best idea (smallest fitness) per cluster */
-	for (i = 0; i < s->k; i++)
+	for (c = 0; c < s->k; c++)
 	{
-		best_fitness_cluster[i] = DBL_MAX;
-
-		/* it allocates an array to store the ids of the ideas of cluster i. The first position stores the number of ideas clustered in cluster i. */
-		(*ideas_per_cluster)[i] = (int *)calloc((ctr[i] + 1), sizeof(int));
+		best_fitness_cluster[c] = DBL_MAX;
+		best_ideas[c] = best;
+		ideas_per_cluster[c][0] = 0;
 	}
 
 	for (i = 0; i < s->m; i++)
 	{
-		(*ideas_per_cluster)[nearest[i]][ctr[nearest[i]]] = i;
-		ctr[nearest[i]]--;
-		if (s->a[i]->fit < best_fitness_cluster[nearest[i]])
+		c = km->label[i];
+		ideas_per_cluster[c][++ideas_per_cluster[c][0]] = i;
+		if (s->a[i]->fit < best_fitness_cluster[c])
 		{
-			best_fitness_cluster[nearest[i]] = s->a[i]->fit;
-			best_ideas[nearest[i]] = i;
+			best_fitness_cluster[c] = s->a[i]->fit;
+			best_ideas[c] = i;
 		}
 	}
-	/*************************************************************/
-
-	for (i = 0; i < s->k; i++)
-	{
-		free(center[i]);
-		free(center_mean[i]);
-	}
-	free(center);
-	free(center_mean);
-	free(is_chosen);
-	free(nearest);
-	free(ctr);
-	free(best_fitness_cluster);
 }
 /****************************/
 
-/* It executes the Brain Storm Optimization for function minimization according to Algorithm 1 (El-Abd, 2017)
+/* It executes the Brain Storm Optimization with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runBSO(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void BSO(SearchSpace *s, Evaluator *e)
 {
-	va_list arg, argtmp;
 	int i, j, z, k, t, *best = NULL, c1, c2, **ideas_per_cluster = NULL;
-	double p, r;
+	double p, r, **X = NULL, *best_fitness_cluster = NULL;
 	Agent *nidea = NULL;
-
-	va_start(arg, Evaluate);
-	va_copy(argtmp, arg);
+	KMeans *km = NULL;
 
 	if (!s)
 	{
@@ -177,24 +87,31 @@ void runBSO(SearchSpace *s, prtFun Evaluate, ...)
 		exit(-1);
 	}
 
+	km = CreateKMeans(s->k, s->n, s->m);
+	if (!km)
+	{
+		fprintf(stderr, "\nProblems creating the k-means engine @runBSO. Probably k is too large.\n");
+		exit(-1);
+	}
+
 	ideas_per_cluster = (int **)malloc(s->k * sizeof(int *));
+	for (i = 0; i < s->k; i++)
+		ideas_per_cluster[i] = (int *)malloc((s->m + 1) * sizeof(int));
 	best = (int *)malloc(s->k * sizeof(int));
+	X = (double **)malloc(s->m * sizeof(double *));
+	best_fitness_cluster = (double *)malloc(s->k * sizeof(double));
 	nidea = CreateAgent(s->n, _BSO_, _NOTENSOR_);
 
-	EvaluateSearchSpace(s, _BSO_, Evaluate, arg); /* Initial evaluation */
+	EvaluateSearchSpaceWith(s, _BSO_, e); /* Initial evaluation */
 
 	for (t = 1; t <= s->iterations; t++)
 	{
-		fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
 		/* clustering ideas */
-		k_means(s, best, &ideas_per_cluster);
+		k_means(s, km, X, best_fitness_cluster, best, ideas_per_cluster);
 
 		/* for each idea */
 		for (i = 0; i < s->m; i++)
 		{
-			va_copy(arg, argtmp);
-
 			p = GenerateUniformRandomNumber(0, 1);
 			if (s->p_one_cluster > p)
 			{
@@ -202,9 +119,8 @@ void runBSO(SearchSpace *s, prtFun Evaluate, ...)
 				p = GenerateUniformRandomNumber(0, 1);
 
 				/* creating a new idea based on the cluster selected previously.
-		We also consider if cluster c1 has a single idea, i.e., ideas_per_cluster[c1][0] == 0.
-		Notice we do not consider the cluster's center into that computation @kmeans function, which means a
-		unitary cluster has ideas_per_cluster[c1][0] == 0. */
+		We also consider if cluster c1 is empty, i.e., ideas_per_cluster[c1][0] == 0, in which case
+		best[c1] is the best idea of the whole population (see @kmeans function). */
 				if ((s->p_one_center > p) || (ideas_per_cluster[c1][0] == 0))
 				{
 					for (k = 0; k < s->n; k++)
@@ -212,7 +128,7 @@ void runBSO(SearchSpace *s, prtFun Evaluate, ...)
 				}
 				else
 				{ /* creating a new idea based on another idea j selected randomly from cluster c1 */
-					j = (int)GenerateUniformRandomNumber(1, ideas_per_cluster[c1][0]);
+					j = (int)GenerateUniformRandomNumber(1, ideas_per_cluster[c1][0] + 1);
 					j = ideas_per_cluster[c1][j];
 
 					for (k = 0; k < s->n; k++)
@@ -231,7 +147,7 @@ void runBSO(SearchSpace *s, prtFun Evaluate, ...)
 					j = best[c1];
 				else
 				{
-					j = (int)GenerateUniformRandomNumber(1, ideas_per_cluster[c1][0]);
+					j = (int)GenerateUniformRandomNumber(1, ideas_per_cluster[c1][0] + 1);
 					j = ideas_per_cluster[c1][j];
 				}
 
@@ -239,7 +155,7 @@ void runBSO(SearchSpace *s, prtFun Evaluate, ...)
 					z = best[c2];
 				else
 				{
-					z = (int)GenerateUniformRandomNumber(1, ideas_per_cluster[c2][0]);
+					z = (int)GenerateUniformRandomNumber(1, ideas_per_cluster[c2][0] + 1);
 					z = ideas_per_cluster[c2][z];
 				}
 
@@ -268,7 +184,7 @@ void runBSO(SearchSpace *s, prtFun Evaluate, ...)
 
 			/* It evaluates the new created idea */
 			CheckAgentLimits(s, nidea);
-			p = Evaluate(nidea, arg);
+			p = ComputeFitness(e, nidea);
 			if (p < s->a[i]->fit)
 			{ /* if the new idea is better than the current one */
 				for (k = 0; k < s->n; k++)
@@ -280,15 +196,51 @@ void runBSO(SearchSpace *s, prtFun Evaluate, ...)
 				s->gfit = s->a[i]->fit;
 		}
 
-		fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
-
-		for (i = 0; i < s->k; i++)
-			free(ideas_per_cluster[i]);
+		ReportIteration(s, _BSO_, e, t, s->gfit);
 	}
 
+	for (i = 0; i < s->k; i++)
+		free(ideas_per_cluster[i]);
 	free(ideas_per_cluster);
 	free(best);
+	free(X);
+	free(best_fitness_cluster);
 	DestroyAgent(&nidea, _BSO_);
+	DestroyKMeans(&km);
+}
+
+/* It executes the Brain Storm Optimization for function minimization according to Algorithm 1 (El-Abd, 2017)
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runBSO(SearchSpace *s, prtFun Evaluate, ...)
+{
+	va_list arg;
+	Evaluator e;
+
+	va_start(arg, Evaluate);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	BSO(s, &e);
+	PROFILE_END_RUN("BSO", &e);
+	DestroyEvaluator(&e);
 	va_end(arg);
 }
+
+/* It executes the Brain Storm Optimization for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runBSO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+	Evaluator e;
+
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	BSO(s, &e);
+	PROFILE_END_RUN("BSO", &e);
+	DestroyEvaluator(&e);
+}
 /*************************/
\ No newline at end of file
@@ -0,0 +1,642 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include <math.h>
+
+#include "cache.h"
+#include "kernel.h"
+
+/* It computes the key of a decision vector
+Parameters:
+c: fitness cache
+x: n-dimensional decision vector
+key: output array with n words
+It returns the hash value of the key */
+static uint64_t ComputeKey(FitnessCache *c, const double *x, uint64_t *key) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    double y;
+    int j;
+
+    for (j = 0; j < c->n; j++) {
+        /* Quantized keys must fit in a long long, so huge and non-finite values fall back to exact keys */
+        if ((c->resolution > 0) && (isfinite(x[j])) && (fabs(x[j] / c->resolution) < 0x1p63))
+            key[j] = (uint64_t) llround(x[j] / c->resolution);
+        else {
+            y = x[j] + 0.0; /* -0.0 and 0.0 get the same key */
+            memcpy(&key[j], &y, sizeof(uint64_t));
+        }
+        h = (h ^ key[j]) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+
+    return h;
+}
+
+/* It finds the entry of a key
+Parameters:
+c: fitness cache
+key: key of the decision vector
+h: hash value of the key
+It returns the index of the entry, or -1 if the key is not stored */
+static int FindEntry(FitnessCache *c, const uint64_t *key, uint64_t h) {
+    int i;
+
+    for (i = c->bucket[h & (c->n_buckets - 1)]; i != -1; i = c->next[i])
+        if ((c->hash[i] == h) && (!memcmp(c->key + (size_t) i * c->n, key, c->n * sizeof(uint64_t))))
+            return i;
+
+    return -1;
+}
+
+/* It removes an entry from the list of its bucket
+Parameters:
+c: fitness cache
+i: index of the entry */
+static void UnlinkEntry(FitnessCache *c, int i) {
+    int *link = &c->bucket[c->hash[i] & (c->n_buckets - 1)];
+
+    while (*link != i)
+        link = &c->next[*link];
+    *link = c->next[i];
+}
+
+/* Fitness cache-related functions */
+/* It creates a fitness cache
+Parameters:
+n: number of decision variables
+capacity: maximum number of entries
+resolution: quantization step of the decision variables (0 for exact keys) */
+FitnessCache *CreateFitnessCache(int n, int capacity, double resolution) {
+    if ((n < 1) || (capacity < 1) || (resolution < 0)) {
+        fprintf(stderr, "\nInvalid input parameters @CreateFitnessCache.\n");
+        return NULL;
+    }
+
+    FitnessCache *c = NULL;
+
+    c = (FitnessCache *) malloc(sizeof(FitnessCache));
+    c->n = n;
+    c->capacity = capacity;
+    c->resolution = resolution;
+    for (c->n_buckets = 1; c->n_buckets < 2 * capacity; c->n_buckets <<= 1);
+    c->key = (uint64_t *) malloc((size_t) capacity * n * sizeof(uint64_t));
+    c->hash = (uint64_t *) malloc(capacity * sizeof(uint64_t));
+    c->fit = (double *) malloc(capacity * sizeof(double));
+    c->next = (int *) malloc(capacity * sizeof(int));
+    c->bucket = (int *) malloc(c->n_buckets * sizeof(int));
+    c->ref = (char *) malloc(capacity * sizeof(char));
+    c->tmp = (uint64_t *) malloc(n * sizeof(uint64_t));
+    pthread_mutex_init(&c->lock, NULL);
+    ClearFitnessCache(c);
+
+    return c;
+}
+
+/* It deallocates a fitness cache
+Parameters:
+c: address of the fitness cache to be deallocated */
+void DestroyFitnessCache(FitnessCache **c) {
+    FitnessCache *tmp = NULL;
+
+    tmp = *c;
+    if (!tmp) {
+        fprintf(stderr, "\nFitness cache not allocated @DestroyFitnessCache.\n");
+        exit(-1);
+    }
+
+    pthread_mutex_destroy(&tmp->lock);
+    free(tmp->key);
+    free(tmp->hash);
+    free(tmp->fit);
+    free(tmp->next);
+    free(tmp->bucket);
+    free(tmp->ref);
+    free(tmp->tmp);
+    free(tmp);
+    *c = NULL;
+}
+
+/* It looks up the fitness value of a decision vector
+Parameters:
+c: fitness cache
+x: n-dimensional decision vector
+fit: output fitness value (it is not modified if the vector is not found)
+It returns 1 if the vector has been found, and 0 otherwise */
+int LookupFitness(FitnessCache *c, const double *x, double *fit) {
+    if ((!c) || (!x) || (!fit)) {
+        fprintf(stderr, "\nInvalid input parameters @LookupFitness.\n");
+        exit(-1);
+    }
+
+    int i;
+
+    pthread_mutex_lock(&c->lock);
+    i = FindEntry(c, c->tmp, ComputeKey(c, x, c->tmp));
+    c->n_lookups++;
+    if (i != -1) {
+        c->n_hits++;
+        c->ref[i] = 1;
+        *fit = c->fit[i];
+    }
+    pthread_mutex_unlock(&c->lock);
+
+    return i != -1;
+}
+
+/* It stores the fitness value of a decision vector
+ * If the vector is already stored, its fitness value is replaced. If the cache is full, an entry is evicted by the clock policy:
+ * the hand skips (and clears the reference bit of) the entries found since it last passed by them.
+Parameters:
+c: fitness cache
+x: n-dimensional decision vector
+fit: fitness value */
+void InsertFitness(FitnessCache *c, const double *x, double fit) {
+    if ((!c) || (!x)) {
+        fprintf(stderr, "\nInvalid input parameters @InsertFitness.\n");
+        exit(-1);
+    }
+
+    uint64_t h;
+    int i;
+
+    pthread_mutex_lock(&c->lock);
+    h = ComputeKey(c, x, c->tmp);
+    i = FindEntry(c, c->tmp, h);
+    if (i == -1) {
+        if (c->size < c->capacity)
+            i = c->size++;
+        else {
+            while (c->ref[c->hand]) {
+                c->ref[c->hand] = 0;
+                c->hand = (c->hand + 1) % c->capacity;
+            }
+            i = c->hand;
+            c->hand = (c->hand + 1) % c->capacity;
+            UnlinkEntry(c, i);
+            c->n_evictions++;
+        }
+        memcpy(c->key + (size_t) i * c->n, c->tmp, c->n * sizeof(uint64_t));
+        c->hash[i] = h;
+        c->next[i] = c->bucket[h & (c->n_buckets - 1)];
+        c->bucket[h & (c->n_buckets - 1)] = i;
+        c->ref[i] = 0;
+    }
+    c->fit[i] = fit;
+    pthread_mutex_unlock(&c->lock);
+}
+
+/* It removes all entries and resets the statistics of a fitness cache
+Parameters:
+c: fitness cache */
+void ClearFitnessCache(FitnessCache *c) {
+    if (!c) {
+        fprintf(stderr, "\nFitness cache not allocated @ClearFitnessCache.\n");
+        exit(-1);
+    }
+
+    int i;
+
+    pthread_mutex_lock(&c->lock);
+    for (i = 0; i < c->n_buckets; i++)
+        c->bucket[i] = -1;
+    c->size = 0;
+    c->hand = 0;
+    c->n_lookups = c->n_hits = c->n_evictions = 0;
+    pthread_mutex_unlock(&c->lock);
+}
+
+/* It returns the fraction of lookups that found the decision vector (0 if there has been no lookup)
+Parameters:
+c: fitness cache */
+double GetFitnessCacheHitRate(FitnessCache *c) {
+    if (!c) {
+        fprintf(stderr, "\nFitness cache not allocated @GetFitnessCacheHitRate.\n");
+        exit(-1);
+    }
+
+    return c->n_lookups ? (double) c->n_hits / c->n_lookups : 0;
+}
+
+/* It shows the statistics of a fitness cache
+Parameters:
+c: fitness cache */
+void ShowFitnessCache(FitnessCache *c) {
+    if (!c) {
+        fprintf(stderr, "\nFitness cache not allocated @ShowFitnessCache.\n");
+        exit(-1);
+    }
+
+    fprintf(stderr, "\nFitness cache: %d/%d entries, %ld lookups, %ld hits (hit rate %.2lf%%), %ld evictions\n", c->size, c->capacity,
+            c->n_lookups, c->n_hits, 100 * GetFitnessCacheHitRate(c), c->n_evictions);
+}
+/**************************/
+
+/* It computes the hash value of the key of a subtree
+Parameters:
+key: 3 words (function and identifiers of the sons) */
+static uint64_t HashSubtree(const int64_t *key) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    int j;
+
+    for (j = 0; j < 3; j++) {
+        h = (h ^ (uint64_t) key[j]) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+
+    return h;
+}
+
+/* It finds the entry of a subtree
+Parameters:
+c: subtree cache
+key: key of the subtree
+h: hash value of the key
+It returns the index of the entry, or -1 if the subtree is not stored */
+static int FindSubtree(SubtreeCache *c, const int64_t *key, uint64_t h) {
+    int i;
+
+    for (i = c->bucket[h & (c->n_buckets - 1)]; i != -1; i = c->next[i])
+        if ((c->hash[i] == h) && (!memcmp(c->key + 3 * i, key, 3 * sizeof(int64_t))))
+            return i;
+
+    return -1;
+}
+
+/* It removes an entry from the list of its bucket
+Parameters:
+c: subtree cache
+i: index of the entry */
+static void UnlinkSubtree(SubtreeCache *c, int i) {
+    int *link = &c->bucket[c->hash[i] & (c->n_buckets - 1)];
+
+    while (*link != i)
+        link = &c->next[*link];
+    *link = c->next[i];
+}
+
+/* It removes all entries of a subtree cache, keeping its statistics
+ * The outputs of the constants are loaded again on their next use.
+Parameters:
+c: subtree cache */
+static void ResetSubtrees(SubtreeCache *c) {
+    int i;
+
+    for (i = 0; i < c->n_buckets; i++)
+        c->bucket[i] = -1;
+    for (i = 0; i < c->capacity; i++)
+        c->pin[i] = 0;
+    for (i = 0; i < c->n_leaves - c->n_terminals; i++)
+        c->loaded[i] = 0;
+    c->size = 0;
+    c->hand = 0;
+}
+
+/* It loads the output of a constant into the leaves of a subtree cache
+Parameters:
+s: search space
+c: subtree cache
+id: identifier of the constant */
+static void LoadConstant(SearchSpace *s, SubtreeCache *c, int id) {
+    double *x = c->leaf + (size_t) (c->n_terminals + id) * c->width;
+    int i;
+
+    if (c->tensor_dim == -1) {
+        for (i = 0; i < s->n; i++)
+            x[i] = s->constant[i][id];
+    } else
+        memcpy(x, s->t_constant[id][0], c->width * sizeof(double));
+    c->loaded[id] = 1;
+}
+
+/* It runs the subtree rooted at the k-th node of a pooled tree through a subtree cache (post-order)
+ * The entry of the subtree (if any) is pinned, so that it is not evicted before the caller is done with its output.
+Parameters:
+s: search space
+c: subtree cache
+T: nodes of the pooled tree
+k: position of the node
+out: output array of the subtree
+entry: index of the pinned entry, or -1 for leaves (whose outputs are not cached)
+It returns the unique identifier of the subtree */
+static int64_t RunCachedNode(SearchSpace *s, SubtreeCache *c, const TreeNode *T, int k, double **out, int *entry) {
+    int64_t key[3];
+    uint64_t h;
+    double *x = NULL, *y = NULL;
+    int i, leaf, son, left = -1, right = -1;
+
+    if (T[k].opcode == -1) {
+        leaf = T[k].status == CONSTANT ? c->n_terminals + T[k].id : T[k].id;
+        if ((T[k].status == CONSTANT) && (!c->loaded[T[k].id]))
+            LoadConstant(s, c, T[k].id);
+        *out = c->leaf + (size_t) leaf * c->width;
+        *entry = -1;
+        return -1 - leaf; /* the identifiers of the leaves are negative */
+    }
+
+    son = k + 1;
+    key[0] = T[k].opcode;
+    key[1] = RunCachedNode(s, c, T, son, &x, &left);
+    key[2] = 0;
+    if (T[k].n_args > 1) {
+        son += T[son].size;
+        key[2] = RunCachedNode(s, c, T, son, &y, &right);
+    }
+
+    h = HashSubtree(key);
+    i = FindSubtree(c, key, h);
+    c->n_lookups++;
+    if (i != -1)
+        c->n_hits++;
+    else {
+        if (c->size < c->capacity)
+            i = c->size++;
+        else {
+            while ((c->ref[c->hand]) || (c->pin[c->hand])) {
+                c->ref[c->hand] = 0;
+                c->hand = (c->hand + 1) % c->capacity;
+            }
+            i = c->hand;
+            c->hand = (c->hand + 1) % c->capacity;
+            UnlinkSubtree(c, i);
+            c->n_evictions++;
+        }
+        RunGPFunction(T[k].opcode, x, y, c->out + (size_t) i * c->width, c->width);
+        memcpy(c->key + 3 * i, key, 3 * sizeof(int64_t));
+        c->hash[i] = h;
+        c->uid[i] = c->next_uid++;
+        c->next[i] = c->bucket[h & (c->n_buckets - 1)];
+        c->bucket[h & (c->n_buckets - 1)] = i;
+    }
+    c->ref[i] = 1;
+
+    if (left != -1)
+        c->pin[left]--;
+    if (right != -1)
+        c->pin[right]--;
+    c->pin[i]++;
+
+    *out = c->out + (size_t) i * c->width;
+    *entry = i;
+
+    return c->uid[i];
+}
+
+/* It returns the depth of the subtree rooted at the k-th node of a pooled tree
+Parameters:
+T: nodes of the pooled tree
+k: position of the node */
+static int PooledDepth(const TreeNode *T, int k) {
+    int i, son = k + 1, depth, max_depth = 0;
+
+    for (i = 0; i < T[k].n_args; i++) {
+        depth = PooledDepth(T, son);
+        if (depth > max_depth)
+            max_depth = depth;
+        son += T[son].size;
+    }
+
+    return 1 + max_depth;
+}
+
+/* Subtree cache-related functions */
+/* It creates a subtree cache
+Parameters:
+capacity: maximum number of entries (each one keeps an output array) */
+SubtreeCache *CreateSubtreeCache(int capacity) {
+    if (capacity < 1) {
+        fprintf(stderr, "\nInvalid input parameters @CreateSubtreeCache.\n");
+        return NULL;
+    }
+
+    SubtreeCache *c = NULL;
+
+    c = (SubtreeCache *) malloc(sizeof(SubtreeCache));
+    c->capacity = capacity;
+    c->width = 0;
+    c->n_terminals = c->n_leaves = 0;
+    c->tensor_dim = -1;
+    c->leaf = c->tmp = NULL;
+    c->loaded = NULL;
+    c->out = NULL;
+    for (c->n_buckets = 1; c->n_buckets < 2 * capacity; c->n_buckets <<= 1);
+    c->key = (int64_t *) malloc(3 * (size_t) capacity * sizeof(int64_t));
+    c->uid = (int64_t *) malloc(capacity * sizeof(int64_t));
+    c->hash = (uint64_t *) malloc(capacity * sizeof(uint64_t));
+    c->next = (int *) malloc(capacity * sizeof(int));
+    c->bucket = (int *) malloc(c->n_buckets * sizeof(int));
+    c->ref = (char *) malloc(capacity * sizeof(char));
+    c->pin = (int *) malloc(capacity * sizeof(int));
+    c->next_uid = 0;
+    ClearSubtreeCache(c);
+
+    return c;
+}
+
+/* It deallocates a subtree cache
+Parameters:
+c: address of the subtree cache to be deallocated */
+void DestroySubtreeCache(SubtreeCache **c) {
+    SubtreeCache *tmp = NULL;
+
+    tmp = *c;
+    if (!tmp) {
+        fprintf(stderr, "\nSubtree cache not allocated @DestroySubtreeCache.\n");
+        exit(-1);
+    }
+
+    if (tmp->leaf) free(tmp->leaf);
+    if (tmp->loaded) free(tmp->loaded);
+    if (tmp->tmp) free(tmp->tmp);
+    if (tmp->out) free(tmp->out);
+    free(tmp->key);
+    free(tmp->uid);
+    free(tmp->hash);
+    free(tmp->next);
+    free(tmp->bucket);
+    free(tmp->ref);
+    free(tmp->pin);
+    free(tmp);
+    *c = NULL;
+}
+
+/* It updates the outputs of the terminals of a subtree cache, and it invalidates the cache if they have changed
+ * It must be called before running trees whenever the agents (terminals) of the search space may have changed. The constants
+ * are loaded on demand, and they are assumed to be fixed: if they are modified, the cache must be cleared (see ClearSubtreeCache).
+Parameters:
+s: search space
+c: subtree cache
+tensor_dim: dimension of the tensors (-1 for real-valued trees) */
+void SyncSubtreeCache(SearchSpace *s, SubtreeCache *c, int tensor_dim) {
+    if ((!s) || (!c)) {
+        fprintf(stderr, "\nInvalid input parameters @SyncSubtreeCache.\n");
+        exit(-1);
+    }
+
+    int i, j, k, width, n_leaves, reshaped = 0;
+    double *x = NULL;
+
+    width = tensor_dim == -1 ? s->n : s->n * tensor_dim;
+    n_leaves = s->n_terminals + s->n_constants;
+    if ((width != c->width) || (tensor_dim != c->tensor_dim) || (n_leaves != c->n_leaves) || (s->n_terminals != c->n_terminals)) {
+        if (width != c->width) { /* the cache is reshaped for a new kind of tree */
+            free(c->out);
+            c->out = (double *) malloc((size_t) c->capacity * width * sizeof(double));
+        }
+        free(c->leaf);
+        free(c->loaded);
+        free(c->tmp);
+        c->leaf = (double *) malloc((size_t) n_leaves * width * sizeof(double));
+        c->loaded = (char *) malloc((s->n_constants + 1) * sizeof(char));
+        c->tmp = (double *) malloc((size_t) (s->n_terminals + 1) * width * sizeof(double));
+        c->width = width;
+        c->tensor_dim = tensor_dim;
+        c->n_terminals = s->n_terminals;
+        c->n_leaves = n_leaves;
+        reshaped = 1;
+    }
+
+    for (k = 0; k < s->n_terminals; k++) { /* see RunGPProgram */
+        x = c->tmp + (size_t) k * width;
+        if ((!strcmp(s->terminal[k], "CONST")) || (k >= s->m)) {
+            for (i = 0; i < width; i++)
+                x[i] = 0;
+        } else if (tensor_dim == -1)
+            memcpy(x, s->a[k]->x, width * sizeof(double));
+        else {
+            for (i = 0; i < s->n; i++)
+                for (j = 0; j < tensor_dim; j++)
+                    x[i * tensor_dim + j] = s->a[k]->t[i][j];
+        }
+    }
+
+    if ((reshaped) || (memcmp(c->tmp, c->leaf, (size_t) s->n_terminals * width * sizeof(double)))) {
+        memcpy(c->leaf, c->tmp, (size_t) s->n_terminals * width * sizeof(double));
+        ResetSubtrees(c);
+    }
+}
+
+/* It runs a pooled tree through a subtree cache and outputs its solution array
+ * Only the subtrees that are not found in the cache are computed, and their outputs are stored.
+Parameters:
+s: search space
+c: subtree cache (it must have been synchronized with the search space, see SyncSubtreeCache)
+p: pool
+i: position of the tree
+It returns the solution (width doubles, which must not be modified), or NULL if the tree is too deep for the capacity of the cache,
+i.e., its depth plus 2 exceeds the capacity. The solution is overwritten by the next run. */
+double *RunCachedTree(SearchSpace *s, SubtreeCache *c, TreePool *p, int i) {
+    if ((!s) || (!c) || (!p) || (i < 0) || (i >= p->m) || (p->root[i] < 0)) {
+        fprintf(stderr, "\nInvalid input parameters @RunCachedTree.\n");
+        exit(-1);
+    }
+    if (!c->width) {
+        fprintf(stderr, "\nSubtree cache not synchronized @RunCachedTree.\n");
+        exit(-1);
+    }
+
+    TreeNode *T = p->node + p->root[i];
+    double *out = NULL;
+    int entry;
+
+    if (PooledDepth(T, 0) + 2 > c->capacity) /* it bounds the number of entries pinned at once */
+        return NULL;
+
+    RunCachedNode(s, c, T, 0, &out, &entry);
+    if (entry != -1)
+        c->pin[entry]--;
+
+    return out;
+}
+
+/* It removes all entries and resets the statistics of a subtree cache
+Parameters:
+c: subtree cache */
+void ClearSubtreeCache(SubtreeCache *c) {
+    if (!c) {
+        fprintf(stderr, "\nSubtree cache not allocated @ClearSubtreeCache.\n");
+        exit(-1);
+    }
+
+    ResetSubtrees(c);
+    c->n_lookups = c->n_hits = c->n_evictions = 0;
+}
+
+/* It returns the fraction of lookups that found the subtree (0 if there has been no lookup)
+Parameters:
+c: subtree cache */
+double GetSubtreeCacheHitRate(SubtreeCache *c) {
+    if (!c) {
+        fprintf(stderr, "\nSubtree cache not allocated @GetSubtreeCacheHitRate.\n");
+        exit(-1);
+    }
+
+    return c->n_lookups ? (double) c->n_hits / c->n_lookups : 0;
+}
+
+/* It shows the statistics of a subtree cache
+Parameters:
+c: subtree cache */
+void ShowSubtreeCache(SubtreeCache *c) {
+    if (!c) {
+        fprintf(stderr, "\nSubtree cache not allocated @ShowSubtreeCache.\n");
+        exit(-1);
+    }
+
+    fprintf(stderr, "\nSubtree cache: %d/%d entries, %ld lookups, %ld hits (hit rate %.2lf%%), %ld evictions\n", c->size, c->capacity,
+            c->n_lookups, c->n_hits, 100 * GetSubtreeCacheHitRate(c), c->n_evictions);
+}
+/**************************/
+
+/* General-purpose functions */
+/* It enables (or disables) the fitness cache of a search space
+ * The cache is used by the evaluators created afterwards, i.e., by the optimizers run afterwards. Setting a new cache discards the current one.
+ * For integer-valued problems (s->is_integer_opt), the resolution is ignored and the decision vectors are compared exactly,
+ * so that the cache never changes the results; note this is the default setting of CreateSearchSpace.
+ * The cache must not be used by techniques whose fitness does not depend on the decision vector alone (e.g., CGP).
+Parameters:
+s: search space
+capacity: maximum number of cached fitness values (0 disables the cache)
+resolution: quantization step of the decision variables of real-valued problems (0 for exact keys) */
+void SetFitnessCache(SearchSpace *s, int capacity, double resolution) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @SetFitnessCache.\n");
+        exit(-1);
+    }
+
+    if (s->cache)
+        DestroyFitnessCache(&(s->cache));
+    if (capacity > 0)
+        s->cache = CreateFitnessCache(s->n, capacity, s->is_integer_opt ? 0 : resolution);
+}
+
+/* It enables (or disables) the subtree cache of a search space
+ * The cache is used by GP and TGP, whose trees are run through it (see RunPooledTree). Setting a new cache discards the current one.
+ * Each entry keeps the output of a subtree, i.e., n doubles (n x tensor_dim doubles for TGP).
+Parameters:
+s: search space
+capacity: maximum number of cached subtrees (0 disables the cache) */
+void SetSubtreeCache(SearchSpace *s, int capacity) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @SetSubtreeCache.\n");
+        exit(-1);
+    }
+
+    if (s->subtree_cache)
+        DestroySubtreeCache(&(s->subtree_cache));
+    if (capacity > 0)
+        s->subtree_cache = CreateSubtreeCache(capacity);
+}
+/**************************/
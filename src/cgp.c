@@ -14,6 +14,9 @@ limitations under the License.
 */
 
 #include "cgp.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "parallel.h"
 
 double computeFunc(double x, double y, int op_id) {
     switch (op_id) {
@@ -106,55 +109,121 @@ int get_valid_input_index(int n_rows, int levels_back, int n_input_values, int n
     }
 }
 
-void decode_chromossome(Agent *a, int n_columns, int n_rows, int n_input_values, int n) {
-    /* array that holds the output of all nodes, including the input nodes */
-    double output_nodes_values[n_columns * n_rows + n_input_values];
-    /* copying the input nodes to the value output array */
-    for(int i = 0; i < n_input_values; i++)
-        output_nodes_values[i] = a->input_values[i];
-
-    /* binary array indicating which nodes must be evaluated */
-    int to_evaluate[n_columns * n_rows];
-    /* and starting it with all entries as Zero / False */
-    memset(to_evaluate, 0, n_columns * n_rows * sizeof(int));
+/**
+ * It marks the active nodes of an agent, i.e., the ones its outputs depend on, and lists them in evaluation order
+ * @param a Agent
+ * @param n_nodes Number of nodes (n_columns * n_rows)
+ * @param n_input_values Number of input values
+ * @param n Number of outputs
+ */
+static void mark_active_nodes(Agent *a, int n_nodes, int n_input_values, int n) {
+    memset(a->active_mask, 0, n_nodes * sizeof(char));
 
-    /* getting the nodes directed connected to the output */
+    /* getting the nodes directed connected to the output (the first indexes are from the input values) */
     for(int i = 0; i < n; i++) {
-        /* the first indexes are from the input values so we are only interested on values equal greater than n_input_values */
-        if(a->output_nodes[i] >= n_input_values) {
-            to_evaluate[a->output_nodes[i] - n_input_values] = 1; /* that node must be evaluated */
-        }
+        if(a->output_nodes[i] >= n_input_values)
+            a->active_mask[a->output_nodes[i] - n_input_values] = 1;
     }
-    /* going in the reverse order to check which node is dependent of which */
-    for(int i = n_columns * n_rows; i >= 0; i--) {
-        /* if that node needs to be evaluated, we marks its inputs as nodes that also need evaluation */
-        if(to_evaluate[i] == 1) {
-            int c0 = a->genotype[i].connection0 - n_input_values; /* we subtract n_input_values to get the real node index instead of its output index */
-            /* if the value is greater or equal to zero, means that the input chosen is a node, not a value coming from the input array, so we mark it as peding evaluation */
-            if(c0 >= 0)
-                to_evaluate[c0] = 1;
 
-            int c1 = a->genotype[i].connection1 - n_input_values; /* we subtract n_input_values to get the real node index instead of its output index */
-            /* if the value is greater or equal to zero, means that the input chosen is a node, not a value coming from the input array, so we mark it as peding evaluation */
+    /* going in the reverse order, since a node only takes its inputs from previous columns */
+    for(int i = n_nodes - 1; i >= 0; i--) {
+        if(a->active_mask[i]) {
+            int c0 = a->genotype[i].connection0 - n_input_values;
+            int c1 = a->genotype[i].connection1 - n_input_values;
+            if(c0 >= 0)
+                a->active_mask[c0] = 1;
             if(c1 >= 0)
-                to_evaluate[c1] = 1;
+                a->active_mask[c1] = 1;
         }
     }
-    /* getting the output of each used node */
-    for(int i = 0; i < n_columns * n_rows; i++) {
-        if(to_evaluate[i] == 1) {
-            int f_id = a->genotype[i].func_id;
-            int value_c0 = output_nodes_values[a->genotype[i].connection0];
-            int value_c1 = output_nodes_values[a->genotype[i].connection1];
-            output_nodes_values[i + n_input_values] = computeFunc(value_c0, value_c1, f_id);
-        }
+
+    a->n_active = 0;
+    for(int i = 0; i < n_nodes; i++) {
+        if(a->active_mask[i])
+            a->active[a->n_active++] = i;
+    }
+}
+
+/**
+ * It decodes the genotype of an agent, computing the output of its active nodes and saving the outputs of the graph on a->x
+ * @param a Agent
+ * @param n_columns Number of columns of the grid
+ * @param n_rows Number of rows of the grid
+ * @param n_input_values Number of input values
+ * @param n Number of outputs
+ */
+void decode_chromossome(Agent *a, int n_columns, int n_rows, int n_input_values, int n) {
+    double *value = a->node_values;
+
+    mark_active_nodes(a, n_columns * n_rows, n_input_values, n);
+
+    /* copying the input nodes to the value output array */
+    memcpy(value, a->input_values, n_input_values * sizeof(double));
+
+    /* getting the output of each active node */
+    for(int k = 0; k < a->n_active; k++) {
+        int i = a->active[k];
+        value[i + n_input_values] = computeFunc(value[a->genotype[i].connection0], value[a->genotype[i].connection1], a->genotype[i].func_id);
     }
 
     /* putting the output values in the position array to be further evaluated */
+    for(int i = 0; i < n; i++)
+        a->x[i] = value[a->output_nodes[i]];
+}
+
+/**
+ * It decodes the genotype of an offspring, given its already decoded parent
+ * Only the active nodes whose genes differ from the parent's, that were not active in the parent, or whose inputs changed their values
+ * are computed; the output of any other active node is taken from the parent. The offspring must have the parent's input values.
+ * @param a Offspring
+ * @param parent Parent of the offspring
+ * @param n_columns Number of columns of the grid
+ * @param n_rows Number of rows of the grid
+ * @param n_input_values Number of input values
+ * @param n Number of outputs
+ * @return 1 if the active graph of the offspring differs from the parent's one, 0 otherwise (a->x is then equal to the parent's outputs)
+ */
+int decode_chromossome_incremental(Agent *a, Agent *parent, int n_columns, int n_rows, int n_input_values, int n) {
+    double *value = a->node_values;
+    int changed = 0;
+
+    mark_active_nodes(a, n_columns * n_rows, n_input_values, n);
+
+    memcpy(value, a->input_values, n_input_values * sizeof(double));
+
     for(int i = 0; i < n; i++) {
-        a->x[i] = output_nodes_values[a->output_nodes[i]];
+        if(a->output_nodes[i] != parent->output_nodes[i])
+            changed = 1;
+    }
+
+    /* the active nodes whose values differ from the parent's ones are flagged with 2 */
+    for(int k = 0; k < a->n_active; k++) {
+        int i = a->active[k];
+        CGP_Node *g = &(a->genotype[i]);
+        CGP_Node *pg = &(parent->genotype[i]);
+        int c0 = g->connection0 - n_input_values, c1 = g->connection1 - n_input_values;
+        int same_genes = (g->func_id == pg->func_id) && (g->connection0 == pg->connection0) && (g->connection1 == pg->connection1);
+
+        if(!same_genes || !parent->active_mask[i])
+            changed = 1;
+
+        if(same_genes && parent->active_mask[i] && ((c0 < 0) || (a->active_mask[c0] != 2)) && ((c1 < 0) || (a->active_mask[c1] != 2))) {
+            value[i + n_input_values] = parent->node_values[i + n_input_values];
+        }
+        else {
+            value[i + n_input_values] = computeFunc(value[g->connection0], value[g->connection1], g->func_id);
+            if(!parent->active_mask[i] || memcmp(&(value[i + n_input_values]), &(parent->node_values[i + n_input_values]), sizeof(double)))
+                a->active_mask[i] = 2;
+        }
     }
 
+    for(int k = 0; k < a->n_active; k++)
+        a->active_mask[a->active[k]] = 1;
+
+    for(int i = 0; i < n; i++)
+        a->x[i] = value[a->output_nodes[i]];
+
+    return changed;
 }
 
 void point_mutation(Agent* a, int n_columns, int n_rows, int levels_back, int n_input_values, int n_functions) {
@@ -190,18 +259,67 @@ void point_mutation(Agent* a, int n_columns, int n_rows, int levels_back, int n_
 }
 
 /**
- * It executes the Cartesian Genetic Programming for function minimization
- * @param s Search space
- * @param prtFunction Pointer to the function used to evaluate particles
- * @param ... List of additional arguments
+ * It swaps the genotype, output nodes, input values and decoded graph of two CGP agents
+ * @param a first agent
+ * @param b second agent
  */
-void runCGP(SearchSpace *s, prtFun Evaluate, ...) {
-    va_list arg, argtmp;
-    double beta, prob;
-    int lambda = 4; /* number of offsprings to be generated from an individual */
+static void SwapCGPStructures(Agent *a, Agent *b) {
+    CGP_Node *genotype = a->genotype;
+    int *output_nodes = a->output_nodes;
+    double *input_values = a->input_values;
+    char *active_mask = a->active_mask;
+    int *active = a->active;
+    int n_active = a->n_active;
+    double *node_values = a->node_values;
+
+    a->genotype = b->genotype;
+    a->output_nodes = b->output_nodes;
+    a->input_values = b->input_values;
+    a->active_mask = b->active_mask;
+    a->active = b->active;
+    a->n_active = b->n_active;
+    a->node_values = b->node_values;
+    b->genotype = genotype;
+    b->output_nodes = output_nodes;
+    b->input_values = input_values;
+    b->active_mask = active_mask;
+    b->active = active;
+    b->n_active = n_active;
+    b->node_values = node_values;
+}
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+/* It defines the offspring of a generation of CGP, which are decoded concurrently */
+typedef struct CGPOffspring_{
+    SearchSpace *s; /* search space */
+    Agent **offspring; /* offspring of the i-th agent are offspring[i * s->lambda], ..., offspring[(i + 1) * s->lambda - 1] */
+    char *changed; /* flag of each offspring telling whether its active graph differs from its parent's one */
+}CGPOffspring;
+
+/**
+ * It decodes the k-th offspring of a generation from its parent
+ * @param k Index of the offspring
+ * @param arg Offspring of the generation (CGPOffspring)
+ */
+static void DecodeOffspringTask(int k, void *arg) {
+    CGPOffspring *g = (CGPOffspring *) arg;
+    SearchSpace *s = g->s;
+
+    g->changed[k] = decode_chromossome_incremental(g->offspring[k], s->a[k / s->lambda], s->n_columns, s->n_rows, s->n_input_values, s->n);
+    CheckAgentLimits(s, g->offspring[k]); /* the offspring is evaluated at the same position it will have as a parent */
+}
+
+/**
+ * It executes the Cartesian Genetic Programming with a given fitness evaluator
+ * The m * lambda offspring of each generation are first mutated in order (so the random numbers are drawn as in a serial run), then
+ * they are decoded and evaluated concurrently, and the best offspring of each agent is finally chosen in order.
+ * @param s Search space
+ * @param e Fitness evaluator
+ */
+static void CGP(SearchSpace *s, Evaluator *e) {
+    double beta, prob, *f = NULL;
+    int lambda, n_changed;
+    Agent **offspring = NULL, **evaluate = NULL;
+    CGPOffspring g;
 
     if (!s)
     {
@@ -209,6 +327,9 @@ void runCGP(SearchSpace *s, prtFun Evaluate, ...) {
         exit(-1);
     }
 
+    e->cache = NULL; /* the fitness depends on the genotype, not only on the decision vector, so it cannot be cached */
+    lambda = s->lambda; /* number of offsprings to be generated from an individual */
+
     /* generate random valid genotypes (coding genes and output genes) */
     /* for each agent */
     for(int agent_index = 0; agent_index < s->m; agent_index++) {
@@ -231,76 +352,81 @@ void runCGP(SearchSpace *s, prtFun Evaluate, ...) {
         decode_chromossome(s->a[agent_index], s->n_columns, s->n_rows, s->n_input_values, s->n);
     }
 
-    EvaluateSearchSpace(s, _CGP_, Evaluate, arg); /* Initial evaluation */
+    EvaluateSearchSpaceWith(s, _CGP_, e); /* Initial evaluation */
+
+    /* the offspring buffers are allocated once, and they are refilled at each generation */
+    offspring = (Agent **) malloc(s->m * lambda * sizeof(Agent *));
+    evaluate = (Agent **) malloc(s->m * lambda * sizeof(Agent *));
+    f = (double *) malloc(s->m * lambda * sizeof(double));
+    for(int k = 0; k < s->m * lambda; k++)
+        offspring[k] = BorrowAgent(s, _CGP_);
+    g.s = s;
+    g.offspring = offspring;
+    g.changed = (char *) malloc(s->m * lambda * sizeof(char));
+
+    int num_mutations = (int)(s->pMutation * 3 * s->n_columns * s->n_rows + s->n);
 
     for (int t = 1; t <= s->iterations; t++)
     {
-        /* make reproduction by mutation and make selection (1 + lambda) */
-        /* for each agent */
+        /* make reproduction by mutation (1 + lambda) */
+        for(int k = 0; k < s->m * lambda; k++) {
+            Agent *parent = s->a[k / lambda];
+
+            /* copying the agent's genes */
+            memcpy(offspring[k]->output_nodes, parent->output_nodes, s->n * sizeof(int));
+            memcpy(offspring[k]->genotype, parent->genotype, s->n_columns * s->n_rows * sizeof(CGP_Node));
+            memcpy(offspring[k]->input_values, parent->input_values, s->n_input_values * sizeof(double));
+
+            /* mutating that offspring num_mutations times */
+            for(int i = 0; i < num_mutations; i++)
+                point_mutation(offspring[k], s->n_columns, s->n_rows, s->levels_back, s->n_input_values, s->n_functions);
+        }
+
+        /* decoding the offspring chromossomes from their parents' ones */
+        ParallelFor(s, s->m * lambda, DecodeOffspringTask, &g);
+
+        /* evaluating the offspring, unless only inactive genes have been mutated */
+        n_changed = 0;
+        for(int k = 0; k < s->m * lambda; k++) {
+            if(g.changed[k])
+                evaluate[n_changed++] = offspring[k];
+            else
+                offspring[k]->fit = s->a[k / lambda]->fit;
+        }
+        EvaluateAgents(s, evaluate, n_changed, e, f);
+        for(int k = 0; k < n_changed; k++)
+            evaluate[k]->fit = f[k];
+
+        /* make selection (1 + lambda) */
         for(int agent_index = 0; agent_index < s->m; agent_index++) {
-            /* for each offspring to be generated */
-            Agent* best_offspring = NULL;
-            for(int offspring_counter = 0; offspring_counter < lambda; offspring_counter++) {
-                /* copying the agent and its internal structures */
-                Agent* current_offspring = GenerateNewAgent(s, _CGP_);
-                memcpy(current_offspring->x, s->a[agent_index]->x, s->n * sizeof(double));
-                memcpy(current_offspring->output_nodes, s->a[agent_index]->output_nodes, s->n * sizeof(int));
-                memcpy(current_offspring->genotype, s->a[agent_index]->genotype, s->n_columns * s->n_rows * sizeof(CGP_Node));
-                memcpy(current_offspring->input_values, s->a[agent_index]->input_values, s->n_input_values * sizeof(double));
-
-
-                int num_mutations = (int)(s->pMutation * 3 * s->n_columns * s->n_rows + s->n);
-                /* mutating that agent num_mutations times */
-                for(int i = 0; i < num_mutations; i++)
-                    point_mutation(current_offspring, s->n_columns, s->n_rows, s->levels_back, s->n_input_values, s->n_functions);
-
-                /* decoding offspring chromossome */
-                decode_chromossome(current_offspring, s->n_columns, s->n_rows, s->n_input_values, s->n);
-                /* evaluating offspring */
-                va_list argtmp;
-                va_copy(argtmp, arg);
-                current_offspring->fit = Evaluate(current_offspring, arg);
-                va_copy(arg, argtmp);
-
-                /* if is the first iteration... */
-                if(best_offspring == NULL) {
-                    best_offspring = current_offspring;
-                }
-                /* if the current offspring has the best fitness yet */
-                else if(current_offspring->fit < best_offspring->fit) {
-                    /* destroying the old best offspring */
-                    DestroyAgent(&(best_offspring), _CGP_);
-                    best_offspring = current_offspring;
-                }
-                else {
-                    /* destroying the current offspring */
-                    DestroyAgent(&(current_offspring), _CGP_);
-                }
+            Agent *best_offspring = offspring[agent_index * lambda];
+
+            /* the first offspring with the lowest fitness is chosen */
+            for(int k = 1; k < lambda; k++) {
+                if(offspring[agent_index * lambda + k]->fit < best_offspring->fit)
+                    best_offspring = offspring[agent_index * lambda + k];
             }
 
             /* if the best offspring has better or equal fitness than its parent, it will become the new parent */
             if(best_offspring->fit <= s->a[agent_index]->fit) {
-                /* destroying the parent and making the offspring the new future parent */
-                DestroyAgent(&(s->a[agent_index]), _CGP_);
-                s->a[agent_index] = best_offspring;
-            }
-            else {
-                /* destroying the offspring */
-                DestroyAgent(&(best_offspring), _CGP_);
+                /* the parent takes the structures of the offspring, whose buffer keeps the old ones until the next generation */
+                SwapCGPStructures(s->a[agent_index], best_offspring);
+                memcpy(s->a[agent_index]->x, best_offspring->x, s->n * sizeof(double));
+                s->a[agent_index]->fit = best_offspring->fit;
             }
-
-        }
-        /* decode the genes and saving the output on s->a[i]->x*/
-        for(int agent_index = 0; agent_index < s->m; agent_index++) {
-            /* decode the genes and saving the output on s->a[i]->x */
-            decode_chromossome(s->a[agent_index], s->n_columns, s->n_rows, s->n_input_values, s->n);
         }
 
-        EvaluateSearchSpace(s, _CGP_, Evaluate, arg);
+        /* the parents keep the fitness of their offspring, so the best one is taken without evaluating them again */
+        for(int i = 0; i < s->m; i++) {
+            if(s->a[i]->fit < s->gfit) {
+                s->gfit = s->a[i]->fit;
+                memcpy(s->g, s->a[i]->x, s->n * sizeof(double));
+            }
+        }
 
         // ShowSearchSpace(s, _CGP_);
 
-        fprintf(stderr, "OK: %.2f%% done. (minimum fitness value %lf) \n", 100 * (double)t / (double)s->iterations, s->gfit);
+        ReportIteration(s, _CGP_, e, t, s->gfit);
         //fprintf(stderr, "Vector: ");
         //for (int i = 0; i < s->n; i++) {
         //        fprintf(stderr, "%f ", s->g[i]);
@@ -308,6 +434,45 @@ void runCGP(SearchSpace *s, prtFun Evaluate, ...) {
         //fprintf(stderr, "\n\n");
     }
 
+    for(int k = 0; k < s->m * lambda; k++)
+        ReturnAgent(s, &(offspring[k]));
+    free(offspring);
+    free(evaluate);
+    free(f);
+    free(g.changed);
+}
+
+/**
+ * It executes the Cartesian Genetic Programming for function minimization
+ * @param s Search space
+ * @param prtFunction Pointer to the function used to evaluate particles
+ * @param ... List of additional arguments
+ */
+void runCGP(SearchSpace *s, prtFun Evaluate, ...) {
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    CGP(s, &e);
+    PROFILE_END_RUN("CGP", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
+}
 
+/**
+ * It executes the Cartesian Genetic Programming for function minimization using a reentrant fitness function
+ * @param s Search space
+ * @param Evaluate Pointer to the function used to evaluate decision vectors
+ * @param ctx Context forwarded to each call of Evaluate
+ */
+void runCGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx) {
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    CGP(s, &e);
+    PROFILE_END_RUN("CGP", &e);
+    DestroyEvaluator(&e);
 }
@@ -0,0 +1,347 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "cluster.h"
+#include "kernel.h"
+#include "parallel.h"
+
+#define KMEANS_BLOCK 64 /* number of points assigned by each task of the assignment step */
+#define KMEANS_MAX_ITERATIONS 100 /* default maximum number of Lloyd iterations of each call */
+
+/* It defines the arguments of the tasks of the assignment step */
+typedef struct KMeansTask_{
+    KMeans *km; /* k-means engine */
+    int m; /* number of points */
+    char full; /* 1 if the distances to all centers must be computed, 0 if the bounds may skip them */
+}KMeansTask;
+
+/* It finds the nearest and the second nearest centers of a point by computing its distances to all centers
+Parameters:
+km: k-means engine
+i: index of the point */
+static void AssignPoint(KMeans *km, int i) {
+    double *d = km->d + (size_t) i * km->k, d1 = DBL_MAX, d2 = DBL_MAX;
+    int j, nearest = 0;
+
+    EuclideanDistances(km->X[i], km->c, km->k, km->n, d);
+    for (j = 0; j < km->k; j++) {
+        if (d[j] < d1) {
+            d2 = d1;
+            d1 = d[j];
+            nearest = j;
+        }
+        else if (d[j] < d2)
+            d2 = d[j];
+    }
+
+    km->new_label[i] = nearest;
+    km->upper[i] = d1;
+    km->lower[i] = d2;
+}
+
+/* It assigns a block of points to their nearest centers
+ * A point keeps its center whenever its upper bound does not exceed both its lower bound and half the distance
+ * from its center to the nearest other one (Hamerly's test), and the bound is tightened before giving up.
+Parameters:
+b: index of the block
+arg: arguments of the task (KMeansTask) */
+static void AssignBlock(int b, void *arg) {
+    KMeansTask *task = (KMeansTask *) arg;
+    KMeans *km = task->km;
+    int i, l, end = (b + 1) * KMEANS_BLOCK < task->m ? (b + 1) * KMEANS_BLOCK : task->m;
+    double bound;
+
+    for (i = b * KMEANS_BLOCK; i < end; i++) {
+        l = km->new_label[i] = km->label[i];
+        if (!task->full) {
+            bound = km->half[l] > km->lower[i] ? km->half[l] : km->lower[i];
+            if (km->upper[i] <= bound)
+                continue;
+            km->upper[i] = EuclideanDistance(km->X[i], km->c[l], km->n);
+            if (km->upper[i] <= bound)
+                continue;
+        }
+        AssignPoint(km, i);
+    }
+}
+
+/* It runs the assignment step over all points
+Parameters:
+s: search space
+km: k-means engine
+m: number of points
+full: 1 if the distances to all centers must be computed, 0 if the bounds may skip them */
+static void AssignPoints(SearchSpace *s, KMeans *km, int m, char full) {
+    KMeansTask task;
+
+    task.km = km;
+    task.m = m;
+    task.full = full;
+    ParallelFor(s, (m + KMEANS_BLOCK - 1) / KMEANS_BLOCK, AssignBlock, &task);
+}
+
+/* It moves the points whose cluster has changed at the last assignment step, and it updates the sums of the clusters
+Parameters:
+km: k-means engine
+m: number of points
+It returns the number of points that changed their cluster. */
+static int ApplyAssignment(KMeans *km, int m) {
+    int i, j, from, to, changed = 0;
+
+    for (i = 0; i < m; i++) {
+        from = km->label[i];
+        to = km->new_label[i];
+        if (from == to)
+            continue;
+        for (j = 0; j < km->n; j++) {
+            km->sum[from * km->n + j] -= km->X[i][j];
+            km->sum[to * km->n + j] += km->X[i][j];
+        }
+        km->count[from]--;
+        km->count[to]++;
+        km->label[i] = to;
+        changed++;
+    }
+
+    return changed;
+}
+
+/* It moves each center to the mean of its cluster (the centers of empty clusters are kept)
+Parameters:
+km: k-means engine
+It returns the largest distance moved by a center. */
+static double MoveCenters(KMeans *km) {
+    double mean, diff, dist, max_shift = 0;
+    int i, j;
+
+    for (i = 0; i < km->k; i++) {
+        dist = 0;
+        if (km->count[i]) {
+            for (j = 0; j < km->n; j++) {
+                mean = km->sum[i * km->n + j] / km->count[i];
+                diff = mean - km->c[i][j];
+                dist += diff * diff;
+                km->c[i][j] = mean;
+            }
+        }
+        km->shift[i] = sqrt(dist);
+        if (km->shift[i] > max_shift)
+            max_shift = km->shift[i];
+    }
+
+    return max_shift;
+}
+
+/* It computes half the distance from each center to the nearest other one
+Parameters:
+km: k-means engine */
+static void UpdateHalfDistances(KMeans *km) {
+    double *d = km->d; /* the distances of the first points are only needed during the assignment step */
+    int i, j;
+
+    for (i = 0; i < km->k; i++) {
+        km->half[i] = DBL_MAX;
+        EuclideanDistances(km->c[i], km->c, km->k, km->n, d);
+        for (j = 0; j < km->k; j++)
+            if ((j != i) && (0.5 * d[j] < km->half[i]))
+                km->half[i] = 0.5 * d[j];
+    }
+}
+
+/* It seeds the centers with k-means++, i.e., each center is a point drawn with probability proportional to its squared distance to the nearest center chosen so far
+Parameters:
+km: k-means engine
+m: number of points */
+static void SeedCenters(KMeans *km, int m) {
+    double *dmin = km->upper, *d = km->lower, total, r; /* the bounds are computed from scratch after seeding */
+    int i, j, chosen;
+
+    for (j = 0; j < km->k; j++) {
+        if (!j)
+            chosen = (int) GenerateUniformRandomNumber(0, m);
+        else {
+            total = 0;
+            for (i = 0; i < m; i++)
+                total += dmin[i];
+
+            if (total > 0) {
+                r = GenerateUniformRandomNumber(0, total);
+                for (chosen = 0; chosen < m - 1; chosen++) {
+                    if (r < dmin[chosen])
+                        break;
+                    r -= dmin[chosen];
+                }
+                while (!dmin[chosen]) /* it avoids picking a center twice due to rounding errors */
+                    chosen--;
+            }
+            else
+                chosen = (int) GenerateUniformRandomNumber(0, m); /* all points coincide with the centers */
+        }
+        if (chosen >= m)
+            chosen = m - 1;
+        memcpy(km->c[j], km->X[chosen], km->n * sizeof(double));
+
+        EuclideanDistances(km->c[j], km->X, m, km->n, d);
+        for (i = 0; i < m; i++) {
+            d[i] *= d[i];
+            if ((!j) || (d[i] < dmin[i]))
+                dmin[i] = d[i];
+        }
+    }
+}
+
+/* K-means-related functions */
+/* It creates a k-means engine
+Parameters:
+k: number of clusters
+n: number of dimensions
+capacity: maximum number of points to be clustered */
+KMeans *CreateKMeans(int k, int n, int capacity) {
+    if ((k < 1) || (n < 1) || (capacity < k)) {
+        fprintf(stderr, "\nInvalid input parameters @CreateKMeans.\n");
+        return NULL;
+    }
+
+    KMeans *km = NULL;
+    int i;
+
+    km = (KMeans *) malloc(sizeof(KMeans));
+    km->k = k;
+    km->n = n;
+    km->capacity = capacity;
+    km->max_iterations = KMEANS_MAX_ITERATIONS;
+    km->iterations = 0;
+    km->seeded = 0;
+
+    km->center = (double *) malloc(2 * k * n * sizeof(double));
+    km->sum = km->center + k * n;
+    km->c = (double **) malloc(k * sizeof(double *));
+    for (i = 0; i < k; i++)
+        km->c[i] = km->center + i * n;
+    km->count = (int *) malloc(k * sizeof(int));
+    km->shift = (double *) malloc(2 * k * sizeof(double));
+    km->half = km->shift + k;
+
+    km->label = (int *) malloc(2 * capacity * sizeof(int));
+    km->new_label = km->label + capacity;
+    km->upper = (double *) malloc(2 * capacity * sizeof(double));
+    km->lower = km->upper + capacity;
+    km->d = (double *) malloc((size_t) capacity * k * sizeof(double));
+    km->X = NULL;
+
+    return km;
+}
+
+/* It deallocates a k-means engine
+Parameters:
+km: address of the k-means engine to be deallocated */
+void DestroyKMeans(KMeans **km) {
+    KMeans *tmp = NULL;
+
+    tmp = *km;
+    if (!tmp) {
+        fprintf(stderr, "\nK-means engine not allocated @DestroyKMeans.\n");
+        exit(-1);
+    }
+
+    free(tmp->center);
+    free(tmp->c);
+    free(tmp->count);
+    free(tmp->shift);
+    free(tmp->label);
+    free(tmp->upper);
+    free(tmp->d);
+    free(tmp);
+    *km = NULL;
+}
+
+/* It discards the centers, so that the next call seeds them again
+Parameters:
+km: k-means engine */
+void ResetKMeans(KMeans *km) {
+    if (!km) {
+        fprintf(stderr, "\nK-means engine not allocated @ResetKMeans.\n");
+        exit(-1);
+    }
+
+    km->seeded = 0;
+}
+
+/* It clusters m points
+ * The centers are seeded with k-means++ at the first call (or after ResetKMeans), and the following calls start from the
+ * centers found by the previous one. The iterations stop when no point changes its cluster, or after km->max_iterations.
+ * Afterwards, km->label[i] stores the cluster of the i-th point, km->count[j] the number of points of the j-th cluster,
+ * and km->c[j] its center.
+Parameters:
+s: search space, whose threads run the assignment step
+km: k-means engine
+X: m points (km->n-dimensional arrays)
+m: number of points (km->k <= m <= km->capacity)
+It returns the number of Lloyd iterations. */
+int RunKMeans(SearchSpace *s, KMeans *km, double **X, int m) {
+    if ((!s) || (!km) || (!X)) {
+        fprintf(stderr, "\nInvalid input parameters @RunKMeans.\n");
+        exit(-1);
+    }
+    if ((m < km->k) || (m > km->capacity)) {
+        fprintf(stderr, "\nInvalid number of points @RunKMeans. It must be within [%d,%d].\n", km->k, km->capacity);
+        exit(-1);
+    }
+
+    int i, j;
+    double max_shift;
+
+    km->X = X;
+    if (!km->seeded) {
+        SeedCenters(km, m);
+        km->seeded = 1;
+    }
+
+    /* the points have moved since the last call, thus the first assignment computes all distances */
+    for (i = 0; i < m; i++)
+        km->label[i] = 0;
+    AssignPoints(s, km, m, 1);
+    memset(km->sum, 0, km->k * km->n * sizeof(double));
+    memset(km->count, 0, km->k * sizeof(int));
+    for (i = 0; i < m; i++) {
+        km->label[i] = km->new_label[i];
+        km->count[km->label[i]]++;
+        for (j = 0; j < km->n; j++)
+            km->sum[km->label[i] * km->n + j] += X[i][j];
+    }
+
+    for (km->iterations = 1; km->iterations < km->max_iterations;) {
+        max_shift = MoveCenters(km);
+        if (max_shift == 0)
+            break;
+
+        for (i = 0; i < m; i++) {
+            km->upper[i] += km->shift[km->label[i]];
+            km->lower[i] -= max_shift;
+        }
+        UpdateHalfDistances(km);
+
+        AssignPoints(s, km, m, 0);
+        km->iterations++;
+        if (!ApplyAssignment(km, m))
+            break;
+    }
+    MoveCenters(km); /* the centers are the means of the final clusters (it does nothing if they have converged) */
+    km->X = NULL;
+
+    return km->iterations;
+}
+/**************************/
@@ -15,11 +15,20 @@ limitations under the License.
 
 #include "common.h"
 #include "function.h"
+#include "parallel.h"
+#include "cache.h"
+#include "kernel.h"
+#include "telemetry.h"
+#include "profile.h"
 
 /* number of arguments (descendants) required by each terminal function in GP in the following order:
 SUM, SUB, MUL, DIV, EXP, SQRT, LOG, ABS, AND, OR, XOR, NOT, TSUM, TSUB, TMUL and TDIV */
 const int N_ARGS_FUNCTION[] = {2, 2, 2, 2, 1, 1, 1, 1, 2, 2, 2, 1, 2, 2, 2, 2};
 
+static long n_created_agents = 0; /* number of agents created by CreateAgent so far */
+
+#define DRAW_CHUNK 64 /* number of decision variables whose random numbers are drawn at once by DrawNewPosition */
+
 /* Agent-related functions */
 /* It creates an agent
 Parameters:
@@ -34,9 +43,12 @@ Agent *CreateAgent(int n, int opt_id, int tensor_dim) {
 
     Agent *a = NULL;
     a = (Agent *) malloc(sizeof(Agent));
+    __atomic_fetch_add(&n_created_agents, 1, __ATOMIC_RELAXED);
+    PROFILE_COUNT(_PROFILE_ALLOCATIONS_, 1);
     a->v = NULL;
     a->xl = NULL;
     a->fit = DBL_MAX;
+    a->view = 0;
     a->t = NULL;
     a->t_v = NULL;
     a->t_xl = NULL;
@@ -53,6 +65,10 @@ Agent *CreateAgent(int n, int opt_id, int tensor_dim) {
     a->genotype = NULL;
     a->input_values = NULL;
     a->output_nodes = NULL;
+    a->active_mask = NULL;
+    a->active = NULL;
+    a->n_active = 0;
+    a->node_values = NULL;
 
     switch (opt_id) {
         case _PSO_:
@@ -120,6 +136,12 @@ void DestroyAgent(Agent **a, int opt_id) {
         exit(-1);
     }
 
+    if (tmp->view) { /* these arrays belong to the search space */
+        tmp->x = NULL;
+        tmp->v = NULL;
+        tmp->xl = NULL;
+    }
+
     switch (opt_id) {
         case _PSO_:
         case _BA_:
@@ -175,6 +197,12 @@ void DestroyAgent(Agent **a, int opt_id) {
                 free(tmp->genotype);
             if(tmp->input_values)
                 free(tmp->input_values);
+            if(tmp->active_mask)
+                free(tmp->active_mask);
+            if(tmp->active)
+                free(tmp->active);
+            if(tmp->node_values)
+                free(tmp->node_values);
             break;
 
         default:
@@ -197,12 +225,14 @@ void CheckAgentLimits(SearchSpace *s, Agent *a) {
 
     int j;
 
+    PROFILE_BEGIN(_PROFILE_LIMITS_);
     for (j = 0; j < a->n; j++) {
         if (a->x[j] < s->LB[j])
             a->x[j] = s->LB[j];
         else if (a->x[j] > s->UB[j])
             a->x[j] = s->UB[j];
     }
+    PROFILE_END(_PROFILE_LIMITS_);
 }
 
 /* It copies an agent
@@ -218,6 +248,7 @@ Agent *CopyAgent(Agent *a, int opt_id, int tensor_dim) {
     }
 
     Agent *cpy = NULL;
+    PROFILE_BEGIN(_PROFILE_COPY_);
     cpy = CreateAgent(a->n, opt_id, tensor_dim);
 
     switch (opt_id) {
@@ -243,18 +274,92 @@ Agent *CopyAgent(Agent *a, int opt_id, int tensor_dim) {
                 memcpy(cpy->xl, a->xl, a->n * sizeof(double));
             if (opt_id == _FA_ || opt_id == _JADE_ || opt_id == _COBIDE_ || opt_id == _BSA_ || opt_id == _DE_)
                 cpy->fit = a->fit;
+            PROFILE_COUNT(_PROFILE_BYTES_COPIED_, (opt_id == _PSO_ ? 3 : 2) * a->n * sizeof(double));
             break;
 
         default:
             fprintf(stderr, "\nInvalid optimization identifier @CopyAgent.\n");
             DestroyAgent(&cpy, opt_id);
-            return NULL;
             break;
     }
+    PROFILE_END(_PROFILE_COPY_);
 
     return cpy;
 }
 
+/* It copies an agent into another one that has already been allocated (it copies the same content as CopyAgent does)
+Parameters:
+dst: agent that receives the copy
+a: agent to be copied
+opt_id: identifier of the optimization technique */
+void CopyAgentInto(Agent *dst, Agent *a, int opt_id) {
+    if ((!dst) || (!a)) {
+        fprintf(stderr, "\nAgent not allocated @CopyAgentInto.\n");
+        exit(-1);
+    }
+
+    PROFILE_BEGIN(_PROFILE_COPY_);
+    switch (opt_id) {
+        case _PSO_:
+        case _BA_:
+        case _FPA_:
+        case _FA_:
+        case _CS_:
+        case _GA_:
+        case _BHA_:
+        case _WCA_:
+        case _ABC_:
+        case _JADE_:
+        case _COBIDE_:
+        case _BSA_:
+        case _ABO_:
+        case _HS_:
+        case _DE_:
+        case _SA_:
+            memcpy(dst->x, a->x, a->n * sizeof(double));
+            if ((dst->v) && (a->v))
+                memcpy(dst->v, a->v, a->n * sizeof(double));
+            if (opt_id == _PSO_)
+                memcpy(dst->xl, a->xl, a->n * sizeof(double));
+            if (opt_id == _FA_ || opt_id == _JADE_ || opt_id == _COBIDE_ || opt_id == _BSA_ || opt_id == _DE_)
+                dst->fit = a->fit;
+            PROFILE_COUNT(_PROFILE_BYTES_COPIED_, (1 + ((dst->v) && (a->v)) + (opt_id == _PSO_)) * a->n * sizeof(double));
+            break;
+
+        default:
+            fprintf(stderr, "\nInvalid optimization identifier @CopyAgentInto.\n");
+            break;
+    }
+    PROFILE_END(_PROFILE_COPY_);
+}
+
+/* It resets an agent to the state of a newly created one, i.e., null arrays and default values
+Parameters:
+a: agent */
+void ResetAgent(Agent *a) {
+    if (!a) {
+        fprintf(stderr, "\nAgent not allocated @ResetAgent.\n");
+        exit(-1);
+    }
+
+    if (a->x) memset(a->x, 0, a->n * sizeof(double));
+    if (a->v) memset(a->v, 0, a->n * sizeof(double));
+    if (a->xl) memset(a->xl, 0, a->n * sizeof(double));
+    if (a->prev_x) memset(a->prev_x, 0, a->n * sizeof(double));
+    a->fit = DBL_MAX;
+    a->pfit = DBL_MAX;
+    a->best_fit = DBL_MAX;
+    a->f = NAN;
+    a->r = NAN;
+    a->A = NAN;
+}
+
+/* It returns the number of agents created so far by CreateAgent (and thus by CopyAgent and GenerateNewAgent)
+ * Comparing two readings tells how many agents a piece of code allocates, e.g., zero for an iteration that only uses pooled agents. */
+long GetAgentAllocationCount() {
+    return __atomic_load_n(&n_created_agents, __ATOMIC_RELAXED);
+}
+
 /* It evaluate an agent according to each technique
 Parameters:
 s: search space
@@ -263,29 +368,41 @@ opt_id: identifier of optimization technique
 Evaluate: pointer to the function used to evaluate
 arg: list of additional arguments */
 void EvaluateAgent(SearchSpace *s, Agent *a, int opt_id, prtFun Evaluate, va_list arg)
+{
+    Evaluator e;
+
+    InitEvaluator(&e, s, Evaluate, arg);
+    EvaluateAgentWith(s, a, opt_id, &e);
+    DestroyEvaluator(&e);
+}
+
+/* It evaluate an agent according to each technique using a fitness evaluator
+Parameters:
+s: search space
+a: agent
+opt_id: identifier of optimization technique
+e: fitness evaluator */
+void EvaluateAgentWith(SearchSpace *s, Agent *a, int opt_id, Evaluator *e)
 {
     if (opt_id < 1) // invalid opt_id
     {
-      fprintf(stderr, "\nInvalid optimization identifier @EvaluateAgent.\n");
+      fprintf(stderr, "\nInvalid optimization identifier @EvaluateAgentWith.\n");
       return;
     }
 
     if (a == NULL) // not allocated agent
     {
-        fprintf(stderr, "\nNull pointer to Agent @EvaluateAgent.\n");				
+        fprintf(stderr, "\nNull pointer to Agent @EvaluateAgentWith.\n");
         return;
     }
 
     int i;
-    double eva;
-    va_list argtmp;
-
-    va_copy(argtmp, arg);
 
+    PROFILE_BEGIN(_PROFILE_EVALUATION_);
     switch (opt_id) {
         case _COBIDE_:
         case _JADE_:
-            a->fit = Evaluate(a, arg); /* It executes the fitness function for agent  */
+            a->fit = ComputeFitness(e, a); /* It executes the fitness function for agent  */
 
             if (a->fit < s->gfit) { /* It updates the global best value and position */
                 s->best = i;
@@ -302,7 +419,7 @@ void EvaluateAgent(SearchSpace *s, Agent *a, int opt_id, prtFun Evaluate, va_lis
             for (i = 0; i < s->n; i++)
                 a->prev_x[i] = a->x[i];
 
-            a->fit = Evaluate(a, arg);
+            a->fit = ComputeFitness(e, a);
 
             /* if the actual fit is the best fitness so far of the agent */
             if (a->fit < a->best_fit) {
@@ -321,7 +438,7 @@ void EvaluateAgent(SearchSpace *s, Agent *a, int opt_id, prtFun Evaluate, va_lis
             break;
         case _SA_:
         case _CGP_:
-            a->fit = Evaluate(a, arg);
+            a->fit = ComputeFitness(e, a);
             /* If the actual position is the best solution so far */
             if (a->fit < s->gfit)
             {
@@ -331,9 +448,204 @@ void EvaluateAgent(SearchSpace *s, Agent *a, int opt_id, prtFun Evaluate, va_lis
             }
             break;
     }
+    PROFILE_END(_PROFILE_EVALUATION_);
+}
+
+/* It calls the fitness function of an evaluator on an agent, bypassing the fitness cache
+Parameters:
+e: fitness evaluator
+a: agent */
+static double CallFitness(Evaluator *e, Agent *a) {
+    va_list arg;
+    double f;
+
+    __atomic_fetch_add(&e->evaluations, 1, __ATOMIC_RELAXED);
+    if (e->f_b) { /* a batch with a single decision vector */
+        e->f_b(a->x, 1, a->n, &f, e->ctx_b);
+        return f;
+    }
+
+    if (e->f_r)
+        return e->f_r(a->x, a->n, e->ctx);
+
+    va_copy(arg, e->arg); /* each call gets its own copy of the list of additional arguments */
+    f = e->f(a, arg);
+    va_end(arg);
+
+    return f;
+}
+
+/* It defines the arguments shared by the tasks of EvaluateAgents */
+typedef struct EvaluationTask_{
+    Agent **a; /* agents to be evaluated */
+    Evaluator *e; /* fitness evaluator */
+    double *f; /* output fitness values */
+}EvaluationTask;
+
+/* It evaluates the i-th agent of an evaluation task
+Parameters:
+i: index of the agent
+arg: evaluation task */
+static void EvaluateAgentTask(int i, void *arg) {
+    EvaluationTask *task = (EvaluationTask *) arg;
+
+    task->f[i] = CallFitness(task->e, task->a[i]);
+}
+
+/* It computes the fitness values of a set of agents without consulting the fitness cache (see EvaluateAgents)
+Parameters:
+s: search space
+a: array of agents
+m: number of agents
+e: fitness evaluator
+f: output array with m fitness values */
+static void CallFitnessOfAgents(SearchSpace *s, Agent **a, int m, Evaluator *e, double *f) {
+    EvaluationTask task;
+    int i;
+
+    if (e->f_b) { /* the decision vectors are gathered row by row and evaluated at once */
+        for (i = 0; (s->block_x) && (i < m) && (a[i]->x == s->block_x + i * s->n); i++);
+        e->evaluations += m;
+        if (i == m) { /* the agents are the rows of the search space's block in order, so no copy is needed */
+            e->f_b(s->block_x, m, s->n, f, e->ctx_b);
+            return;
+        }
+
+        if (e->size < m * s->n) {
+            free(e->X);
+            e->size = m * s->n;
+            e->X = (double *) malloc(e->size * sizeof(double));
+        }
+        for (i = 0; i < m; i++)
+            memcpy(e->X + i * s->n, a[i]->x, s->n * sizeof(double));
+        e->f_b(e->X, m, s->n, f, e->ctx_b);
+        return;
+    }
+
+    task.a = a;
+    task.e = e;
+    task.f = f;
+
+    ParallelFor(s, m, EvaluateAgentTask, &task);
+}
+
+/* It computes the fitness values of a set of agents (concurrently if s->n_threads > 1)
+ * If a batch function has been registered, the agents are evaluated by a single call to it, instead.
+ * If the evaluator has a fitness cache, only the agents whose positions are not cached are evaluated, and their fitness values are cached.
+ * This function does not update neither the agents nor the global best, so that
+ * the caller can perform such reduction serially and obtain the same results of a serial evaluation.
+Parameters:
+s: search space
+a: array of agents
+m: number of agents
+e: fitness evaluator
+f: output array with m fitness values */
+void EvaluateAgents(SearchSpace *s, Agent **a, int m, Evaluator *e, double *f) {
+    if ((!s) || (!a) || (!e) || (!f)) {
+        fprintf(stderr, "\nInvalid input parameters @EvaluateAgents.\n");
+        exit(-1);
+    }
+
+    Agent **miss = NULL;
+    double *f_miss = NULL;
+    int *index = NULL, i, k = 0;
+
+    PROFILE_BEGIN(_PROFILE_FITNESS_);
+    if (!e->cache) {
+        CallFitnessOfAgents(s, a, m, e, f);
+        PROFILE_END(_PROFILE_FITNESS_);
+        return;
+    }
+
+    /* The arrays of missed agents are kept by the evaluator, and they are only reallocated when m grows */
+    if (e->miss_size < m) {
+        free(e->miss);
+        free(e->f_miss);
+        free(e->index);
+        e->miss_size = m;
+        e->miss = (Agent **) malloc(m * sizeof(Agent *));
+        e->f_miss = (double *) malloc(m * sizeof(double));
+        e->index = (int *) malloc(m * sizeof(int));
+    }
+    miss = e->miss;
+    f_miss = e->f_miss;
+    index = e->index;
+    for (i = 0; i < m; i++) {
+        if (!LookupFitness(e->cache, a[i]->x, &f[i])) {
+            miss[k] = a[i];
+            index[k++] = i;
+        }
+    }
+
+    if (k) {
+        CallFitnessOfAgents(s, miss, k, e, f_miss);
+        for (i = 0; i < k; i++) {
+            f[index[i]] = f_miss[i];
+            InsertFitness(e->cache, miss[i]->x, f_miss[i]);
+        }
+    }
+
+    PROFILE_END(_PROFILE_FITNESS_);
+}
+
+/* It draws the decision variables of a newly generated agent into an array (only BA and HS positions are drawn, the others are left untouched)
+Parameters:
+s: search space
+x: output n-dimensional array (it must not be the position of an agent of s)
+opt_id: identifier of the optimization technique */
+void DrawNewPosition(SearchSpace *s, double *x, int opt_id) {
+    int i, j, k;
+    double r, signal, u[5 * DRAW_CHUNK];
 
-    va_copy(arg, argtmp);
+    switch (opt_id) {
+        case _BA_:
+            /* The factor 0.001 limits the step sizes of random walks */
+            FillUniform(x, s->n, 0, 0.001);
+            for (j = 0; j < s->n; j++)
+                x[j] += s->g[j];
+            break;
+        case _HS_:
+            /* Random numbers are drawn in chunks of DRAW_CHUNK variables: five per decision variable, some of which may be left unused */
+            for (j = 0; j < s->n; j++) {
+                if (!(j % DRAW_CHUNK))
+                    FillUniform(u, 5 * (s->n - j < DRAW_CHUNK ? s->n - j : DRAW_CHUNK), 0, 1);
+                k = 5 * (j % DRAW_CHUNK);
+                r = u[k];
+                if (s->HMCR >= r) {
+                    i = (int) (u[k + 1] * s->m);
+                    r = u[k + 2];
+                    x[j] = s->a[i]->x[j];
+                    if (s->PAR >= r) {
+                        signal = u[k + 3];
+                        r = u[k + 4];
+                        if (signal >= 0.5)
+                            x[j] = s->a[i]->x[j] + r * s->bw;
+                        else
+                            x[j] = s->a[i]->x[j] - r * s->bw;
+                    }
+                } else {
+                    r = (s->UB[j] - s->LB[j]) * u[k + 1] + s->LB[j];
+                    x[j] = r;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
 
+/* It allocates the structures of a CGP agent that are not allocated by CreateAgent
+Parameters:
+s: search space
+a: agent */
+static void AllocateCGPStructures(SearchSpace *s, Agent *a) {
+    a->output_nodes = (int *) malloc(s->n * sizeof(int));
+    a->genotype = (CGP_Node *) malloc(s->n_columns * s->n_rows * sizeof(CGP_Node));
+    a->input_values = (double *) malloc(s->n_input_values * sizeof(double));
+    a->active_mask = (char *) calloc(s->n_columns * s->n_rows, sizeof(char));
+    a->active = (int *) malloc(s->n_columns * s->n_rows * sizeof(int));
+    a->n_active = 0;
+    a->node_values = (double *) calloc(s->n_columns * s->n_rows + s->n_input_values, sizeof(double));
 }
 
 /* It generates a new agent according to each technique
@@ -347,8 +659,6 @@ Agent *GenerateNewAgent(SearchSpace *s, int opt_id) {
     }
 
     Agent *a = NULL;
-    int i, j;
-    double r, signal;
 
     switch (opt_id) {
         case _DE_:
@@ -358,10 +668,7 @@ Agent *GenerateNewAgent(SearchSpace *s, int opt_id) {
             break;
         case _BA_:
             a = CreateAgent(s->n, _BA_, _NOTENSOR_);
-
-            /* The factor 0.001 limits the step sizes of random walks */
-            for (j = 0; j < s->n; j++)
-                a->x[j] = s->g[j] + 0.001 * GenerateUniformRandomNumber(0, 1);
+            DrawNewPosition(s, a->x, _BA_);
             break;
         case _FPA_:
             break;
@@ -397,33 +704,11 @@ Agent *GenerateNewAgent(SearchSpace *s, int opt_id) {
             break;
         case _HS_:
             a = CreateAgent(s->n, _HS_, _NOTENSOR_);
-
-            for (j = 0; j < s->n; j++) {
-                r = GenerateUniformRandomNumber(0, 1);
-                if (s->HMCR >= r) {
-                    i = GenerateUniformRandomNumber(0, s->m);
-                    r = GenerateUniformRandomNumber(0, 1);
-                    a->x[j] = s->a[i]->x[j];
-                    if (s->PAR >= r) {
-                        signal = GenerateUniformRandomNumber(0, 1);
-                        r = GenerateUniformRandomNumber(0, 1);
-                        if (signal >= 0.5)
-                            a->x[j] = s->a[i]->x[j] + r * s->bw;
-                        else
-                            a->x[j] = s->a[i]->x[j] - r * s->bw;
-                    }
-                } else {
-                    r = (s->UB[j] - s->LB[j]) * GenerateUniformRandomNumber(0, 1) + s->LB[j];
-                    a->x[j] = r;
-                }
-            }
+            DrawNewPosition(s, a->x, _HS_);
             break;
         case _CGP_:
             a = CreateAgent(s->n, _CGP_, _NOTENSOR_);    
-
-            a->output_nodes = (int *) malloc(s->n * sizeof(int));
-            a->genotype = (CGP_Node *) malloc(s->n_columns * s->n_rows * sizeof(CGP_Node));
-            a->input_values = (double *) malloc(s->n_input_values * sizeof(double));
+            AllocateCGPStructures(s, a);
 
             break;
 
@@ -438,6 +723,7 @@ Agent *GenerateNewAgent(SearchSpace *s, int opt_id) {
 
 
 /* It copies the agents from s to oldS
+ * The positions, fitness values and tensors are copied in place, so that no agent is allocated.
 Parameters:
 s: source search space
 oldS: destination search space
@@ -456,114 +742,518 @@ void CopySearchSpaceAgents(SearchSpace *s, SearchSpace *oldS, int opt_id, int te
     }
 
     for (j = 0; j < oldS->m; j++) {
-
-        if (oldS->a[j]->t && tensor_id > 0) DestroyTensor(&(oldS->a[j]->t), oldS->n);
-        DestroyAgent(&(oldS->a[j]), opt_id);
-        oldS->a[j] = CopyAgent(s->a[j], opt_id, tensor_id);
-        if (s->a[j]->t && tensor_id > 0) oldS->a[j]->t = CopyTensor(s->a[j]->t, s->n, tensor_id);
+        memcpy(oldS->a[j]->x, s->a[j]->x, s->n * sizeof(double));
+        oldS->a[j]->fit = s->a[j]->fit;
+        if (s->a[j]->t && tensor_id > 0) {
+            if (!oldS->a[j]->t) oldS->a[j]->t = CreateTensor(s->n, tensor_id);
+            for (k = 0; k < s->n; k++)
+                memcpy(oldS->a[j]->t[k], s->a[j]->t[k], tensor_id * sizeof(double));
+        }
     }
 }
 
 /* It performs a SearchSpace permutation
+ * The agents are exchanged by their pointers, and their tensors go along with them.
 Parameters:
 s: search space
 opt_id: identifier of the optimization technique
 tensor_dim: identifier of tensor's dimension*/
 void TensorPermutation(SearchSpace *s, int opt_id, int tensor_dim) {
-    int i;
+    Permutation(s, opt_id, tensor_dim);
+}
+
+/* It performs a SearchSpace permutation
+ * The agents are exchanged by their pointers, so that no agent is copied.
+Parameters:
+s: search space
+opt_id: identifier of the optimization technique
+tensor_dim: identifier of tensor's dimension*/
+void Permutation(SearchSpace *s, int opt_id, int tensor_dim) {
+    int i, r;
+    Agent *tmp = NULL;
 
     if (!s) {
         fprintf(stderr, "\nSearch space not allocated @Permutation.\n");
         exit(-1);
     }
-    Agent *tmp = NULL;
-    double **t = NULL;
+
     for (i = 0; i < s->m; i++) {
         //generate a random position
-        int r = rand() % s->m;
+        r = (int) GenerateUniformRandomNumber(0, s->m);
         if (r != i) {
-            tmp = CopyAgent(s->a[i], opt_id, tensor_dim);
-            t = CopyTensor(s->a[i]->t, s->n, tensor_dim);
+            tmp = s->a[i];
+            s->a[i] = s->a[r];
+            s->a[r] = tmp;
+        }
+    }
+}
 
-            DestroyTensor(&(s->a[i]->t), s->n);
-            DestroyAgent(&(s->a[i]), opt_id);
+/**************************/
+
+/* Agent pool-related functions */
+/* It returns the pool of scratch agents of a search space, creating it if needed
+Parameters:
+s: search space
+opt_id: identifier of the optimization technique */
+static AgentPool *GetAgentPool(SearchSpace *s, int opt_id) {
+    AgentPool *p = s->agent_pool;
+
+    if (!p) {
+        p = (AgentPool *) malloc(sizeof(AgentPool));
+        p->opt_id = opt_id;
+        p->agent = NULL;
+        p->available = NULL;
+        p->size = p->n_available = p->capacity = 0;
+        p->n_borrowed = 0;
+        s->agent_pool = p;
+    }
 
-            s->a[i] = CopyAgent(s->a[r], opt_id, tensor_dim);
-            s->a[i]->t = CopyTensor(s->a[r]->t, s->n, tensor_dim);
+    return p;
+}
 
-            DestroyTensor(&(s->a[r]->t), s->n);
-            DestroyAgent(&(s->a[r]), opt_id);
+/* It borrows a scratch agent from the pool of a search space
+ * The agent is reset as in ResetAgent, and it belongs to the pool: it must be given back with ReturnAgent (or ResetAgentPool), never deallocated.
+ * A new agent is created only when every agent of the pool is borrowed, so the pool stops growing after the first iteration of a loop.
+ * The pool is not thread-safe, and all agents borrowed from it must use the same optimization technique.
+Parameters:
+s: search space
+opt_id: identifier of the optimization technique (tensors are not supported) */
+Agent *BorrowAgent(SearchSpace *s, int opt_id) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @BorrowAgent.\n");
+        exit(-1);
+    }
 
+    AgentPool *p = GetAgentPool(s, opt_id);
+    Agent *a = NULL;
 
-            s->a[r] = CopyAgent(tmp, opt_id, tensor_dim);
-            s->a[r]->t = CopyTensor(t, s->n, tensor_dim);
+    if ((opt_id == _SA_) || (opt_id == _LOA_) || (opt_id == _GP_) || (opt_id == _TGP_) || (opt_id != p->opt_id)) {
+        fprintf(stderr, "\nInvalid optimization identifier @BorrowAgent.\n");
+        return NULL;
+    }
 
-            DestroyTensor(&(t), s->n);
-            DestroyAgent(&tmp, opt_id);
+    if (p->n_available) {
+        a = p->available[--p->n_available];
+        ResetAgent(a);
+    } else {
+        a = CreateAgent(s->n, opt_id, _NOTENSOR_);
+        if (opt_id == _CGP_)
+            AllocateCGPStructures(s, a);
+        if (p->size == p->capacity) {
+            p->capacity = p->capacity ? 2 * p->capacity : 8;
+            p->agent = (Agent **) realloc(p->agent, p->capacity * sizeof(Agent *));
+            p->available = (Agent **) realloc(p->available, p->capacity * sizeof(Agent *));
         }
+        p->agent[p->size++] = a;
+    }
+    p->n_borrowed++;
+
+    return a;
+}
+
+/* It borrows a scratch agent holding a copy of a given agent (see CopyAgent)
+Parameters:
+s: search space
+a: agent to be copied
+opt_id: identifier of the optimization technique */
+Agent *BorrowAgentCopy(SearchSpace *s, Agent *a, int opt_id) {
+    if (!a) {
+        fprintf(stderr, "\nAgent not allocated @BorrowAgentCopy.\n");
+        exit(-1);
     }
 
+    Agent *cpy = BorrowAgent(s, opt_id);
 
+    if (cpy)
+        CopyAgentInto(cpy, a, opt_id);
+
+    return cpy;
 }
 
-/* It performs a SearchSpace permutation
+/* It borrows a scratch agent generated as in GenerateNewAgent
 Parameters:
 s: search space
-opt_id: identifier of the optimization technique
-tensor_dim: identifier of tensor's dimension*/
-void Permutation(SearchSpace *s, int opt_id, int tensor_dim) {
-    int i;
+opt_id: identifier of the optimization technique */
+Agent *BorrowNewAgent(SearchSpace *s, int opt_id) {
+    Agent *a = BorrowAgent(s, opt_id);
 
-    if (!s) {
-        fprintf(stderr, "\nSearch space not allocated @Permutation.\n");
+    if (a)
+        DrawNewPosition(s, a->x, opt_id);
+
+    return a;
+}
+
+/* It gives a borrowed agent back to the pool of a search space
+Parameters:
+s: search space
+a: address of the borrowed agent (it is set to NULL) */
+void ReturnAgent(SearchSpace *s, Agent **a) {
+    if ((!s) || (!s->agent_pool) || (!a) || (!*a)) {
+        fprintf(stderr, "\nInvalid input parameters @ReturnAgent.\n");
         exit(-1);
     }
-    Agent *tmp = NULL;
-    for (i = 0; i < s->m; i++) {
-        //generate a random position
-        int r = rand() % s->m;
-        if (r != i) {
-            tmp = CopyAgent(s->a[i], opt_id, tensor_dim);
-            DestroyAgent(&(s->a[i]), opt_id);
-            s->a[i] = CopyAgent(s->a[r], opt_id, tensor_dim);
-            DestroyAgent(&(s->a[r]), opt_id);
-            s->a[r] = CopyAgent(tmp, opt_id, tensor_dim);
 
-            DestroyAgent(&tmp, opt_id);
-        }
+    AgentPool *p = s->agent_pool;
+
+    if (p->n_available == p->size) {
+        fprintf(stderr, "\nAgent not borrowed from this pool @ReturnAgent.\n");
+        exit(-1);
     }
+
+    p->available[p->n_available++] = *a;
+    *a = NULL;
 }
 
-/**************************/
+/* It gives all borrowed agents back to the pool of a search space at once, e.g., at the end of an iteration
+ * Pointers to the borrowed agents must not be used afterwards.
+Parameters:
+s: search space */
+void ResetAgentPool(SearchSpace *s) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @ResetAgentPool.\n");
+        exit(-1);
+    }
 
-/* Search Space-related functions */
-/* It creates a search space
+    AgentPool *p = s->agent_pool;
+
+    if (!p)
+        return;
+
+    memcpy(p->available, p->agent, p->size * sizeof(Agent *));
+    p->n_available = p->size;
+}
+
+/* It deallocates a pool of agents and all agents it owns (borrowed ones included)
 Parameters:
-m: number of agents
-n: number of decision variables
-opt_id: identifier of the optimization technique
-additional parameters: related to each technique
-PSO, BA, FPA and FA: do not require additional parameters
-GP: it requires the minimum and maximum depth of a tree, number of terminals and a matrix (char **) with the terminals' names
-Tensor-based approaches require the number of dimensions of the tensor, i.e., if it is a quaternion, octonion or sedenion */
-SearchSpace *CreateSearchSpace(int m, int n, int opt_id, ...) {
-    SearchSpace *s = NULL;
-    va_list arg;
+p: address of the pool to be deallocated */
+void DestroyAgentPool(AgentPool **p) {
+    AgentPool *tmp = NULL;
+    int i;
 
-    if ((m < 1) || (n < 1) || (opt_id < 1)) {
-        fprintf(stderr, "\nInvalid parameters @CreateSearchSpace.\n");
-        return NULL;
+    tmp = *p;
+    if (!tmp) {
+        fprintf(stderr, "\nAgent pool not allocated @DestroyAgentPool.\n");
+        exit(-1);
     }
-    int i, j, remained_lions, tensor_dim;
 
-    va_start(arg, opt_id);
-    s = (SearchSpace *) malloc(sizeof(SearchSpace));
-    s->m = m;
-    s->n = n;
-    s->gfit = DBL_MAX;
+    for (i = 0; i < tmp->size; i++)
+        DestroyAgent(&(tmp->agent[i]), tmp->opt_id);
+    if (tmp->agent) free(tmp->agent);
+    if (tmp->available) free(tmp->available);
+
+    free(tmp);
+    *p = NULL;
+}
+/**************************/
+
+/* Fitness heap-related functions */
+/* It moves an entry of a fitness heap up until its parent is not better than it
+Parameters:
+s: search space
+h: fitness heap
+k: position of the entry */
+static void SiftUpFitnessHeap(SearchSpace *s, FitnessHeap *h, int k) {
+    int i = h->heap[k], parent;
+
+    while (k > 0) {
+        parent = (k - 1) / 2;
+        if (!(s->a[i]->fit > s->a[h->heap[parent]]->fit))
+            break;
+        h->heap[k] = h->heap[parent];
+        h->pos[h->heap[k]] = k;
+        k = parent;
+    }
+    h->heap[k] = i;
+    h->pos[i] = k;
+}
+
+/* It moves an entry of a fitness heap down until none of its children is worse than it
+Parameters:
+s: search space
+h: fitness heap
+k: position of the entry */
+static void SiftDownFitnessHeap(SearchSpace *s, FitnessHeap *h, int k) {
+    int i = h->heap[k], child;
+
+    while ((child = 2 * k + 1) < h->m) {
+        if ((child + 1 < h->m) && (s->a[h->heap[child + 1]]->fit > s->a[h->heap[child]]->fit))
+            child++;
+        if (!(s->a[h->heap[child]]->fit > s->a[i]->fit))
+            break;
+        h->heap[k] = h->heap[child];
+        h->pos[h->heap[k]] = k;
+        k = child;
+    }
+    h->heap[k] = i;
+    h->pos[i] = k;
+}
+
+/* It creates a max-heap of the agents of a search space on their fitness values
+ * The heap refers to the agents by their indices in s->a, so it remains valid if an agent is replaced by another one,
+ * as long as UpdateFitnessHeap is called afterwards.
+Parameters:
+s: search space */
+FitnessHeap *CreateFitnessHeap(SearchSpace *s) {
+    if ((!s) || (!s->a)) {
+        fprintf(stderr, "\nSearch space not allocated @CreateFitnessHeap.\n");
+        return NULL;
+    }
+
+    FitnessHeap *h = NULL;
+    int i;
+
+    h = (FitnessHeap *) malloc(sizeof(FitnessHeap));
+    h->m = s->m;
+    h->heap = (int *) malloc(2 * s->m * sizeof(int));
+    h->pos = h->heap + s->m;
+    for (i = 0; i < s->m; i++)
+        h->heap[i] = h->pos[i] = i;
+    for (i = s->m / 2 - 1; i >= 0; i--)
+        SiftDownFitnessHeap(s, h, i);
+
+    return h;
+}
+
+/* It deallocates a fitness heap
+Parameters:
+h: address of the fitness heap to be deallocated */
+void DestroyFitnessHeap(FitnessHeap **h) {
+    FitnessHeap *tmp = NULL;
+
+    tmp = *h;
+    if (!tmp) {
+        fprintf(stderr, "\nFitness heap not allocated @DestroyFitnessHeap.\n");
+        exit(-1);
+    }
+
+    free(tmp->heap);
+    free(tmp);
+    *h = NULL;
+}
+
+/* It returns the index of the agent with the largest fitness value
+Parameters:
+h: fitness heap */
+int GetWorstAgent(FitnessHeap *h) {
+    if (!h) {
+        fprintf(stderr, "\nFitness heap not allocated @GetWorstAgent.\n");
+        exit(-1);
+    }
+
+    return h->heap[0];
+}
+
+/* It restores the heap after the fitness value of the i-th agent has changed
+Parameters:
+s: search space
+h: fitness heap
+i: index of the agent */
+void UpdateFitnessHeap(SearchSpace *s, FitnessHeap *h, int i) {
+    if ((!s) || (!h) || (i < 0) || (i >= h->m)) {
+        fprintf(stderr, "\nInvalid input parameters @UpdateFitnessHeap.\n");
+        exit(-1);
+    }
+
+    SiftUpFitnessHeap(s, h, h->pos[i]);
+    SiftDownFitnessHeap(s, h, h->pos[i]);
+}
+/**************************/
+
+/* Evaluator-related functions */
+/* It initializes a fitness evaluator with an agent-based function
+Parameters:
+e: fitness evaluator
+s: search space (its batch function, if any, is used instead of Evaluate)
+Evaluate: pointer to the function used to evaluate agents
+arg: list of additional arguments (it is copied, so the caller may release it only after DestroyEvaluator) */
+void InitEvaluator(Evaluator *e, SearchSpace *s, prtFun Evaluate, va_list arg) {
+    if ((!e) || (!Evaluate)) {
+        fprintf(stderr, "\nInvalid input parameters @InitEvaluator.\n");
+        exit(-1);
+    }
+
+    e->f = Evaluate;
+    va_copy(e->arg, arg);
+    e->f_r = NULL;
+    e->ctx = NULL;
+    e->f_b = s ? s->batch : NULL;
+    e->ctx_b = s ? s->batch_ctx : NULL;
+    e->X = NULL;
+    e->size = 0;
+    e->miss = NULL;
+    e->f_miss = NULL;
+    e->index = NULL;
+    e->miss_size = 0;
+    e->cache = s ? s->cache : NULL;
+    e->evaluations = 0;
+    e->start = GetWallTime();
+}
+
+/* It initializes a fitness evaluator with a reentrant function
+Parameters:
+e: fitness evaluator
+s: search space (its batch function, if any, is used instead of Evaluate)
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void InitEvaluator_r(Evaluator *e, SearchSpace *s, prtFun_r Evaluate, void *ctx) {
+    if ((!e) || (!Evaluate)) {
+        fprintf(stderr, "\nInvalid input parameters @InitEvaluator_r.\n");
+        exit(-1);
+    }
+
+    e->f = NULL;
+    e->f_r = Evaluate;
+    e->ctx = ctx;
+    e->f_b = s ? s->batch : NULL;
+    e->ctx_b = s ? s->batch_ctx : NULL;
+    e->X = NULL;
+    e->size = 0;
+    e->miss = NULL;
+    e->f_miss = NULL;
+    e->index = NULL;
+    e->miss_size = 0;
+    e->cache = s ? s->cache : NULL;
+    e->evaluations = 0;
+    e->start = GetWallTime();
+}
+
+/* It releases the resources held by a fitness evaluator
+Parameters:
+e: fitness evaluator */
+void DestroyEvaluator(Evaluator *e) {
+    if (!e) {
+        fprintf(stderr, "\nEvaluator not allocated @DestroyEvaluator.\n");
+        exit(-1);
+    }
+
+    if (e->f) va_end(e->arg);
+    if (e->X) free(e->X);
+    if (e->miss) free(e->miss);
+    if (e->f_miss) free(e->f_miss);
+    if (e->index) free(e->index);
+    e->f = NULL;
+    e->f_r = NULL;
+    e->f_b = NULL;
+    e->X = NULL;
+    e->size = 0;
+    e->miss = NULL;
+    e->f_miss = NULL;
+    e->index = NULL;
+    e->miss_size = 0;
+    e->cache = NULL;
+}
+
+/* It computes the fitness value of an agent
+ * The fitness cache, if any, is consulted first, and it stores the computed value afterwards. The evaluator itself is not changed,
+ * so this function can be called by several threads at the same time.
+Parameters:
+e: fitness evaluator
+a: agent */
+double ComputeFitness(Evaluator *e, Agent *a) {
+    double f;
+
+    PROFILE_BEGIN(_PROFILE_FITNESS_);
+    if ((!e->cache) || (!LookupFitness(e->cache, a->x, &f))) {
+        f = CallFitness(e, a);
+        if (e->cache)
+            InsertFitness(e->cache, a->x, f);
+    }
+    PROFILE_END(_PROFILE_FITNESS_);
+
+    return f;
+}
+/**************************/
+
+/* Search Space-related functions */
+/* It allocates a 64-byte aligned block of doubles set to zero
+Parameters:
+size: number of doubles */
+static double *AllocateBlock(int size) {
+    void *block = NULL;
+
+    if (posix_memalign(&block, 64, size * sizeof(double))) {
+        fprintf(stderr, "\nUnable to allocate memory @AllocateBlock.\n");
+        exit(-1);
+    }
+    memset(block, 0, size * sizeof(double));
+    PROFILE_COUNT(_PROFILE_ALLOCATIONS_, 1);
+
+    return (double *) block;
+}
+
+/* It moves the positions, velocities and local bests of the agents to contiguous m x n blocks
+ * Agent i becomes a view of row i of each block, so that its arrays are not deallocated by DestroyAgent.
+Parameters:
+s: search space */
+static void CreateAgentBlocks(SearchSpace *s) {
+    int i;
+
+    s->block_x = AllocateBlock(s->m * s->n);
+    if (s->a[0]->v) s->block_v = AllocateBlock(s->m * s->n);
+    if (s->a[0]->xl) s->block_xl = AllocateBlock(s->m * s->n);
+
+    for (i = 0; i < s->m; i++) {
+        free(s->a[i]->x);
+        s->a[i]->x = s->block_x + i * s->n;
+        if (s->block_v) {
+            free(s->a[i]->v);
+            s->a[i]->v = s->block_v + i * s->n;
+        }
+        if (s->block_xl) {
+            free(s->a[i]->xl);
+            s->a[i]->xl = s->block_xl + i * s->n;
+        }
+        s->a[i]->view = 1;
+    }
+}
+
+/* It creates a search space
+Parameters:
+m: number of agents
+n: number of decision variables
+opt_id: identifier of the optimization technique
+additional parameters: related to each technique
+PSO, BA, FPA and FA: do not require additional parameters
+GP: it requires the minimum and maximum depth of a tree, number of terminals and a matrix (char **) with the terminals' names
+Tensor-based approaches require the number of dimensions of the tensor, i.e., if it is a quaternion, octonion or sedenion */
+SearchSpace *CreateSearchSpace(int m, int n, int opt_id, ...) {
+    SearchSpace *s = NULL;
+    va_list arg;
+
+    if ((m < 1) || (n < 1) || (opt_id < 1)) {
+        fprintf(stderr, "\nInvalid parameters @CreateSearchSpace.\n");
+        return NULL;
+    }
+    int i, j, remained_lions, tensor_dim;
+
+    va_start(arg, opt_id);
+    s = (SearchSpace *) malloc(sizeof(SearchSpace));
+    s->m = m;
+    s->n = n;
+    s->gfit = DBL_MAX;
     s->iterations = 0;
     s->is_integer_opt = 1;
     s->tensor_dim = -1;
+    s->n_threads = GetDefaultNumberOfThreads();
+    s->pool = NULL;
+    s->batch = NULL;
+    s->batch_ctx = NULL;
+    s->agent_pool = NULL;
+    s->cache = NULL;
+    SetDefaultObserver(s);
+    s->centroid = NULL;
+    s->program = NULL;
+    s->individual = NULL;
+    s->forest = NULL;
+    s->subtree_cache = NULL;
+    s->gsgp_log = NULL;
+    s->semantics = NULL;
+    s->block_x = NULL;
+    s->block_v = NULL;
+    s->block_xl = NULL;
+    s->block_fit = (double *) calloc(s->m, sizeof(double));
+    s->block_trial = NULL;
+    s->trial = NULL;
 
     /* PSO */
     s->w = NAN;
@@ -586,6 +1276,7 @@ SearchSpace *CreateSearchSpace(int m, int n, int opt_id, ...) {
     s->alpha = NAN;
     s->beta_0 = NAN;
     s->gamma = NAN;
+    s->keep_distances = 0;
 
     /* GP and GA */
     s->pReproduction = NAN;
@@ -648,6 +1339,7 @@ SearchSpace *CreateSearchSpace(int m, int n, int opt_id, ...) {
             /* Here, we verify whether opt_id is valid or not. In the latter case, function CreateAgent returns NULL. */
             for (i = 1; i < s->m; i++)
                 s->a[i] = CreateAgent(s->n, opt_id, _NOTENSOR_);
+            CreateAgentBlocks(s);
 
             if (opt_id == _MBO_) {
                 s->k = va_arg(arg, int);
@@ -680,17 +1372,16 @@ SearchSpace *CreateSearchSpace(int m, int n, int opt_id, ...) {
                 s->n_rows = n_rows;
                 s->n_input_values = n_input_values;
                 s->pMutation = pMutation;
+                s->lambda = 4;
 
                 /* allocating other parts of the agent structure */
-                for (i = 0; i < s->m; i++) {
-                    s->a[i]->output_nodes = (int *) malloc(n * sizeof(int));
-                    s->a[i]->genotype = (CGP_Node *) malloc(n_columns * n_rows * sizeof(CGP_Node));
-                    s->a[i]->input_values = (double *) malloc(n_input_values * sizeof(double));
-                }
+                for (i = 0; i < s->m; i++)
+                    AllocateCGPStructures(s, s->a[i]);
 
             }
         } else {
             free(s->a);
+            free(s->block_fit);
             free(s);
             fprintf(stderr, "\nInvalid optimization identifier @CreateSearchSpace.\n");
             return NULL;
@@ -865,16 +1556,18 @@ void DestroySearchSpace(SearchSpace **s, int opt_id) {
                 }
             } else { /* Tensor-based GP */
                 if (tmp->t_constant) {
-                    for (i = 0; i < N_CONSTANTS; i++) {
-                        for (j = 0; j < tmp->n; j++)
-                            if (tmp->t_constant[i][j]) free(tmp->t_constant[i][j]);
-                        if (tmp->t_constant[i]) free(tmp->t_constant[i]);
-                    }
+                    for (i = 0; i < N_CONSTANTS; i++)
+                        if (tmp->t_constant[i]) DestroyTensor(&(tmp->t_constant[i]), tmp->n);
                     free(tmp->t_constant);
                 }
             }
             if (tmp->tree_fit) free(tmp->tree_fit);
             if (tmp->g) free(tmp->g);
+            if (tmp->individual) {
+                for (i = 0; i < tmp->m; i++)
+                    DestroyAgent(&(tmp->individual[i]), opt_id);
+                free(tmp->individual);
+            }
         }
         if (opt_id == _LOA_) {
             for (i = 0; i < tmp->n_female_nomads; i++)
@@ -898,6 +1591,20 @@ void DestroySearchSpace(SearchSpace **s, int opt_id) {
 
     if (tmp->LB) free(tmp->LB);
     if (tmp->UB) free(tmp->UB);
+    if (tmp->block_x) free(tmp->block_x);
+    if (tmp->block_v) free(tmp->block_v);
+    if (tmp->block_xl) free(tmp->block_xl);
+    if (tmp->block_fit) free(tmp->block_fit);
+    if (tmp->block_trial) free(tmp->block_trial);
+    if (tmp->trial) free(tmp->trial);
+    if (tmp->pool) DestroyThreadPool(&(tmp->pool));
+    if (tmp->agent_pool) DestroyAgentPool(&(tmp->agent_pool));
+    if (tmp->cache) DestroyFitnessCache(&(tmp->cache));
+    if (tmp->centroid) free(tmp->centroid);
+    if (tmp->program) DestroyGPProgram(&(tmp->program));
+    if (tmp->forest) DestroyTreePool(&(tmp->forest));
+    if (tmp->subtree_cache) DestroySubtreeCache(&(tmp->subtree_cache));
+    if (tmp->gsgp_log) DestroyGSGPLog(&(tmp->gsgp_log));
 
     free(tmp);
     tmp = NULL;
@@ -1165,18 +1872,45 @@ s: search space
 EvaluateFun: pointer to the function used to evaluate particles (agents)
 arg: list of additional arguments */
 void EvaluateSearchSpace(SearchSpace *s, int opt_id, prtFun Evaluate, va_list arg) {
+    Evaluator e;
+
+    InitEvaluator(&e, s, Evaluate, arg);
+    EvaluateSearchSpaceWith(s, opt_id, &e);
+    DestroyEvaluator(&e);
+}
+
+/* It evaluates a search space using a reentrant fitness function
+Parameters:
+s: search space
+opt_id: identifier of the optimization technique
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void EvaluateSearchSpace_r(SearchSpace *s, int opt_id, prtFun_r Evaluate, void *ctx) {
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    EvaluateSearchSpaceWith(s, opt_id, &e);
+    DestroyEvaluator(&e);
+}
+
+/* It evaluates a search space using a fitness evaluator
+ * The fitness values are computed first (concurrently if s->n_threads > 1), and then the
+ * local and global bests are updated in ascending order of agents, as in a serial evaluation.
+Parameters:
+s: search space
+opt_id: identifier of the optimization technique
+e: fitness evaluator */
+void EvaluateSearchSpaceWith(SearchSpace *s, int opt_id, Evaluator *e) {
     if (!s) {
-        fprintf(stderr, "\nSearch space not allocated @EvaluateSearchSpace.\n");
+        fprintf(stderr, "\nSearch space not allocated @EvaluateSearchSpaceWith.\n");
         exit(-1);
     }
 
-    int i, j;
-    double f, **t_tmp = NULL, *tmp = NULL;
-    Agent *individual = NULL;
-    va_list argtmp;
-
-    va_copy(argtmp, arg);
+    int i, j, k, ctr;
+    double *f = NULL, *tmp = NULL;
+    Agent **individual = NULL;
 
+    PROFILE_BEGIN(_PROFILE_EVALUATION_);
     switch (opt_id) {
         case _BA_:
         case _FPA_:
@@ -1192,11 +1926,12 @@ void EvaluateSearchSpace(SearchSpace *s, int opt_id, prtFun Evaluate, va_list ar
         case _ABO_:
         case _BSO_:
         case _DE_:
-            for (i = 0; i < s->m; i++) {
-                f = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+            f = s->block_fit;
+            EvaluateAgents(s, s->a, s->m, e, f); /* It executes the fitness function for all agents */
 
-                if (f < s->a[i]->fit) /* It updates the fitness value */
-                    s->a[i]->fit = f;
+            for (i = 0; i < s->m; i++) {
+                if (f[i] < s->a[i]->fit) /* It updates the fitness value */
+                    s->a[i]->fit = f[i];
 
                 if (s->a[i]->fit < s->gfit) { /* It updates the global best value and position */
                     s->best = i;
@@ -1204,16 +1939,15 @@ void EvaluateSearchSpace(SearchSpace *s, int opt_id, prtFun Evaluate, va_list ar
                     for (j = 0; j < s->n; j++)
                         s->g[j] = s->a[i]->x[j];
                 }
-
-                va_copy(arg, argtmp);
             }
             break;
         case _PSO_:
-            for (i = 0; i < s->m; i++) {
-                f = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+            f = s->block_fit;
+            EvaluateAgents(s, s->a, s->m, e, f); /* It executes the fitness function for all agents */
 
-                if (f < s->a[i]->fit) { /* It updates the local best value and position */
-                    s->a[i]->fit = f;
+            for (i = 0; i < s->m; i++) {
+                if (f[i] < s->a[i]->fit) { /* It updates the local best value and position */
+                    s->a[i]->fit = f[i];
                     for (j = 0; j < s->n; j++)
                         s->a[i]->xl[j] = s->a[i]->x[j];
                 }
@@ -1223,136 +1957,201 @@ void EvaluateSearchSpace(SearchSpace *s, int opt_id, prtFun Evaluate, va_list ar
                     for (j = 0; j < s->n; j++)
                         s->g[j] = s->a[i]->x[j];
                 }
-
-                va_copy(arg, argtmp);
             }
             break;
         case _FA_:
-            for (i = 0; i < s->m; i++) {
-                f = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+            f = s->block_fit;
+            EvaluateAgents(s, s->a, s->m, e, f); /* It executes the fitness function for all agents */
 
-                s->a[i]->fit = f; /* It updates the fitness value of actual agent i */
+            for (i = 0; i < s->m; i++) {
+                s->a[i]->fit = f[i]; /* It updates the fitness value of actual agent i */
 
                 if (s->a[i]->fit < s->gfit) { /* It updates the global best value and position */
                     s->gfit = s->a[i]->fit;
                     for (j = 0; j < s->n; j++)
                         s->g[j] = s->a[i]->x[j];
                 }
-
-                va_copy(arg, argtmp);
             }
             break;
         case _GP_:
-            individual = CreateAgent(s->n, _GP_, _NOTENSOR_);
+            if (!s->program)
+                s->program = CreateGPProgram();
+            if ((s->forest) && (s->subtree_cache))
+                SyncSubtreeCache(s, s->subtree_cache, -1);
+            if (!s->individual) {
+                s->individual = (Agent **) malloc(s->m * sizeof(Agent *));
+                for (i = 0; i < s->m; i++)
+                    s->individual[i] = CreateAgent(s->n, _GP_, _NOTENSOR_);
+            }
+            individual = s->individual;
             for (i = 0; i < s->m; i++) {
-                tmp = RunTree(s, s->T[i]);
-                memcpy(individual->x, tmp, s->n *
-                                           sizeof(double)); /* It runs over a tree computing the output individual (current solution) */
-                free(tmp);
+                if (s->forest)
+                    tmp = RunPooledTree(s, s->forest, i);
+                else if (s->semantics)
+                    tmp = s->semantics + (size_t) i * s->n;
+                else {
+                    CompileTree(s, s->T[i], s->program);
+                    tmp = RunGPProgram(s, s->program);
+                }
+                memcpy(individual[i]->x, tmp, s->n * sizeof(double)); /* It runs over a tree computing the output individual (current solution) */
 
-                CheckAgentLimits(s, individual);
+                CheckAgentLimits(s, individual[i]);
+            }
 
-                f = Evaluate(individual, arg); /* It executes the fitness function for agent i */
+            f = s->block_fit;
+            EvaluateAgents(s, individual, s->m, e, f); /* It executes the fitness function for all trees */
 
-                if (f < s->tree_fit[i]) /* It updates the fitness value */
-                    s->tree_fit[i] = f;
+            for (i = 0; i < s->m; i++) {
+                if (f[i] < s->tree_fit[i]) /* It updates the fitness value */
+                    s->tree_fit[i] = f[i];
 
                 if (s->tree_fit[i] < s->gfit) { /* It updates the global best value */
                     s->best = i;
                     s->gfit = s->tree_fit[i];
                     for (j = 0; j < s->n; j++)
-                        s->g[j] = individual->x[j];
+                        s->g[j] = individual[i]->x[j];
                 }
-
-                va_copy(arg, argtmp);
             }
-            DestroyAgent(&individual, _GP_);
             break;
         case _TGP_:
-            individual = CreateAgent(s->n, _TGP_, s->tensor_dim);
-            tmp = (double *) calloc(s->n, sizeof(double));
+            if (!s->program)
+                s->program = CreateGPProgram();
+            if ((s->forest) && (s->subtree_cache))
+                SyncSubtreeCache(s, s->subtree_cache, s->tensor_dim);
+            if (!s->individual) {
+                s->individual = (Agent **) malloc(s->m * sizeof(Agent *));
+                for (i = 0; i < s->m; i++)
+                    s->individual[i] = CreateAgent(s->n, _TGP_, s->tensor_dim);
+            }
+            individual = s->individual;
             for (i = 0; i < s->m; i++) {
-                t_tmp = RunTTree(s, s->T[i]);
-                CheckTensorLimits(s, t_tmp, s->tensor_dim);
+                if (s->forest)
+                    tmp = RunPooledTTree(s, s->forest, i);
+                else {
+                    CompileTTree(s, s->T[i], s->program);
+                    tmp = RunGPProgram(s, s->program); /* It runs over a tree computing the output tensor, stored row by row */
+                }
+                for (j = 0; j < s->n; j++) { /* as in CheckTensorLimits (the output may be cached, so it is clamped into the individual's tensor) */
+                    for (k = 0; k < s->tensor_dim; k++) {
+                        if (tmp[j * s->tensor_dim + k] < 0)
+                            individual[i]->t[j][k] = 0;
+                        else if (tmp[j * s->tensor_dim + k] > 1)
+                            individual[i]->t[j][k] = 1;
+                        else
+                            individual[i]->t[j][k] = tmp[j * s->tensor_dim + k];
+                    }
+                }
 
-                for (j = 0; j < s->n; j++)
-                    tmp[j] = TensorSpan(s->LB[j], s->UB[j], t_tmp[j], s->tensor_dim);
-                memcpy(individual->x, tmp, s->n *
-                                           sizeof(double)); /* It runs over a tree computing the output individual (current solution) */
-                DestroyTensor(&t_tmp, s->n);
+                TensorSpans(s->LB, s->UB, individual[i]->t[0], s->n, s->tensor_dim, individual[i]->x); /* It maps the tensor to the output individual (current solution) */
+
+                CheckAgentLimits(s, individual[i]);
+            }
 
-                CheckAgentLimits(s, individual);
+            f = s->block_fit;
+            EvaluateAgents(s, individual, s->m, e, f); /* It executes the fitness function for all trees */
 
-                f = Evaluate(individual, arg); /* It executes the fitness function for agent i */
-                if (f < s->tree_fit[i]) /* It updates the fitness value */
-                    s->tree_fit[i] = f;
+            for (i = 0; i < s->m; i++) {
+                if (f[i] < s->tree_fit[i]) /* It updates the fitness value */
+                    s->tree_fit[i] = f[i];
 
                 /* It updates the global best value */
                 if (s->tree_fit[i] < s->gfit) {
                     s->best = i;
                     s->gfit = s->tree_fit[i];
                     for (j = 0; j < s->n; j++)
-                        s->g[j] = individual->x[j];
+                        s->g[j] = individual[i]->x[j];
                 }
-
-                va_copy(arg, argtmp);
             }
-            DestroyAgent(&individual, _TGP_);
-            free(tmp);
             break;
         case _MBO_:
-            for (i = 0; i < s->m; i++) {
-                f = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
-                s->a[i]->fit = f;           /* It updates the fitness value of actual agent i */
+            f = s->block_fit;
+            EvaluateAgents(s, s->a, s->m, e, f); /* It executes the fitness function for all agents */
 
-            va_copy(arg, argtmp);
-        }
-        break;
+            for (i = 0; i < s->m; i++)
+                s->a[i]->fit = f[i]; /* It updates the fitness value of actual agent i */
+            break;
     case _LOA_:
+        /* It gathers all lions (nomads first, and then the residents of each pride) in the same order used to update the best ones */
+        ctr = s->n_female_nomads + s->n_male_nomads;
+        for (i = 0; i < s->n_prides; i++)
+            ctr += s->pride_id[i].n_females + s->pride_id[i].n_males;
+        individual = (Agent **) malloc(ctr * sizeof(Agent *));
+        ctr = 0;
         for (i = 0; i < s->n_female_nomads; i++)
-        {
-            EvaluateAgent(s, s->female_nomads[i], _LOA_, Evaluate, arg);
-            /* after the firt evaluation pfit still is DBL_MAX, we need to update it */
-            s->female_nomads[i]->pfit = s->female_nomads[i]->fit;
-        }
+            individual[ctr++] = s->female_nomads[i];
         for (i = 0; i < s->n_male_nomads; i++)
-        {
-            EvaluateAgent(s, s->male_nomads[i], _LOA_, Evaluate, arg);
-            /* after the firt evaluation pfit still is DBL_MAX, we need to update it */
-            s->male_nomads[i]->pfit = s->male_nomads[i]->fit;
-        }
+            individual[ctr++] = s->male_nomads[i];
         for (i = 0; i < s->n_prides; i++)
         {
             for (j = 0; j < s->pride_id[i].n_females; j++)
-            {
-                EvaluateAgent(s, s->pride_id[i].females[j], _LOA_, Evaluate, arg);
-                /* after the firt evaluation pfit still is DBL_MAX, we need to update it */
-                s->pride_id[i].females[j]->pfit = s->pride_id[i].females[j]->fit;
-            }
+                individual[ctr++] = s->pride_id[i].females[j];
             for (j = 0; j < s->pride_id[i].n_males; j++)
+                individual[ctr++] = s->pride_id[i].males[j];
+        }
+
+        f = (double *) malloc(ctr * sizeof(double));
+        EvaluateAgents(s, individual, ctr, e, f); /* It executes the fitness function for all lions */
+
+        for (k = 0; k < ctr; k++)
+        {
+            /* saving the last fitness value and the previous location */
+            individual[k]->pfit = individual[k]->fit;
+            for (j = 0; j < s->n; j++)
+                individual[k]->prev_x[j] = individual[k]->x[j];
+
+            individual[k]->fit = f[k];
+
+            /* if the actual fit is the best fitness so far of the agent */
+            if (individual[k]->fit < individual[k]->best_fit)
             {
-                EvaluateAgent(s, s->pride_id[i].males[j], _LOA_, Evaluate, arg);
-                /* after the firt evaluation pfit still is DBL_MAX, we need to update it */
-                s->pride_id[i].males[j]->pfit = s->pride_id[i].males[j]->fit;
+                individual[k]->best_fit = individual[k]->fit;
+                /* update the best visited location */
+                for (j = 0; j < s->n; j++)
+                    individual[k]->xl[j] = individual[k]->x[j];
+                /* The this lion is the best solution so far */
+                if (individual[k]->fit < s->gfit)
+                {
+                    s->gfit = individual[k]->fit;
+                    /* update the global best visited location */
+                    for (j = 0; j < s->n; j++)
+                        s->g[j] = individual[k]->x[j];
+                }
             }
+            /* after the firt evaluation pfit still is DBL_MAX, we need to update it */
+            individual[k]->pfit = individual[k]->fit;
         }
+        free(individual);
         break;
 
     case _SA_:
-        for (i = 0; i < s->m; i++)
-            EvaluateAgent(s, s->a[i], _SA_, Evaluate, arg); /* It executes the fitness function for agent i */
-        break;
     case _CGP_:
-        for (i = 0; i < s->m; i++) {
-            CheckAgentLimits(s, s->a[i]);
-            EvaluateAgent(s, s->a[i], _CGP_, Evaluate, arg); /* It executes the fitness function for agent i */
+        if (opt_id == _CGP_)
+            for (i = 0; i < s->m; i++)
+                CheckAgentLimits(s, s->a[i]);
+
+        f = s->block_fit;
+        EvaluateAgents(s, s->a, s->m, e, f); /* It executes the fitness function for all agents */
+
+        for (i = 0; i < s->m; i++)
+        {
+            s->a[i]->fit = f[i];
+            /* If the actual position is the best solution so far */
+            if (s->a[i]->fit < s->gfit)
+            {
+                s->gfit = s->a[i]->fit;
+                /* update the global best solution */
+                memcpy(s->g, s->a[i]->x, s->n * sizeof(double));
+            }
         }
         break;
 
     default:
-        fprintf(stderr, "\n Invalid optimization identifier @EvaluateSearchSpace.\n");
+        fprintf(stderr, "\n Invalid optimization identifier @EvaluateSearchSpaceWith.\n");
         break;
     }
+
+    if ((f) && (f != s->block_fit)) free(f);
+    PROFILE_END(_PROFILE_EVALUATION_);
 }
 
 /* It checks whether a search space has been properly set or not
@@ -1656,6 +2455,11 @@ char CheckSearchSpace(SearchSpace *s, int opt_id) {
             fprintf(stderr, "\n -> Invalid value for the number of input constants @CheckSearchSpace.\n");
             OK = 0;
         }
+        if (s->lambda < 1)
+        {
+            fprintf(stderr, "\n -> Invalid value for the number of offspring @CheckSearchSpace.\n");
+            OK = 0;
+        }
         break;
     default:
         fprintf(stderr, "\n Invalid optimization identifier @CheckSearchSpace.\n");
@@ -1673,67 +2477,154 @@ char CheckSearchSpace(SearchSpace *s, int opt_id) {
     return OK;
 }
 
-/**************************/
-
-/* General-purpose functions */
-/* It generates a random number uniformly distributed between low and high
+/* It registers a function used to evaluate all agents at once
+ * Once it is registered, EvaluateSearchSpace and the optimization techniques call it with the decision vectors of
+ * the agents stored row by row in a dense m x n matrix, instead of calling their own fitness function once per agent.
 Parameters:
-low: lower bound
-high: upper bound
-This algorithm has been inspired by: http://www.cprogramming.com/tutorial/random.html */
-double GenerateUniformRandomNumber(double low, double high) {
-    return randinter(low, high);
-}
+s: search space
+Evaluate: pointer to the batch function (NULL unregisters the current one)
+ctx: context forwarded to each call of Evaluate */
+void SetBatchEvaluation(SearchSpace *s, prtBatchFun Evaluate, void *ctx) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @SetBatchEvaluation.\n");
+        exit(-1);
+    }
 
-/* It generates a random number drawn from a Gaussian (normal) distribution
-Parameters:
-mean: mean of the distribution
-variance: variance of the distribution */
-double GenerateGaussianRandomNumber(double mean, double variance) {
-    return randGaussian(mean, variance);
+    s->batch = Evaluate;
+    s->batch_ctx = ctx;
 }
 
-/* It generates a random number drawn from a Cauchy distribution
-Parameters:
-location: location of the distribution
-scale: scale of the distribution */
-double GenerateCauchyRandomNumber(double location, double scale) {
-    return randCauchy(location, scale);
-}
+/**************************/
 
-/* It generates an n-dimensional array drawn from a Levy distribution
- * The formulation used here is based on the paper "Multiobjective Cuckoo Search for Design Optimization", X.-S. Yang and S. Deb, Computers & Operations Research, 2013.
+/* Trial vector-related functions */
+/* It returns the trial vector of the i-th agent of a search space
+ * The trial vectors are the rows of an m x n block allocated upon the first request. A candidate position is built in the
+ * trial vector, and it becomes the position of the agent through SwapTrialVector, which avoids copying it.
+ * The trial vector of an agent is not related to the agent's position (it does not hold a copy of it).
 Parameters:
-n: dimension of the output array
-beta: input parameter used in the formulation */
-double *GenerateLevyDistribution(int n, double beta) {
-    double *L = NULL, sigma_u, sigma_v = 1;
-    double *u = NULL, *v = NULL;
-    int i;
-
-    if (n < 1) {
-        fprintf(stderr, "Invalid input paramater @GenerateLevyDistribution.\n");
-        return NULL;
+s: search space
+i: index of the agent */
+double *GetTrialVector(SearchSpace *s, int i) {
+    if ((!s) || (i < 0) || (i >= s->m)) {
+        fprintf(stderr, "\nInvalid input parameters @GetTrialVector.\n");
+        exit(-1);
     }
 
-    L = (double *) malloc(n * sizeof(double));
-
-    sigma_u = pow((tgamma(1 + beta) * sin(M_PI * beta / 2)) / (tgamma((1 + beta) / 2) * beta * pow(2, (beta - 1) / 2)),
-                  1 / beta); /* Equation 16 */
+    int j;
 
-    u = (double *) malloc(n * sizeof(double));
-    v = (double *) malloc(n * sizeof(double));
-    sigma_u = pow(sigma_u, 2);
-    for (i = 0; i < n; i++) { /* It computes Equation 15 */
-        u[i] = GenerateGaussianRandomNumber(0, sigma_u);
-        v[i] = GenerateGaussianRandomNumber(0, sigma_v);
+    if (!s->block_trial) {
+        s->block_trial = AllocateBlock(s->m * s->n);
+        s->trial = (double **) malloc(s->m * sizeof(double *));
+        for (j = 0; j < s->m; j++)
+            s->trial[j] = s->block_trial + j * s->n;
     }
 
-    for (i = 0; i < n; i++)
-        L[i] = 0.01 * (u[i] / pow(fabs(v[i]), 1 / beta)); /* It computes Equation 14 (part of it) */
+    return s->trial[i];
+}
 
-    free(u);
-    free(v);
+/* It exchanges the position of an agent with the i-th trial vector of a search space
+ * If the agent is a view of the search space's blocks, their pointers are swapped; otherwise, their contents are.
+ * Calling it twice restores the previous position, e.g., when the candidate stored in the trial vector is rejected.
+Parameters:
+s: search space
+a: agent
+i: index of the trial vector */
+void SwapTrialVector(SearchSpace *s, Agent *a, int i) {
+    if ((!a) || (!GetTrialVector(s, i))) {
+        fprintf(stderr, "\nInvalid input parameters @SwapTrialVector.\n");
+        exit(-1);
+    }
+
+    double *aux = NULL, tmp;
+    int j;
+
+    if (a->view) {
+        aux = a->x;
+        a->x = s->trial[i];
+        s->trial[i] = aux;
+    } else {
+        for (j = 0; j < s->n; j++) {
+            tmp = a->x[j];
+            a->x[j] = s->trial[i][j];
+            s->trial[i][j] = tmp;
+        }
+    }
+}
+
+/* It moves the positions of the agents back to the rows of the search space's block
+ * After a number of calls to SwapTrialVector, some agents may point to the block of trial vectors. This function copies
+ * their positions to the rows of block_x that are held by trial vectors, so that block_x holds the positions of all agents (not necessarily in order).
+Parameters:
+s: search space */
+void RestoreAgentBlocks(SearchSpace *s) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @RestoreAgentBlocks.\n");
+        exit(-1);
+    }
+
+    double *aux = NULL, *end = NULL;
+    int i, j = 0;
+
+    if ((!s->block_trial) || (!s->block_x))
+        return;
+
+    end = s->block_x + s->m * s->n;
+    for (i = 0; i < s->m; i++) {
+        if ((!s->a[i]->view) || ((s->a[i]->x >= s->block_x) && (s->a[i]->x < end)))
+            continue;
+        while ((j < s->m) && ((s->trial[j] < s->block_x) || (s->trial[j] >= end)))
+            j++;
+        if (j == s->m) /* no row of block_x is left, which happens only if some view has been replaced by an agent that owns its position */
+            return;
+        memcpy(s->trial[j], s->a[i]->x, s->n * sizeof(double));
+        aux = s->a[i]->x;
+        s->a[i]->x = s->trial[j];
+        s->trial[j] = aux;
+    }
+}
+/**************************/
+
+/* General-purpose functions */
+/* It generates a random number uniformly distributed between low and high
+Parameters:
+low: lower bound
+high: upper bound
+This algorithm has been inspired by: http://www.cprogramming.com/tutorial/random.html */
+double GenerateUniformRandomNumber(double low, double high) {
+    return randinter(low, high);
+}
+
+/* It generates a random number drawn from a Gaussian (normal) distribution
+Parameters:
+mean: mean of the distribution
+variance: variance of the distribution */
+double GenerateGaussianRandomNumber(double mean, double variance) {
+    return randGaussian(mean, variance);
+}
+
+/* It generates a random number drawn from a Cauchy distribution
+Parameters:
+location: location of the distribution
+scale: scale of the distribution */
+double GenerateCauchyRandomNumber(double location, double scale) {
+    return randCauchy(location, scale);
+}
+
+/* It generates an n-dimensional array drawn from a Levy distribution
+ * The formulation used here is based on the paper "Multiobjective Cuckoo Search for Design Optimization", X.-S. Yang and S. Deb, Computers & Operations Research, 2013.
+Parameters:
+n: dimension of the output array
+beta: input parameter used in the formulation */
+double *GenerateLevyDistribution(int n, double beta) {
+    double *L = NULL;
+
+    if (n < 1) {
+        fprintf(stderr, "Invalid input paramater @GenerateLevyDistribution.\n");
+        return NULL;
+    }
+
+    L = (double *) malloc(n * sizeof(double));
+    FillLevy(L, n, beta); /* It computes Equations 14-16 */
 
     return L;
 }
@@ -2036,16 +2927,12 @@ SearchSpace *ReadSearchSpaceFromFile(char *fileName, int opt_id) {
                 } else { /* tensor-based GP */
                     /* here we generate N_CONSTANTS random matrices within the range [0,1] */
                     t_constant = (double ***) malloc(N_CONSTANTS * sizeof(double **));
-                    for (i = 0; i < N_CONSTANTS; i++) {
-                        t_constant[i] = (double **) malloc(n * sizeof(double *));
-                        for (j = 0; j < n; j++)
-                            t_constant[i][j] = (double *) malloc(tensor_dim * sizeof(double));
-                    }
+                    for (i = 0; i < N_CONSTANTS; i++)
+                        t_constant[i] = CreateTensor(n, tensor_dim);
 
                     for (i = 0; i < N_CONSTANTS; i++)
-                        for (j = 0; j < n; j++)
-                            for (k = 0; k < tensor_dim; k++)
-                                t_constant[i][j][k] = GenerateUniformRandomNumber(0, 1);
+                        for (j = 0; j < n * tensor_dim; j++)
+                            t_constant[i][0][j] = GenerateUniformRandomNumber(0, 1);
 
                 }
             }
@@ -2126,7 +3013,12 @@ SearchSpace *ReadSearchSpaceFromFile(char *fileName, int opt_id) {
             fscanf(fp, "%lf", &pMutation);
             s = CreateSearchSpace(m, n, _CGP_, levels_back, n_columns, n_rows, n_input_values, pMutation);
             s->iterations = iterations;
-            WaiveComment(fp);
+            /* lambda is optional, and it defaults to 4: it is only read if an integer follows pMutation on its line, before any comment */
+            if (fgets(line, LINE_SIZE, fp)) {
+                sscanf(line, "%d", &(s->lambda));
+                if (!strchr(line, '\n'))
+                    WaiveComment(fp);
+            }
             break;
         default:
             fprintf(stderr, "\nInvalid optimization identifier @ReadSearchSpaceFromFile.\n");
@@ -2224,7 +3116,9 @@ int *RouletteSelection(SearchSpace *s, int k) {
         D[i].val /= sum;
 
     /* It sorts the population by ascending values of fitness */
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(D, s->m, sizeof(Data), SortDataByVal);
+    PROFILE_END(_PROFILE_SORT_);
 
     /* It computes the accumulate normalized fitness */
     accum = (double *) calloc(s->m, sizeof(double));
@@ -2252,6 +3146,10 @@ int *RouletteSelection(SearchSpace *s, int k) {
     return elem;
 }
 
+/* It selects k elements based on the roulette selection method, and it returns a newly allocated array with their indices (see RouletteSelectionGAInto)
+Parameters:
+s: search space
+k: number of elements to be selected */
 int *RouletteSelectionGA(SearchSpace *s, int k) {
     if (!s) {
         fprintf(stderr, "\nSearch space not allocated @RouletteSelectionGA.\n");
@@ -2263,12 +3161,37 @@ int *RouletteSelectionGA(SearchSpace *s, int k) {
         return NULL;
     }
 
-    int *elem = NULL, i, j;
-    double min, sum, *accum = NULL, prob;
+    int *elem = NULL;
+    double *accum = NULL;
     Data *D = NULL;
 
     elem = (int *) malloc(k * sizeof(int));
     D = (Data *) malloc(s->m * sizeof(Data));
+    accum = (double *) malloc(s->m * sizeof(double));
+
+    RouletteSelectionGAInto(s, k, elem, D, accum);
+
+    free(D);
+    free(accum);
+
+    return elem;
+}
+
+/* It selects k elements based on the roulette selection method using arrays that have already been allocated, e.g., once per run
+Parameters:
+s: search space
+k: number of elements to be selected
+elem: output array with the indices of the k selected elements
+D: auxiliary array with room for s->m elements
+accum: auxiliary array with room for s->m doubles */
+void RouletteSelectionGAInto(SearchSpace *s, int k, int *elem, Data *D, double *accum) {
+    if ((!s) || (!elem) || (!D) || (!accum)) {
+        fprintf(stderr, "\nInvalid input parameters @RouletteSelectionGAInto.\n");
+        exit(-1);
+    }
+
+    int i, j;
+    double min, sum, prob;
 
     /* It normalizes the fitness of each agent ***/
     sum = 0;
@@ -2287,11 +3210,13 @@ int *RouletteSelectionGA(SearchSpace *s, int k) {
         D[i].val /= sum;
 
     /* It sorts the population by ascending values of fitness */
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(D, s->m, sizeof(Data), SortDataByVal);
+    PROFILE_END(_PROFILE_SORT_);
 
     /* It computes the accumulate normalized fitness */
-    accum = (double *) calloc(s->m, sizeof(double));
     for (i = 0; i < s->m; i++) {
+        accum[i] = 0;
         for (j = i; j >= 0; j--)
             accum[i] += D[j].val;
     }
@@ -2308,11 +3233,6 @@ int *RouletteSelectionGA(SearchSpace *s, int k) {
             elem[j] = D[i].id;
         elem[j] = D[i].id;
     }
-
-    free(D);
-    free(accum);
-
-    return elem;
 }
 /**************************/
 
@@ -2335,7 +3255,7 @@ Node *CreateNode(char *value, int node_id, char status, ...) {
     }
 
     va_start(arg, status);
-    n_decision_variables = va_arg(arg, int);
+    n_decision_variables = status == NEW_TERMINAL ? va_arg(arg, int) : 0;
 
     tmp->id = node_id;
     tmp->left = tmp->right = tmp->parent = NULL;
@@ -2345,8 +3265,11 @@ Node *CreateNode(char *value, int node_id, char status, ...) {
     strcpy(tmp->elem, value);
 
     tmp->val = NULL;
-    if (status == NEW_TERMINAL)
+    tmp->n_val = 0;
+    if (status == NEW_TERMINAL) {
         tmp->val = (double *) malloc(n_decision_variables * sizeof(double));
+        tmp->n_val = n_decision_variables;
+    }
 
     va_end(arg);
 
@@ -2459,77 +3382,217 @@ void PreFixPrintTree4File(SearchSpace *s, Node *T, FILE *fp) {
 }
 
 /* It runs a given tree and outputs its solution array
+ * The tree is compiled into a temporary program (see CompileTree), whose output is copied into a newly allocated array.
+ * To run many trees, compiling them into the same program with CompileTree and running it with RunGPProgram avoids any allocation.
 Parameters:
 s: search space
 T: current tree */
 double *RunTree(SearchSpace *s, Node *T) {
-    double *x = NULL, *y = NULL, *out = NULL;
-    int i;
+    GPProgram *p = NULL;
+    double *out = NULL;
 
-    if (T) {
-        x = RunTree(s, T->left);  /* It runs over the subtree on the left */
-        y = RunTree(s, T->right); /* It runs over the subtree on the right */
+    if (!T)
+        return NULL;
 
-        if (T->status == TERMINAL || T->status == CONSTANT || T->status == NEW_TERMINAL) {
-            out = (double *) calloc(s->n, sizeof(double));
-            if (T->status == CONSTANT) {
-                for (i = 0; i < s->n; i++)
-                    out[i] = s->constant[i][T->id];
-            } else {
-                if (T->status == NEW_TERMINAL) {
-                    for (i = 0; i < s->n; i++)
-                        out[i] = T->val[i];
-                } else {
+    p = CreateGPProgram();
+    CompileTree(s, T, p);
+    out = (double *) malloc(s->n * sizeof(double));
+    memcpy(out, RunGPProgram(s, p), s->n * sizeof(double));
+    DestroyGPProgram(&p);
+
+    return out;
+}
+
+/* It creates an empty GP program */
+GPProgram *CreateGPProgram() {
+    GPProgram *p = NULL;
+
+    p = (GPProgram *) malloc(sizeof(GPProgram));
+    p->code = NULL;
+    p->size = p->capacity = 0;
+    p->depth = 0;
+    p->tensor_dim = -1;
+    p->width = 0;
+    p->stack = NULL;
+    p->stack_size = 0;
+
+    return p;
+}
+
+/* It deallocates a GP program
+Parameters:
+p: address of the program to be deallocated */
+void DestroyGPProgram(GPProgram **p) {
+    GPProgram *tmp = NULL;
+
+    tmp = *p;
+    if (!tmp) {
+        fprintf(stderr, "\nGP program not allocated @DestroyGPProgram.\n");
+        exit(-1);
+    }
+
+    if (tmp->code) free(tmp->code);
+    if (tmp->stack) free(tmp->stack);
+    free(tmp);
+    *p = NULL;
+}
+
+/* It appends an instruction to a GP program
+Parameters:
+p: GP program
+opcode: identifier of the function, or -1 for a leaf
+status, id, val: status, identifier and values (NEW_TERMINAL only) of the node that originates the instruction
+n_args: number of values popped by the instruction */
+static void EmitInstruction(GPProgram *p, int opcode, int status, int id, double *val, int n_args) {
+    GPInstruction *ins = NULL;
+
+    if (p->size == p->capacity) {
+        p->capacity = p->capacity ? 2 * p->capacity : 64;
+        p->code = (GPInstruction *) realloc(p->code, p->capacity * sizeof(GPInstruction));
+    }
+
+    ins = &p->code[p->size++];
+    ins->opcode = opcode;
+    ins->status = status;
+    ins->id = id;
+    ins->n_args = n_args;
+    ins->val = val;
+}
+
+/* It compiles a subtree in postfix order, i.e., each node is emitted after its sons (left before right)
+Parameters:
+T: subtree
+p: GP program
+height: number of values on the stack when the subtree starts running (it is updated)
+caller: name of the public function, used by error messages */
+static void CompileNode(Node *T, GPProgram *p, int *height, const char *caller) {
+    int h, opcode;
+
+    if (!T)
+        return;
+
+    if ((T->status == TERMINAL) || (T->status == CONSTANT) || ((T->status == NEW_TERMINAL) && (p->tensor_dim == -1))) {
+        EmitInstruction(p, -1, T->status, T->id, T->val, 0);
+    } else {
+        h = *height;
+        CompileNode(T->left, p, height, caller);
+        CompileNode(T->right, p, height, caller);
+
+        opcode = getFUNCTIONid(T->elem);
+        if (((p->tensor_dim == -1) && (opcode > _NOT_)) || ((p->tensor_dim != -1) && (opcode < _TSUM_))) {
+            fprintf(stderr, "\nFunction %s is not supported by this kind of tree @%s.\n", T->elem, caller);
+            exit(-1);
+        }
+        if (*height - h < N_ARGS_FUNCTION[opcode]) {
+            fprintf(stderr, "\nMissing argument of function %s @%s.\n", T->elem, caller);
+            exit(-1);
+        }
+        EmitInstruction(p, opcode, T->status, T->id, T->val, *height - h);
+        *height = h;
+    }
+
+    (*height)++;
+    if (*height > p->depth)
+        p->depth = *height;
+}
+
+/* It discards the instructions of a GP program before compiling a new tree
+Parameters:
+s: search space
+p: GP program
+tensor_dim: dimension of the tensors (-1 for real-valued trees) */
+static void ResetGPProgram(SearchSpace *s, GPProgram *p, int tensor_dim) {
+    p->size = 0;
+    p->depth = 0;
+    p->tensor_dim = tensor_dim;
+    p->width = tensor_dim == -1 ? s->n : s->n * tensor_dim;
+}
+
+/* It makes room for the stack of a compiled GP program (its memory is only reallocated when it grows)
+Parameters:
+p: GP program */
+static void ReserveGPStack(GPProgram *p) {
+    if (p->stack_size < p->depth * p->width) {
+        free(p->stack);
+        p->stack_size = p->depth * p->width;
+        p->stack = (double *) malloc(p->stack_size * sizeof(double));
+    }
+}
+
+/* It compiles a tree into a program whose instructions must be executed by RunGPProgram
+Parameters:
+s: search space
+T: tree
+p: GP program (its previous contents are discarded)
+tensor_dim: dimension of the tensors (-1 for real-valued trees)
+caller: name of the public function, used by error messages */
+static void CompileProgram(SearchSpace *s, Node *T, GPProgram *p, int tensor_dim, const char *caller) {
+    if ((!s) || (!T) || (!p)) {
+        fprintf(stderr, "\nInvalid input parameters @%s.\n", caller);
+        exit(-1);
+    }
+
+    int height = 0;
+
+    ResetGPProgram(s, p, tensor_dim);
+    CompileNode(T, p, &height, caller);
+    ReserveGPStack(p);
+}
+
+/* It compiles a tree into postfix bytecode
+ * The program runs the same operations of the recursive evaluation of the tree, in the same order, so its output is identical.
+ * It only refers to the tree's NEW_TERMINAL values, so the tree must not be deallocated while the program is used.
+Parameters:
+s: search space
+T: tree
+p: GP program (its previous contents are discarded, and its memory is reused) */
+void CompileTree(SearchSpace *s, Node *T, GPProgram *p) {
+    CompileProgram(s, T, p, -1, "CompileTree");
+}
+
+/* It runs a compiled tree and outputs its solution array
+ * Every value is computed in place on the program's stack, so no memory is allocated.
+Parameters:
+s: search space
+p: GP program
+It returns the solution (n doubles, or n x tensor_dim doubles stored row by row for tensor-based trees), which is
+overwritten by the next run of the program */
+double *RunGPProgram(SearchSpace *s, GPProgram *p) {
+    if ((!s) || (!p) || (!p->size)) {
+        fprintf(stderr, "\nInvalid input parameters @RunGPProgram.\n");
+        exit(-1);
+    }
+
+    GPInstruction *ins = NULL;
+    double *x = NULL;
+    int i, top = 0, w = p->width, d = p->tensor_dim;
+
+    for (ins = p->code; ins < p->code + p->size; ins++) {
+        if (ins->opcode == -1) {
+            x = p->stack + top * w;
+            if (ins->status == CONSTANT) {
+                if (d == -1) {
                     for (i = 0; i < s->n; i++)
-                        out[i] = s->a[T->id]->x[i];
-                }
+                        x[i] = s->constant[i][ins->id];
+                } else
+                    memcpy(x, s->t_constant[ins->id][0], w * sizeof(double));
+            } else if (ins->status == NEW_TERMINAL) {
+                memcpy(x, ins->val, w * sizeof(double));
+            } else {
+                memcpy(x, d == -1 ? s->a[ins->id]->x : s->a[ins->id]->t[0], w * sizeof(double));
             }
-            return out;
-        } else {
-            if (!strcmp(T->elem, "SUM"))
-                out = f_SUM_(x, y, s->n);
-            else if (!strcmp(T->elem, "SUB"))
-                out = f_SUB_(x, y, s->n);
-            else if (!strcmp(T->elem, "MUL"))
-                out = f_MUL_(x, y, s->n);
-            else if (!strcmp(T->elem, "DIV"))
-                out = f_DIV_(x, y, s->n);
-            else if (!strcmp(T->elem, "EXP")) {
-                if (x)
-                    out = f_EXP_(x, s->n);
-                else
-                    out = f_EXP_(y, s->n);
-            } else if (!strcmp(T->elem, "SQRT")) {
-                if (x)
-                    out = f_SQRT_(x, s->n);
-                else
-                    out = f_SQRT_(y, s->n);
-            } else if (!strcmp(T->elem, "LOG")) {
-                if (x)
-                    out = f_LOG_(x, s->n);
-                else
-                    out = f_LOG_(y, s->n);
-            } else if (!strcmp(T->elem, "AND"))
-                out = f_AND_(x, y, s->n);
-            else if (!strcmp(T->elem, "OR"))
-                out = f_OR_(x, y, s->n);
-            else if (!strcmp(T->elem, "XOR"))
-                out = f_XOR_(x, y, s->n);
-            else if (!strcmp(T->elem, "NOT")) {
-                if (x)
-                    out = f_NOT_(x, s->n);
-                else
-                    out = f_NOT_(y, s->n);
-            }
-            /* it deallocates the sons of the current one, since they have been used already */
-            if (x)
-                free(x);
-            if (y)
-                free(y);
-            return out;
+            top++;
+            continue;
         }
-    } else
-        return NULL;
+
+        /* the operand of unary functions is the first son, i.e., the left one if it exists */
+        top -= ins->n_args;
+        x = p->stack + top * w;
+        RunGPFunction(ins->opcode, x, ins->n_args == 2 ? x + w : NULL, x, w); /* in place, with no memory allocation */
+        top++;
+    }
+
+    return p->stack;
 }
 
 /* It copies a given tree
@@ -2542,7 +3605,9 @@ Node *CopyTree(Node *T) {
         fprintf(stderr, "\nThere is no tree allocated @CopyTree.\n");
         return NULL;
     } else {
-        root = CreateNode(T->elem, T->id, T->status);
+        root = CreateNode(T->elem, T->id, T->status, T->n_val);
+        if (T->status == NEW_TERMINAL)
+            memcpy(root->val, T->val, T->n_val * sizeof(double));
         root->left_son = T->left_son;
         PreFixTravel4Copy(T->left, root);
         PreFixTravel4Copy(T->right, root);
@@ -2558,7 +3623,9 @@ Parent: pointer to the subtree on the right */
 void PreFixTravel4Copy(Node *T, Node *Parent) {
     Node *aux = NULL;
     if (T) {
-        aux = CreateNode(T->elem, T->id, T->status);
+        aux = CreateNode(T->elem, T->id, T->status, T->n_val);
+        if (T->status == NEW_TERMINAL)
+            memcpy(aux->val, T->val, T->n_val * sizeof(double));
         aux->left_son = T->left_son;
         aux->left = NULL;
         aux->right = NULL;
@@ -2761,25 +3828,13 @@ Node *PreFixPositioningTree(Node *T, int pos, char *left_son, int status, int *c
         return NULL;
 }
 
-/* It performs the Geometric Semantic Genetic Programming crossover operator for boolean functions
+/* It builds the offspring of the boolean crossover: (T1 AND TR) OR ((NOT TR) AND T2)
 Parameters:
-s: search space
-T1: pointer to the first tree
-T2: pointer to the second tree */
-Node *SGXB(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
-    Node *T3 = NULL, *TR = NULL, *TR_cpy = NULL, *LeftTree = NULL;
-    Node *RightTree = NULL, *T1 = NULL, *T2 = NULL, *NOT = NULL;
-
-    if (!s || !T1_tmp || !T2_tmp) {
-        fprintf(stderr, "\nInput error @SGXB.\n");
-        return NULL;
-    }
-
-    T1 = CopyTree(T1_tmp);
-    T2 = CopyTree(T2_tmp);
+T1, T2: parent trees (they become part of the offspring)
+TR: random tree (it becomes part of the offspring, and a copy of it is made) */
+static Node *BuildSGXB(Node *T1, Node *T2, Node *TR) {
+    Node *T3 = NULL, *TR_cpy = NULL, *LeftTree = NULL, *RightTree = NULL, *NOT = NULL;
 
-    /* It generates a random tree. It is expected a random tree with boolean functions if properly defined when creating the search space. */
-    TR = GROW(s, s->min_depth, s->max_depth);
     TR_cpy = CopyTree(TR);
 
     T3 = CreateNode("OR", getFUNCTIONid("OR"), FUNCTION); /* It creates the root */
@@ -2810,28 +3865,15 @@ Node *SGXB(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
     return T3;
 }
 
-/* It performs the Geometric Semantic Genetic Programming mutation operator for boolean functions
+/* It builds the offspring of the boolean mutation: T OR M, or T AND (NOT M)
 Parameters:
-s: search space
-T: pointer to the tree */
-Node *SGMB(SearchSpace *s, Node *T_tmp) {
-    Node *TM = NULL, *T = NULL, *M = NULL, *NOT = NULL;
-    double r;
-    int i;
-
-    if (!s || !T_tmp) {
-        fprintf(stderr, "\nInput error @SGMB.\n");
-        return NULL;
-    }
-
-    r = randinter(0, 1);
-    T = CopyTree(T_tmp);
-
-    M = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
-    for (i = 0; i < s->n; i++)
-        M->val[i] = round(GenerateUniformRandomNumber(s->LB[0], s->UB[0])); /* Creating a random minterm */
+T: parent tree (it becomes part of the offspring)
+M: random minterm (it becomes part of the offspring)
+use_or: 1 for T OR M, 0 for T AND (NOT M) */
+static Node *BuildSGMB(Node *T, Node *M, int use_or) {
+    Node *TM = NULL, *NOT = NULL;
 
-    if (r <= 0.5) {
+    if (use_or) {
         TM = CreateNode("OR", getFUNCTIONid("OR"), FUNCTION);
         TM->parent = NULL;
         TM->left = T;
@@ -2854,31 +3896,16 @@ Node *SGMB(SearchSpace *s, Node *T_tmp) {
 
     return TM;
 }
-/***********************/
 
-/* It performs the Geometric Semantic Genetic Programming crossover operator for real-valued functions
+/* It builds the offspring of the real-valued crossover and mutation: (T1 * TR) + ((1 - TR) * T2)
 Parameters:
-s: search space
-T1: pointer to the first tree
-T2: pointer to the second tree */
-Node *SGXE(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
-    Node *T3 = NULL, *TR = NULL, *LeftTree = NULL;
-    Node *RightTree = NULL, *T1 = NULL, *T2 = NULL, *NOT_TR = NULL;
+T1, T2: parent trees (they become part of the offspring)
+TR: random array (it becomes part of the offspring)
+n: number of decision variables */
+static Node *BuildSGXE(Node *T1, Node *T2, Node *TR, int n) {
+    Node *T3 = NULL, *LeftTree = NULL, *RightTree = NULL, *NOT_TR = NULL;
     int i;
 
-    if (!s || !T1_tmp || !T2_tmp) {
-        fprintf(stderr, "\nInput error @SGXE.\n");
-        return NULL;
-    }
-
-    T1 = CopyTree(T1_tmp);
-    T2 = CopyTree(T2_tmp);
-
-    /* It generates an array with random values within [0,1] */
-    TR = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
-    for (i = 0; i < s->n; i++)
-        TR->val[i] = GenerateUniformRandomNumber(0, 1); /* Creating an array composed of random numbers */
-
     T3 = CreateNode("SUM", getFUNCTIONid("SUM"), FUNCTION); /* It creates the root */
     T3->parent = NULL;
 
@@ -2896,8 +3923,8 @@ Node *SGXE(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
     RightTree->parent = T3;
     RightTree->left_son = 0;
 
-    NOT_TR = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
-    for (i = 0; i < s->n; i++)
+    NOT_TR = CreateNode("TMP", 0, NEW_TERMINAL, n);
+    for (i = 0; i < n; i++)
         NOT_TR->val[i] = 1 - TR->val[i]; /* Creating 1-TR */
 
     RightTree->left = NOT_TR;
@@ -2909,93 +3936,1154 @@ Node *SGXE(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
     return T3;
 }
 
-/* It performs the Geometric Semantic Genetic Programming mutation operator for real-valued functions
+/* It performs the Geometric Semantic Genetic Programming crossover operator for boolean functions
 Parameters:
 s: search space
 T1: pointer to the first tree
 T2: pointer to the second tree */
-Node *SGME(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
-    Node *T3 = NULL, *TR = NULL, *LeftTree = NULL;
-    Node *RightTree = NULL, *T1 = NULL, *T2 = NULL, *NOT_TR = NULL;
-    int i, j;
+Node *SGXB(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
+    Node *TR = NULL, *T1 = NULL, *T2 = NULL;
 
     if (!s || !T1_tmp || !T2_tmp) {
-        fprintf(stderr, "\nInput error @SGME.\n");
+        fprintf(stderr, "\nInput error @SGXB.\n");
         return NULL;
     }
 
     T1 = CopyTree(T1_tmp);
     T2 = CopyTree(T2_tmp);
 
-    /* It generates an array with random values within [0,1] */
-    TR = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
-    for (i = 0; i < s->n; i++)
-        TR->val[i] = GenerateUniformRandomNumber(0, 1); /* Creating an array composed of random numbers */
+    /* It generates a random tree. It is expected a random tree with boolean functions if properly defined when creating the search space. */
+    TR = GROW(s, s->min_depth, s->max_depth);
 
-    /* Now we choose a random number within [0,2] in order to pick some
-    function bounded within [0,1] at random */
-    j = round(GenerateUniformRandomNumber(0, 2));
-    switch (j) {
-        case 0:
-            for (i = 0; i < s->n; i++)
-                TR->val[i] = exp(TR->val[i]);
-            break;
-        case 1:
-            for (i = 0; i < s->n; i++)
-                TR->val[i] = fabs(sin(TR->val[i]));
-            break;
-        case 2:
-            for (i = 0; i < s->n; i++)
-                TR->val[i] = cos(sin(TR->val[i]));
-            break;
-    }
+    return BuildSGXB(T1, T2, TR);
+}
 
-    T3 = CreateNode("SUM", getFUNCTIONid("SUM"), FUNCTION); /* It creates the root */
-    T3->parent = NULL;
+/* It performs the Geometric Semantic Genetic Programming mutation operator for boolean functions
+Parameters:
+s: search space
+T: pointer to the tree */
+Node *SGMB(SearchSpace *s, Node *T_tmp) {
+    Node *T = NULL, *M = NULL;
+    double r;
+    int i;
 
-    LeftTree = CreateNode("MUL", getFUNCTIONid("MUL"), FUNCTION); /* It creates the tree on the left */
-    T3->left = LeftTree;
-    LeftTree->parent = T3;
-    LeftTree->left = T1;
-    T1->parent = LeftTree;
-    LeftTree->right = TR;
-    TR->parent = LeftTree;
-    TR->left_son = 0;
+    if (!s || !T_tmp) {
+        fprintf(stderr, "\nInput error @SGMB.\n");
+        return NULL;
+    }
 
-    RightTree = CreateNode("MUL", getFUNCTIONid("MUL"), FUNCTION); /* It creates the tree on the right */
-    T3->right = RightTree;
-    RightTree->parent = T3;
-    RightTree->left_son = 0;
+    r = randinter(0, 1);
+    T = CopyTree(T_tmp);
 
-    NOT_TR = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
+    M = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
     for (i = 0; i < s->n; i++)
-        NOT_TR->val[i] = 1 - TR->val[i]; /* Creating 1-TR */
+        M->val[i] = round(GenerateUniformRandomNumber(s->LB[0], s->UB[0])); /* Creating a random minterm */
 
-    RightTree->left = NOT_TR;
-    NOT_TR->parent = RightTree;
-    RightTree->right = T2;
-    T2->parent = RightTree;
-    T2->left_son = 0;
+    return BuildSGMB(T, M, r <= 0.5);
+}
+/***********************/
 
-    return T3;
+/* It performs the Geometric Semantic Genetic Programming crossover operator for real-valued functions
+Parameters:
+s: search space
+T1: pointer to the first tree
+T2: pointer to the second tree */
+Node *SGXE(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
+    Node *TR = NULL, *T1 = NULL, *T2 = NULL;
+    int i;
+
+    if (!s || !T1_tmp || !T2_tmp) {
+        fprintf(stderr, "\nInput error @SGXE.\n");
+        return NULL;
+    }
+
+    T1 = CopyTree(T1_tmp);
+    T2 = CopyTree(T2_tmp);
+
+    /* It generates an array with random values within [0,1] */
+    TR = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
+    for (i = 0; i < s->n; i++)
+        TR->val[i] = GenerateUniformRandomNumber(0, 1); /* Creating an array composed of random numbers */
+
+    return BuildSGXE(T1, T2, TR, s->n);
+}
+
+/* It generates the random array of the real-valued mutation
+ * A random array within [0,1] is mapped by a function picked at random among exp, |sin| and cos(sin).
+Parameters:
+s: search space
+tr: output array (n doubles) */
+static void GenerateSGMEArray(SearchSpace *s, double *tr) {
+    int i, j;
+
+    for (i = 0; i < s->n; i++)
+        tr[i] = GenerateUniformRandomNumber(0, 1); /* Creating an array composed of random numbers */
+
+    /* Now we choose a random number within [0,2] in order to pick some
+    function bounded within [0,1] at random */
+    j = round(GenerateUniformRandomNumber(0, 2));
+    switch (j) {
+        case 0:
+            for (i = 0; i < s->n; i++)
+                tr[i] = exp(tr[i]);
+            break;
+        case 1:
+            for (i = 0; i < s->n; i++)
+                tr[i] = fabs(sin(tr[i]));
+            break;
+        case 2:
+            for (i = 0; i < s->n; i++)
+                tr[i] = cos(sin(tr[i]));
+            break;
+    }
+}
+
+/* It performs the Geometric Semantic Genetic Programming mutation operator for real-valued functions
+Parameters:
+s: search space
+T1: pointer to the first tree
+T2: pointer to the second tree */
+Node *SGME(SearchSpace *s, Node *T1_tmp, Node *T2_tmp) {
+    Node *TR = NULL, *T1 = NULL, *T2 = NULL;
+
+    if (!s || !T1_tmp || !T2_tmp) {
+        fprintf(stderr, "\nInput error @SGME.\n");
+        return NULL;
+    }
+
+    T1 = CopyTree(T1_tmp);
+    T2 = CopyTree(T2_tmp);
+
+    /* It generates an array with random values within [0,1] */
+    TR = CreateNode("TMP", 0, NEW_TERMINAL, s->n);
+    GenerateSGMEArray(s, TR->val);
+
+    return BuildSGXE(T1, T2, TR, s->n);
+}
+
+/* Semantic GSGP-related functions */
+/* It creates an empty ancestry log
+Parameters:
+m: number of individuals
+n: number of decision variables */
+GSGPLog *CreateGSGPLog(int m, int n) {
+    if ((m < 1) || (n < 1)) {
+        fprintf(stderr, "\nInvalid input @CreateGSGPLog.\n");
+        return NULL;
+    }
+
+    GSGPLog *l = NULL;
+
+    l = (GSGPLog *) malloc(sizeof(GSGPLog));
+    l->m = m;
+    l->n = n;
+    l->T = (Node **) calloc(m, sizeof(Node *));
+    l->record = NULL;
+    l->n_generations = l->capacity = 0;
+    l->semantics = (double *) calloc((size_t) m * n, sizeof(double));
+    l->next = (double *) calloc((size_t) m * n, sizeof(double));
+    l->tmp = (double *) calloc(n, sizeof(double));
+
+    return l;
+}
+
+/* It deallocates an ancestry log
+Parameters:
+l: address of the log to be deallocated */
+void DestroyGSGPLog(GSGPLog **l) {
+    GSGPLog *tmp = NULL;
+
+    tmp = *l;
+    if (!tmp) {
+        fprintf(stderr, "\nAncestry log not allocated @DestroyGSGPLog.\n");
+        exit(-1);
+    }
+
+    ClearGSGPLog(tmp);
+    free(tmp->T);
+    if (tmp->record) free(tmp->record);
+    free(tmp->semantics);
+    free(tmp->next);
+    free(tmp->tmp);
+    free(tmp);
+    *l = NULL;
+}
+
+/* It removes all recorded generations and trees from an ancestry log
+Parameters:
+l: ancestry log */
+void ClearGSGPLog(GSGPLog *l) {
+    if (!l) {
+        fprintf(stderr, "\nAncestry log not allocated @ClearGSGPLog.\n");
+        exit(-1);
+    }
+
+    int g, i;
+
+    for (g = 0; g < l->n_generations; g++) {
+        for (i = 0; i < l->m; i++) {
+            if (l->record[g][i].val) free(l->record[g][i].val);
+            if (l->record[g][i].tree) DestroyTree(&(l->record[g][i].tree));
+        }
+        free(l->record[g]);
+    }
+    l->n_generations = 0;
+
+    for (i = 0; i < l->m; i++)
+        if (l->T[i]) DestroyTree(&(l->T[i]));
+}
+
+/* It starts a log from the current trees of a search space
+ * The trees are moved from s->T to the log (s->T[i] is set to NULL), and their outputs become the semantics of the first generation.
+Parameters:
+s: search space
+l: ancestry log */
+void StartGSGPLog(SearchSpace *s, GSGPLog *l) {
+    if ((!s) || (!l)) {
+        fprintf(stderr, "\nInvalid input @StartGSGPLog.\n");
+        exit(-1);
+    }
+
+    if ((l->m != s->m) || (l->n != s->n)) {
+        fprintf(stderr, "\nAncestry log does not match the search space @StartGSGPLog.\n");
+        exit(-1);
+    }
+
+    int i;
+
+    ClearGSGPLog(l);
+    if (!s->program)
+        s->program = CreateGPProgram();
+
+    for (i = 0; i < s->m; i++) {
+        if (!s->T[i]) {
+            fprintf(stderr, "\nTree %d not allocated @StartGSGPLog.\n", i);
+            exit(-1);
+        }
+        CompileTree(s, s->T[i], s->program);
+        memcpy(l->semantics + (size_t) i * l->n, RunGPProgram(s, s->program), l->n * sizeof(double));
+        l->T[i] = s->T[i];
+        s->T[i] = NULL;
+    }
+}
+
+/* It starts recording a new generation
+ * Every individual of the new generation starts as a copy of the individual at the same position of the current one.
+Parameters:
+l: ancestry log */
+void BeginGSGPGeneration(GSGPLog *l) {
+    if (!l) {
+        fprintf(stderr, "\nAncestry log not allocated @BeginGSGPGeneration.\n");
+        exit(-1);
+    }
+
+    GSGPRecord *r = NULL;
+    int i;
+
+    if (l->n_generations == l->capacity) {
+        l->capacity = l->capacity ? 2 * l->capacity : 16;
+        l->record = (GSGPRecord **) realloc(l->record, l->capacity * sizeof(GSGPRecord *));
+    }
+
+    r = (GSGPRecord *) malloc(l->m * sizeof(GSGPRecord));
+    for (i = 0; i < l->m; i++) {
+        r[i].op = GSGP_REPRODUCTION;
+        r[i].parent[0] = i;
+        r[i].parent[1] = -1;
+        r[i].val = NULL;
+        r[i].tree = NULL;
+    }
+    l->record[l->n_generations++] = r;
+
+    memcpy(l->next, l->semantics, (size_t) l->m * l->n * sizeof(double));
+}
+
+/* It makes the generation being recorded the current one
+Parameters:
+l: ancestry log */
+void EndGSGPGeneration(GSGPLog *l) {
+    if (!l) {
+        fprintf(stderr, "\nAncestry log not allocated @EndGSGPGeneration.\n");
+        exit(-1);
+    }
+
+    double *aux = NULL;
+
+    aux = l->semantics;
+    l->semantics = l->next;
+    l->next = aux;
+}
+
+/* It returns the record of the i-th individual of the generation being recorded, releasing the data of a previous record
+Parameters:
+l: ancestry log
+i: position of the individual */
+static GSGPRecord *GetGSGPRecord(GSGPLog *l, int i) {
+    GSGPRecord *r = NULL;
+
+    if ((!l->n_generations) || (i < 0) || (i >= l->m)) {
+        fprintf(stderr, "\nInvalid input @GetGSGPRecord.\n");
+        exit(-1);
+    }
+
+    r = &(l->record[l->n_generations - 1][i]);
+    if (r->val) free(r->val);
+    if (r->tree) DestroyTree(&(r->tree));
+    r->val = NULL;
+    r->tree = NULL;
+
+    return r;
+}
+
+/* It copies the j-th individual into the i-th position of the new generation
+Parameters:
+l: ancestry log
+i: position in the new generation
+j: position in the current generation */
+void ReproductionSemantics(GSGPLog *l, int i, int j) {
+    GSGPRecord *r = GetGSGPRecord(l, i);
+
+    r->op = GSGP_REPRODUCTION;
+    r->parent[0] = j;
+    r->parent[1] = -1;
+    memcpy(l->next + (size_t) i * l->n, l->semantics + (size_t) j * l->n, l->n * sizeof(double));
+}
+
+/* It applies SGXB to the outputs of two individuals
+ * It draws the same random numbers as SGXB, and the output of the offspring is exactly the one of the tree built by SGXB.
+Parameters:
+s: search space
+l: ancestry log
+i: position of the offspring in the new generation
+father, mother: positions of the parents in the current generation */
+void SGXBSemantics(SearchSpace *s, GSGPLog *l, int i, int father, int mother) {
+    GSGPRecord *r = GetGSGPRecord(l, i);
+    double *out = l->next + (size_t) i * l->n, *tr = NULL;
+
+    r->op = GSGP_SGXB;
+    r->parent[0] = father;
+    r->parent[1] = mother;
+    r->tree = GROW(s, s->min_depth, s->max_depth);
+
+    tr = RunTree(s, r->tree);
+    f_AND_Into(l->semantics + (size_t) father * l->n, tr, out, l->n); /* T1 AND TR */
+    f_NOT_Into(tr, l->tmp, l->n);
+    f_AND_Into(l->tmp, l->semantics + (size_t) mother * l->n, l->tmp, l->n); /* (NOT TR) AND T2 */
+    f_OR_Into(out, l->tmp, out, l->n);
+    free(tr);
+}
+
+/* It applies SGMB to the output of an individual
+ * It draws the same random numbers as SGMB, and the output of the offspring is exactly the one of the tree built by SGMB.
+Parameters:
+s: search space
+l: ancestry log
+i: position of the offspring in the new generation
+j: position of the parent in the current generation */
+void SGMBSemantics(SearchSpace *s, GSGPLog *l, int i, int j) {
+    GSGPRecord *r = GetGSGPRecord(l, i);
+    double *out = l->next + (size_t) i * l->n, prob;
+    int k;
+
+    prob = randinter(0, 1);
+    r->op = prob <= 0.5 ? GSGP_SGMB_OR : GSGP_SGMB_AND;
+    r->parent[0] = j;
+    r->parent[1] = -1;
+    r->val = (double *) malloc(l->n * sizeof(double));
+    for (k = 0; k < l->n; k++)
+        r->val[k] = round(GenerateUniformRandomNumber(s->LB[0], s->UB[0])); /* Creating a random minterm */
+
+    if (r->op == GSGP_SGMB_OR)
+        f_OR_Into(l->semantics + (size_t) j * l->n, r->val, out, l->n);
+    else {
+        f_NOT_Into(r->val, l->tmp, l->n);
+        f_AND_Into(l->semantics + (size_t) j * l->n, l->tmp, out, l->n);
+    }
+}
+
+/* It computes (x * tr) + ((1 - tr) * y), as the tree built by BuildSGXE does
+Parameters:
+l: ancestry log
+i: position of the offspring in the new generation
+father, mother: positions of the parents in the current generation
+tr: random array */
+static void SGXESemanticsFrom(GSGPLog *l, int i, int father, int mother, double *tr) {
+    double *out = l->next + (size_t) i * l->n;
+    int k;
+
+    for (k = 0; k < l->n; k++)
+        l->tmp[k] = 1 - tr[k];
+    f_MUL_Into(l->tmp, l->semantics + (size_t) mother * l->n, l->tmp, l->n);
+    f_MUL_Into(l->semantics + (size_t) father * l->n, tr, out, l->n);
+    f_SUM_Into(out, l->tmp, out, l->n);
+}
+
+/* It applies SGXE to the outputs of two individuals
+ * It draws the same random numbers as SGXE, and the output of the offspring is exactly the one of the tree built by SGXE.
+Parameters:
+s: search space
+l: ancestry log
+i: position of the offspring in the new generation
+father, mother: positions of the parents in the current generation */
+void SGXESemantics(SearchSpace *s, GSGPLog *l, int i, int father, int mother) {
+    GSGPRecord *r = GetGSGPRecord(l, i);
+    int k;
+
+    r->op = GSGP_SGXE;
+    r->parent[0] = father;
+    r->parent[1] = mother;
+    r->val = (double *) malloc(l->n * sizeof(double));
+    for (k = 0; k < l->n; k++)
+        r->val[k] = GenerateUniformRandomNumber(0, 1); /* Creating an array composed of random numbers */
+
+    SGXESemanticsFrom(l, i, father, mother, r->val);
+}
+
+/* It applies SGME to the outputs of two individuals
+ * It draws the same random numbers as SGME, and the output of the offspring is exactly the one of the tree built by SGME.
+Parameters:
+s: search space
+l: ancestry log
+i: position of the offspring in the new generation
+father, mother: positions of the parents in the current generation */
+void SGMESemantics(SearchSpace *s, GSGPLog *l, int i, int father, int mother) {
+    GSGPRecord *r = GetGSGPRecord(l, i);
+
+    r->op = GSGP_SGME;
+    r->parent[0] = father;
+    r->parent[1] = mother;
+    r->val = (double *) malloc(l->n * sizeof(double));
+    GenerateSGMEArray(s, r->val);
+
+    SGXESemanticsFrom(l, i, father, mother, r->val);
+}
+
+/* It returns the size of the tree of the i-th individual of the last generation
+ * The size is returned as a double, since it grows exponentially with the number of generations.
+Parameters:
+l: ancestry log
+i: position of the individual */
+double getSizeGSGPTree(GSGPLog *l, int i) {
+    if ((!l) || (i < 0) || (i >= l->m)) {
+        fprintf(stderr, "\nInvalid input @getSizeGSGPTree.\n");
+        return 0;
+    }
+
+    double *size = NULL, *next = NULL, *aux = NULL, out;
+    GSGPRecord *r = NULL;
+    int g, j;
+
+    size = (double *) malloc(l->m * sizeof(double));
+    next = (double *) malloc(l->m * sizeof(double));
+    for (j = 0; j < l->m; j++)
+        size[j] = getSizeTree(l->T[j]);
+
+    for (g = 0; g < l->n_generations; g++) {
+        for (j = 0; j < l->m; j++) {
+            r = &(l->record[g][j]);
+            switch (r->op) {
+                case GSGP_REPRODUCTION:
+                    next[j] = size[r->parent[0]];
+                    break;
+                case GSGP_SGXE:
+                case GSGP_SGME:
+                    next[j] = size[r->parent[0]] + size[r->parent[1]] + 5;
+                    break;
+                case GSGP_SGXB:
+                    next[j] = size[r->parent[0]] + size[r->parent[1]] + 2 * getSizeTree(r->tree) + 4;
+                    break;
+                case GSGP_SGMB_OR:
+                    next[j] = size[r->parent[0]] + 2;
+                    break;
+                case GSGP_SGMB_AND:
+                    next[j] = size[r->parent[0]] + 3;
+                    break;
+            }
+        }
+        aux = size;
+        size = next;
+        next = aux;
+    }
+
+    out = size[i];
+    free(size);
+    free(next);
+
+    return out;
+}
+
+/* It rebuilds the tree of the i-th individual of a given generation
+Parameters:
+l: ancestry log
+g: generation (0 for the initial population)
+i: position of the individual */
+static Node *BuildGSGPTree(GSGPLog *l, int g, int i) {
+    GSGPRecord *r = NULL;
+    Node *TR = NULL;
+
+    if (!g)
+        return CopyTree(l->T[i]);
+
+    r = &(l->record[g - 1][i]);
+    switch (r->op) {
+        case GSGP_REPRODUCTION:
+            return BuildGSGPTree(l, g - 1, r->parent[0]);
+        case GSGP_SGXE:
+        case GSGP_SGME:
+            TR = CreateNode("TMP", 0, NEW_TERMINAL, l->n);
+            memcpy(TR->val, r->val, l->n * sizeof(double));
+            return BuildSGXE(BuildGSGPTree(l, g - 1, r->parent[0]), BuildGSGPTree(l, g - 1, r->parent[1]), TR, l->n);
+        case GSGP_SGXB:
+            return BuildSGXB(BuildGSGPTree(l, g - 1, r->parent[0]), BuildGSGPTree(l, g - 1, r->parent[1]), CopyTree(r->tree));
+        default:
+            TR = CreateNode("TMP", 0, NEW_TERMINAL, l->n);
+            memcpy(TR->val, r->val, l->n * sizeof(double));
+            return BuildSGMB(BuildGSGPTree(l, g - 1, r->parent[0]), TR, r->op == GSGP_SGMB_OR);
+    }
+}
+
+/* It rebuilds the tree of the i-th individual of the last generation
+ * The tree is the same one the tree-based GSGP and BGSGP would have evolved, so its size grows exponentially with the number
+ * of generations (see getSizeGSGPTree).
+Parameters:
+l: ancestry log
+i: position of the individual */
+Node *GetGSGPTree(GSGPLog *l, int i) {
+    if ((!l) || (i < 0) || (i >= l->m) || (!l->T[i])) {
+        fprintf(stderr, "\nInvalid input @GetGSGPTree.\n");
+        return NULL;
+    }
+
+    return BuildGSGPTree(l, l->n_generations, i);
+}
+
+/* It enables or disables the semantic engine of GSGP and BGSGP
+ * When it is enabled, GSGP and BGSGP evolve the outputs of the trees instead of the trees themselves, which makes each
+ * generation linear in the number of decision variables instead of the size of the trees. The trees are moved from s->T
+ * to s->gsgp_log when the optimization starts, and the ones of the last generation can be rebuilt by GetGSGPTree.
+Parameters:
+s: search space
+enable: 1 to enable the engine, 0 to disable it (the log is released) */
+void SetSemanticGSGP(SearchSpace *s, int enable) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @SetSemanticGSGP.\n");
+        exit(-1);
+    }
+
+    if ((enable) && (!s->gsgp_log))
+        s->gsgp_log = CreateGSGPLog(s->m, s->n);
+    else if ((!enable) && (s->gsgp_log))
+        DestroyGSGPLog(&(s->gsgp_log));
+}
+/***********************/
+
+/* Tree pool-related functions */
+/* It creates an empty pool of trees
+Parameters:
+m: number of trees */
+TreePool *CreateTreePool(int m) {
+    if (m < 1) {
+        fprintf(stderr, "\nInvalid number of trees @CreateTreePool.\n");
+        return NULL;
+    }
+
+    TreePool *p = NULL;
+    int i;
+
+    p = (TreePool *) malloc(sizeof(TreePool));
+    p->m = m;
+    p->used = 0;
+    p->capacity = 0;
+    p->node = NULL;
+    p->root = (int *) malloc(m * sizeof(int));
+    for (i = 0; i < m; i++)
+        p->root[i] = -1;
+
+    return p;
+}
+
+/* It deallocates a pool of trees
+Parameters:
+p: address of the pool to be deallocated */
+void DestroyTreePool(TreePool **p) {
+    TreePool *tmp = NULL;
+
+    tmp = *p;
+    if (!tmp) {
+        fprintf(stderr, "\nTree pool not allocated @DestroyTreePool.\n");
+        exit(-1);
+    }
+
+    if (tmp->node) free(tmp->node);
+    free(tmp->root);
+    free(tmp);
+    *p = NULL;
+}
+
+/* It removes all trees from a pool
+ * The memory of the nodes is kept, so the pool can be refilled without any allocation.
+Parameters:
+p: pool */
+void ClearTreePool(TreePool *p) {
+    if (!p) {
+        fprintf(stderr, "\nTree pool not allocated @ClearTreePool.\n");
+        exit(-1);
+    }
+
+    p->used = 0;
+}
+
+/* It appends uninitialized nodes to a pool, and it returns the position of the first one
+ * The array of nodes may be reallocated, so nodes must be referred to by their positions.
+Parameters:
+p: pool
+n: number of nodes */
+static int ReserveTreeNodes(TreePool *p, int n) {
+    int k = p->used;
+
+    if (p->used + n > p->capacity) {
+        p->capacity = p->capacity ? 2 * p->capacity : 256;
+        if (p->capacity < p->used + n)
+            p->capacity = p->used + n;
+        p->node = (TreeNode *) realloc(p->node, p->capacity * sizeof(TreeNode));
+    }
+    p->used += n;
+
+    return k;
+}
+
+/* It appends a copy of n consecutive nodes to a pool
+Parameters:
+p: pool
+node: nodes to be copied (they must not belong to p)
+n: number of nodes */
+static void AppendTreeNodes(TreePool *p, const TreeNode *node, int n) {
+    int k;
+
+    if (n <= 0)
+        return;
+
+    k = ReserveTreeNodes(p, n);
+    memcpy(p->node + k, node, n * sizeof(TreeNode));
+}
+
+/* It starts the i-th tree of a pool at the end of its nodes
+Parameters:
+p: pool
+i: position of the tree
+caller: name of the public function, used by error messages */
+static void BeginPooledTree(TreePool *p, int i, const char *caller) {
+    if ((!p) || (i < 0) || (i >= p->m)) {
+        fprintf(stderr, "\nInvalid input parameters @%s.\n", caller);
+        exit(-1);
+    }
+
+    p->root[i] = p->used;
+}
+
+/* It returns the nodes of the i-th tree of a pool
+Parameters:
+p: pool
+i: position of the tree
+caller: name of the public function, used by error messages */
+static TreeNode *GetPooledTree(TreePool *p, int i, const char *caller) {
+    if ((!p) || (i < 0) || (i >= p->m) || (p->root[i] < 0) || (p->root[i] >= p->used)) {
+        fprintf(stderr, "\nThere is no tree allocated @%s.\n", caller);
+        exit(-1);
+    }
+
+    return p->node + p->root[i];
+}
+
+/* It appends a subtree in prefix order to a pool
+Parameters:
+p: pool
+T: subtree */
+static void AppendNode(TreePool *p, Node *T) {
+    TreeNode *node = NULL;
+    int k;
+
+    k = ReserveTreeNodes(p, 1);
+    node = p->node + k;
+    node->status = T->status;
+    node->id = T->id;
+    node->n_args = 0;
+    if (T->status == FUNCTION) {
+        node->opcode = getFUNCTIONid(T->elem);
+        if (node->opcode == -1) {
+            fprintf(stderr, "\nFunction %s is not supported @Tree2Pool.\n", T->elem);
+            exit(-1);
+        }
+    } else if ((T->status == TERMINAL) || (T->status == CONSTANT))
+        node->opcode = -1;
+    else {
+        fprintf(stderr, "\nNodes of Geometric Semantic GP trees are not supported @Tree2Pool.\n");
+        exit(-1);
+    }
+
+    if (T->left) {
+        AppendNode(p, T->left);
+        p->node[k].n_args++;
+    }
+    if (T->right) {
+        AppendNode(p, T->right);
+        p->node[k].n_args++;
+    }
+    p->node[k].size = p->used - k;
+}
+
+/* It stores a tree as the i-th tree of a pool
+Parameters:
+p: pool
+i: position of the tree
+T: tree (it is not modified) */
+void Tree2Pool(TreePool *p, int i, Node *T) {
+    if (!T) {
+        fprintf(stderr, "\nThere is no tree allocated @Tree2Pool.\n");
+        exit(-1);
+    }
+
+    BeginPooledTree(p, i, "Tree2Pool");
+    AppendNode(p, T);
+}
+
+/* It creates the subtree rooted at the k-th node of a pooled tree
+Parameters:
+s: search space
+T: nodes of the pooled tree
+k: position of the node */
+static Node *PooledNode2Tree(SearchSpace *s, const TreeNode *T, int k) {
+    Node *node = NULL, *son = NULL;
+    int i, c;
+
+    if (T[k].status == FUNCTION)
+        node = CreateNode(s->function[T[k].id], T[k].id, FUNCTION);
+    else if (T[k].status == CONSTANT)
+        node = CreateNode("CONST", T[k].id, CONSTANT);
+    else
+        node = CreateNode(s->terminal[T[k].id], T[k].id, TERMINAL);
+
+    c = k + 1;
+    for (i = 0; i < T[k].n_args; i++) {
+        son = PooledNode2Tree(s, T, c);
+        if (!i)
+            node->left = son;
+        else {
+            node->right = son;
+            son->left_son = 0;
+        }
+        son->parent = node;
+        c += T[c].size;
+    }
+
+    return node;
+}
+
+/* It creates a tree from the i-th tree of a pool
+Parameters:
+s: search space
+p: pool
+i: position of the tree */
+Node *Pool2Tree(SearchSpace *s, TreePool *p, int i) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @Pool2Tree.\n");
+        exit(-1);
+    }
+
+    return PooledNode2Tree(s, GetPooledTree(p, i, "Pool2Tree"), 0);
+}
+
+/* It returns the size of the i-th tree of a pool (number of nodes)
+Parameters:
+p: pool
+i: position of the tree */
+int getSizePooledTree(TreePool *p, int i) {
+    return GetPooledTree(p, i, "getSizePooledTree")->size;
+}
+
+/* It appends a random subtree to a pool based on the GROW algorithm (see GROW, whose random choices are reproduced)
+Parameters:
+s: search space
+p: pool
+min_depth: minimum depth
+max_depth: maximum depth */
+static void GROWNode(SearchSpace *s, TreePool *p, int min_depth, int max_depth) {
+    int i, aux, k;
+
+    k = ReserveTreeNodes(p, 1);
+    p->node[k].opcode = -1;
+    p->node[k].n_args = 0;
+
+    if (min_depth == max_depth)
+        aux = round(GenerateUniformRandomNumber(0, s->n_terminals - 1));
+    else
+        aux = round(GenerateUniformRandomNumber(0, s->n_functions + s->n_terminals - 1)) - s->n_functions;
+
+    if (aux >= 0) { /* If aux is a terminal node */
+        if (!strcmp(s->terminal[aux], "CONST")) {
+            p->node[k].status = CONSTANT;
+            p->node[k].id = round(GenerateUniformRandomNumber(0, s->n_constants - 1));
+        } else {
+            p->node[k].status = TERMINAL;
+            p->node[k].id = aux;
+        }
+    } else { /* The new node is function one */
+        aux += s->n_functions;
+        p->node[k].status = FUNCTION;
+        p->node[k].id = aux;
+        p->node[k].opcode = getFUNCTIONid(s->function[aux]);
+        p->node[k].n_args = N_ARGS_FUNCTION[p->node[k].opcode];
+        for (i = 0; i < p->node[k].n_args; i++)
+            GROWNode(s, p, min_depth + 1, max_depth);
+    }
+    p->node[k].size = p->used - k;
+}
+
+/* It creates a random tree into a pool based on the GROW algorithm
+Parameters:
+s: search space
+p: pool
+i: position of the new tree
+min_depth: minimum depth
+max_depth: maximum depth */
+void GROWIntoPool(SearchSpace *s, TreePool *p, int i, int min_depth, int max_depth) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @GROWIntoPool.\n");
+        exit(-1);
+    }
+
+    BeginPooledTree(p, i, "GROWIntoPool");
+    GROWNode(s, p, min_depth, max_depth);
+}
+
+/* It copies a tree from one pool to another
+Parameters:
+dst: destination pool
+i: position of the copy in dst
+src: source pool (it must not be dst)
+j: position of the tree in src */
+void CopyTreeIntoPool(TreePool *dst, int i, TreePool *src, int j) {
+    TreeNode *T = NULL;
+
+    T = GetPooledTree(src, j, "CopyTreeIntoPool");
+    if (dst == src) {
+        fprintf(stderr, "\nSource and destination pools must be different @CopyTreeIntoPool.\n");
+        exit(-1);
+    }
+
+    BeginPooledTree(dst, i, "CopyTreeIntoPool");
+    AppendTreeNodes(dst, T, T->size);
+}
+
+/* It returns the position of the parent of the c-th node of a pooled tree (c > 0)
+Parameters:
+T: nodes of the pooled tree
+c: position of the node */
+static int PooledParent(const TreeNode *T, int c) {
+    int k = 0, son, i;
+
+    while (1) {
+        son = k + 1;
+        for (i = 0; i < T[k].n_args; i++) {
+            if (son == c)
+                return k;
+            if (c < son + T[son].size)
+                break;
+            son += T[son].size;
+        }
+        k = son;
+    }
+}
+
+/* It returns the position of the subtree replaced by mutation and crossover, or -1 if there is none
+ * It reproduces the choice of PreFixPositioningTree: the pos-th node in prefix order (if status = TERMINAL) or its parent
+ * (if status = FUNCTION and the parent is not the root). If the latter fails, the search goes on from the end of the node's
+ * subtree, counting the positions again.
+Parameters:
+T: nodes of the pooled tree
+pos: position of the node in prefix order (starting at 1)
+status: FUNCTION|TERMINAL */
+static int PooledPositioningTree(const TreeNode *T, int pos, int status) {
+    int c = pos - 1, parent;
+
+    while (c < T->size) {
+        if (status == TERMINAL)
+            return c;
+        parent = PooledParent(T, c);
+        if (parent)
+            return parent;
+        c += T[c].size + pos - 1;
+    }
+
+    return -1;
+}
+
+/* It appends a tree to a pool in which the subtree at position r is replaced by another one
+ * The sizes of the ancestors of the new subtree are updated accordingly.
+Parameters:
+dst: destination pool (its tree must have been started with BeginPooledTree)
+T: nodes of the original tree (they must not belong to dst)
+r: position of the subtree to be replaced
+sub: nodes of the new subtree (they must not belong to dst), or NULL to grow a random subtree
+s: search space (only if sub is NULL) */
+static void SplicePooledTree(TreePool *dst, const TreeNode *T, int r, const TreeNode *sub, SearchSpace *s) {
+    int root = dst->used, delta, k, son, i;
+
+    AppendTreeNodes(dst, T, r);
+    if (sub)
+        AppendTreeNodes(dst, sub, sub->size);
+    else
+        GROWNode(s, dst, s->min_depth, s->max_depth);
+    delta = dst->used - root - r - T[r].size;
+    AppendTreeNodes(dst, T + r + T[r].size, T->size - r - T[r].size);
+
+    k = 0; /* It goes down from the root to the new subtree */
+    while (k != r) {
+        dst->node[root + k].size += delta;
+        son = k + 1;
+        for (i = 0; i < T[k].n_args - 1; i++) {
+            if (r < son + T[son].size)
+                break;
+            son += T[son].size;
+        }
+        k = son;
+    }
+}
+
+/* It performs the mutation of a pooled tree (see Mutation, whose random choices are reproduced)
+ * Only the nodes of the mutated tree are written, with no memory allocation other than the growth of dst.
+Parameters:
+s: search space
+dst: destination pool
+i: position of the mutated tree in dst
+src: source pool (it must not be dst)
+j: position of the tree to be mutated in src
+p: probability of mutation at a function node */
+void MutationIntoPool(SearchSpace *s, TreePool *dst, int i, TreePool *src, int j, float p) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @MutationIntoPool.\n");
+        exit(-1);
+    }
+
+    TreeNode *T = NULL;
+    int mutation_point, r;
+
+    T = GetPooledTree(src, j, "MutationIntoPool");
+    if (dst == src) {
+        fprintf(stderr, "\nSource and destination pools must be different @MutationIntoPool.\n");
+        exit(-1);
+    }
+
+    BeginPooledTree(dst, i, "MutationIntoPool");
+    mutation_point = round(GenerateUniformRandomNumber(2, T->size)); /* Mutation point cannot be the root */
+    if (p > GenerateUniformRandomNumber(0, 1))
+        r = PooledPositioningTree(T, mutation_point, FUNCTION); /* the mutation point is a function node */
+    else
+        r = PooledPositioningTree(T, mutation_point, TERMINAL); /* the mutation point is a terminal node */
+
+    if (r > 0)
+        SplicePooledTree(dst, T, r, NULL, s);
+    else
+        GROWNode(s, dst, s->min_depth, s->max_depth);
+}
+
+/* It performs the crossover between two pooled trees (see Crossover, whose random choices are reproduced)
+Parameters:
+dst: destination pool
+i: position of the first offspring in dst
+k: position of the second offspring in dst, or -1 if it is not needed
+src: source pool (it must not be dst)
+father: position of the father tree in src
+mother: position of the mother tree in src
+p: probability of crossover on a function node */
+void CrossoverIntoPool(TreePool *dst, int i, int k, TreePool *src, int father, int mother, float p) {
+    TreeNode *F = NULL, *M = NULL;
+    int crossover_point, r_father, r_mother;
+
+    F = GetPooledTree(src, father, "CrossoverIntoPool");
+    M = GetPooledTree(src, mother, "CrossoverIntoPool");
+    if (dst == src) {
+        fprintf(stderr, "\nSource and destination pools must be different @CrossoverIntoPool.\n");
+        exit(-1);
+    }
+
+    crossover_point = round(GenerateUniformRandomNumber(2, F->size)); /* Crossover point cannot be the root */
+    if (p >= GenerateUniformRandomNumber(0, 1))
+        r_father = PooledPositioningTree(F, crossover_point, FUNCTION); /* the crossover point is a function node */
+    else
+        r_father = PooledPositioningTree(F, crossover_point, TERMINAL); /* the crossover point is a terminal node */
+
+    crossover_point = round(GenerateUniformRandomNumber(2, M->size)); /* Crossover point cannot be the root */
+    if (p >= GenerateUniformRandomNumber(0, 1))
+        r_mother = PooledPositioningTree(M, crossover_point, FUNCTION);
+    else
+        r_mother = PooledPositioningTree(M, crossover_point, TERMINAL);
+
+    /* If the crossover points have been properly found, the subtrees are swapped */
+    BeginPooledTree(dst, i, "CrossoverIntoPool");
+    if ((r_father > 0) && (r_mother > 0))
+        SplicePooledTree(dst, F, r_father, M + r_mother, NULL);
+    else
+        AppendTreeNodes(dst, F, F->size);
+
+    if (k != -1) {
+        BeginPooledTree(dst, k, "CrossoverIntoPool");
+        if ((r_father > 0) && (r_mother > 0))
+            SplicePooledTree(dst, M, r_mother, F + r_father, NULL);
+        else
+            AppendTreeNodes(dst, M, M->size);
+    }
+}
+
+/* It compiles the subtree rooted at the k-th node of a pooled tree in postfix order (see CompileNode)
+Parameters:
+T: nodes of the pooled tree
+k: position of the node
+p: GP program
+height: number of values on the stack when the subtree starts running (it is updated)
+caller: name of the public function, used by error messages */
+static void CompilePooledNode(const TreeNode *T, int k, GPProgram *p, int *height, const char *caller) {
+    int i, c, h;
+
+    if (T[k].opcode == -1) {
+        EmitInstruction(p, -1, T[k].status, T[k].id, NULL, 0);
+    } else {
+        if (((p->tensor_dim == -1) && (T[k].opcode > _NOT_)) || ((p->tensor_dim != -1) && (T[k].opcode < _TSUM_))) {
+            fprintf(stderr, "\nFunction %d is not supported by this kind of tree @%s.\n", T[k].opcode, caller);
+            exit(-1);
+        }
+        if (T[k].n_args < N_ARGS_FUNCTION[T[k].opcode]) {
+            fprintf(stderr, "\nMissing argument of function %d @%s.\n", T[k].opcode, caller);
+            exit(-1);
+        }
+
+        h = *height;
+        c = k + 1;
+        for (i = 0; i < T[k].n_args; i++) {
+            CompilePooledNode(T, c, p, height, caller);
+            c += T[c].size;
+        }
+        EmitInstruction(p, T[k].opcode, T[k].status, T[k].id, NULL, T[k].n_args);
+        *height = h;
+    }
+
+    (*height)++;
+    if (*height > p->depth)
+        p->depth = *height;
+}
+
+/* It compiles the i-th tree of a pool into a program whose instructions must be executed by RunGPProgram
+Parameters:
+s: search space
+pool: pool
+i: position of the tree
+p: GP program (its previous contents are discarded, and its memory is reused) */
+void CompilePooledTree(SearchSpace *s, TreePool *pool, int i, GPProgram *p) {
+    if ((!s) || (!p)) {
+        fprintf(stderr, "\nInvalid input parameters @CompilePooledTree.\n");
+        exit(-1);
+    }
+
+    int height = 0;
+
+    ResetGPProgram(s, p, -1);
+    CompilePooledNode(GetPooledTree(pool, i, "CompilePooledTree"), 0, p, &height, "CompilePooledTree");
+    ReserveGPStack(p);
+}
+
+/* It compiles the i-th tree of a pool into a tensor-based program whose instructions must be executed by RunGPProgram
+Parameters:
+s: search space
+pool: pool
+i: position of the tree
+p: GP program (its previous contents are discarded, and its memory is reused) */
+void CompilePooledTTree(SearchSpace *s, TreePool *pool, int i, GPProgram *p) {
+    if ((!s) || (!p)) {
+        fprintf(stderr, "\nInvalid input parameters @CompilePooledTTree.\n");
+        exit(-1);
+    }
+
+    int height = 0;
+
+    ResetGPProgram(s, p, s->tensor_dim);
+    CompilePooledNode(GetPooledTree(pool, i, "CompilePooledTTree"), 0, p, &height, "CompilePooledTTree");
+    ReserveGPStack(p);
+}
+
+/* It runs the i-th tree of a pool and outputs its solution array
+ * If the search space has a subtree cache (see SetSubtreeCache), the tree is run through it, and SyncSubtreeCache must have been
+ * called since the terminals or the constants last changed. Otherwise, it is compiled into s->program and run by RunGPProgram.
+Parameters:
+s: search space
+pool: pool
+i: position of the tree
+It returns the solution (n doubles), which must not be modified, and which is overwritten by the next run */
+double *RunPooledTree(SearchSpace *s, TreePool *pool, int i) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @RunPooledTree.\n");
+        exit(-1);
+    }
+
+    double *out = NULL;
+
+    if ((s->subtree_cache) && (s->subtree_cache->width == s->n))
+        out = RunCachedTree(s, s->subtree_cache, pool, i);
+    if (!out) {
+        if (!s->program)
+            s->program = CreateGPProgram();
+        CompilePooledTree(s, pool, i, s->program);
+        out = RunGPProgram(s, s->program);
+    }
+
+    return out;
+}
+
+/* It runs the i-th tensor-based tree of a pool and outputs its solution array (see RunPooledTree)
+Parameters:
+s: search space
+pool: pool
+i: position of the tree
+It returns the solution (n x tensor_dim doubles stored row by row), which must not be modified, and which is overwritten by the next run */
+double *RunPooledTTree(SearchSpace *s, TreePool *pool, int i) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @RunPooledTTree.\n");
+        exit(-1);
+    }
+
+    double *out = NULL;
+
+    if ((s->subtree_cache) && (s->subtree_cache->width == s->n * s->tensor_dim))
+        out = RunCachedTree(s, s->subtree_cache, pool, i);
+    if (!out) {
+        if (!s->program)
+            s->program = CreateGPProgram();
+        CompilePooledTTree(s, pool, i, s->program);
+        out = RunGPProgram(s, s->program);
+    }
+
+    return out;
 }
+/***********************/
 
 /* Tensor-related functions */
 /* It allocates a new tensor
+ * The n x tensor_dim values are stored row by row in a single 64-byte aligned block starting at t[0], and t[i] points to row i,
+ * so that the tensor can be copied at once and handed to the tensor kernels (see kernel.h). The rows must not be reallocated.
 Parameters:
 n: number of decision variables
 tensor_dim: tensor space dimension */
 double **CreateTensor(int n, int tensor_dim) {
-    if (tensor_dim <= 0) {
+    if ((n <= 0) || (tensor_dim <= 0)) {
         fprintf(stderr, "\nInvalid parameters @CreateTensor.\n");
         return NULL;
     }
     double **t = NULL;
     int i;
 
-    t = (double **) calloc(n, sizeof(double *));
-    for (i = 0; i < n; i++)
-        t[i] = (double *) calloc(tensor_dim, sizeof(double));
+    t = (double **) malloc(n * sizeof(double *));
+    t[0] = AllocateBlock(n * tensor_dim);
+    for (i = 1; i < n; i++)
+        t[i] = t[0] + i * tensor_dim;
 
     return t;
 }
@@ -3006,7 +5094,6 @@ Parameters:
 n: number of decision variables */
 void DestroyTensor(double ***t, int n) {
     double **tmp = NULL;
-    int i;
 
     tmp = *t;
     if (!tmp) {
@@ -3014,9 +5101,9 @@ void DestroyTensor(double ***t, int n) {
         exit(-1);
     }
 
-    for (i = 0; i < n; i++)
-        free(tmp[i]);
+    free(tmp[0]);
     free(tmp);
+    *t = NULL;
 }
 
 /* It initializes an allocated search space with tensors
@@ -3029,14 +5116,12 @@ void InitializeTensorSearchSpace(SearchSpace *s, int tensor_id) {
         exit(-1);
     }
 
-    int i, j, k;
+    int i, j;
 
     for (i = 0; i < s->m; i++) {
-        for (j = 0; j < s->n; j++) {
-            for (k = 0; k < tensor_id; k++)
-                s->a[i]->t[j][k] = GenerateUniformRandomNumber(0, 1);
-            s->a[i]->x[j] = TensorSpan(s->LB[j], s->UB[j], s->a[i]->t[j], tensor_id);
-        }
+        for (j = 0; j < s->n * tensor_id; j++)
+            s->a[i]->t[0][j] = GenerateUniformRandomNumber(0, 1);
+        TensorSpans(s->LB, s->UB, s->a[i]->t[0], s->n, tensor_id, s->a[i]->x);
     }
 }
 
@@ -3103,16 +5188,35 @@ double **CopyTensor(double **t, int n, int tensor_id) {
         exit(-1);
     }
 
-    int i;
     double **cpy = NULL;
 
+    PROFILE_BEGIN(_PROFILE_COPY_);
     cpy = CreateTensor(n, tensor_id);
-    for (i = 0; i < n; i++)
-        memcpy(cpy[i], t[i], tensor_id * sizeof(double));
+    memcpy(cpy[0], t[0], n * tensor_id * sizeof(double));
+    PROFILE_COUNT(_PROFILE_BYTES_COPIED_, n * tensor_id * sizeof(double));
+    PROFILE_END(_PROFILE_COPY_);
 
     return cpy;
 }
 
+/* It copies a given tensor into another one that has already been allocated
+Parameters:
+dst: tensor that receives the copy (created by CreateTensor with the same dimensions)
+t: tensor vector
+n: problem's dimension
+tensor_id: identifier of the tensor space dimension */
+void CopyTensorInto(double **dst, double **t, int n, int tensor_id) {
+    if ((!dst) || (!t)) {
+        fprintf(stderr, "\nNo tensor allocated @CopyTensorInto.\n");
+        exit(-1);
+    }
+
+    PROFILE_BEGIN(_PROFILE_COPY_);
+    memcpy(dst[0], t[0], n * tensor_id * sizeof(double));
+    PROFILE_COUNT(_PROFILE_BYTES_COPIED_, n * tensor_id * sizeof(double));
+    PROFILE_END(_PROFILE_COPY_);
+}
+
 /* It computes the norm of a given tensor
 Parameters:
 t: tensor vector
@@ -3127,7 +5231,7 @@ double TensorNorm(double *t, int tensor_id) {
     int i;
 
     for (i = 0; i < tensor_id; i++)
-        norm += pow(t[i], 2);
+        norm += t[i] * t[i];
     norm = sqrt(norm);
 
     return norm;
@@ -3144,12 +5248,11 @@ double **GenerateNewTensor(SearchSpace *s, int tensor_id) {
     }
 
     double **t = NULL;
-    int j, k;
+    int j;
 
     t = CreateTensor(s->n, tensor_id);
-    for (j = 0; j < s->n; j++)
-        for (k = 0; k < tensor_id; k++)
-            t[j][k] = GenerateUniformRandomNumber(0, 1);
+    for (j = 0; j < s->n * tensor_id; j++)
+        t[0][j] = GenerateUniformRandomNumber(0, 1);
 
     return t;
 }
@@ -3167,7 +5270,6 @@ double TensorSpan(double L, double U, double *t, int tensor_dim) {
     }
 
     double span = 0;
-    int i;
 
     span = (U - L) * (TensorNorm(t, tensor_dim) / sqrt(tensor_dim)) + L;
 
@@ -3175,6 +5277,7 @@ double TensorSpan(double L, double U, double *t, int tensor_dim) {
 }
 
 /* It calculates the Euclidean Distance between tensors
+ * The distances between the rows are computed by the tensor kernels (see TensorDistanceSum).
 Parameters:
 t: first tensor
 s: second tensor
@@ -3186,19 +5289,7 @@ double TensorEuclideanDistance(double **t, double **s, int n, int tensor_id) {
         return -1;
     }
 
-    double distance = 0, p_distance = 0;
-    int j, k;
-
-    for (j = 0; j < n; j++) {
-        for (k = 0; k < tensor_id; k++)
-            p_distance += pow(t[j][k] - s[j][k], 2);
-        distance += sqrt(p_distance);
-        p_distance = 0;
-    }
-
-    distance = sqrt(distance);
-
-    return distance;
+    return sqrt(TensorDistanceSum(t[0], s[0], n, tensor_id));
 }
 
 /* It evaluates a tensor-based search space
@@ -3211,17 +5302,48 @@ tensor_id: identifier of tensor's dimension
 EvaluateFun: pointer to the function used to evaluate particles (agents)
 arg: list of additional arguments */
 void EvaluateTensorSearchSpace(SearchSpace *s, int opt_id, int tensor_id, prtFun Evaluate, va_list arg) {
+    Evaluator e;
+
+    InitEvaluator(&e, s, Evaluate, arg);
+    EvaluateTensorSearchSpaceWith(s, opt_id, tensor_id, &e);
+    DestroyEvaluator(&e);
+}
+
+/* It maps the tensors of all agents to their real-valued positions bounded by [LB,UB] (see TensorSpans)
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension */
+void MapTensorSearchSpace(SearchSpace *s, int tensor_id) {
     if (!s) {
-        fprintf(stderr, "\nSearch space not allocated @EvaluateTensorSearchSpace.\n");
+        fprintf(stderr, "\nSearch space not allocated @MapTensorSearchSpace.\n");
         exit(-1);
     }
 
-    int i, j, k;
-    double f, *tmp = NULL;
-    Agent *individual = NULL;
-    va_list argtmp;
+    int i;
 
-    va_copy(argtmp, arg);
+    for (i = 0; i < s->m; i++)
+        TensorSpans(s->LB, s->UB, s->a[i]->t[0], s->n, tensor_id, s->a[i]->x);
+}
+
+/* It evaluates a tensor-based search space using a fitness evaluator
+ * The tensors are mapped to the positions of the agents (see MapTensorSearchSpace), the fitness values
+ * are computed (concurrently if s->n_threads > 1), and then the
+ * local and global bests are updated in ascending order of agents, as in a serial evaluation.
+Parameters:
+s: search space
+opt_id: optimization technique identifier
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+void EvaluateTensorSearchSpaceWith(SearchSpace *s, int opt_id, int tensor_id, Evaluator *e) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @EvaluateTensorSearchSpaceWith.\n");
+        exit(-1);
+    }
+
+    int i;
+    double f, *fit = NULL;
+
+    MapTensorSearchSpace(s, tensor_id);
 
     switch (opt_id) {
         case _BA_:
@@ -3231,110 +5353,95 @@ void EvaluateTensorSearchSpace(SearchSpace *s, int opt_id, int tensor_id, prtFun
         case _ABC_:
         case _BSA_:
         case _HS_:
+            fit = s->block_fit;
+            EvaluateAgents(s, s->a, s->m, e, fit); /* It executes the fitness function for all agents */
             for (i = 0; i < s->m; i++) {
-                f = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+                f = fit[i];
 
                 if (f < s->a[i]->fit) /* It updates the fitness value */
                     s->a[i]->fit = f;
 
                 if (s->a[i]->fit < s->gfit) { /* It updates the global best value and position */
                     s->gfit = s->a[i]->fit;
-                    for (j = 0; j < s->n; j++) {
-                        s->g[j] = s->a[i]->x[j];
-                        for (k = 0; k < tensor_id; k++)
-                            s->t_g[j][k] = s->a[i]->t[j][k];
-                    }
+                    memcpy(s->g, s->a[i]->x, s->n * sizeof(double));
+                    memcpy(s->t_g[0], s->a[i]->t[0], s->n * tensor_id * sizeof(double));
                 }
-
-                va_copy(arg, argtmp);
             }
             break;
         case _PSO_:
+            fit = s->block_fit;
+            EvaluateAgents(s, s->a, s->m, e, fit); /* It executes the fitness function for all agents */
             for (i = 0; i < s->m; i++) {
-                f = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+                f = fit[i];
 
                 if (f < s->a[i]->fit) { /* It updates the local best value and position */
                     s->a[i]->fit = f;
-                    for (j = 0; j < s->n; j++)
-                        for (k = 0; k < tensor_id; k++)
-                            s->a[i]->t_xl[j][k] = s->a[i]->t[j][k];
+                    memcpy(s->a[i]->t_xl[0], s->a[i]->t[0], s->n * tensor_id * sizeof(double));
                 }
 
                 if (s->a[i]->fit < s->gfit) { /* It updates the global best value and position */
                     s->gfit = s->a[i]->fit;
-                    for (j = 0; j < s->n; j++) {
-                        s->g[j] = s->a[i]->x[j];
-                        for (k = 0; k < tensor_id; k++)
-                            s->t_g[j][k] = s->a[i]->t[j][k];
-                    }
+                    memcpy(s->g, s->a[i]->x, s->n * sizeof(double));
+                    memcpy(s->t_g[0], s->a[i]->t[0], s->n * tensor_id * sizeof(double));
                 }
-                va_copy(arg, argtmp);
             }
             break;
         case _FA_:
+            fit = s->block_fit;
+            EvaluateAgents(s, s->a, s->m, e, fit); /* It executes the fitness function for all agents */
             for (i = 0; i < s->m; i++) {
-                f = Evaluate(s->a[i], arg); /* It executes the fitness function for agent i */
+                f = fit[i];
 
                 s->a[i]->fit = f; /* It updates the fitness value of actual agent i */
 
                 if (s->a[i]->fit < s->gfit) { /* It updates the global best value and position */
                     s->gfit = s->a[i]->fit;
-                    for (j = 0; j < s->n; j++) {
-                        s->g[j] = s->a[i]->x[j];
-                        for (k = 0; k < tensor_id; k++)
-                            s->t_g[j][k] = s->a[i]->t[j][k];
-                    }
+                    memcpy(s->g, s->a[i]->x, s->n * sizeof(double));
+                    memcpy(s->t_g[0], s->a[i]->t[0], s->n * tensor_id * sizeof(double));
                 }
-
-                va_copy(arg, argtmp);
             }
             break;
         default:
-            fprintf(stderr, "\n Invalid optimization identifier @EvaluateTensorSearchSpace.\n");
+            fprintf(stderr, "\n Invalid optimization identifier @EvaluateTensorSearchSpaceWith.\n");
             break;
     }
 }
 
 /* It runs a given tensor-based tree and outputs its solution array
+ * The tree is compiled into a temporary program (see CompileTTree), whose output is copied into a newly allocated tensor.
 Parameters:
 s: search space
 T: current tree */
 double **RunTTree(SearchSpace *s, Node *T) {
-    double **x = NULL, **y = NULL, **out = NULL;
-    int i, j;
+    GPProgram *p = NULL;
+    double **out = NULL, *r = NULL;
 
-    if (T) {
-        x = RunTTree(s, T->left);  /* It runs over the subtree on the left */
-        y = RunTTree(s, T->right); /* It runs over the subtree on the right */
+    if (!T)
+        return NULL;
 
-        if (T->status == TERMINAL || T->status == CONSTANT) {
-            out = CreateTensor(s->n, s->tensor_dim);
-            if (T->status == CONSTANT) {
-                for (i = 0; i < s->n; i++)
-                    for (j = 0; j < s->tensor_dim; j++)
-                        out[i][j] = s->t_constant[T->id][i][j];
-            } else { /* it is a terminal node */
-                for (i = 0; i < s->n; i++)
-                    for (j = 0; j < s->tensor_dim; j++)
-                        out[i][j] = s->a[T->id]->t[i][j];
-            }
-            return out;
-        } else {
-            if (!strcmp(T->elem, "TSUM"))
-                out = f_TSUM_(x, y, s->n, s->tensor_dim);
-            else if (!strcmp(T->elem, "TSUB"))
-                out = f_TSUB_(x, y, s->n, s->tensor_dim);
-            else if (!strcmp(T->elem, "TMUL"))
-                out = f_TMUL_(x, y, s->n, s->tensor_dim);
-            else if (!strcmp(T->elem, "TDIV"))
-                out = f_TDIV_(x, y, s->n, s->tensor_dim);
-
-            /* it deallocates the sons of the current one, since they have been used already */
-            if (x) DestroyTensor(&x, s->n);
-            if (y) DestroyTensor(&y, s->n);
-            return out;
-        }
-    } else return NULL;
+    p = CreateGPProgram();
+    CompileTTree(s, T, p);
+    r = RunGPProgram(s, p);
+    out = CreateTensor(s->n, s->tensor_dim);
+    memcpy(out[0], r, s->n * s->tensor_dim * sizeof(double));
+    DestroyGPProgram(&p);
+
+    return out;
+}
+
+/* It compiles a tensor-based tree into postfix bytecode (see CompileTree)
+ * The program outputs the n x tensor_dim tensor stored row by row.
+Parameters:
+s: search space
+T: tree
+p: GP program (its previous contents are discarded, and its memory is reused) */
+void CompileTTree(SearchSpace *s, Node *T, GPProgram *p) {
+    if (!s) {
+        fprintf(stderr, "\nInvalid input parameters @CompileTTree.\n");
+        exit(-1);
+    }
+
+    CompileProgram(s, T, p, s->tensor_dim, "CompileTTree");
 }
 
 
@@ -14,6 +14,9 @@ limitations under the License.
 */
 
 #include "cs.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
 /* It computes the number of nests that will be replaced, taking into account a probability [0,1] */
 int NestLossParameter(int size, float probability)
@@ -25,68 +28,58 @@ int NestLossParameter(int size, float probability)
     return loss;
 }
 
-/* It executes the Cuckoo Search for function minimization
+/* It executes the Cuckoo Search with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate nests
-arg: list of additional arguments */
-void runCS(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void CS(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j, k, nest_i, nest_j, loss;
     double rand, *L = NULL, fitValue;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runCS.\n");
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _CS_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _CS_, e); /* Initial evaluation of the search space */
+    L = (double *)malloc(s->n * sizeof(double));
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        va_copy(arg, argtmp);
-
         nest_i = round(GenerateUniformRandomNumber(0, s->m - 1));
-        tmp = CopyAgent(s->a[nest_i], _CS_, _NOTENSOR_);
+        tmp = BorrowAgentCopy(s, s->a[nest_i], _CS_);
 
         /* Equation 1 */
-        L = GenerateLevyDistribution(s->n, s->beta);
+        FillLevy(L, s->n, s->beta);
         for (k = 0; k < s->n; k++)
             tmp->x[k] += s->alpha * L[k];
-        free(L);
         /**************/
 
         CheckAgentLimits(s, tmp);
 
         nest_j = round(GenerateUniformRandomNumber(0, s->m - 1));
 
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+        fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
         if (fitValue < s->a[nest_j]->fit)
         { /* We accept the new solution */
-            DestroyAgent(&(s->a[nest_j]), _CS_);
-            s->a[nest_j] = CopyAgent(tmp, _CS_, _NOTENSOR_);
+            CopyAgentInto(s->a[nest_j], tmp, _CS_);
             s->a[nest_j]->fit = fitValue;
         }
 
-        DestroyAgent(&tmp, _CS_);
+        ReturnAgent(s, &tmp);
 
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all nests according to their fitness. First position gets the best nest. */
+        PROFILE_END(_PROFILE_SORT_);
 
         loss = NestLossParameter(s->m, s->p);
 
         for (i = s->m - 1; i >= loss; i--)
         {
-            va_copy(arg, argtmp);
-
-            tmp = GenerateNewAgent(s, _CS_);
+            tmp = BorrowNewAgent(s, _CS_);
             /* Random walk */
             rand = GenerateUniformRandomNumber(0, 1);
             nest_i = round(GenerateUniformRandomNumber(0, s->m - 1));
@@ -97,55 +90,82 @@ void runCS(SearchSpace *s, prtFun Evaluate, ...)
 
             CheckAgentLimits(s, tmp);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
             if (fitValue < s->a[i]->fit)
             { /* We accept the new solution */
-                DestroyAgent(&(s->a[i]), _CS_);
-                s->a[i] = CopyAgent(tmp, _CS_, _NOTENSOR_);
+                CopyAgentInto(s->a[i], tmp, _CS_);
                 s->a[i]->fit = fitValue;
             }
-            DestroyAgent(&tmp, _CS_);
+            ReturnAgent(s, &tmp);
         }
 
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all nests according to their fitness. First position gets the best nest. */
+        PROFILE_END(_PROFILE_SORT_);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->a[0]->fit);
+        ReportIteration(s, _CS_, e, t, s->a[0]->fit);
     }
 
-    va_end(arg);
+    free(L);
 }
 
-/* It executes the Tensor-based Cuckoo Search for function minimization
+/* It executes the Cuckoo Search for function minimization
 Parameters:
 s: search space
-tensor_id: identifier of tensor's dimension
 Evaluate: pointer to the function used to evaluate nests
 arg: list of additional arguments */
-void runTensorCS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runCS(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    CS(s, &e);
+    PROFILE_END_RUN("CS", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Cuckoo Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runCS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    CS(s, &e);
+    PROFILE_END_RUN("CS", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Tensor-based Cuckoo Search with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorCS(SearchSpace *s, int tensor_id, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j, k, nest_i, nest_j, loss;
     double rand, **L = NULL, fitValue;
     double **tmp_t = NULL;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runTensorCS.\n");
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _CS_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _CS_, tensor_id, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        va_copy(arg, argtmp);
-
         nest_i = round(GenerateUniformRandomNumber(0, s->m - 1));
         tmp = CopyAgent(s->a[nest_i], _CS_, _NOTENSOR_);
         tmp_t = CopyTensor(s->a[nest_i]->t, s->n, tensor_id);
@@ -163,12 +183,11 @@ void runTensorCS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         /**************/
 
         CheckTensorLimits(s, tmp_t, tensor_id);
-        for (j = 0; j < s->n; j++)
-            tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+        TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
 
         nest_j = round(GenerateUniformRandomNumber(0, s->m - 1));
 
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+        fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
         if (fitValue < s->a[nest_j]->fit)
         { /* We accept the new solution */
             DestroyTensor(&s->a[nest_j]->t, s->n);
@@ -181,14 +200,14 @@ void runTensorCS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         DestroyAgent(&tmp, _CS_);
         DestroyTensor(&tmp_t, s->n);
 
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all nests according to their fitness. First position gets the best nest. */
+        PROFILE_END(_PROFILE_SORT_);
 
         loss = NestLossParameter(s->m, s->p);
 
         for (i = s->m - 1; i >= loss; i--)
         {
-            va_copy(arg, argtmp);
-
             tmp = GenerateNewAgent(s, _CS_);
             tmp_t = GenerateNewTensor(s, tensor_id);
 
@@ -201,10 +220,9 @@ void runTensorCS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                     tmp_t[j][k] += rand * (s->a[nest_i]->t[j][k] - s->a[nest_j]->t[j][k]);
             /**************/
             CheckTensorLimits(s, tmp_t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+            TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
             if (fitValue < s->a[i]->fit)
             { /* We accept the new solution */
                 DestroyTensor(&s->a[i]->t, s->n);
@@ -217,10 +235,47 @@ void runTensorCS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
             DestroyTensor(&tmp_t, s->n);
         }
 
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all nests according to their fitness. First position gets the best nest. */
+        PROFILE_END(_PROFILE_SORT_);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->a[0]->fit);
+        ReportIteration(s, _CS_, e, t, s->a[0]->fit);
     }
+}
+
+/* It executes the Tensor-based Cuckoo Search for function minimization
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate nests
+arg: list of additional arguments */
+void runTensorCS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
 
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorCS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorCS", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Tensor-based Cuckoo Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorCS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorCS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorCS", &e);
+    DestroyEvaluator(&e);
+}
@@ -1,48 +1,46 @@
 #include "de.h"
+#include "telemetry.h"
+#include "profile.h"
 #include "function.h"
 
-void MutationAndRecombination(SearchSpace *s, int target, prtFun Evaluate, va_list arg) {
-    Agent *mutant;
+void MutationAndRecombination(SearchSpace *s, int target, Evaluator *e) {
+    double *mutant, fitValue;
     int a, b, c, k;
 
-    mutant = GenerateNewAgent(s, _DE_);
+    mutant = GetTrialVector(s, target);
     a = b = c = target;
     while (a == target) a = GenerateUniformRandomNumber(0, 1) * s->m;
     while (b == target || b == a) b = GenerateUniformRandomNumber(0, 1) * s->m;
     while (c == target || c == b || c == a) c = GenerateUniformRandomNumber(0, 1) * s->m;
     for (k = 0; k < s->n; k++) {
 
-        mutant->x[k] = GenerateUniformRandomNumber(0, 1) < s->cross_probability
-                       ? s->a[target]->x[k]
-                       : s->a[a]->x[k]
-                         + s->mutation_factor
-                           * (s->a[b]->x[k] - s->a[c]->x[k]);
+        mutant[k] = GenerateUniformRandomNumber(0, 1) < s->cross_probability
+                    ? s->a[target]->x[k]
+                    : s->a[a]->x[k]
+                      + s->mutation_factor
+                        * (s->a[b]->x[k] - s->a[c]->x[k]);
 
     }
-    CheckAgentLimits(s, mutant);
 
-    mutant->fit = Evaluate(mutant, arg);
+    /* The mutant takes the place of the target, and it is swapped back if it is rejected */
+    SwapTrialVector(s, s->a[target], target);
+    CheckAgentLimits(s, s->a[target]);
 
-    if (mutant->fit < s->a[target]->fit) {
-        DestroyAgent(&s->a[target], _DE_);
-        s->a[target] = CopyAgent(mutant, _DE_, _NOTENSOR_);
-    }
+    fitValue = ComputeFitness(e, s->a[target]);
 
-    DestroyAgent(&mutant, _DE_);
+    if (fitValue < s->a[target]->fit)
+        s->a[target]->fit = fitValue;
+    else
+        SwapTrialVector(s, s->a[target], target);
 }
 
 /**
- * It executes the Differential Evolution for function minimization
+ * It executes the Differential evolution with a given fitness evaluator
  * @param s Search space
- * @param prtFunction Pointer to the function used to evaluate particles
- * @param ... List of additional arguments
+ * @param e Fitness evaluator
  */
-void runDE(SearchSpace *s, prtFun Evaluate, ...) {
+static void DE(SearchSpace *s, Evaluator *e) {
     int t, k;
-    va_list arg, argtmp;
-
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
 
     if (!s) {
         fprintf(stderr, "\nSearch space not allocated @runDE.\n");
@@ -54,23 +52,52 @@ void runDE(SearchSpace *s, prtFun Evaluate, ...) {
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _DE_, Evaluate, arg); /* Initial evaluation */
+    EvaluateSearchSpaceWith(s, _DE_, e); /* Initial evaluation */
 
     for (t = 1; t <= s->iterations; t++) {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-
         /* For each particle */
         for (k = 0; k < s->m; k++) {
-            va_copy(arg, argtmp);
-            MutationAndRecombination(s, k, Evaluate, arg);
+            MutationAndRecombination(s, k, e);
         }
-        va_copy(arg, argtmp);
-        EvaluateSearchSpace(s, _DE_, Evaluate, arg);
+        EvaluateSearchSpaceWith(s, _DE_, e);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
-        fprintf(stdout, "\n%d %lf", t, s->gfit);
+        ReportIteration(s, _DE_, e, t, s->gfit);
     }
 
+    RestoreAgentBlocks(s);
+}
+
+/**
+ * It executes the Differential Evolution for function minimization
+ * @param s Search space
+ * @param prtFunction Pointer to the function used to evaluate particles
+ * @param ... List of additional arguments
+ */
+void runDE(SearchSpace *s, prtFun Evaluate, ...) {
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    DE(s, &e);
+    PROFILE_END_RUN("DE", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/**
+ * It executes the Differential evolution for function minimization using a reentrant fitness function
+ * @param s Search space
+ * @param Evaluate Pointer to the function used to evaluate decision vectors
+ * @param ctx Context forwarded to each call of Evaluate
+ */
+void runDE_r(SearchSpace *s, prtFun_r Evaluate, void *ctx) {
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    DE(s, &e);
+    PROFILE_END_RUN("DE", &e);
+    DestroyEvaluator(&e);
+}
@@ -15,22 +15,57 @@ limitations under the License.
 
 
 #include "fa.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
-/* It executes the Firefly Algorithm for function minimization
+/* It updates the squared distances among the fireflies that moved in the last iteration and all the others
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runFA(SearchSpace *s, prtFun Evaluate, ...)
+D: m x m matrix of squared distances among the fireflies (row-major), whose rows and columns of the moved fireflies are updated
+moved: array of m flags, moved[i] is 1 if the i-th firefly moved (all of them at the first iteration)
+X: auxiliary array of 2m pointers
+row: auxiliary array of m x m doubles */
+static void UpdateFireflyDistances(SearchSpace *s, double *D, const char *moved, double **X, double *row)
+{
+    int i, j, k, n_moved = 0;
+    double **P = X + s->m;
+
+    for (i = 0; i < s->m; i++)
+    {
+        P[i] = s->a[i]->x;
+        if (moved[i])
+            X[n_moved++] = s->a[i]->x;
+    }
+    if (!n_moved)
+        return;
+
+    SquaredDistanceMatrix(X, n_moved, P, s->m, s->n, row);
+    for (i = 0, k = 0; i < s->m; i++)
+    {
+        if (!moved[i])
+            continue;
+        for (j = 0; j < s->m; j++)
+            D[i * s->m + j] = D[j * s->m + i] = row[k * s->m + j];
+        k++;
+    }
+}
+
+/* It executes the Firefly Algorithm with a given fitness evaluator
+ * If s->keep_distances is set, the attractiveness is computed from the distances among the fireflies at the beginning of each iteration,
+ * which are kept along the iterations and updated only for the fireflies that moved. Otherwise, each distance is computed from the
+ * current position of the moving firefly, and only when it is needed, i.e., when the other firefly is brighter.
+Parameters:
+s: search space
+e: fitness evaluator */
+static void FA(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int i, j, k, t;
     double beta, delta = 0.97, distance;
-    double r;
+    double *r = NULL, *D = NULL, *row = NULL, **X = NULL;
+    char *moved = NULL;
     Agent **tmp = NULL;
-
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    Data *rank = NULL;
 
     if (!s)
     {
@@ -39,67 +74,132 @@ void runFA(SearchSpace *s, prtFun Evaluate, ...)
     }
 
     tmp = (Agent **)malloc(s->m * sizeof(Agent *));
+    r = (double *)malloc(s->n * sizeof(double)); /* random perturbation of a single move */
+    if (s->keep_distances)
+    {
+        D = (double *)malloc(2 * s->m * s->m * sizeof(double));
+        row = D + s->m * s->m;
+        X = (double **)malloc(2 * s->m * sizeof(double *));
+        rank = (Data *)malloc(s->m * sizeof(Data));
+        moved = (char *)malloc(s->m * sizeof(char));
+        memset(moved, 1, s->m * sizeof(char)); /* the whole matrix is computed at the first iteration */
+    }
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        EvaluateSearchSpace(s, _FA_, Evaluate, arg); /* Initial evaluation of the search space */
-        for (i = 0; i < s->m; i++)
-            tmp[i] = CopyAgent(s->a[i], _FA_, _NOTENSOR_);
-        qsort(tmp, s->m, sizeof(Agent **), SortAgent); /* Sorts all fireflies according to their fitness. First position gets the best firefly. */
+        EvaluateSearchSpaceWith(s, _FA_, e); /* Initial evaluation of the search space */
+        if (s->keep_distances)
+        {
+            UpdateFireflyDistances(s, D, moved, X, row);
+            for (i = 0; i < s->m; i++)
+            {
+                rank[i].id = i;
+                rank[i].val = s->a[i]->fit;
+            }
+            PROFILE_BEGIN(_PROFILE_SORT_);
+            qsort(rank, s->m, sizeof(Data), SortDataByVal); /* Sorts all fireflies according to their fitness. First position gets the best firefly. */
+            PROFILE_END(_PROFILE_SORT_);
+            for (i = 0; i < s->m; i++)
+                tmp[i] = BorrowAgentCopy(s, s->a[rank[i].id], _FA_);
+        }
+        else
+        {
+            for (i = 0; i < s->m; i++)
+                tmp[i] = BorrowAgentCopy(s, s->a[i], _FA_);
+            PROFILE_BEGIN(_PROFILE_SORT_);
+            qsort(tmp, s->m, sizeof(Agent **), SortAgent); /* Sorts all fireflies according to their fitness. First position gets the best firefly. */
+            PROFILE_END(_PROFILE_SORT_);
+        }
 
         for (i = 0; i < s->m; i++)
         {
+            if (s->keep_distances)
+                moved[i] = 0;
             for (j = 0; j < s->m; j++)
             {
-                distance = EuclideanDistance(s->a[i]->x, tmp[j]->x, s->n); /* It obtains the euclidean distance for further use */
-                distance *= distance;
                 if (s->a[i]->fit > tmp[j]->fit)
                 {
-                    beta = s->beta_0 * exp(-s->gamma * distance); /* It obtains attractiveness by Equation 1 */
-                    for (k = 0; k < s->n; k++)
+                    if (s->keep_distances)
                     {
-                        r = GenerateUniformRandomNumber(0, 1);
-                        s->a[i]->x[k] = s->a[i]->x[k] + beta * (tmp[j]->x[k] - s->a[i]->x[k]) + s->alpha * (r - 0.5); /* It updates the firefly position by Equation 2 */
+                        distance = D[i * s->m + rank[j].id]; /* It takes the squared euclidean distance at the beginning of the iteration */
+                        moved[i] = 1;
                     }
+                    else
+                        distance = SquaredDistance(s->a[i]->x, tmp[j]->x, s->n); /* It obtains the squared euclidean distance for further use */
+                    beta = s->beta_0 * exp(-s->gamma * distance); /* It obtains attractiveness by Equation 1 */
+                    FillUniform(r, s->n, -0.5, 0.5);
+                    for (k = 0; k < s->n; k++)
+                        s->a[i]->x[k] = s->a[i]->x[k] + beta * (tmp[j]->x[k] - s->a[i]->x[k]) + s->alpha * r[k]; /* It updates the firefly position by Equation 2 */
                 }
             }
         }
 
         for (i = 0; i < s->m; i++)
-        {
             CheckAgentLimits(s, s->a[i]);
-            DestroyAgent(&tmp[i], _FA_);
-        }
+        ResetAgentPool(s); /* It gives the sorted copies back */
 
-        va_copy(arg, argtmp);
-
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _FA_, e, t, s->gfit);
     }
 
     free(tmp);
-    va_end(arg);
+    free(r);
+    if (s->keep_distances)
+    {
+        free(D);
+        free(X);
+        free(rank);
+        free(moved);
+    }
 }
 
-/* It executes the Tensor-based Firefly Algorithm for function minimization
+/* It executes the Firefly Algorithm for function minimization
 Parameters:
 s: search space
-tensor_id: identifier of tensor's dimension
 Evaluate: pointer to the function used to evaluate particles
 arg: list of additional arguments */
-void runTensorFA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runFA(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    FA(s, &e);
+    PROFILE_END_RUN("FA", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Firefly Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runFA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    FA(s, &e);
+    PROFILE_END_RUN("FA", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Tensor-based Firefly Algorithm with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorFA(SearchSpace *s, int tensor_id, Evaluator *e)
 {
-    va_list arg, argtmp;
     int i, j, k, l, t;
     double beta, delta = 0.97, distance;
     double r;
     double ***tmp_t = NULL;
     Agent **tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runTensorFA.\n");
@@ -111,24 +211,24 @@ void runTensorFA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        EvaluateTensorSearchSpace(s, _FA_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+        EvaluateTensorSearchSpaceWith(s, _FA_, tensor_id, e); /* Initial evaluation of the search space */
         for (i = 0; i < s->m; i++)
         {
             tmp[i] = CopyAgent(s->a[i], _FA_, _NOTENSOR_);
             tmp_t[i] = CopyTensor(s->a[i]->t, s->n, tensor_id);
         }
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(tmp, s->m, sizeof(Agent **), SortAgent); /* Sorts all fireflies according to their fitness. First position gets the best firefly. */
+        PROFILE_END(_PROFILE_SORT_);
 
         for (i = 0; i < s->m; i++)
         {
             for (j = 0; j < s->m; j++)
             {
-                distance = TensorEuclideanDistance(s->a[i]->t, tmp_t[j], s->n, tensor_id); /* It obtains the euclidean distance for further use */
-                distance *= distance;
                 if (s->a[i]->fit > tmp[j]->fit)
                 {
+                    distance = TensorEuclideanDistance(s->a[i]->t, tmp_t[j], s->n, tensor_id); /* It obtains the euclidean distance for further use */
+                    distance *= distance;
                     beta = s->beta_0 * exp(-s->gamma * distance); /* It obtains attractiveness by Equation 1 */
                     for (k = 0; k < s->n; k++)
                     {
@@ -145,19 +245,52 @@ void runTensorFA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         for (i = 0; i < s->m; i++)
         {
             CheckTensorLimits(s, s->a[i]->t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                s->a[i]->x[j] = TensorSpan(s->LB[j], s->UB[j], s->a[i]->t[j], tensor_id);
+            TensorSpans(s->LB, s->UB, s->a[i]->t[0], s->n, tensor_id, s->a[i]->x);
             DestroyAgent(&tmp[i], _FA_);
             DestroyTensor(&tmp_t[i], s->n);
         }
 
-        va_copy(arg, argtmp);
-
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _FA_, e, t, s->gfit);
     }
 
     free(tmp);
     free(tmp_t);
+}
+
+/* It executes the Tensor-based Firefly Algorithm for function minimization
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runTensorFA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorFA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorFA", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Tensor-based Firefly Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorFA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorFA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorFA", &e);
+    DestroyEvaluator(&e);
+}
 /*************************/
\ No newline at end of file
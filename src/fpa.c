@@ -15,56 +15,50 @@ limitations under the License.
 
 
 #include "fpa.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
-/* It executes the Flower Pollination Algorithm for function minimization
+/* It executes the Flower Pollination Algorithm with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runFPA(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void FPA(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j, flower_j, flower_k;
     double prob, epsilon, *L = NULL, fitValue;
     Agent *tmp = NULL, **tmp_flowers = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runFPA.\n");
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _FPA_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _FPA_, e); /* Initial evaluation of the search space */
 
-    tmp_flowers = (Agent **)calloc(s->m, sizeof(Agent));
+    tmp_flowers = (Agent **)malloc(s->m * sizeof(Agent *));
+    L = (double *)malloc(s->n * sizeof(double));
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         for (i = 0; i < s->m; i++)
-            tmp_flowers[i] = CopyAgent(s->a[i], _FPA_, _NOTENSOR_);
+            tmp_flowers[i] = BorrowAgentCopy(s, s->a[i], _FPA_);
 
         /* for each flower */
         for (i = 0; i < s->m; i++)
         {
-            va_copy(arg, argtmp);
-            tmp = CopyAgent(s->a[i], _FPA_, _NOTENSOR_);
+            tmp = BorrowAgentCopy(s, s->a[i], _FPA_);
 
             prob = GenerateUniformRandomNumber(0, 1);
             if (prob > s->p)
             { /* large-scale pollination */
-                L = GenerateLevyDistribution(s->n, s->beta);
+                FillLevy(L, s->n, s->beta);
 
                 /* Equation 1 */
                 for (j = 0; j < s->n; j++)
                     tmp->x[j] = tmp->x[j] + L[j] * (s->g[j] - tmp->x[j]);
                 /**************/
-
-                free(L);
             }
             else
             { /* local pollination */
@@ -78,11 +72,10 @@ void runFPA(SearchSpace *s, prtFun Evaluate, ...)
             }
             CheckAgentLimits(s, tmp);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
             if (fitValue < s->a[i]->fit)
             { /* We accept the new solution */
-                DestroyAgent(&(s->a[i]), _FPA_);
-                s->a[i] = CopyAgent(tmp, _FPA_, _NOTENSOR_);
+                CopyAgentInto(s->a[i], tmp, _FPA_);
                 s->a[i]->fit = fitValue;
             }
 
@@ -92,77 +85,103 @@ void runFPA(SearchSpace *s, prtFun Evaluate, ...)
                 for (j = 0; j < s->n; j++)
                     s->g[j] = tmp->x[j];
             }
-            DestroyAgent(&tmp, _FPA_);
+            ReturnAgent(s, &tmp);
         }
 
-        for (i = 0; i < s->m; i++)
-            DestroyAgent(&tmp_flowers[i], _FPA_);
+        ResetAgentPool(s); /* It gives the copies of the flowers back */
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _FPA_, e, t, s->gfit);
     }
 
     free(tmp_flowers);
+    free(L);
+}
+
+/* It executes the Flower Pollination Algorithm for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runFPA(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
 
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    FPA(s, &e);
+    PROFILE_END_RUN("FPA", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Flower Pollination Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runFPA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    FPA(s, &e);
+    PROFILE_END_RUN("FPA", &e);
+    DestroyEvaluator(&e);
+}
 /****************************/
 
-/* It executes the Tensor-based Flower Pollination Algorithm for function minimization
+/* It executes the Tensor-based Flower Pollination Algorithm with a given fitness evaluator
 Parameters:
 s: search space
 tensor_id: identifier of tensor's dimension
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runTensorFPA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void TensorFPA(SearchSpace *s, int tensor_id, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j, k, flower_j, flower_k;
     double prob, epsilon, **L = NULL, fitValue;
     double **tmp_t = NULL, ***tmp_tensors = NULL;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runTensorFPA.\n");
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _FPA_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _FPA_, tensor_id, e); /* Initial evaluation of the search space */
 
-    tmp_tensors = (double ***)calloc(s->m, sizeof(double **));
+    /* The copies of the tensors and the Levy steps are allocated once, and they are overwritten at each iteration */
+    tmp_tensors = (double ***)malloc(s->m * sizeof(double **));
+    for (i = 0; i < s->m; i++)
+        tmp_tensors[i] = CreateTensor(s->n, tensor_id);
+    tmp_t = CreateTensor(s->n, tensor_id);
+    L = CreateTensor(s->n, tensor_id);
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
         for (i = 0; i < s->m; i++)
-            tmp_tensors[i] = CopyTensor(s->a[i]->t, s->n, tensor_id);
+            CopyTensorInto(tmp_tensors[i], s->a[i]->t, s->n, tensor_id);
 
         /* for each flower */
         for (i = 0; i < s->m; i++)
         {
-            va_copy(arg, argtmp);
-            tmp = CopyAgent(s->a[i], _FPA_, _NOTENSOR_);
-            tmp_t = CopyTensor(s->a[i]->t, s->n, tensor_id);
+            tmp = BorrowAgentCopy(s, s->a[i], _FPA_);
+            CopyTensorInto(tmp_t, s->a[i]->t, s->n, tensor_id);
 
             prob = GenerateUniformRandomNumber(0, 1);
             if (prob > s->p)
             { /* large-scale pollination */
-                L = (double **)calloc(s->n, sizeof(double *));
                 for (j = 0; j < s->n; j++)
-                    L[j] = GenerateLevyDistribution(tensor_id, s->beta);
+                    FillLevy(L[j], tensor_id, s->beta);
 
                 /* Equation 1 */
                 for (j = 0; j < s->n; j++)
                     for (k = 0; k < tensor_id; k++)
                         tmp_t[j][k] = tmp_t[j][k] + L[j][k] * (s->t_g[j][k] - tmp_t[j][k]);
                 /**************/
-                for (j = 0; j < s->n; j++)
-                    free(L[j]);
-                free(L);
             }
             else
             { /* local pollination */
@@ -176,39 +195,71 @@ void runTensorFPA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                         tmp_t[j][k] = tmp_t[j][k] + epsilon * (tmp_tensors[flower_j][j][k] - tmp_tensors[flower_k][j][k]);
             }
             CheckTensorLimits(s, tmp_t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+            TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
 
-            fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent i */
+            fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent i */
             if (fitValue < s->a[i]->fit)
             { /* We accept the new solution */
-                DestroyTensor(&s->a[i]->t, s->n);
-                DestroyAgent(&(s->a[i]), _FPA_);
-                s->a[i] = CopyAgent(tmp, _FPA_, _NOTENSOR_);
+                CopyAgentInto(s->a[i], tmp, _FPA_);
                 s->a[i]->fit = fitValue;
-                s->a[i]->t = CopyTensor(tmp_t, s->n, tensor_id);
+                CopyTensorInto(s->a[i]->t, tmp_t, s->n, tensor_id);
             }
 
             if (fitValue < s->gfit)
             { /* update the global best */
                 s->gfit = fitValue;
-                DestroyTensor(&s->t_g, s->n);
-                s->t_g = CopyTensor(tmp_t, s->n, tensor_id);
+                CopyTensorInto(s->t_g, tmp_t, s->n, tensor_id);
                 for (j = 0; j < s->n; j++)
                     s->g[j] = tmp->x[j];
             }
 
-            DestroyAgent(&tmp, _FPA_);
-            DestroyTensor(&tmp_t, s->n);
+            ReturnAgent(s, &tmp);
         }
 
-        for (i = 0; i < s->m; i++)
-            DestroyTensor(&tmp_tensors[i], s->n);
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _FPA_, e, t, s->gfit);
     }
 
+    for (i = 0; i < s->m; i++)
+        DestroyTensor(&tmp_tensors[i], s->n);
     free(tmp_tensors);
+    DestroyTensor(&tmp_t, s->n);
+    DestroyTensor(&L, s->n);
+}
+
+/* It executes the Tensor-based Flower Pollination Algorithm for function minimization
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runTensorFPA(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
 
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorFPA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorFPA", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Tensor-based Flower Pollination Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorFPA_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorFPA(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorFPA", &e);
+    DestroyEvaluator(&e);
+}
 /****************************/
\ No newline at end of file
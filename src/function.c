@@ -15,6 +15,7 @@ limitations under the License.
 
 
 #include "function.h"
+#include "kernel.h"
 
 /* Benchmark functions */
 /* It computes the 1st Ackley's function
@@ -47,7 +48,7 @@ double Ackley_First(Agent *a, va_list arg)
         sum_2 += cos(gamma * a->x[i]);
     }
 
-    sum = -alpha * exp(-beta * sqrt((1 / a->n) * sum_1)) - exp((1 / a->n) * sum_2) + alpha + exp(1);
+    sum = -alpha * exp(-beta * sqrt((1.0 / a->n) * sum_1)) - exp((1.0 / a->n) * sum_2) + alpha + exp(1);
 
     return sum;
 }
@@ -3278,12 +3279,10 @@ double *f_SUM_(double *x, double *y, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = x[i] + y[i];
+    f_SUM_Into(x, y, out, n);
 
     return out;
 }
@@ -3300,12 +3299,10 @@ double *f_SUB_(double *x, double *y, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = x[i] - y[i];
+    f_SUB_Into(x, y, out, n);
 
     return out;
 }
@@ -3322,12 +3319,10 @@ double *f_MUL_(double *x, double *y, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = x[i] * y[i];
+    f_MUL_Into(x, y, out, n);
 
     return out;
 }
@@ -3344,12 +3339,10 @@ double *f_DIV_(double *x, double *y, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = x[i] / (y[i] + 0.00001); /* It avoids division by 0 */
+    f_DIV_Into(x, y, out, n); /* It avoids division by 0 */
 
     return out;
 }
@@ -3366,12 +3359,10 @@ double *f_ABS_(double *x, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = fabs(x[i]);
+    f_ABS_Into(x, out, n);
 
     return out;
 }
@@ -3388,12 +3379,10 @@ double *f_SQRT_(double *x, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = sqrt(fabs(x[i]));
+    f_SQRT_Into(x, out, n);
 
     return out;
 }
@@ -3410,12 +3399,10 @@ double *f_EXP_(double *x, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = exp(x[i]);
+    f_EXP_Into(x, out, n);
 
     return out;
 }
@@ -3432,12 +3419,10 @@ double *f_LOG_(double *x, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = log(x[i] + 0.00001);
+    f_LOG_Into(x, out, n);
 
     return out;
 }
@@ -3454,12 +3439,10 @@ double *f_AND_(double *x, double *y, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = (double)((int)x[i] & (int)y[i]);
+    f_AND_Into(x, y, out, n);
 
     return out;
 }
@@ -3476,12 +3459,10 @@ double *f_OR_(double *x, double *y, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = (double)((int)x[i] | (int)y[i]);
+    f_OR_Into(x, y, out, n);
 
     return out;
 }
@@ -3498,12 +3479,10 @@ double *f_XOR_(double *x, double *y, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = (double)((int)x[i] ^ (int)y[i]);
+    f_XOR_Into(x, y, out, n);
 
     return out;
 }
@@ -3520,18 +3499,57 @@ double *f_NOT_(double *x, int n)
         exit(-1);
     }
 
-    int i;
     double *out = NULL;
 
     out = (double *)malloc(n * sizeof(double));
-    for (i = 0; i < n; i++)
-        out[i] = (double)~(int)x[i];
+    f_NOT_Into(x, out, n);
 
     return out;
 }
 /*****************************/
 
 /* Tensor-based Genetic Programming general-purpose functions */
+typedef void (*prtTensorInto)(const double *x, const double *y, double *out, int m, int n); /* Pointer to a tensor-based GP primitive (see kernel.h) */
+
+/* It checks whether the rows of an mxn-dimensional tensor are stored in a single block, as in CreateTensor
+Parameters:
+t: tensor
+m,n: dimensions */
+static int IsTensorBlock(double **t, int m, int n)
+{
+    int i;
+
+    for (i = 1; i < m; i++)
+        if (t[i] != t[0] + i * n)
+            return 0;
+
+    return 1;
+}
+
+/* It applies a tensor-based GP primitive to two mxn-dimensional tensors
+ * The output is allocated by CreateTensor. If both inputs are stored in a single block, the primitive runs over the m x n values at once,
+ * so that quaternions and octonions fill whole vector registers, otherwise it runs row by row.
+Parameters:
+f: GP primitive
+x, y: tensors
+m,n: dimensions */
+static double **TensorFunction(prtTensorInto f, double **x, double **y, int m, int n)
+{
+    double **out = NULL;
+    int i;
+
+    out = CreateTensor(m, n);
+    if ((IsTensorBlock(x, m, n)) && (IsTensorBlock(y, m, n)))
+        f(x[0], y[0], out[0], m, n);
+    else
+    {
+        for (i = 0; i < m; i++)
+            f(x[i], y[i], out[i], 1, n);
+    }
+
+    return out;
+}
+
 /* It computes the tensor sum of two mxn-dimensional tensors
 Parameters:
 x, y:tensors
@@ -3544,18 +3562,7 @@ double **f_TSUM_(double **x, double **y, int m, int n)
         exit(-1);
     }
 
-    int i, j;
-    double **out = NULL;
-
-    out = (double **)malloc(m * sizeof(double));
-    for (i = 0; i < m; i++){
-	out[i] = (double *)malloc(n * sizeof(double));
-	
-	for(j = 0; j < n; j++)
-	    out[i][j] = x[i][j] + y[i][j];
-    }
-
-    return out;
+    return TensorFunction(f_TSUM_Into, x, y, m, n);
 }
 
 /* It computes the tensor subtraction of two mxn-dimensional tensors
@@ -3570,18 +3577,7 @@ double **f_TSUB_(double **x, double **y, int m, int n)
         exit(-1);
     }
 
-    int i, j;
-    double **out = NULL;
-
-    out = (double **)malloc(m * sizeof(double));
-    for (i = 0; i < m; i++){
-	out[i] = (double *)malloc(n * sizeof(double));
-	
-	for(j = 0; j < n; j++)
-	    out[i][j] = x[i][j] - y[i][j];
-    }
-
-    return out;
+    return TensorFunction(f_TSUB_Into, x, y, m, n);
 }
 
 /* It computes the tensor multiplication of two mxn-dimensional tensors
@@ -3596,18 +3592,7 @@ double **f_TMUL_(double **x, double **y, int m, int n)
         exit(-1);
     }
 
-    int i, j;
-    double **out = NULL;
-
-    out = (double **)malloc(m * sizeof(double));
-    for (i = 0; i < m; i++){
-	out[i] = (double *)malloc(n * sizeof(double));
-	
-	for(j = 0; j < n; j++)
-	    out[i][j] = x[i][j] * y[i][j];
-    }
-
-    return out;
+    return TensorFunction(f_TMUL_Into, x, y, m, n);
 }
 
 /* It computes the tensor division (protected) of two mxn-dimensional tensors
@@ -3622,20 +3607,7 @@ double **f_TDIV_(double **x, double **y, int m, int n)
         exit(-1);
     }
 
-    int i, j;
-    double **out = NULL;
-
-    out = (double **)malloc(m * sizeof(double));
-    for (i = 0; i < m; i++){
-	out[i] = (double *)malloc(n * sizeof(double));
-	
-	for(j = 0; j < n; j++){
-            if(!y[i][j]) out[i][j] = 0.0;
-            else out[i][j] = x[i][j]/y[i][j];
-	}
-    }
-
-    return out;
+    return TensorFunction(f_TDIV_Into, x, y, m, n);
 }
 /*****************************/
 
@@ -1,21 +1,18 @@
 #include "ga.h"
+#include "telemetry.h"
+#include "profile.h"
 
-/* It executes the Genetic Algorithm for function minimization
+/* It executes the Genetic Algorithm with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate chromosomes
-arg: list of additional arguments */
-
-void runGA(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void GA(SearchSpace *s, Evaluator *e)
 {
-	va_list arg, argtmp;
 	int i, j, k, t;
 	int *selection = NULL;
 	int crossover_index, mutation_index;
-	double **tmp;
-
-	va_start(arg, Evaluate);
-	va_copy(argtmp, arg);
+	double **tmp, *accum = NULL;
+	Data *D = NULL;
 
 	if (!s)
 	{
@@ -23,18 +20,19 @@ void runGA(SearchSpace *s, prtFun Evaluate, ...)
 		exit(-1);
 	}
 
-	EvaluateSearchSpace(s, _GA_, Evaluate, arg); /* Initial evaluation of the search space */
+	EvaluateSearchSpaceWith(s, _GA_, e); /* Initial evaluation of the search space */
 	
 	tmp = (double **)calloc(s->m, sizeof(double *));
 	for(i = 0; i < s->m; i++)
 		tmp[i] = (double *)calloc(s->n, sizeof(double));
+	selection = (int *)malloc(s->m * sizeof(int));
+	D = (Data *)malloc(s->m * sizeof(Data)); /* auxiliary arrays of the selection */
+	accum = (double *)malloc(s->m * sizeof(double));
 
 	for (t = 1; t <= s->iterations; t++)
 	{
-		fprintf(stderr, "\nRunning generation %d/%d ... ", t, s->iterations);
-
 		/* It performs the selection */
-		selection = RouletteSelectionGA(s, s->m);
+		RouletteSelectionGAInto(s, s->m, selection, D, accum);
 
 		/* It performs the crossover */
 		for(i = 0; i < s->m / 2; i += 2)
@@ -94,18 +92,52 @@ void runGA(SearchSpace *s, prtFun Evaluate, ...)
 			}
 		}
 
-		EvaluateSearchSpace(s, _GA_, Evaluate, arg);
+		EvaluateSearchSpaceWith(s, _GA_, e);
 
-		free(selection);
+		ReportIteration(s, _GA_, e, t, s->gfit);
 	}
 
-	fprintf(stderr, "\nOK (minimum fitness value %lf)\n", s->gfit);
-
 	for(i = 0; i < s->m; i++)
 		free(tmp[i]);
 
 	free(tmp);
+	free(selection);
+	free(D);
+	free(accum);
+}
 
+/* It executes the Genetic Algorithm for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate chromosomes
+arg: list of additional arguments */
+
+void runGA(SearchSpace *s, prtFun Evaluate, ...)
+{
+	va_list arg;
+	Evaluator e;
 
+	va_start(arg, Evaluate);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	GA(s, &e);
+	PROFILE_END_RUN("GA", &e);
+	DestroyEvaluator(&e);
 	va_end(arg);
+}
+
+/* It executes the Genetic Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runGA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+	Evaluator e;
+
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	GA(s, &e);
+	PROFILE_END_RUN("GA", &e);
+	DestroyEvaluator(&e);
 }
\ No newline at end of file
@@ -15,23 +15,21 @@ limitations under the License.
 
 
 #include "gp.h"
+#include "telemetry.h"
+#include "profile.h"
 
-/* It executes the Binary Geometric Semantic Genetic Programming for function minimization
+/* It executes the Binary Geometric Semantic Genetic Programming with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runBGSGP(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void BGSGP(SearchSpace *s, Evaluator *e)
 {
-	va_list arg, argtmp;
 	int t, i, j, z, n_reproduction, n_mutation, n_crossover;
 	int *reproduction = NULL, *mutation = NULL, *crossover = NULL;
 	int father_cross_point, mother_crosspoint, ctr;
 	double beta, prob;
 	Node **tmpTree = NULL, *aux = NULL;
-
-	va_start(arg, Evaluate);
-	va_copy(argtmp, arg);
+	GSGPLog *l = NULL;
 
 	if (!s)
 	{
@@ -39,16 +37,25 @@ void runBGSGP(SearchSpace *s, prtFun Evaluate, ...)
 		exit(-1);
 	}
 
-	EvaluateSearchSpace(s, _GP_, Evaluate, arg); /* Initial evaluation */
-	tmpTree = (Node **)malloc(s->m * sizeof(Node *));
+	l = s->gsgp_log;
+	if (l)
+	{ /* Semantic engine: the trees are moved to the log, and only their outputs are evolved */
+		StartGSGPLog(s, l);
+		s->semantics = l->semantics;
+	}
+
+	EvaluateSearchSpaceWith(s, _GP_, e); /* Initial evaluation */
+	if (!l)
+		tmpTree = (Node **)malloc(s->m * sizeof(Node *));
 	ShowSearchSpace(s, _GP_);
 
 	for (t = 1; t <= s->iterations; t++)
 	{
-		fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-		for (i = 0; i < s->m; i++)
-			tmpTree[i] = CopyTree(s->T[i]);
+		if (l)
+			BeginGSGPGeneration(l);
+		else
+			for (i = 0; i < s->m; i++)
+				tmpTree[i] = CopyTree(s->T[i]);
 
 		/* Calcultating the number of individuals to be reproducted */
 		n_reproduction = round(s->m * s->pReproduction);
@@ -65,16 +72,26 @@ void runBGSGP(SearchSpace *s, prtFun Evaluate, ...)
 		/* It performs the reproduction */
 		for (i = 0; i < n_reproduction; i++)
 		{
-			DestroyTree(&s->T[i]);
-			s->T[i] = CopyTree(tmpTree[reproduction[i]]);
+			if (l)
+				ReproductionSemantics(l, i, reproduction[i]);
+			else
+			{
+				DestroyTree(&s->T[i]);
+				s->T[i] = CopyTree(tmpTree[reproduction[i]]);
+			}
 		}
 
 		/* It performs the mutation */
 		z = 0;
 		for (j = n_reproduction; j < n_reproduction + n_mutation; j++)
 		{
-			DestroyTree(&s->T[j]);
-			s->T[j] = SGMB(s, tmpTree[mutation[z]]);
+			if (l)
+				SGMBSemantics(s, l, j, mutation[z]);
+			else
+			{
+				DestroyTree(&s->T[j]);
+				s->T[j] = SGMB(s, tmpTree[mutation[z]]);
+			}
 			z++;
 		}
 
@@ -90,10 +107,15 @@ void runBGSGP(SearchSpace *s, prtFun Evaluate, ...)
 				ctr++;
 			} while ((father_cross_point == mother_crosspoint) && (ctr <= 10));
 
-			aux = SGXB(s, tmpTree[crossover[father_cross_point]], tmpTree[crossover[mother_crosspoint]]);
-			DestroyTree(&(s->T[j]));
-			s->T[j] = CopyTree(aux);
-			DestroyTree(&aux);
+			if (l)
+				SGXBSemantics(s, l, j, crossover[father_cross_point], crossover[mother_crosspoint]);
+			else
+			{
+				aux = SGXB(s, tmpTree[crossover[father_cross_point]], tmpTree[crossover[mother_crosspoint]]);
+				DestroyTree(&(s->T[j]));
+				s->T[j] = CopyTree(aux);
+				DestroyTree(&aux);
+			}
 			z++;
 		}
 
@@ -101,36 +123,74 @@ void runBGSGP(SearchSpace *s, prtFun Evaluate, ...)
 		free(mutation);
 		free(crossover);
 
-		for (i = 0; i < s->m; i++)
-			DestroyTree(&tmpTree[i]);
+		if (l)
+		{
+			EndGSGPGeneration(l);
+			s->semantics = l->semantics;
+		}
+		else
+			for (i = 0; i < s->m; i++)
+				DestroyTree(&tmpTree[i]);
 
-		EvaluateSearchSpace(s, _GP_, Evaluate, arg);
+		EvaluateSearchSpaceWith(s, _GP_, e);
 
-		fprintf(stderr, "OK (minimum fitness value %lf) -> Best tree: %d.", s->gfit, s->best);
-		va_copy(arg, argtmp);
+		ReportIteration(s, _GP_, e, t, s->gfit);
 	}
 
-	free(tmpTree);
-	va_end(arg);
+	if (l)
+		s->semantics = NULL;
+	else
+		free(tmpTree);
 }
-/*************************/
 
-/* It executes standard (real-valued) Geometric Semantic Genetic Programming for function minimization
+/* It executes the Binary Geometric Semantic Genetic Programming for function minimization
 Parameters:
 s: search space
 Evaluate: pointer to the function used to evaluate particles
 arg: list of additional arguments */
-void runGSGP(SearchSpace *s, prtFun Evaluate, ...)
+void runBGSGP(SearchSpace *s, prtFun Evaluate, ...)
+{
+	va_list arg;
+	Evaluator e;
+
+	va_start(arg, Evaluate);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	BGSGP(s, &e);
+	PROFILE_END_RUN("BGSGP", &e);
+	DestroyEvaluator(&e);
+	va_end(arg);
+}
+
+/* It executes the Binary Geometric Semantic Genetic Programming for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runBGSGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+	Evaluator e;
+
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	BGSGP(s, &e);
+	PROFILE_END_RUN("BGSGP", &e);
+	DestroyEvaluator(&e);
+}
+/*************************/
+
+/* It executes the standard (real-valued) Geometric Semantic Genetic Programming with a given fitness evaluator
+Parameters:
+s: search space
+e: fitness evaluator */
+static void GSGP(SearchSpace *s, Evaluator *e)
 {
-	va_list arg, argtmp;
 	int t, i, j, z, n_reproduction, n_mutation, n_crossover;
 	int *reproduction = NULL, *mutation = NULL, *crossover = NULL;
 	int father_cross_point, mother_crosspoint, ctr;
 	double beta, prob;
 	Node **tmpTree = NULL, *aux = NULL;
-
-	va_start(arg, Evaluate);
-	va_copy(argtmp, arg);
+	GSGPLog *l = NULL;
 
 	if (!s)
 	{
@@ -138,16 +198,25 @@ void runGSGP(SearchSpace *s, prtFun Evaluate, ...)
 		exit(-1);
 	}
 
-	EvaluateSearchSpace(s, _GP_, Evaluate, arg); /* Initial evaluation */
-	tmpTree = (Node **)malloc(s->m * sizeof(Node *));
+	l = s->gsgp_log;
+	if (l)
+	{ /* Semantic engine: the trees are moved to the log, and only their outputs are evolved */
+		StartGSGPLog(s, l);
+		s->semantics = l->semantics;
+	}
+
+	EvaluateSearchSpaceWith(s, _GP_, e); /* Initial evaluation */
+	if (!l)
+		tmpTree = (Node **)malloc(s->m * sizeof(Node *));
 	ShowSearchSpace(s, _GP_);
 
 	for (t = 1; t <= s->iterations; t++)
 	{
-		fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-		for (i = 0; i < s->m; i++)
-			tmpTree[i] = CopyTree(s->T[i]);
+		if (l)
+			BeginGSGPGeneration(l);
+		else
+			for (i = 0; i < s->m; i++)
+				tmpTree[i] = CopyTree(s->T[i]);
 
 		/* Calcultating the number of individuals to be reproducted */
 		n_reproduction = round(s->m * s->pReproduction);
@@ -164,8 +233,13 @@ void runGSGP(SearchSpace *s, prtFun Evaluate, ...)
 		/* It performs the reproduction */
 		for (i = 0; i < n_reproduction; i++)
 		{
-			DestroyTree(&s->T[i]);
-			s->T[i] = CopyTree(tmpTree[reproduction[i]]);
+			if (l)
+				ReproductionSemantics(l, i, reproduction[i]);
+			else
+			{
+				DestroyTree(&s->T[i]);
+				s->T[i] = CopyTree(tmpTree[reproduction[i]]);
+			}
 		}
 
 		/* It performs the mutation */
@@ -180,12 +254,15 @@ void runGSGP(SearchSpace *s, prtFun Evaluate, ...)
 				ctr++;
 			} while ((father_cross_point == mother_crosspoint) && (ctr <= 10));
 
-			fprintf(stderr, "%d %d %d\n", n_reproduction, n_mutation, n_crossover);
-
-			aux = SGME(s, tmpTree[crossover[father_cross_point]], tmpTree[crossover[mother_crosspoint]]);
-			DestroyTree(&s->T[j]);
-			s->T[j] = CopyTree(aux);
-			DestroyTree(&aux);
+			if (l)
+				SGMESemantics(s, l, j, crossover[father_cross_point], crossover[mother_crosspoint]);
+			else
+			{
+				aux = SGME(s, tmpTree[crossover[father_cross_point]], tmpTree[crossover[mother_crosspoint]]);
+				DestroyTree(&s->T[j]);
+				s->T[j] = CopyTree(aux);
+				DestroyTree(&aux);
+			}
 			z++;
 		}
 
@@ -201,10 +278,15 @@ void runGSGP(SearchSpace *s, prtFun Evaluate, ...)
 				ctr++;
 			} while ((father_cross_point == mother_crosspoint) && (ctr <= 10));
 
-			aux = SGXE(s, tmpTree[crossover[father_cross_point]], tmpTree[crossover[mother_crosspoint]]);
-			DestroyTree(&(s->T[j]));
-			s->T[j] = CopyTree(aux);
-			DestroyTree(&aux);
+			if (l)
+				SGXESemantics(s, l, j, crossover[father_cross_point], crossover[mother_crosspoint]);
+			else
+			{
+				aux = SGXE(s, tmpTree[crossover[father_cross_point]], tmpTree[crossover[mother_crosspoint]]);
+				DestroyTree(&(s->T[j]));
+				s->T[j] = CopyTree(aux);
+				DestroyTree(&aux);
+			}
 			z++;
 		}
 
@@ -212,252 +294,268 @@ void runGSGP(SearchSpace *s, prtFun Evaluate, ...)
 		free(mutation);
 		free(crossover);
 
-		for (i = 0; i < s->m; i++)
-			DestroyTree(&tmpTree[i]);
+		if (l)
+		{
+			EndGSGPGeneration(l);
+			s->semantics = l->semantics;
+		}
+		else
+			for (i = 0; i < s->m; i++)
+				DestroyTree(&tmpTree[i]);
 
-		EvaluateSearchSpace(s, _GP_, Evaluate, arg);
+		EvaluateSearchSpaceWith(s, _GP_, e);
 
-		fprintf(stderr, "OK (minimum fitness value %lf) -> Best tree: %d.", s->gfit, s->best);
-		va_copy(arg, argtmp);
+		ReportIteration(s, _GP_, e, t, s->gfit);
 	}
 
-	free(tmpTree);
-	va_end(arg);
+	if (l)
+		s->semantics = NULL;
+	else
+		free(tmpTree);
 }
-/*************************/
 
-/* It executes the Genetic Programming for function minimization
+/* It executes standard (real-valued) Geometric Semantic Genetic Programming for function minimization
 Parameters:
 s: search space
 Evaluate: pointer to the function used to evaluate particles
 arg: list of additional arguments */
-void runGP(SearchSpace *s, prtFun Evaluate, ...)
+void runGSGP(SearchSpace *s, prtFun Evaluate, ...)
 {
-	va_list arg, argtmp;
-	int t, i, j, z, n_reproduction, n_mutation, n_crossover;
-	int *reproduction = NULL, *mutation = NULL, *crossover = NULL;
-	int father_cross_point, mother_crosspoint, ctr;
-	double beta, prob;
-	Node **tmpTree = NULL, **aux = NULL;
+	va_list arg;
+	Evaluator e;
 
 	va_start(arg, Evaluate);
-	va_copy(argtmp, arg);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	GSGP(s, &e);
+	PROFILE_END_RUN("GSGP", &e);
+	DestroyEvaluator(&e);
+	va_end(arg);
+}
 
-	if (!s)
-	{
-		fprintf(stderr, "\nSearch space not allocated @runGP.\n");
-		exit(-1);
-	}
+/* It executes the standard (real-valued) Geometric Semantic Genetic Programming for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runGSGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+	Evaluator e;
 
-	EvaluateSearchSpace(s, _GP_, Evaluate, arg); /* Initial evaluation */
-	tmpTree = (Node **)malloc(s->m * sizeof(Node *));
-	ShowSearchSpace(s, _GP_);
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	GSGP(s, &e);
+	PROFILE_END_RUN("GSGP", &e);
+	DestroyEvaluator(&e);
+}
+/*************************/
 
-	for (t = 1; t <= s->iterations; t++)
-	{
-		fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
+/* It breeds a new generation of trees through reproduction, mutation and crossover (GP and TGP)
+ * The trees are read from one pool and written into another one, so that no tree has to be copied beforehand.
+Parameters:
+s: search space
+cur: pool with the current generation
+next: pool that receives the new generation (its previous trees are discarded) */
+static void BreedTrees(SearchSpace *s, TreePool *cur, TreePool *next)
+{
+	int i, j, z, n_reproduction, n_mutation, n_crossover;
+	int *reproduction = NULL, *mutation = NULL, *crossover = NULL;
+	int father_cross_point, mother_crosspoint, ctr;
 
-		for (i = 0; i < s->m; i++)
-			tmpTree[i] = CopyTree(s->T[i]);
+	ClearTreePool(next);
 
-		/* Calcultating the number of individuals to be reproducted */
-		n_reproduction = round(s->m * s->pReproduction);
-		reproduction = RouletteSelection(s, n_reproduction);
+	/* Calcultating the number of individuals to be reproducted */
+	n_reproduction = round(s->m * s->pReproduction);
+	reproduction = RouletteSelection(s, n_reproduction);
 
-		/* Calcultating the number of individuals to be mutated */
-		n_mutation = round(s->m * s->pMutation);
-		mutation = RouletteSelection(s, n_mutation);
+	/* Calcultating the number of individuals to be mutated */
+	n_mutation = round(s->m * s->pMutation);
+	mutation = RouletteSelection(s, n_mutation);
 
-		/* Calcultating the number of individuals to perform the crossover */
-		n_crossover = s->m - (n_reproduction + n_mutation);
-		crossover = RouletteSelection(s, n_crossover);
+	/* Calcultating the number of individuals to perform the crossover */
+	n_crossover = s->m - (n_reproduction + n_mutation);
+	crossover = RouletteSelection(s, n_crossover);
 
-		/* It performs the reproduction */
-		for (i = 0; i < n_reproduction; i++)
-		{
-			DestroyTree(&s->T[i]);
-			s->T[i] = CopyTree(tmpTree[reproduction[i]]);
-		}
+	/* It performs the reproduction */
+	for (i = 0; i < n_reproduction; i++)
+		CopyTreeIntoPool(next, i, cur, reproduction[i]);
 
-		/* It performs the mutation */
-		z = 0;
-		for (j = n_reproduction; j < n_reproduction + n_mutation; j++)
+	/* It performs the mutation */
+	z = 0;
+	for (j = n_reproduction; j < n_reproduction + n_mutation; j++)
+	{
+		if (getSizePooledTree(cur, mutation[z]) > 1)
+			MutationIntoPool(s, next, j, cur, mutation[z], PROB_MUTATION_FUNCTION);
+		else
+			GROWIntoPool(s, next, j, s->min_depth, s->max_depth);
+		z++;
+	}
+
+	/* It performs the crossover */
+	for (j = n_reproduction + n_mutation; j < n_reproduction + n_mutation + n_crossover; j += 2)
+	{
+		ctr = 1;
+		do
 		{
-			DestroyTree(&s->T[j]);
-			if (getSizeTree(tmpTree[mutation[z]]) > 1)
-				s->T[j] = Mutation(s, tmpTree[mutation[z]], PROB_MUTATION_FUNCTION);
-			else
-				s->T[j] = GROW(s, s->min_depth, s->max_depth);
-			z++;
+			father_cross_point = GenerateUniformRandomNumber(0, n_crossover);
+			mother_crosspoint = GenerateUniformRandomNumber(0, n_crossover);
+			ctr++;
+		} while ((father_cross_point == mother_crosspoint) && (ctr <= 10));
+
+		/* in case of an odd number of samples to do crossover, the second offspring is discarded */
+		if ((getSizePooledTree(cur, crossover[father_cross_point]) > 1) && (getSizePooledTree(cur, crossover[mother_crosspoint]) > 1))
+			CrossoverIntoPool(next, j, j + 1 < n_reproduction + n_mutation + n_crossover ? j + 1 : -1, cur,
+							  crossover[father_cross_point], crossover[mother_crosspoint], PROB_CROSSOVER_FUNCTION);
+		else
+		{
+			CopyTreeIntoPool(next, j, cur, crossover[father_cross_point]);
+			if (j + 1 < n_reproduction + n_mutation + n_crossover)
+				CopyTreeIntoPool(next, j + 1, cur, crossover[mother_crosspoint]);
 		}
+	}
 
-		/* It performs the crossover */
-		z = 0;
-		for (j = n_reproduction + n_mutation; j < n_reproduction + n_mutation + n_crossover; j += 2)
-		{
-			ctr = 1;
-			do
-			{
-				father_cross_point = GenerateUniformRandomNumber(0, n_crossover);
-				mother_crosspoint = GenerateUniformRandomNumber(0, n_crossover);
-				ctr++;
-			} while ((father_cross_point == mother_crosspoint) && (ctr <= 10));
+	free(reproduction);
+	free(mutation);
+	free(crossover);
+}
 
-			if ((getSizeTree(tmpTree[crossover[father_cross_point]]) > 1) && (getSizeTree(tmpTree[crossover[mother_crosspoint]]) > 1))
-			{
-				aux = Crossover(tmpTree[crossover[father_cross_point]],
-								tmpTree[crossover[mother_crosspoint]], PROB_CROSSOVER_FUNCTION);
-				DestroyTree(&(s->T[j]));
-				s->T[j] = CopyTree(aux[0]);
-				if (j + 1 < n_reproduction + n_mutation + n_crossover)
-				{
-					DestroyTree(&(s->T[j + 1]));
-					s->T[j + 1] = CopyTree(aux[1]); /* in case of an odd number of samples to do crossover */
-				}
-				DestroyTree(&aux[0]);
-				DestroyTree(&aux[1]);
-				free(aux);
-			}
-			else
-			{
-				DestroyTree(&(s->T[j]));
-				s->T[j] = CopyTree(tmpTree[crossover[father_cross_point]]);
-				if (j + 1 < n_reproduction + n_mutation + n_crossover)
-				{
-					DestroyTree(&(s->T[j + 1]));
-					s->T[j + 1] = CopyTree(tmpTree[crossover[mother_crosspoint]]); /* in case of an odd number of samples to do crossover */
-				}
-			}
-			z++;
-		}
+/* It evolves the trees of a search space, which are moved to a pair of tree pools during the iterations (GP and TGP)
+Parameters:
+s: search space
+e: fitness evaluator
+opt_id: identifier of the optimization technique (_GP_ or _TGP_) */
+static void EvolveTrees(SearchSpace *s, Evaluator *e, int opt_id)
+{
+	int t, i;
+	TreePool *cur = NULL, *next = NULL, *aux = NULL;
 
-		free(reproduction);
-		free(mutation);
-		free(crossover);
+	cur = CreateTreePool(s->m);
+	next = CreateTreePool(s->m);
+	for (i = 0; i < s->m; i++)
+		Tree2Pool(cur, i, s->T[i]);
 
-		for (i = 0; i < s->m; i++)
-			DestroyTree(&tmpTree[i]);
+	for (t = 1; t <= s->iterations; t++)
+	{
+		BreedTrees(s, cur, next);
+		aux = cur; /* the new generation becomes the current one */
+		cur = next;
+		next = aux;
 
-		EvaluateSearchSpace(s, _GP_, Evaluate, arg);
+		s->forest = cur;
+		EvaluateSearchSpaceWith(s, opt_id, e);
 
-		fprintf(stderr, "OK (minimum fitness value %lf) -> Best tree: %d.", s->gfit, s->best);
-		va_copy(arg, argtmp);
+		ReportIteration(s, opt_id, e, t, s->gfit);
 	}
 
-	free(tmpTree);
-	va_end(arg);
+	s->forest = NULL;
+	for (i = 0; i < s->m; i++)
+	{
+		DestroyTree(&s->T[i]);
+		s->T[i] = Pool2Tree(s, cur, i);
+	}
+	DestroyTreePool(&cur);
+	DestroyTreePool(&next);
 }
-/*************************/
 
-/* It executes the Tensor-based Genetic Programming for function minimization
+/* It executes the Genetic Programming with a given fitness evaluator
+Parameters:
+s: search space
+e: fitness evaluator */
+static void GP(SearchSpace *s, Evaluator *e)
+{
+	if (!s)
+	{
+		fprintf(stderr, "\nSearch space not allocated @runGP.\n");
+		exit(-1);
+	}
+
+	EvaluateSearchSpaceWith(s, _GP_, e); /* Initial evaluation */
+	ShowSearchSpace(s, _GP_);
+
+	EvolveTrees(s, e, _GP_);
+}
+
+/* It executes the Genetic Programming for function minimization
 Parameters:
 s: search space
 Evaluate: pointer to the function used to evaluate particles
 arg: list of additional arguments */
-void runTGP(SearchSpace *s, prtFun Evaluate, ...){
-	va_list arg, argtmp;
-	int t, i, j, z, n_reproduction, n_mutation, n_crossover;
-	int *reproduction = NULL, *mutation = NULL, *crossover = NULL;
-	int father_cross_point, mother_crosspoint, ctr;
-	double beta, prob;
-	Node **tmpTree = NULL, **aux = NULL;
+void runGP(SearchSpace *s, prtFun Evaluate, ...)
+{
+	va_list arg;
+	Evaluator e;
 
 	va_start(arg, Evaluate);
-	va_copy(argtmp, arg);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	GP(s, &e);
+	PROFILE_END_RUN("GP", &e);
+	DestroyEvaluator(&e);
+	va_end(arg);
+}
+
+/* It executes the Genetic Programming for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+	Evaluator e;
+
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	GP(s, &e);
+	PROFILE_END_RUN("GP", &e);
+	DestroyEvaluator(&e);
+}
+/*************************/
 
+/* It executes the Tensor-based Genetic Programming with a given fitness evaluator
+Parameters:
+s: search space
+e: fitness evaluator */
+static void TGP(SearchSpace *s, Evaluator *e){
 	if (!s){
 		fprintf(stderr, "\nSearch space not allocated @runTGP.\n");
 		exit(-1);
 	}
 	
-	EvaluateSearchSpace(s, _TGP_, Evaluate, arg); /* Initial evaluation */
-	tmpTree = (Node **)malloc(s->m * sizeof(Node *));
-	
-	for (t = 1; t <= s->iterations; t++){
-		fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-		for (i = 0; i < s->m; i++)
-			tmpTree[i] = CopyTree(s->T[i]);
-
-		/* Calcultating the number of individuals to be reproducted */
-		n_reproduction = round(s->m * s->pReproduction);
-		reproduction = RouletteSelection(s, n_reproduction);
-
-		/* Calcultating the number of individuals to be mutated */
-		n_mutation = round(s->m * s->pMutation);
-		mutation = RouletteSelection(s, n_mutation);
-
-		/* Calcultating the number of individuals to perform the crossover */
-		n_crossover = s->m - (n_reproduction + n_mutation);
-		crossover = RouletteSelection(s, n_crossover);
-
-		/* It performs the reproduction */
-		for (i = 0; i < n_reproduction; i++){
-			DestroyTree(&s->T[i]);
-			s->T[i] = CopyTree(tmpTree[reproduction[i]]);
-		}
-
-		/* It performs the mutation */
-		z = 0;
-		for (j = n_reproduction; j < n_reproduction + n_mutation; j++){
-			DestroyTree(&s->T[j]);
-			if (getSizeTree(tmpTree[mutation[z]]) > 1)
-				s->T[j] = Mutation(s, tmpTree[mutation[z]], PROB_MUTATION_FUNCTION);
-			else
-				s->T[j] = GROW(s, s->min_depth, s->max_depth);
-			z++;
-		}
-
-		/* It performs the crossover */
-		z = 0;
-		for (j = n_reproduction + n_mutation; j < n_reproduction + n_mutation + n_crossover; j += 2){
-			ctr = 1;
-			do{
-				father_cross_point = GenerateUniformRandomNumber(0, n_crossover);
-				mother_crosspoint = GenerateUniformRandomNumber(0, n_crossover);
-				ctr++;
-			} while ((father_cross_point == mother_crosspoint) && (ctr <= 10));
-
-			if ((getSizeTree(tmpTree[crossover[father_cross_point]]) > 1) && (getSizeTree(tmpTree[crossover[mother_crosspoint]]) > 1)){
-				aux = Crossover(tmpTree[crossover[father_cross_point]],
-								tmpTree[crossover[mother_crosspoint]], PROB_CROSSOVER_FUNCTION);
-				DestroyTree(&(s->T[j]));
-				s->T[j] = CopyTree(aux[0]);
-				if (j + 1 < n_reproduction + n_mutation + n_crossover)
-				{
-					DestroyTree(&(s->T[j + 1]));
-					s->T[j + 1] = CopyTree(aux[1]); /* in case of an odd number of samples to do crossover */
-				}
-				DestroyTree(&aux[0]);
-				DestroyTree(&aux[1]);
-				free(aux);
-			}
-			else{
-				DestroyTree(&(s->T[j]));
-				s->T[j] = CopyTree(tmpTree[crossover[father_cross_point]]);
-				if (j + 1 < n_reproduction + n_mutation + n_crossover)
-				{
-					DestroyTree(&(s->T[j + 1]));
-					s->T[j + 1] = CopyTree(tmpTree[crossover[mother_crosspoint]]); /* in case of an odd number of samples to do crossover */
-				}
-			}
-			z++;
-		}
-
-		free(reproduction);
-		free(mutation);
-		free(crossover);
+	EvaluateSearchSpaceWith(s, _TGP_, e); /* Initial evaluation */
 
-		for (i = 0; i < s->m; i++)
-			DestroyTree(&tmpTree[i]);
+	EvolveTrees(s, e, _TGP_);
+}
 
-		EvaluateSearchSpace(s, _TGP_, Evaluate, arg);
+/* It executes the Tensor-based Genetic Programming for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runTGP(SearchSpace *s, prtFun Evaluate, ...){
+	va_list arg;
+	Evaluator e;
 
-		fprintf(stderr, "OK (minimum fitness value %lf) -> Best tree: %d.", s->gfit, s->best);
-		va_copy(arg, argtmp);
-	}
-	
-	free(tmpTree);
+	va_start(arg, Evaluate);
+	InitEvaluator(&e, s, Evaluate, arg);
+	PROFILE_BEGIN_RUN();
+	TGP(s, &e);
+	PROFILE_END_RUN("TGP", &e);
+	DestroyEvaluator(&e);
 	va_end(arg);
 }
+
+/* It executes the Tensor-based Genetic Programming for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTGP_r(SearchSpace *s, prtFun_r Evaluate, void *ctx){
+	Evaluator e;
+
+	InitEvaluator_r(&e, s, Evaluate, ctx);
+	PROFILE_BEGIN_RUN();
+	TGP(s, &e);
+	PROFILE_END_RUN("TGP", &e);
+	DestroyEvaluator(&e);
+}
 /*************************/
\ No newline at end of file
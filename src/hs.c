@@ -14,21 +14,19 @@ limitations under the License.
 */
 
 #include "hs.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
-/* It executes the Harmony Search for function minimization
+/* It executes the Harmony Search with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate nests
-arg: list of additional arguments */
-void runHS(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void HS(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
-    int t, i, j;
+    int t, i, j, w;
     double fitValue;
-    Agent *tmp = NULL;
-
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    FitnessHeap *h = NULL;
 
     if (!s)
     {
@@ -36,56 +34,85 @@ void runHS(SearchSpace *s, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _HS_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _HS_, e); /* Initial evaluation of the search space */
+    h = CreateFitnessHeap(s);
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
+        w = GetWorstAgent(h); /* The worst harmony is the root of the heap */
 
-        va_copy(arg, argtmp);
-
-        qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all harmonies according to their fitness. First position gets the best harmony. */
-
-        tmp = GenerateNewAgent(s, _HS_);
-        CheckAgentLimits(s, tmp);
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
-
-        if ((fitValue < s->a[s->m - 1]->fit))
-        { /* We accept the new solution */
-            DestroyAgent(&(s->a[s->m - 1]), _HS_);
-            s->a[s->m - 1] = CopyAgent(tmp, _HS_, _NOTENSOR_);
-            s->a[s->m - 1]->fit = fitValue;
-        }
+        /* The new harmony takes the place of the worst one, and it is swapped back if it is rejected */
+        DrawNewPosition(s, GetTrialVector(s, w), _HS_);
+        SwapTrialVector(s, s->a[w], w);
+        CheckAgentLimits(s, s->a[w]);
+        fitValue = ComputeFitness(e, s->a[w]); /* It executes the fitness function for the new harmony */
 
         if (fitValue < s->gfit)
         { /* update the global best */
             s->gfit = fitValue;
             for (j = 0; j < s->n; j++)
-                s->g[j] = tmp->x[j];
+                s->g[j] = s->a[w]->x[j];
         }
 
-        DestroyAgent(&tmp, _HS_);
+        if ((fitValue < s->a[w]->fit))
+        { /* We accept the new solution */
+            s->a[w]->fit = fitValue;
+            UpdateFitnessHeap(s, h, w);
+        }
+        else
+            SwapTrialVector(s, s->a[w], w);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _HS_, e, t, s->gfit);
     }
 
-    va_end(arg);
+    DestroyFitnessHeap(&h);
+    RestoreAgentBlocks(s);
 }
 
-/* It executes the Improved Harmony Search for function minimization
+/* It executes the Harmony Search for function minimization
 Parameters:
 s: search space
 Evaluate: pointer to the function used to evaluate nests
 arg: list of additional arguments */
-void runIHS(SearchSpace *s, prtFun Evaluate, ...)
+void runHS(SearchSpace *s, prtFun Evaluate, ...)
 {
-    va_list arg, argtmp;
-    int t, i, j;
-    double fitValue;
-    Agent *tmp = NULL;
+    va_list arg;
+    Evaluator e;
 
     va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    HS(s, &e);
+    PROFILE_END_RUN("HS", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Harmony Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runHS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    HS(s, &e);
+    PROFILE_END_RUN("HS", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Improved Harmony Search with a given fitness evaluator
+Parameters:
+s: search space
+e: fitness evaluator */
+static void IHS(SearchSpace *s, Evaluator *e)
+{
+    int t, i, j, w;
+    double fitValue;
+    FitnessHeap *h = NULL;
 
     if (!s)
     {
@@ -93,44 +120,78 @@ void runIHS(SearchSpace *s, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _HS_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _HS_, e); /* Initial evaluation of the search space */
+    h = CreateFitnessHeap(s);
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        va_copy(arg, argtmp);
-
-        qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all harmonies according to their fitness. First position gets the best harmony. */
+        w = GetWorstAgent(h); /* The worst harmony is the root of the heap */
 
         s->PAR = s->PAR_min + ((s->PAR_max - s->PAR_min) / s->iterations) * t;
         s->bw = s->bw_max * exp((log(s->bw_min / s->bw_max) / s->iterations) * t);
-        tmp = GenerateNewAgent(s, _HS_);
-        CheckAgentLimits(s, tmp);
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
-
-        if ((fitValue < s->a[s->m - 1]->fit))
-        { /* We accept the new solution */
-            DestroyAgent(&(s->a[s->m - 1]), _HS_);
-            s->a[s->m - 1] = CopyAgent(tmp, _HS_, _NOTENSOR_);
-            s->a[s->m - 1]->fit = fitValue;
-        }
+        /* The new harmony takes the place of the worst one, and it is swapped back if it is rejected */
+        DrawNewPosition(s, GetTrialVector(s, w), _HS_);
+        SwapTrialVector(s, s->a[w], w);
+        CheckAgentLimits(s, s->a[w]);
+        fitValue = ComputeFitness(e, s->a[w]); /* It executes the fitness function for the new harmony */
 
         if (fitValue < s->gfit)
         { /* update the global best */
             s->gfit = fitValue;
             for (j = 0; j < s->n; j++)
-                s->g[j] = tmp->x[j];
+                s->g[j] = s->a[w]->x[j];
         }
 
-        DestroyAgent(&tmp, _HS_);
+        if ((fitValue < s->a[w]->fit))
+        { /* We accept the new solution */
+            s->a[w]->fit = fitValue;
+            UpdateFitnessHeap(s, h, w);
+        }
+        else
+            SwapTrialVector(s, s->a[w], w);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _HS_, e, t, s->gfit);
     }
 
+    DestroyFitnessHeap(&h);
+    RestoreAgentBlocks(s);
+}
+
+/* It executes the Improved Harmony Search for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate nests
+arg: list of additional arguments */
+void runIHS(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    IHS(s, &e);
+    PROFILE_END_RUN("IHS", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
 
+/* It executes the Improved Harmony Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runIHS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    IHS(s, &e);
+    PROFILE_END_RUN("IHS", &e);
+    DestroyEvaluator(&e);
+}
+
 /* It updates the individual values of HMCR and PAR concerning PSF-HS
 Parameters:
 s: search space
@@ -174,26 +235,18 @@ void UpdateIndividualTensorHMCR_PAR(SearchSpace *s, int tensor_id, char ***rehea
     }
 }
 
-/* It generates a new PSF agent
+/* It draws the decision variables of a new PSF agent
 Paremeters:
 s: search space
+x: output n-dimensional array (it must not be the position of an agent of s)
 HMCR: harmony memory considering rate
 PAR: pitch adjustemt rate
 op_type: vector that contains the operation that the harmony was generated */
-Agent *GenerateNewPSF(SearchSpace *s, double *HMCR, double *PAR, char *op_type)
+static void DrawNewPSF(SearchSpace *s, double *x, double *HMCR, double *PAR, char *op_type)
 {
-    if (!s)
-    {
-        fprintf(stderr, "\nSearch space not allocated @GenerateNewPSF.\n");
-        exit(-1);
-    }
-
-    Agent *a = NULL;
     int i, j;
     double r, signal;
 
-    a = CreateAgent(s->n, _HS_, _NOTENSOR_);
-
     for (j = 0; j < s->n; j++)
     {
         r = GenerateUniformRandomNumber(0, 1);
@@ -201,51 +254,63 @@ Agent *GenerateNewPSF(SearchSpace *s, double *HMCR, double *PAR, char *op_type)
         {
             i = GenerateUniformRandomNumber(0, s->m);
             r = GenerateUniformRandomNumber(0, 1);
-            a->x[j] = s->a[i]->x[j];
+            x[j] = s->a[i]->x[j];
             op_type[j] = PSF_MEMORY;
             if (PAR[j] >= r)
             {
                 signal = GenerateUniformRandomNumber(0, 1);
                 r = GenerateUniformRandomNumber(0, 1);
                 if (signal >= 0.5)
-                    a->x[j] = s->a[i]->x[j] + r * s->bw;
+                    x[j] = s->a[i]->x[j] + r * s->bw;
                 else
-                    a->x[j] = s->a[i]->x[j] - r * s->bw;
+                    x[j] = s->a[i]->x[j] - r * s->bw;
                 op_type[j] = PSF_PITCH;
             }
         }
         else
         {
             r = (s->UB[j] - s->LB[j]) * GenerateUniformRandomNumber(0, 1) + s->LB[j];
-            a->x[j] = r;
+            x[j] = r;
             op_type[j] = PSF_RANDOM;
         }
     }
-
-    return a;
 }
 
-/* It generates a new PSF tensor
+/* It generates a new PSF agent
 Paremeters:
 s: search space
-tensor_id: identifier of tensor's dimension
 HMCR: harmony memory considering rate
 PAR: pitch adjustemt rate
 op_type: vector that contains the operation that the harmony was generated */
-double **GenerateNewPSFTensor(SearchSpace *s, int tensor_id, double **HMCR, double **PAR, char **op_type)
+Agent *GenerateNewPSF(SearchSpace *s, double *HMCR, double *PAR, char *op_type)
 {
     if (!s)
     {
-        fprintf(stderr, "\nSearch space not allocated @GenerateNewPSFTensor.\n");
+        fprintf(stderr, "\nSearch space not allocated @GenerateNewPSF.\n");
         exit(-1);
     }
 
-    double **t = NULL;
+    Agent *a = NULL;
+
+    a = CreateAgent(s->n, _HS_, _NOTENSOR_);
+    DrawNewPSF(s, a->x, HMCR, PAR, op_type);
+
+    return a;
+}
+
+/* It draws the decision variables of a new PSF tensor into an existing one
+Parameters:
+s: search space
+t: n x tensor_id tensor
+tensor_id: identifier of tensor's dimension
+HMCR: harmony memory considering rate
+PAR: pitch adjustemt rate
+op_type: vector that contains the operation that the harmony was generated */
+static void DrawNewPSFTensor(SearchSpace *s, double **t, int tensor_id, double **HMCR, double **PAR, char **op_type)
+{
     int i, j, k;
     double r, signal;
 
-    t = CreateTensor(s->n, tensor_id);
-
     for (j = 0; j < s->n; j++)
     {
         for (k = 0; k < tensor_id; k++)
@@ -276,25 +341,41 @@ double **GenerateNewPSFTensor(SearchSpace *s, int tensor_id, double **HMCR, doub
             }
         }
     }
+}
+
+/* It generates a new PSF tensor
+Paremeters:
+s: search space
+tensor_id: identifier of tensor's dimension
+HMCR: harmony memory considering rate
+PAR: pitch adjustemt rate
+op_type: vector that contains the operation that the harmony was generated */
+double **GenerateNewPSFTensor(SearchSpace *s, int tensor_id, double **HMCR, double **PAR, char **op_type)
+{
+    if (!s)
+    {
+        fprintf(stderr, "\nSearch space not allocated @GenerateNewPSFTensor.\n");
+        exit(-1);
+    }
+
+    double **t = NULL;
+
+    t = CreateTensor(s->n, tensor_id);
+    DrawNewPSFTensor(s, t, tensor_id, HMCR, PAR, op_type);
 
     return t;
 }
 
-/* It executes the Parameter-setting-free Harmony Search for function minimization
+/* It executes the Parameter-setting-free Harmony Search with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate nests
-arg: list of additional arguments */
-void runPSF_HS(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void PSF_HS(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
-    int i, j, t;
+    int i, j, t, w;
     double fitValue, *HMCR, *PAR;
     char *op_type, **rehearsal;
-    Agent *tmp = NULL;
-
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    FitnessHeap *h = NULL;
 
     if (!s)
     {
@@ -302,7 +383,7 @@ void runPSF_HS(SearchSpace *s, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _HS_, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateSearchSpaceWith(s, _HS_, e); /* Initial evaluation of the search space */
 
     rehearsal = (char **)calloc(s->m, sizeof(char *));
     for (i = 0; i < s->m; i++)
@@ -313,10 +394,6 @@ void runPSF_HS(SearchSpace *s, prtFun Evaluate, ...)
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        va_copy(arg, argtmp);
-
         if (t == 1)
         {
             for (i = 0; i < s->m; i++)
@@ -326,45 +403,47 @@ void runPSF_HS(SearchSpace *s, prtFun Evaluate, ...)
                     HMCR[j] = s->HMCR;
                     PAR[j] = s->PAR;
                 }
-                tmp = GenerateNewPSF(s, HMCR, PAR, op_type);
+                DrawNewPSF(s, GetTrialVector(s, i), HMCR, PAR, op_type);
                 for (j = 0; j < s->n; j++)
                     rehearsal[i][j] = op_type[j];
-                DestroyAgent(&(s->a[i]), _HS_);
-                s->a[i] = CopyAgent(tmp, _HS_, _NOTENSOR_);
-                DestroyAgent(&tmp, _HS_);
+                SwapTrialVector(s, s->a[i], i);
             }
-            EvaluateSearchSpace(s, _HS_, Evaluate, arg);
+            EvaluateSearchSpaceWith(s, _HS_, e);
+            h = CreateFitnessHeap(s);
         }
 
-        qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all harmonies according to their fitness. First position gets the best harmony. */
+        w = GetWorstAgent(h); /* The worst harmony is the root of the heap */
 
-        tmp = GenerateNewPSF(s, HMCR, PAR, op_type);
+        /* The new harmony takes the place of the worst one, and it is swapped back if it is rejected */
+        DrawNewPSF(s, GetTrialVector(s, w), HMCR, PAR, op_type);
         UpdateIndividualHMCR_PAR(s, rehearsal, HMCR, PAR);
-        CheckAgentLimits(s, tmp);
+        SwapTrialVector(s, s->a[w], w);
+        CheckAgentLimits(s, s->a[w]);
 
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
-
-        if ((fitValue < s->a[s->m - 1]->fit))
-        { /* We accept the new solution */
-            DestroyAgent(&(s->a[s->m - 1]), _HS_);
-            s->a[s->m - 1] = CopyAgent(tmp, _HS_, _NOTENSOR_);
-            s->a[s->m - 1]->fit = fitValue;
-            for (j = 0; j < s->n; j++)
-                rehearsal[s->m - 1][j] = op_type[j];
-        }
+        fitValue = ComputeFitness(e, s->a[w]); /* It executes the fitness function for the new harmony */
 
         if (fitValue < s->gfit)
         { /* update the global best */
             s->gfit = fitValue;
             for (j = 0; j < s->n; j++)
-                s->g[j] = tmp->x[j];
+                s->g[j] = s->a[w]->x[j];
         }
 
-        DestroyAgent(&tmp, _HS_);
+        if ((fitValue < s->a[w]->fit))
+        { /* We accept the new solution */
+            s->a[w]->fit = fitValue;
+            UpdateFitnessHeap(s, h, w);
+            for (j = 0; j < s->n; j++)
+                rehearsal[w][j] = op_type[j];
+        }
+        else
+            SwapTrialVector(s, s->a[w], w);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _HS_, e, t, s->gfit);
     }
 
+    if (h)
+        DestroyFitnessHeap(&h);
     for (i = 0; i < s->m; i++)
         free(rehearsal[i]);
     free(rehearsal);
@@ -372,24 +451,55 @@ void runPSF_HS(SearchSpace *s, prtFun Evaluate, ...)
     free(PAR);
     free(op_type);
 
-    va_end(arg);
+    RestoreAgentBlocks(s);
 }
 
-/* It executes the Tensor-based Harmony Search for function minimization
+/* It executes the Parameter-setting-free Harmony Search for function minimization
 Parameters:
 s: search space
-tensor_id: identifier of tensor's dimension
 Evaluate: pointer to the function used to evaluate nests
 arg: list of additional arguments */
-void runTensorHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runPSF_HS(SearchSpace *s, prtFun Evaluate, ...)
 {
-    va_list arg, argtmp;
-    int t, i, j, l;
-    double fitValue, r, signal, **tmp_t = NULL;
-    Agent *tmp = NULL;
+    va_list arg;
+    Evaluator e;
 
     va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    PSF_HS(s, &e);
+    PROFILE_END_RUN("PSF-HS", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Parameter-setting-free Harmony Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runPSF_HS_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    PSF_HS(s, &e);
+    PROFILE_END_RUN("PSF-HS", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Tensor-based Harmony Search with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorHS(SearchSpace *s, int tensor_id, Evaluator *e)
+{
+    int t, i, j, l, w;
+    double fitValue, r, signal, **aux = NULL, **tmp_t = NULL;
+    Agent *tmp = NULL;
+    FitnessHeap *h = NULL;
 
     if (!s)
     {
@@ -397,18 +507,14 @@ void runTensorHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _HS_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _HS_, tensor_id, e); /* Initial evaluation of the search space */
+    h = CreateFitnessHeap(s);
+    tmp = CreateAgent(s->n, _HS_, _NOTENSOR_);
+    tmp_t = CreateTensor(s->n, tensor_id);
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        va_copy(arg, argtmp);
-
-        qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all harmonies according to their fitness. First position gets the best harmony. */
-
-        tmp = CreateAgent(s->n, _HS_, _NOTENSOR_);
-        tmp_t = GenerateNewTensor(s, tensor_id);
+        w = GetWorstAgent(h); /* The worst harmony is the root of the heap */
 
         for (j = 0; j < s->n; j++)
         {
@@ -442,18 +548,18 @@ void runTensorHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         }
 
         CheckTensorLimits(s, tmp_t, tensor_id);
-        for (j = 0; j < s->n; j++)
-            tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
-
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
-
-        if ((fitValue < s->a[s->m - 1]->fit))
-        { /* We accept the new solution */
-            DestroyTensor(&s->a[s->m - 1]->t, s->n);
-            DestroyAgent(&(s->a[s->m - 1]), _HS_);
-            s->a[s->m - 1] = CopyAgent(tmp, _HS_, _NOTENSOR_);
-            s->a[s->m - 1]->fit = fitValue;
-            s->a[s->m - 1]->t = CopyTensor(tmp_t, s->n, tensor_id);
+        TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
+
+        fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent tmp */
+
+        if ((fitValue < s->a[w]->fit))
+        { /* We accept the new solution, whose tensor takes the place of the worst one's */
+            aux = s->a[w]->t;
+            s->a[w]->t = tmp_t;
+            tmp_t = aux;
+            memcpy(s->a[w]->x, tmp->x, s->n * sizeof(double));
+            s->a[w]->fit = fitValue;
+            UpdateFitnessHeap(s, h, w);
         }
 
         if (fitValue < s->gfit)
@@ -463,30 +569,62 @@ void runTensorHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 s->g[j] = tmp->x[j];
         }
 
-        DestroyAgent(&tmp, _HS_);
-        DestroyTensor(&tmp_t, s->n);
-
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _HS_, e, t, s->gfit);
     }
 
-    va_end(arg);
+    DestroyAgent(&tmp, _HS_);
+    DestroyTensor(&tmp_t, s->n);
+    DestroyFitnessHeap(&h);
 }
 
-/* It executes the Tensor-based Improved Harmony Search for function minimization
+/* It executes the Tensor-based Harmony Search for function minimization
 Parameters:
 s: search space
 tensor_id: identifier of tensor's dimension
 Evaluate: pointer to the function used to evaluate nests
 arg: list of additional arguments */
-void runTensorIHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runTensorHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
 {
-    va_list arg, argtmp;
-    int t, i, j, l;
-    double fitValue, r, signal, **tmp_t = NULL;
-    Agent *tmp = NULL;
+    va_list arg;
+    Evaluator e;
 
     va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorHS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorHS", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Tensor-based Harmony Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorHS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorHS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorHS", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Tensor-based Improved Harmony Search with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorIHS(SearchSpace *s, int tensor_id, Evaluator *e)
+{
+    int t, i, j, l, w;
+    double fitValue, r, signal, **aux = NULL, **tmp_t = NULL;
+    Agent *tmp = NULL;
+    FitnessHeap *h = NULL;
 
     if (!s)
     {
@@ -494,22 +632,18 @@ void runTensorIHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _HS_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _HS_, tensor_id, e); /* Initial evaluation of the search space */
+    h = CreateFitnessHeap(s);
+    tmp = CreateAgent(s->n, _HS_, _NOTENSOR_);
+    tmp_t = CreateTensor(s->n, tensor_id);
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        va_copy(arg, argtmp);
-
-        qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all harmonies according to their fitness. First position gets the best harmony. */
+        w = GetWorstAgent(h); /* The worst harmony is the root of the heap */
 
         s->PAR = s->PAR_min + ((s->PAR_max - s->PAR_min) / s->iterations) * t;
         s->bw = s->bw_max * exp((log(s->bw_min / s->bw_max) / s->iterations) * t);
 
-        tmp = CreateAgent(s->n, _HS_, _NOTENSOR_);
-        tmp_t = GenerateNewTensor(s, tensor_id);
-
         for (j = 0; j < s->n; j++)
         {
             r = GenerateUniformRandomNumber(0, 1);
@@ -542,18 +676,18 @@ void runTensorIHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         }
 
         CheckTensorLimits(s, tmp_t, tensor_id);
-        for (j = 0; j < s->n; j++)
-            tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
-
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
-
-        if ((fitValue < s->a[s->m - 1]->fit))
-        { /* We accept the new solution */
-            DestroyTensor(&s->a[s->m - 1]->t, s->n);
-            DestroyAgent(&(s->a[s->m - 1]), _HS_);
-            s->a[s->m - 1] = CopyAgent(tmp, _HS_, _NOTENSOR_);
-            s->a[s->m - 1]->fit = fitValue;
-            s->a[s->m - 1]->t = CopyTensor(tmp_t, s->n, tensor_id);
+        TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
+
+        fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent tmp */
+
+        if ((fitValue < s->a[w]->fit))
+        { /* We accept the new solution, whose tensor takes the place of the worst one's */
+            aux = s->a[w]->t;
+            s->a[w]->t = tmp_t;
+            tmp_t = aux;
+            memcpy(s->a[w]->x, tmp->x, s->n * sizeof(double));
+            s->a[w]->fit = fitValue;
+            UpdateFitnessHeap(s, h, w);
         }
 
         if (fitValue < s->gfit)
@@ -563,31 +697,63 @@ void runTensorIHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 s->g[j] = tmp->x[j];
         }
 
-        DestroyAgent(&tmp, _HS_);
-        DestroyTensor(&tmp_t, s->n);
-
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _HS_, e, t, s->gfit);
     }
 
-    va_end(arg);
+    DestroyAgent(&tmp, _HS_);
+    DestroyTensor(&tmp_t, s->n);
+    DestroyFitnessHeap(&h);
 }
 
-/* It executes the Parameter-setting-free Tensor-based Harmony Search for function minimization
+/* It executes the Tensor-based Improved Harmony Search for function minimization
 Parameters:
 s: search space
 tensor_id: identifier of tensor's dimension
 Evaluate: pointer to the function used to evaluate nests
 arg: list of additional arguments */
-void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runTensorIHS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
 {
-    va_list arg, argtmp;
-    int i, j, l, t;
-    double fitValue, r, signal, **HMCR, **PAR, **tmp_t = NULL;
-    char **op_type, ***rehearsal;
-    Agent *tmp = NULL;
+    va_list arg;
+    Evaluator e;
 
     va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorIHS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorIHS", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Tensor-based Improved Harmony Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorIHS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorIHS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorIHS", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Parameter-setting-free Tensor-based Improved Harmony Search with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorPSF_HS(SearchSpace *s, int tensor_id, Evaluator *e)
+{
+    int i, j, l, t, w;
+    double fitValue, r, signal, **aux = NULL, **HMCR, **PAR, **tmp_t = NULL;
+    char **op_type, ***rehearsal;
+    Agent *tmp = NULL;
+    FitnessHeap *h = NULL;
 
     if (!s)
     {
@@ -595,7 +761,7 @@ void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _HS_, tensor_id, Evaluate, arg); /* Initial evaluation of the search space */
+    EvaluateTensorSearchSpaceWith(s, _HS_, tensor_id, e); /* Initial evaluation of the search space */
 
     rehearsal = (char ***)calloc(s->m, sizeof(char **));
     for (i = 0; i < s->m; i++)
@@ -616,10 +782,6 @@ void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-
-        va_copy(arg, argtmp);
-
         if (t == 1)
         {
             for (i = 0; i < s->m; i++)
@@ -635,8 +797,7 @@ void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 tmp = CreateAgent(s->n, _HS_, _NOTENSOR_);
                 tmp_t = GenerateNewPSFTensor(s, tensor_id, HMCR, PAR, op_type);
                 CheckTensorLimits(s, tmp_t, tensor_id);
-                for (j = 0; j < s->n; j++)
-                    tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+                TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
                 CheckAgentLimits(s, tmp);
                 for (j = 0; j < s->n; j++)
                     for (l = 0; l < tensor_id; l++)
@@ -648,31 +809,33 @@ void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 DestroyAgent(&tmp, _HS_);
                 DestroyTensor(&tmp_t, s->n);
             }
-            EvaluateTensorSearchSpace(s, _HS_, tensor_id, Evaluate, arg);
+            EvaluateTensorSearchSpaceWith(s, _HS_, tensor_id, e);
+            h = CreateFitnessHeap(s);
+            tmp = CreateAgent(s->n, _HS_, _NOTENSOR_);
+            tmp_t = CreateTensor(s->n, tensor_id);
         }
 
-        qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all harmonies according to their fitness. First position gets the best harmony. */
+        w = GetWorstAgent(h); /* The worst harmony is the root of the heap */
 
-        tmp = CreateAgent(s->n, _HS_, _NOTENSOR_);
-        tmp_t = GenerateNewPSFTensor(s, tensor_id, HMCR, PAR, op_type);
+        DrawNewPSFTensor(s, tmp_t, tensor_id, HMCR, PAR, op_type);
         CheckTensorLimits(s, tmp_t, tensor_id);
-        for (j = 0; j < s->n; j++)
-            tmp->x[j] = TensorSpan(s->LB[j], s->UB[j], tmp_t[j], tensor_id);
+        TensorSpans(s->LB, s->UB, tmp_t[0], s->n, tensor_id, tmp->x);
         CheckAgentLimits(s, tmp);
         UpdateIndividualTensorHMCR_PAR(s, tensor_id, rehearsal, HMCR, PAR);
 
-        fitValue = Evaluate(tmp, arg); /* It executes the fitness function for agent tmp */
+        fitValue = ComputeFitness(e, tmp); /* It executes the fitness function for agent tmp */
 
-        if ((fitValue < s->a[s->m - 1]->fit))
-        { /* We accept the new solution */
-            DestroyTensor(&s->a[s->m - 1]->t, s->n);
-            DestroyAgent(&(s->a[s->m - 1]), _HS_);
-            s->a[s->m - 1] = CopyAgent(tmp, _HS_, _NOTENSOR_);
-            s->a[s->m - 1]->fit = fitValue;
-            s->a[s->m - 1]->t = CopyTensor(tmp_t, s->n, tensor_id);
+        if ((fitValue < s->a[w]->fit))
+        { /* We accept the new solution, whose tensor takes the place of the worst one's */
+            aux = s->a[w]->t;
+            s->a[w]->t = tmp_t;
+            tmp_t = aux;
+            memcpy(s->a[w]->x, tmp->x, s->n * sizeof(double));
+            s->a[w]->fit = fitValue;
+            UpdateFitnessHeap(s, h, w);
             for (j = 0; j < s->n; j++)
                 for (l = 0; l < tensor_id; l++)
-                    rehearsal[s->m - 1][j][l] = op_type[j][l];
+                    rehearsal[w][j][l] = op_type[j][l];
         }
 
         if (fitValue < s->gfit)
@@ -682,10 +845,14 @@ void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
                 s->g[j] = tmp->x[j];
         }
 
+        ReportIteration(s, _HS_, e, t, s->gfit);
+    }
+
+    if (h)
+    {
         DestroyAgent(&tmp, _HS_);
         DestroyTensor(&tmp_t, s->n);
-
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        DestroyFitnessHeap(&h);
     }
 
     for (i = 0; i < s->m; i++)
@@ -706,6 +873,41 @@ void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
     free(HMCR);
     free(PAR);
     free(op_type);
+}
+
+/* It executes the Parameter-setting-free Tensor-based Harmony Search for function minimization
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate nests
+arg: list of additional arguments */
+void runTensorPSF_HS(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
 
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorPSF_HS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorPSF-HS", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Parameter-setting-free Tensor-based Improved Harmony Search for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorPSF_HS_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorPSF_HS(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorPSF-HS", &e);
+    DestroyEvaluator(&e);
+}
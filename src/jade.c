@@ -14,15 +14,15 @@ limitations under the License.
 */
 
 #include "jade.h"
+#include "telemetry.h"
+#include "profile.h"
 
-/* It executes the Adaptive Differential Evolution with Optional External Archive for function minimization
+/* It executes the Adaptive Differential Evolution with Optional External Archive with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate nests
-arg: list of additional arguments */
-void runJADE(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void JADE(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, j;
 	int n_elements_lists = 0, n_elements_archive = 0;
 	double uF = 0.5, uCR = 0.5; /* Mean Mutation Factor and Crossover parameters, respectivelly */
@@ -31,6 +31,7 @@ void runJADE(SearchSpace *s, prtFun Evaluate, ...)
 	double* Sf = NULL; /* scale Factor parameter for each individual */
 	double* Scr = NULL; /* Crossover parameter for each individual */
 	double* mutation = NULL;
+	Agent **sorted = NULL; /* agents sorted by GetBestPAgent */
 	SearchSpace *crossOver = NULL;
 	SearchSpace *A = NULL;
 
@@ -42,10 +43,6 @@ void runJADE(SearchSpace *s, prtFun Evaluate, ...)
 		crossOver->UB[j] = s->UB[j];
 	}
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
-
 	/* ----- paper variables ---------
 	N P = s->m - population size
 	D = s->n - dimension of the problem
@@ -78,40 +75,38 @@ void runJADE(SearchSpace *s, prtFun Evaluate, ...)
 	}
 	InitializeSearchSpace(A, _JADE_);
 
-    EvaluateSearchSpace(s, _JADE_, Evaluate, arg); /* Initial evaluation of the search space */
+	/* At most m agents are replaced at each iteration, so the lists and the mutation vector are allocated once */
+	Sf = (double *)malloc(s->m * sizeof(double));
+	Scr = (double *)malloc(s->m * sizeof(double));
+	mutation = (double *)malloc(s->n * sizeof(double));
+	sorted = (Agent **)malloc(s->m * sizeof(Agent *));
+
+    EvaluateSearchSpaceWith(s, _JADE_, e); /* Initial evaluation of the search space */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-        va_copy(arg, argtmp);
-		if(n_elements_lists > 0)
-		{
-			if (Sf) free(Sf);  
-			if (Scr) free(Scr);  
-		}
 		n_elements_lists = 0;
 
 		for (i = 0; i<s->m; i++)
 		{
 			/* SetCriFi */
-			CRi = GenerateGaussianRandomNumber(uCR, 0.1); 
+			CRi = GenerateGaussianRandomNumber(uCR, 0.01); /* variance 0.01, i.e., standard deviation 0.1 as in JADE */
 			Fi = GenerateCauchyRandomNumber(uF, 0.1);
 
 			/* MUTATION */
-			mutation = MutationJade(i,s, A, Fi, n_elements_archive);
+			MutationJade(i,s, A, Fi, n_elements_archive, mutation, sorted);
 
 			/* CROSSOVER */
 			CrossoverJade(s, crossOver, i, mutation, CRi);
 
 			/* SELECTION */
-			EvaluateAgent(crossOver, crossOver->a[i], _JADE_, Evaluate, arg);
+			EvaluateAgentWith(crossOver, crossOver->a[i], _JADE_, e);
 			if( s->a[i]->fit > crossOver->a[i]->fit )
 			{
 				n_elements_lists= n_elements_lists+1;
 	
 				InsertAgentIntoArchive(A, s, s->a[i], &n_elements_archive);
-				DestroyAgent(&(s->a[i]), _JADE_);
-				s->a[i] = CopyAgent(crossOver->a[i], _JADE_, _NOTENSOR_);
+				CopyAgentInto(s->a[i], crossOver->a[i], _JADE_);
 		        if (s->a[i]->fit < s->gfit) 
 		        { /* It updates the global best value and position */
 		            s->best = i;
@@ -120,26 +115,59 @@ void runJADE(SearchSpace *s, prtFun Evaluate, ...)
 		                s->g[j] = s->a[i]->x[j];
 		        }
 	
-				Sf = AddList(Sf, Fi, n_elements_lists);
-				Scr = AddList(Scr, CRi, n_elements_lists);
+				AddList(Sf, Fi, n_elements_lists);
+				AddList(Scr, CRi, n_elements_lists);
 			}
-
-			if(mutation) free(mutation);
-
 		}
 		uCR = ((1.0 - s->c) * uCR) + (s->c * ArithmeticMeanList(Scr, n_elements_lists));
 		uF = ((1.0 - s->c) * uF) + (s->c * LehmerMeanList(Sf, n_elements_lists));
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _JADE_, e, t, s->gfit);
     }
 
 	DestroySearchSpace(&A, _JADE_);
 	DestroySearchSpace(&crossOver, _JADE_);
-	if (n_elements_lists>0) free(Sf); 
-	if (n_elements_lists>0) free(Scr);
+	free(Sf);
+	free(Scr);
+	free(mutation);
+	free(sorted);
+}
+
+/* It executes the Adaptive Differential Evolution with Optional External Archive for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate nests
+arg: list of additional arguments */
+void runJADE(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    JADE(s, &e);
+    PROFILE_END_RUN("JADE", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
 
+/* It executes the Adaptive Differential Evolution with Optional External Archive for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runJADE_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    JADE(s, &e);
+    PROFILE_END_RUN("JADE", &e);
+    DestroyEvaluator(&e);
+}
+
 /* It executes the crossover operation 
 Parameters:
 s: search space
@@ -182,8 +210,10 @@ i: index of current individual
 s: search space
 A: search space containing archived individuals
 Fi: Mutation scale Factor  for ith individual
-n_elements_archive: number of elements in A */
-double* MutationJade(int i, SearchSpace *s, SearchSpace *A, double Fi, int n_elements_archive) 
+n_elements_archive: number of elements in A
+mutation: output mutate vector with s->n elements
+sorted: array with room for s->m agents used to sort the population (see GetBestPAgent) */
+void MutationJade(int i, SearchSpace *s, SearchSpace *A, double Fi, int n_elements_archive, double *mutation, Agent **sorted) 
 {
     if (!s)
     {
@@ -193,11 +223,8 @@ double* MutationJade(int i, SearchSpace *s, SearchSpace *A, double Fi, int n_ele
 
 	Agent *bestP = NULL, *r1 = NULL, * r2 = NULL; 
     int r1_index, j;
-	double* mutation = NULL;
-
-	mutation = (double *)calloc(s->n, sizeof(double));
 
-	bestP = GetBestPAgent(s); /* Randomly choose bestP as one of the 100 p% best vectors */
+	bestP = GetBestPAgent(s, sorted); /* Randomly choose bestP as one of the 100 p% best vectors */
 	r1 = Getr1Agent(s, i, &r1_index); /* Randomly choose r1 from current population P */
 	r2 = Getr2Agent(s, A, i, r1_index, n_elements_archive); /* Randomly choose r2 from current population P union Archive population A */ 
 
@@ -212,11 +239,9 @@ double* MutationJade(int i, SearchSpace *s, SearchSpace *A, double Fi, int n_ele
 	  	if (mutation[j] > s->UB[j])
 		    mutation[j] = (s->UB[j] + s->a[i]->x[j])/2;
 	}
-	DestroyAgent(&bestP, _JADE_);
-	DestroyAgent(&r1, _JADE_);
-	DestroyAgent(&r2, _JADE_);
-
-    return mutation;
+	ReturnAgent(s, &bestP);
+	ReturnAgent(s, &r1);
+	ReturnAgent(s, &r2);
 }
 
 /* It calculates the Lehmer mean of a given list of doubles 
@@ -259,22 +284,12 @@ double ArithmeticMeanList(double* list, int nElements)
 
 /* Insert a double into a predefined list of doubles 
 Parameters:
-list: list of elements
+list: list of elements, with room for nElements elements
 value: value to be added
-nElements: number of elements in list */
-double* AddList( double *list, double value, int nElements)
+nElements: number of elements in list, including the added one */
+void AddList( double *list, double value, int nElements)
 {
-	double* l = NULL;
-	int i;
-	l = (double *)(double *)calloc(nElements, sizeof(double));   
-	if(nElements > 1)
-	{
-		for(i = 0; i < nElements-1; i++)
-			l[i] = list[i];
-		free(list);
-	}
-	l[nElements - 1] = value;
-	return l;
+	list[nElements - 1] = value;
 }
 
 /* Insert an agent replaced in the current population into an archive list 
@@ -305,8 +320,7 @@ void InsertAgentIntoArchive(SearchSpace *A, SearchSpace *s, Agent *a, int* n_ele
 
 	if(*n_elements_archive < s->m)
 	{
-		DestroyAgent(&A->a[*n_elements_archive], _JADE_);
-		A->a[*n_elements_archive] = CopyAgent(a, _JADE_, _NOTENSOR_);
+		CopyAgentInto(A->a[*n_elements_archive], a, _JADE_);
 		*n_elements_archive = *n_elements_archive + 1;
 	}
 	else
@@ -341,11 +355,11 @@ void SwapArchiveAgent(SearchSpace *A, SearchSpace *s, Agent* a)
 	int index;
 
 	index = (int)round(GenerateUniformRandomNumber(0, A->m - 1));
-    DestroyAgent(&(A->a[index]), _JADE_);
-	A->a[index] = CopyAgent(a, _JADE_, _NOTENSOR_);
+	CopyAgentInto(A->a[index], a, _JADE_);
 }
 
-/* Randomly choose r2 from current population P union Archive population A */
+/* Randomly choose r2 from current population P union Archive population A
+The returned copy is borrowed from the pool of s (see BorrowAgent) */
 Agent * Getr2Agent(SearchSpace *s, SearchSpace *A, int i, int r1_index, int n_elements_archive) 
 {
     if (!s)
@@ -379,14 +393,15 @@ Agent * Getr2Agent(SearchSpace *s, SearchSpace *A, int i, int r1_index, int n_el
 	if(r2 >= s->m)
 	{
 		r2 = r2 - s->m;
-		a = CopyAgent(A->a[r2], _JADE_, _NOTENSOR_);
+		a = BorrowAgentCopy(s, A->a[r2], _JADE_);
 	}
 	else
-		a = CopyAgent(s->a[r2], _JADE_, _NOTENSOR_);
+		a = BorrowAgentCopy(s, s->a[r2], _JADE_);
  	return a;
 }
 
-/* Randomly choose r1 from current population P */
+/* Randomly choose r1 from current population P
+The returned copy is borrowed from the pool of s (see BorrowAgent) */
 Agent * Getr1Agent(SearchSpace *s, int i, int* r1_index) 
 {
     if (!s)
@@ -404,12 +419,16 @@ Agent * Getr1Agent(SearchSpace *s, int i, int* r1_index)
 		while(*r1_index == i)
 			*r1_index = (int)round(GenerateUniformRandomNumber(0, s->m-1));
 	}
-	a = CopyAgent(s->a[*r1_index], _JADE_, _NOTENSOR_);
+	a = BorrowAgentCopy(s, s->a[*r1_index], _JADE_);
     return a;
 }
 
-/* Randomly choose bestP as one of the 100 p% best vectors */
-Agent * GetBestPAgent(SearchSpace *s) 
+/* Randomly choose bestP as one of the 100 p% best vectors
+The returned copy is borrowed from the pool of s (see BorrowAgent)
+Parameters:
+s: search space
+sorted: array with room for s->m agents, where the agents are sorted by their pointers, so the population itself is left untouched */
+Agent * GetBestPAgent(SearchSpace *s, Agent **sorted) 
 {
     if (!s)
     {
@@ -417,22 +436,16 @@ Agent * GetBestPAgent(SearchSpace *s)
         exit(-1);
     }
 	Agent *a = NULL;
-	SearchSpace *newS = CreateSearchSpace(s->m, s->n, _JADE_);
-	int n_best_total, best_n, j, i;
+	int n_best_total, best_n;
 
-	for (j=0;j<s->n;j++)
-	{
-		newS->LB[j] = s->LB[j];
-		newS->UB[j] = s->UB[j];
-	}
-	InitializeSearchSpace(newS, _JADE_);
-	CopySearchSpaceAgents(s, newS, _JADE_, _NOTENSOR_);
-	qsort(newS->a, newS->m, sizeof(Agent **), SortAgent);
+	memcpy(sorted, s->a, s->m * sizeof(Agent *));
+	PROFILE_BEGIN(_PROFILE_SORT_);
+	qsort(sorted, s->m, sizeof(Agent **), SortAgent);
+	PROFILE_END(_PROFILE_SORT_);
 	
 	n_best_total = floor(s->m * s->p_greediness );
     if (n_best_total >= s->m) n_best_total = s->m - 1;
     best_n = (int)round(GenerateUniformRandomNumber(0, n_best_total));
-	a = CopyAgent(newS->a[best_n], _JADE_, _NOTENSOR_);
-	DestroySearchSpace(&newS, _JADE_);
+	a = BorrowAgentCopy(s, sorted[best_n], _JADE_);
     return a;
 }
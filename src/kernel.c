@@ -0,0 +1,2223 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "kernel.h"
+#include "function.h"
+#include "random.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNEL_X86
+#endif
+
+/* Kernels */
+#define _K_ACKLEY_FIRST_ 0
+#define _K_ALPINE_FIRST_ 1
+#define _K_GRIEWANK_ 2
+#define _K_RASTRIGIN_ 3
+#define _K_ROSENBROCK_ 4
+#define _K_SCHUMER_STEIGLITZ_ 5
+#define _K_SPHERE_ 6
+#define _K_SUM_SQUARES_ 7
+#define _K_STYBLINSKI_TANG_ 8
+#define N_KERNELS 9
+
+/* Code paths */
+#define _ISA_SCALAR_ 0
+#define _ISA_AVX2_ 1
+#define _ISA_AVX512_ 2
+#define N_ISAS 3
+
+typedef double (*prtKernel)(const double *x, int n); /* Pointer to the code of a kernel */
+
+/* Constants of the vectorized sine and cosine (range reduction by pi/2 in three parts, and the minimax polynomials of fdlibm) */
+#define INV_PIO2 6.36619772367581382433e-01
+#define PIO2_1 1.57079632673412561417e+00
+#define PIO2_2 6.07710050630396597660e-11
+#define PIO2_3 2.02226624871116645580e-21
+#define S1 -1.66666666666666324348e-01
+#define S2 8.33333333332248946124e-03
+#define S3 -1.98412698298579493134e-04
+#define S4 2.75573137070700676789e-06
+#define S5 -2.50507602534068634195e-08
+#define S6 1.58969099521155010221e-10
+#define C1 4.16666666666666019037e-02
+#define C2 -1.38888888888741095749e-03
+#define C3 2.48015872894767294178e-05
+#define C4 -2.75573143513906633035e-07
+#define C5 2.08757232129817482790e-09
+#define C6 -1.13596475577881948265e-11
+#define TRIG_MAX_ARG 1e6 /* larger arguments are handed over to libm, since the range reduction above loses accuracy */
+
+/* Portable kernels */
+static double Ackley_FirstScalar(const double *x, int n)
+{
+    double sum_1 = 0, sum_2 = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        sum_1 += x[i] * x[i];
+        sum_2 += cos(2 * M_PI * x[i]);
+    }
+
+    return -20 * exp(-0.02 * sqrt(sum_1 / n)) - exp(sum_2 / n) + 20 + exp(1);
+}
+
+static double Alpine_FirstScalar(const double *x, int n)
+{
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+        sum += fabs(x[i] * sin(x[i]) + 0.1 * x[i]);
+
+    return sum;
+}
+
+static double GriewankScalar(const double *x, int n)
+{
+    double partial_sum = 1, sum = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        partial_sum *= cos(x[i] / sqrt(i + 1)) + 1;
+        sum += x[i] * x[i];
+    }
+
+    return sum / 4000 - partial_sum;
+}
+
+static double RastriginScalar(const double *x, int n)
+{
+    double sum = 10 * n;
+    int i;
+
+    for (i = 0; i < n; i++)
+        sum += x[i] * x[i] - 10 * cos(2 * M_PI * x[i]);
+
+    return sum;
+}
+
+static double RosenbrockScalar(const double *x, int n)
+{
+    double sum = 0, d;
+    int i;
+
+    for (i = 0; i < n - 1; i++)
+    {
+        d = x[i + 1] - x[i] * x[i];
+        sum += 100 * d * d + (x[i] - 1) * (x[i] - 1);
+    }
+
+    return sum;
+}
+
+static double Schumer_SteiglitzScalar(const double *x, int n)
+{
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+        sum += (x[i] * x[i]) * (x[i] * x[i]);
+
+    return sum;
+}
+
+static double SphereScalar(const double *x, int n)
+{
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+        sum += x[i] * x[i];
+
+    return sum;
+}
+
+static double Sum_SquaresScalar(const double *x, int n)
+{
+    double sum = 0;
+    int i;
+
+    for (i = 0; i < n; i++)
+        sum += (i + 1) * x[i] * x[i];
+
+    return sum;
+}
+
+static double Styblinski_TangScalar(const double *x, int n)
+{
+    double sum = 0, x2;
+    int i;
+
+    for (i = 0; i < n; i++)
+    {
+        x2 = x[i] * x[i];
+        sum += x2 * x2 - 16 * x2 + 5 * x[i];
+    }
+
+    return 0.5 * sum;
+}
+/**************************/
+
+#ifdef KERNEL_X86
+/* AVX2 kernels (4 lanes, FMA) */
+/* It returns the sum of the 4 lanes of a register */
+__attribute__((target("avx2,fma")))
+static inline double Sum256(__m256d v)
+{
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+/* It computes sin(x) (quadrant = 0) or cos(x) (quadrant = 1) of 4 numbers
+ * x = k*pi/2 + r, with |r| <= pi/4, so sin(x) is +-sin(r) or +-cos(r) according to k + quadrant (mod 4). */
+__attribute__((target("avx2,fma")))
+static inline __m256d SinCos256(__m256d x, int quadrant)
+{
+    __m256d k, r, z, s, c, y, ax;
+    __m256i q;
+    double tmp[4];
+    int i, big;
+
+    k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(INV_PIO2)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(PIO2_1), x);
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(PIO2_2), r);
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(PIO2_3), r);
+    q = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(0x1.8p52))); /* the low bits hold k */
+    q = _mm256_add_epi64(q, _mm256_set1_epi64x(quadrant));
+
+    z = _mm256_mul_pd(r, r);
+    s = _mm256_fmadd_pd(z, _mm256_set1_pd(S6), _mm256_set1_pd(S5));
+    s = _mm256_fmadd_pd(z, s, _mm256_set1_pd(S4));
+    s = _mm256_fmadd_pd(z, s, _mm256_set1_pd(S3));
+    s = _mm256_fmadd_pd(z, s, _mm256_set1_pd(S2));
+    s = _mm256_fmadd_pd(z, s, _mm256_set1_pd(S1));
+    s = _mm256_fmadd_pd(_mm256_mul_pd(z, r), s, r);
+    c = _mm256_fmadd_pd(z, _mm256_set1_pd(C6), _mm256_set1_pd(C5));
+    c = _mm256_fmadd_pd(z, c, _mm256_set1_pd(C4));
+    c = _mm256_fmadd_pd(z, c, _mm256_set1_pd(C3));
+    c = _mm256_fmadd_pd(z, c, _mm256_set1_pd(C2));
+    c = _mm256_fmadd_pd(z, c, _mm256_set1_pd(C1));
+    c = _mm256_fmadd_pd(_mm256_mul_pd(z, z), c, _mm256_fnmadd_pd(_mm256_set1_pd(0.5), z, _mm256_set1_pd(1.0)));
+
+    y = _mm256_blendv_pd(s, c, _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(q, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1))));
+    y = _mm256_castsi256_pd(_mm256_xor_si256(_mm256_castpd_si256(y), _mm256_slli_epi64(_mm256_and_si256(q, _mm256_set1_epi64x(2)), 62)));
+
+    ax = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+    big = _mm256_movemask_pd(_mm256_cmp_pd(ax, _mm256_set1_pd(TRIG_MAX_ARG), _CMP_NLE_UQ));
+    if (big)
+    {
+        _mm256_storeu_pd(tmp, y);
+        for (i = 0; i < 4; i++)
+            if (big & (1 << i))
+                tmp[i] = quadrant ? cos(x[i]) : sin(x[i]);
+        y = _mm256_loadu_pd(tmp);
+    }
+
+    return y;
+}
+
+__attribute__((target("avx2,fma")))
+static double Ackley_FirstAVX2(const double *x, int n)
+{
+    __m256d v, acc_1 = _mm256_setzero_pd(), acc_2 = _mm256_setzero_pd();
+    const __m256d two_pi = _mm256_set1_pd(2 * M_PI);
+    double sum_1, sum_2;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        acc_1 = _mm256_fmadd_pd(v, v, acc_1);
+        acc_2 = _mm256_add_pd(acc_2, SinCos256(_mm256_mul_pd(two_pi, v), 1));
+    }
+    sum_1 = Sum256(acc_1);
+    sum_2 = Sum256(acc_2);
+    for (; i < n; i++)
+    {
+        sum_1 += x[i] * x[i];
+        sum_2 += cos(2 * M_PI * x[i]);
+    }
+
+    return -20 * exp(-0.02 * sqrt(sum_1 / n)) - exp(sum_2 / n) + 20 + exp(1);
+}
+
+__attribute__((target("avx2,fma")))
+static double Alpine_FirstAVX2(const double *x, int n)
+{
+    __m256d v, acc = _mm256_setzero_pd();
+    const __m256d abs_mask = _mm256_set1_pd(-0.0), tenth = _mm256_set1_pd(0.1);
+    double sum;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        acc = _mm256_add_pd(acc, _mm256_andnot_pd(abs_mask, _mm256_fmadd_pd(v, SinCos256(v, 0), _mm256_mul_pd(tenth, v))));
+    }
+    sum = Sum256(acc);
+    for (; i < n; i++)
+        sum += fabs(x[i] * sin(x[i]) + 0.1 * x[i]);
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double GriewankAVX2(const double *x, int n)
+{
+    __m256d v, idx = _mm256_set_pd(4, 3, 2, 1), acc = _mm256_setzero_pd(), prod = _mm256_set1_pd(1.0);
+    const __m256d one = _mm256_set1_pd(1.0), four = _mm256_set1_pd(4.0);
+    double tmp[4], partial_sum, sum;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        acc = _mm256_fmadd_pd(v, v, acc);
+        prod = _mm256_mul_pd(prod, _mm256_add_pd(SinCos256(_mm256_div_pd(v, _mm256_sqrt_pd(idx)), 1), one));
+        idx = _mm256_add_pd(idx, four);
+    }
+    _mm256_storeu_pd(tmp, prod);
+    partial_sum = (tmp[0] * tmp[1]) * (tmp[2] * tmp[3]);
+    sum = Sum256(acc);
+    for (; i < n; i++)
+    {
+        partial_sum *= cos(x[i] / sqrt(i + 1)) + 1;
+        sum += x[i] * x[i];
+    }
+
+    return sum / 4000 - partial_sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double RastriginAVX2(const double *x, int n)
+{
+    __m256d v, acc = _mm256_setzero_pd();
+    const __m256d two_pi = _mm256_set1_pd(2 * M_PI), ten = _mm256_set1_pd(10.0);
+    double sum;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        acc = _mm256_add_pd(acc, _mm256_fnmadd_pd(ten, SinCos256(_mm256_mul_pd(two_pi, v), 1), _mm256_mul_pd(v, v)));
+    }
+    sum = 10 * n + Sum256(acc);
+    for (; i < n; i++)
+        sum += x[i] * x[i] - 10 * cos(2 * M_PI * x[i]);
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double RosenbrockAVX2(const double *x, int n)
+{
+    __m256d v, w, d, e, acc = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0), hundred = _mm256_set1_pd(100.0);
+    double sum;
+    int i;
+
+    for (i = 0; i + 5 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        w = _mm256_loadu_pd(x + i + 1);
+        d = _mm256_fnmadd_pd(v, v, w);
+        e = _mm256_sub_pd(v, one);
+        acc = _mm256_fmadd_pd(_mm256_mul_pd(hundred, d), d, _mm256_fmadd_pd(e, e, acc));
+    }
+    sum = Sum256(acc);
+    for (; i < n - 1; i++)
+        sum += 100 * (x[i + 1] - x[i] * x[i]) * (x[i + 1] - x[i] * x[i]) + (x[i] - 1) * (x[i] - 1);
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double Schumer_SteiglitzAVX2(const double *x, int n)
+{
+    __m256d v, acc = _mm256_setzero_pd();
+    double sum;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        v = _mm256_mul_pd(v, v);
+        acc = _mm256_fmadd_pd(v, v, acc);
+    }
+    sum = Sum256(acc);
+    for (; i < n; i++)
+        sum += (x[i] * x[i]) * (x[i] * x[i]);
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double SphereAVX2(const double *x, int n)
+{
+    __m256d v, acc_1 = _mm256_setzero_pd(), acc_2 = _mm256_setzero_pd();
+    double sum;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8) /* two accumulators hide the latency of the FMA */
+    {
+        v = _mm256_loadu_pd(x + i);
+        acc_1 = _mm256_fmadd_pd(v, v, acc_1);
+        v = _mm256_loadu_pd(x + i + 4);
+        acc_2 = _mm256_fmadd_pd(v, v, acc_2);
+    }
+    sum = Sum256(_mm256_add_pd(acc_1, acc_2));
+    for (; i < n; i++)
+        sum += x[i] * x[i];
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double Sum_SquaresAVX2(const double *x, int n)
+{
+    __m256d v, idx = _mm256_set_pd(4, 3, 2, 1), acc = _mm256_setzero_pd();
+    const __m256d four = _mm256_set1_pd(4.0);
+    double sum;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        acc = _mm256_fmadd_pd(_mm256_mul_pd(idx, v), v, acc);
+        idx = _mm256_add_pd(idx, four);
+    }
+    sum = Sum256(acc);
+    for (; i < n; i++)
+        sum += (i + 1) * x[i] * x[i];
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double Styblinski_TangAVX2(const double *x, int n)
+{
+    __m256d v, v2, acc = _mm256_setzero_pd();
+    const __m256d five = _mm256_set1_pd(5.0), sixteen = _mm256_set1_pd(16.0);
+    double sum, x2;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        v = _mm256_loadu_pd(x + i);
+        v2 = _mm256_mul_pd(v, v);
+        acc = _mm256_add_pd(acc, _mm256_fmadd_pd(v2, _mm256_sub_pd(v2, sixteen), _mm256_mul_pd(five, v)));
+    }
+    sum = Sum256(acc);
+    for (; i < n; i++)
+    {
+        x2 = x[i] * x[i];
+        sum += x2 * x2 - 16 * x2 + 5 * x[i];
+    }
+
+    return 0.5 * sum;
+}
+/**************************/
+
+/* AVX-512 kernels (8 lanes) */
+/* It computes sin(x) (quadrant = 0) or cos(x) (quadrant = 1) of 8 numbers (see SinCos256) */
+__attribute__((target("avx512f")))
+static inline __m512d SinCos512(__m512d x, int quadrant)
+{
+    __m512d k, r, z, s, c, y, ax;
+    __m512i q;
+    __mmask8 big;
+    double tmp[8];
+    int i;
+
+    k = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(INV_PIO2)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    r = _mm512_fnmadd_pd(k, _mm512_set1_pd(PIO2_1), x);
+    r = _mm512_fnmadd_pd(k, _mm512_set1_pd(PIO2_2), r);
+    r = _mm512_fnmadd_pd(k, _mm512_set1_pd(PIO2_3), r);
+    q = _mm512_castpd_si512(_mm512_add_pd(k, _mm512_set1_pd(0x1.8p52))); /* the low bits hold k */
+    q = _mm512_add_epi64(q, _mm512_set1_epi64(quadrant));
+
+    z = _mm512_mul_pd(r, r);
+    s = _mm512_fmadd_pd(z, _mm512_set1_pd(S6), _mm512_set1_pd(S5));
+    s = _mm512_fmadd_pd(z, s, _mm512_set1_pd(S4));
+    s = _mm512_fmadd_pd(z, s, _mm512_set1_pd(S3));
+    s = _mm512_fmadd_pd(z, s, _mm512_set1_pd(S2));
+    s = _mm512_fmadd_pd(z, s, _mm512_set1_pd(S1));
+    s = _mm512_fmadd_pd(_mm512_mul_pd(z, r), s, r);
+    c = _mm512_fmadd_pd(z, _mm512_set1_pd(C6), _mm512_set1_pd(C5));
+    c = _mm512_fmadd_pd(z, c, _mm512_set1_pd(C4));
+    c = _mm512_fmadd_pd(z, c, _mm512_set1_pd(C3));
+    c = _mm512_fmadd_pd(z, c, _mm512_set1_pd(C2));
+    c = _mm512_fmadd_pd(z, c, _mm512_set1_pd(C1));
+    c = _mm512_fmadd_pd(_mm512_mul_pd(z, z), c, _mm512_fnmadd_pd(_mm512_set1_pd(0.5), z, _mm512_set1_pd(1.0)));
+
+    y = _mm512_mask_blend_pd(_mm512_test_epi64_mask(q, _mm512_set1_epi64(1)), s, c);
+    y = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(y), _mm512_slli_epi64(_mm512_and_si512(q, _mm512_set1_epi64(2)), 62)));
+
+    ax = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
+    big = _mm512_cmp_pd_mask(ax, _mm512_set1_pd(TRIG_MAX_ARG), _CMP_NLE_UQ);
+    if (big)
+    {
+        _mm512_storeu_pd(tmp, y);
+        for (i = 0; i < 8; i++)
+            if (big & (1 << i))
+                tmp[i] = quadrant ? cos(x[i]) : sin(x[i]);
+        y = _mm512_loadu_pd(tmp);
+    }
+
+    return y;
+}
+
+__attribute__((target("avx512f")))
+static double Ackley_FirstAVX512(const double *x, int n)
+{
+    __m512d v, acc_1 = _mm512_setzero_pd(), acc_2 = _mm512_setzero_pd();
+    const __m512d two_pi = _mm512_set1_pd(2 * M_PI);
+    double sum_1, sum_2;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        acc_1 = _mm512_fmadd_pd(v, v, acc_1);
+        acc_2 = _mm512_add_pd(acc_2, SinCos512(_mm512_mul_pd(two_pi, v), 1));
+    }
+    sum_1 = _mm512_reduce_add_pd(acc_1);
+    sum_2 = _mm512_reduce_add_pd(acc_2);
+    for (; i < n; i++)
+    {
+        sum_1 += x[i] * x[i];
+        sum_2 += cos(2 * M_PI * x[i]);
+    }
+
+    return -20 * exp(-0.02 * sqrt(sum_1 / n)) - exp(sum_2 / n) + 20 + exp(1);
+}
+
+__attribute__((target("avx512f")))
+static double Alpine_FirstAVX512(const double *x, int n)
+{
+    __m512d v, y, acc = _mm512_setzero_pd();
+    const __m512d tenth = _mm512_set1_pd(0.1);
+    const __m512i abs_mask = _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL);
+    double sum;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        y = _mm512_fmadd_pd(v, SinCos512(v, 0), _mm512_mul_pd(tenth, v));
+        acc = _mm512_add_pd(acc, _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(y), abs_mask)));
+    }
+    sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; i++)
+        sum += fabs(x[i] * sin(x[i]) + 0.1 * x[i]);
+
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static double GriewankAVX512(const double *x, int n)
+{
+    __m512d v, idx = _mm512_set_pd(8, 7, 6, 5, 4, 3, 2, 1), acc = _mm512_setzero_pd(), prod = _mm512_set1_pd(1.0);
+    const __m512d one = _mm512_set1_pd(1.0), eight = _mm512_set1_pd(8.0);
+    double partial_sum, sum;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        acc = _mm512_fmadd_pd(v, v, acc);
+        prod = _mm512_mul_pd(prod, _mm512_add_pd(SinCos512(_mm512_div_pd(v, _mm512_sqrt_pd(idx)), 1), one));
+        idx = _mm512_add_pd(idx, eight);
+    }
+    partial_sum = _mm512_reduce_mul_pd(prod);
+    sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; i++)
+    {
+        partial_sum *= cos(x[i] / sqrt(i + 1)) + 1;
+        sum += x[i] * x[i];
+    }
+
+    return sum / 4000 - partial_sum;
+}
+
+__attribute__((target("avx512f")))
+static double RastriginAVX512(const double *x, int n)
+{
+    __m512d v, acc = _mm512_setzero_pd();
+    const __m512d two_pi = _mm512_set1_pd(2 * M_PI), ten = _mm512_set1_pd(10.0);
+    double sum;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        acc = _mm512_add_pd(acc, _mm512_fnmadd_pd(ten, SinCos512(_mm512_mul_pd(two_pi, v), 1), _mm512_mul_pd(v, v)));
+    }
+    sum = 10 * n + _mm512_reduce_add_pd(acc);
+    for (; i < n; i++)
+        sum += x[i] * x[i] - 10 * cos(2 * M_PI * x[i]);
+
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static double RosenbrockAVX512(const double *x, int n)
+{
+    __m512d v, w, d, e, acc = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0), hundred = _mm512_set1_pd(100.0);
+    double sum;
+    int i;
+
+    for (i = 0; i + 9 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        w = _mm512_loadu_pd(x + i + 1);
+        d = _mm512_fnmadd_pd(v, v, w);
+        e = _mm512_sub_pd(v, one);
+        acc = _mm512_fmadd_pd(_mm512_mul_pd(hundred, d), d, _mm512_fmadd_pd(e, e, acc));
+    }
+    sum = _mm512_reduce_add_pd(acc);
+    for (; i < n - 1; i++)
+        sum += 100 * (x[i + 1] - x[i] * x[i]) * (x[i + 1] - x[i] * x[i]) + (x[i] - 1) * (x[i] - 1);
+
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static double Schumer_SteiglitzAVX512(const double *x, int n)
+{
+    __m512d v, acc = _mm512_setzero_pd();
+    double sum;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        v = _mm512_mul_pd(v, v);
+        acc = _mm512_fmadd_pd(v, v, acc);
+    }
+    sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; i++)
+        sum += (x[i] * x[i]) * (x[i] * x[i]);
+
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static double SphereAVX512(const double *x, int n)
+{
+    __m512d v, acc_1 = _mm512_setzero_pd(), acc_2 = _mm512_setzero_pd();
+    double sum;
+    int i;
+
+    for (i = 0; i + 16 <= n; i += 16) /* two accumulators hide the latency of the FMA */
+    {
+        v = _mm512_loadu_pd(x + i);
+        acc_1 = _mm512_fmadd_pd(v, v, acc_1);
+        v = _mm512_loadu_pd(x + i + 8);
+        acc_2 = _mm512_fmadd_pd(v, v, acc_2);
+    }
+    sum = _mm512_reduce_add_pd(_mm512_add_pd(acc_1, acc_2));
+    for (; i < n; i++)
+        sum += x[i] * x[i];
+
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static double Sum_SquaresAVX512(const double *x, int n)
+{
+    __m512d v, idx = _mm512_set_pd(8, 7, 6, 5, 4, 3, 2, 1), acc = _mm512_setzero_pd();
+    const __m512d eight = _mm512_set1_pd(8.0);
+    double sum;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        acc = _mm512_fmadd_pd(_mm512_mul_pd(idx, v), v, acc);
+        idx = _mm512_add_pd(idx, eight);
+    }
+    sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; i++)
+        sum += (i + 1) * x[i] * x[i];
+
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static double Styblinski_TangAVX512(const double *x, int n)
+{
+    __m512d v, v2, acc = _mm512_setzero_pd();
+    const __m512d five = _mm512_set1_pd(5.0), sixteen = _mm512_set1_pd(16.0);
+    double sum, x2;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        v = _mm512_loadu_pd(x + i);
+        v2 = _mm512_mul_pd(v, v);
+        acc = _mm512_add_pd(acc, _mm512_fmadd_pd(v2, _mm512_sub_pd(v2, sixteen), _mm512_mul_pd(five, v)));
+    }
+    sum = _mm512_reduce_add_pd(acc);
+    for (; i < n; i++)
+    {
+        x2 = x[i] * x[i];
+        sum += x2 * x2 - 16 * x2 + 5 * x[i];
+    }
+
+    return 0.5 * sum;
+}
+/**************************/
+#endif
+
+/* Dispatch-related functions */
+/* Code of each kernel (rows) in each code path (columns) */
+static const prtKernel KernelTable[N_KERNELS][N_ISAS] = {
+#ifdef KERNEL_X86
+    {Ackley_FirstScalar, Ackley_FirstAVX2, Ackley_FirstAVX512},
+    {Alpine_FirstScalar, Alpine_FirstAVX2, Alpine_FirstAVX512},
+    {GriewankScalar, GriewankAVX2, GriewankAVX512},
+    {RastriginScalar, RastriginAVX2, RastriginAVX512},
+    {RosenbrockScalar, RosenbrockAVX2, RosenbrockAVX512},
+    {Schumer_SteiglitzScalar, Schumer_SteiglitzAVX2, Schumer_SteiglitzAVX512},
+    {SphereScalar, SphereAVX2, SphereAVX512},
+    {Sum_SquaresScalar, Sum_SquaresAVX2, Sum_SquaresAVX512},
+    {Styblinski_TangScalar, Styblinski_TangAVX2, Styblinski_TangAVX512}
+#else
+    {Ackley_FirstScalar, NULL, NULL},
+    {Alpine_FirstScalar, NULL, NULL},
+    {GriewankScalar, NULL, NULL},
+    {RastriginScalar, NULL, NULL},
+    {RosenbrockScalar, NULL, NULL},
+    {Schumer_SteiglitzScalar, NULL, NULL},
+    {SphereScalar, NULL, NULL},
+    {Sum_SquaresScalar, NULL, NULL},
+    {Styblinski_TangScalar, NULL, NULL}
+#endif
+};
+
+static const char *ISAName[N_ISAS] = {"scalar", "avx2", "avx512"};
+
+/* It returns 1 if the running CPU supports a code path, and 0 otherwise
+Parameters:
+isa: code path */
+static int SupportsISA(int isa)
+{
+    if (isa == _ISA_SCALAR_)
+        return 1;
+#ifdef KERNEL_X86
+    __builtin_cpu_init();
+    if (isa == _ISA_AVX2_)
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (isa == _ISA_AVX512_)
+        return __builtin_cpu_supports("avx512f");
+#endif
+    return 0;
+}
+
+/* It returns the code path used by the kernels, which is chosen at the first call
+ * The widest supported path is chosen, unless the environment variable OPT_KERNEL_ISA asks for a supported one. */
+static int KernelISA()
+{
+    static int isa = -1;
+    char *env;
+    int i;
+
+    if (isa >= 0)
+        return isa;
+
+    env = getenv("OPT_KERNEL_ISA");
+    for (i = N_ISAS - 1; i >= 0; i--)
+        if ((SupportsISA(i)) && ((!env) || (!strcmp(env, ISAName[i])) || (i == _ISA_SCALAR_)))
+            break;
+    if ((env) && (strcmp(env, ISAName[i])))
+        fprintf(stderr, "\nCode path %s not available @KernelISA. Running with %s.\n", env, ISAName[i]);
+
+    __atomic_store_n(&isa, i, __ATOMIC_RELAXED);
+    return i;
+}
+
+/* It computes a kernel for each of m points
+Parameters:
+id: identifier of the kernel
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values */
+static void RunKernelBatch(int id, const double *X, int m, int n, double *fit)
+{
+    prtKernel f = KernelTable[id][KernelISA()];
+    int i;
+
+    for (i = 0; i < m; i++)
+        fit[i] = f(X + (size_t) i * n, n);
+}
+/**************************/
+
+/* Single-point benchmark functions */
+/* It computes the 1st Ackley's function (see Ackley_First)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Ackley_First_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Ackley_First_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_ACKLEY_FIRST_][KernelISA()](x, n);
+}
+
+/* It computes the 1st Alpine's function (see Alpine_First)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Alpine_First_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Alpine_First_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_ALPINE_FIRST_][KernelISA()](x, n);
+}
+
+/* It computes the Griewank's function (see Griewank)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Griewank_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Griewank_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_GRIEWANK_][KernelISA()](x, n);
+}
+
+/* It computes the Rastrigin's function (see Rastrigin)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Rastrigin_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Rastrigin_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_RASTRIGIN_][KernelISA()](x, n);
+}
+
+/* It computes the Rosenbrock's function (see Rosenbrock)
+Parameters:
+x: n-dimensional point
+n: number of decision variables (at least two)
+ctx: unused */
+double Rosenbrock_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 2))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Rosenbrock_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_ROSENBROCK_][KernelISA()](x, n);
+}
+
+/* It computes the Schumer Steiglitz's function (see Schumer_Steiglitz)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Schumer_Steiglitz_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Schumer_Steiglitz_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_SCHUMER_STEIGLITZ_][KernelISA()](x, n);
+}
+
+/* It computes the Sphere's function (see Sphere)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Sphere_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Sphere_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_SPHERE_][KernelISA()](x, n);
+}
+
+/* It computes the Sum Squares function (see Sum_Squares)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Sum_Squares_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Sum_Squares_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_SUM_SQUARES_][KernelISA()](x, n);
+}
+
+/* It computes the Styblinski's-Tang function (see Styblinski_Tang)
+Parameters:
+x: n-dimensional point
+n: number of decision variables
+ctx: unused */
+double Styblinski_Tang_r(const double *x, int n, void *ctx)
+{
+    if ((!x) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Styblinski_Tang_r.\n");
+        return DBL_MAX;
+    }
+
+    return KernelTable[_K_STYBLINSKI_TANG_][KernelISA()](x, n);
+}
+/**************************/
+
+/* Population benchmark functions */
+/* It computes the 1st Ackley's function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Ackley_First_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Ackley_First_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_ACKLEY_FIRST_, X, m, n, fit);
+}
+
+/* It computes the 1st Alpine's function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Alpine_First_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Alpine_First_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_ALPINE_FIRST_, X, m, n, fit);
+}
+
+/* It computes the Griewank's function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Griewank_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Griewank_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_GRIEWANK_, X, m, n, fit);
+}
+
+/* It computes the Rastrigin's function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Rastrigin_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Rastrigin_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_RASTRIGIN_, X, m, n, fit);
+}
+
+/* It computes the Rosenbrock's function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables (at least two)
+fit: output array with m fitness values
+ctx: unused */
+void Rosenbrock_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 2))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Rosenbrock_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_ROSENBROCK_, X, m, n, fit);
+}
+
+/* It computes the Schumer Steiglitz's function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Schumer_Steiglitz_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Schumer_Steiglitz_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_SCHUMER_STEIGLITZ_, X, m, n, fit);
+}
+
+/* It computes the Sphere's function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Sphere_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Sphere_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_SPHERE_, X, m, n, fit);
+}
+
+/* It computes the Sum Squares function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Sum_Squares_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Sum_Squares_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_SUM_SQUARES_, X, m, n, fit);
+}
+
+/* It computes the Styblinski's-Tang function of m points
+Parameters:
+X: m x n matrix (row-major), one point per row
+m: number of points
+n: number of decision variables
+fit: output array with m fitness values
+ctx: unused */
+void Styblinski_Tang_Batch(const double *X, int m, int n, double *fit, void *ctx)
+{
+    if ((!X) || (!fit) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @Styblinski_Tang_Batch.\n");
+        exit(-1);
+    }
+
+    RunKernelBatch(_K_STYBLINSKI_TANG_, X, m, n, fit);
+}
+/**************************/
+
+/* GP primitives */
+typedef void (*prtGPKernel)(int func_id, const double *x, const double *y, double *out, int n); /* Pointer to the code of the GP functions in a given code path */
+
+/* It applies a GP function elementwise (portable code)
+ * EXP and LOG are computed by libm in every code path, so that all paths give the same results.
+Parameters:
+func_id: identifier of the function (see getFUNCTIONid)
+x, y: input arrays (y is not used by unary functions)
+out: output array (it may be x or y)
+n: number of elements */
+static void GPFunctionScalar(int func_id, const double *x, const double *y, double *out, int n)
+{
+    int i;
+
+    switch (func_id)
+    {
+        case _SUM_:
+        case _TSUM_:
+            for (i = 0; i < n; i++)
+                out[i] = x[i] + y[i];
+            break;
+        case _SUB_:
+        case _TSUB_:
+            for (i = 0; i < n; i++)
+                out[i] = x[i] - y[i];
+            break;
+        case _MUL_:
+        case _TMUL_:
+            for (i = 0; i < n; i++)
+                out[i] = x[i] * y[i];
+            break;
+        case _DIV_:
+            for (i = 0; i < n; i++)
+                out[i] = x[i] / (y[i] + 0.00001); /* It avoids division by 0 */
+            break;
+        case _TDIV_:
+            for (i = 0; i < n; i++)
+                out[i] = y[i] ? x[i] / y[i] : 0.0;
+            break;
+        case _EXP_:
+            for (i = 0; i < n; i++)
+                out[i] = exp(x[i]);
+            break;
+        case _SQRT_:
+            for (i = 0; i < n; i++)
+                out[i] = sqrt(fabs(x[i]));
+            break;
+        case _LOG_:
+            for (i = 0; i < n; i++)
+                out[i] = log(x[i] + 0.00001);
+            break;
+        case _ABS_:
+            for (i = 0; i < n; i++)
+                out[i] = fabs(x[i]);
+            break;
+        case _AND_:
+            for (i = 0; i < n; i++)
+                out[i] = (double)((int)x[i] & (int)y[i]);
+            break;
+        case _OR_:
+            for (i = 0; i < n; i++)
+                out[i] = (double)((int)x[i] | (int)y[i]);
+            break;
+        case _XOR_:
+            for (i = 0; i < n; i++)
+                out[i] = (double)((int)x[i] ^ (int)y[i]);
+            break;
+        case _NOT_:
+            for (i = 0; i < n; i++)
+                out[i] = (double)~(int)x[i];
+            break;
+    }
+}
+
+#ifdef KERNEL_X86
+/* It applies a GP function elementwise (4 lanes)
+ * The elements left over, as well as EXP and LOG, are handed over to the portable code. Each lane performs the same
+ * correctly rounded operations of the portable code, and the conversions to int truncate as the C casts do, so the results are identical.
+Parameters: see GPFunctionScalar */
+__attribute__((target("avx2")))
+static void GPFunctionAVX2(int func_id, const double *x, const double *y, double *out, int n)
+{
+    const __m256d eps = _mm256_set1_pd(0.00001), zero = _mm256_setzero_pd(), sign = _mm256_set1_pd(-0.0);
+    const __m128i ones = _mm_set1_epi32(-1);
+    __m256d a, b;
+    int i = 0;
+
+    switch (func_id)
+    {
+        case _SUM_:
+        case _TSUM_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+            break;
+        case _SUB_:
+        case _TSUB_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+            break;
+        case _MUL_:
+        case _TMUL_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+            break;
+        case _DIV_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(x + i), _mm256_add_pd(_mm256_loadu_pd(y + i), eps)));
+            break;
+        case _TDIV_:
+            for (; i + 4 <= n; i += 4)
+            {
+                b = _mm256_loadu_pd(y + i);
+                a = _mm256_div_pd(_mm256_loadu_pd(x + i), b);
+                _mm256_storeu_pd(out + i, _mm256_and_pd(a, _mm256_cmp_pd(b, zero, _CMP_NEQ_UQ)));
+            }
+            break;
+        case _SQRT_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_sqrt_pd(_mm256_andnot_pd(sign, _mm256_loadu_pd(x + i))));
+            break;
+        case _ABS_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_andnot_pd(sign, _mm256_loadu_pd(x + i)));
+            break;
+        case _AND_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_cvtepi32_pd(_mm_and_si128(_mm256_cvttpd_epi32(_mm256_loadu_pd(x + i)), _mm256_cvttpd_epi32(_mm256_loadu_pd(y + i)))));
+            break;
+        case _OR_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_cvtepi32_pd(_mm_or_si128(_mm256_cvttpd_epi32(_mm256_loadu_pd(x + i)), _mm256_cvttpd_epi32(_mm256_loadu_pd(y + i)))));
+            break;
+        case _XOR_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_cvtepi32_pd(_mm_xor_si128(_mm256_cvttpd_epi32(_mm256_loadu_pd(x + i)), _mm256_cvttpd_epi32(_mm256_loadu_pd(y + i)))));
+            break;
+        case _NOT_:
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_cvtepi32_pd(_mm_xor_si128(_mm256_cvttpd_epi32(_mm256_loadu_pd(x + i)), ones)));
+            break;
+    }
+
+    if (i < n)
+        GPFunctionScalar(func_id, x + i, y ? y + i : NULL, out + i, n - i);
+}
+
+/* It applies a GP function elementwise (8 lanes, see GPFunctionAVX2)
+Parameters: see GPFunctionScalar */
+__attribute__((target("avx512f")))
+static void GPFunctionAVX512(int func_id, const double *x, const double *y, double *out, int n)
+{
+    const __m512d eps = _mm512_set1_pd(0.00001), zero = _mm512_setzero_pd();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    __m512d a, b;
+    int i = 0;
+
+    switch (func_id)
+    {
+        case _SUM_:
+        case _TSUM_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+            break;
+        case _SUB_:
+        case _TSUB_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+            break;
+        case _MUL_:
+        case _TMUL_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+            break;
+        case _DIV_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_div_pd(_mm512_loadu_pd(x + i), _mm512_add_pd(_mm512_loadu_pd(y + i), eps)));
+            break;
+        case _TDIV_:
+            for (; i + 8 <= n; i += 8)
+            {
+                b = _mm512_loadu_pd(y + i);
+                a = _mm512_div_pd(_mm512_loadu_pd(x + i), b);
+                _mm512_storeu_pd(out + i, _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(b, zero, _CMP_NEQ_UQ), a));
+            }
+            break;
+        case _SQRT_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_sqrt_pd(_mm512_abs_pd(_mm512_loadu_pd(x + i))));
+            break;
+        case _ABS_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_abs_pd(_mm512_loadu_pd(x + i)));
+            break;
+        case _AND_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_cvtepi32_pd(_mm256_and_si256(_mm512_cvttpd_epi32(_mm512_loadu_pd(x + i)), _mm512_cvttpd_epi32(_mm512_loadu_pd(y + i)))));
+            break;
+        case _OR_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_cvtepi32_pd(_mm256_or_si256(_mm512_cvttpd_epi32(_mm512_loadu_pd(x + i)), _mm512_cvttpd_epi32(_mm512_loadu_pd(y + i)))));
+            break;
+        case _XOR_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_cvtepi32_pd(_mm256_xor_si256(_mm512_cvttpd_epi32(_mm512_loadu_pd(x + i)), _mm512_cvttpd_epi32(_mm512_loadu_pd(y + i)))));
+            break;
+        case _NOT_:
+            for (; i + 8 <= n; i += 8)
+                _mm512_storeu_pd(out + i, _mm512_cvtepi32_pd(_mm256_xor_si256(_mm512_cvttpd_epi32(_mm512_loadu_pd(x + i)), ones)));
+            break;
+    }
+
+    if (i < n)
+        GPFunctionScalar(func_id, x + i, y ? y + i : NULL, out + i, n - i);
+}
+#endif
+
+/* Code of the GP functions in each code path */
+static const prtGPKernel GPKernelTable[N_ISAS] = {
+#ifdef KERNEL_X86
+    GPFunctionScalar, GPFunctionAVX2, GPFunctionAVX512
+#else
+    GPFunctionScalar, NULL, NULL
+#endif
+};
+
+/* It returns 1 if the GP function takes a single argument, and 0 otherwise
+Parameters:
+func_id: identifier of the function */
+static int IsUnaryGPFunction(int func_id)
+{
+    return ((func_id >= _EXP_) && (func_id <= _ABS_)) || (func_id == _NOT_);
+}
+
+/* It applies a GP function elementwise to n-dimensional arrays (see getFUNCTIONid)
+ * Tensor-based functions (TSUM, ..., TDIV) take the tensors stored row by row, i.e., n is the number of elements of the tensor.
+ * No memory is allocated, and out may be one of the inputs, so that a function can be computed in place.
+Parameters:
+func_id: identifier of the function
+x, y: input arrays (y is not used by unary functions, and it may be NULL)
+out: output array
+n: number of elements */
+void RunGPFunction(int func_id, const double *x, const double *y, double *out, int n)
+{
+    if ((!x) || (!out) || (func_id < _SUM_) || (func_id > _TDIV_) || ((!y) && (!IsUnaryGPFunction(func_id))))
+    {
+        fprintf(stderr, "\nInvalid input parameters @RunGPFunction.\n");
+        exit(-1);
+    }
+
+    GPKernelTable[KernelISA()](func_id, x, y, out, n);
+}
+
+/* It computes the pointwise sum of two n-dimensional arrays (see f_SUM_)
+Parameters:
+x, y: arrays
+out: output array (it may be x or y)
+n: dimension */
+void f_SUM_Into(const double *x, const double *y, double *out, int n)
+{
+    RunGPFunction(_SUM_, x, y, out, n);
+}
+
+/* It computes the pointwise subtraction of two n-dimensional arrays (see f_SUB_)
+Parameters:
+x, y: arrays
+out: output array (it may be x or y)
+n: dimension */
+void f_SUB_Into(const double *x, const double *y, double *out, int n)
+{
+    RunGPFunction(_SUB_, x, y, out, n);
+}
+
+/* It computes the pointwise multiplication of two n-dimensional arrays (see f_MUL_)
+Parameters:
+x, y: arrays
+out: output array (it may be x or y)
+n: dimension */
+void f_MUL_Into(const double *x, const double *y, double *out, int n)
+{
+    RunGPFunction(_MUL_, x, y, out, n);
+}
+
+/* It computes the pointwise (protected) division of two n-dimensional arrays (see f_DIV_)
+Parameters:
+x, y: arrays
+out: output array (it may be x or y)
+n: dimension */
+void f_DIV_Into(const double *x, const double *y, double *out, int n)
+{
+    RunGPFunction(_DIV_, x, y, out, n);
+}
+
+/* It computes the absolute value of each element from an n-dimensional array (see f_ABS_)
+Parameters:
+x: array
+out: output array (it may be x)
+n: dimension */
+void f_ABS_Into(const double *x, double *out, int n)
+{
+    RunGPFunction(_ABS_, x, NULL, out, n);
+}
+
+/* It computes the squared root of the absolute value of each element from an n-dimensional array (see f_SQRT_)
+Parameters:
+x: array
+out: output array (it may be x)
+n: dimension */
+void f_SQRT_Into(const double *x, double *out, int n)
+{
+    RunGPFunction(_SQRT_, x, NULL, out, n);
+}
+
+/* It computes the exponential (e) of each element from an n-dimensional array (see f_EXP_)
+Parameters:
+x: array
+out: output array (it may be x)
+n: dimension */
+void f_EXP_Into(const double *x, double *out, int n)
+{
+    RunGPFunction(_EXP_, x, NULL, out, n);
+}
+
+/* It computes the (protected) natural logarithm of each element from an n-dimensional array (see f_LOG_)
+Parameters:
+x: array
+out: output array (it may be x)
+n: dimension */
+void f_LOG_Into(const double *x, double *out, int n)
+{
+    RunGPFunction(_LOG_, x, NULL, out, n);
+}
+
+/* It computes the logical function AND among two n-dimensional arrays (see f_AND_)
+Parameters:
+x, y: arrays
+out: output array (it may be x or y)
+n: dimension */
+void f_AND_Into(const double *x, const double *y, double *out, int n)
+{
+    RunGPFunction(_AND_, x, y, out, n);
+}
+
+/* It computes the logical function OR among two n-dimensional arrays (see f_OR_)
+Parameters:
+x, y: arrays
+out: output array (it may be x or y)
+n: dimension */
+void f_OR_Into(const double *x, const double *y, double *out, int n)
+{
+    RunGPFunction(_OR_, x, y, out, n);
+}
+
+/* It computes the logical function XOR among two n-dimensional arrays (see f_XOR_)
+Parameters:
+x, y: arrays
+out: output array (it may be x or y)
+n: dimension */
+void f_XOR_Into(const double *x, const double *y, double *out, int n)
+{
+    RunGPFunction(_XOR_, x, y, out, n);
+}
+
+/* It computes the logical function NOT of an n-dimensional array (see f_NOT_)
+Parameters:
+x: array
+out: output array (it may be x)
+n: dimension */
+void f_NOT_Into(const double *x, double *out, int n)
+{
+    RunGPFunction(_NOT_, x, NULL, out, n);
+}
+
+/* It computes the tensor sum of two mxn-dimensional tensors stored row by row (see f_TSUM_)
+Parameters:
+x, y: tensors
+out: output tensor (it may be x or y)
+m, n: dimensions */
+void f_TSUM_Into(const double *x, const double *y, double *out, int m, int n)
+{
+    RunGPFunction(_TSUM_, x, y, out, m * n);
+}
+
+/* It computes the tensor subtraction of two mxn-dimensional tensors stored row by row (see f_TSUB_)
+Parameters:
+x, y: tensors
+out: output tensor (it may be x or y)
+m, n: dimensions */
+void f_TSUB_Into(const double *x, const double *y, double *out, int m, int n)
+{
+    RunGPFunction(_TSUB_, x, y, out, m * n);
+}
+
+/* It computes the tensor multiplication of two mxn-dimensional tensors stored row by row (see f_TMUL_)
+Parameters:
+x, y: tensors
+out: output tensor (it may be x or y)
+m, n: dimensions */
+void f_TMUL_Into(const double *x, const double *y, double *out, int m, int n)
+{
+    RunGPFunction(_TMUL_, x, y, out, m * n);
+}
+
+/* It computes the tensor (protected) division of two mxn-dimensional tensors stored row by row (see f_TDIV_)
+Parameters:
+x, y: tensors
+out: output tensor (it may be x or y)
+m, n: dimensions */
+void f_TDIV_Into(const double *x, const double *y, double *out, int m, int n)
+{
+    RunGPFunction(_TDIV_, x, y, out, m * n);
+}
+/**************************/
+
+/* Distance kernels */
+#define DIST_BLOCK_ROWS 64 /* number of rows of each operand kept in cache by SquaredDistanceMatrix */
+#define DIST_BLOCK_DIMS 256 /* number of decision variables of each row kept in cache by SquaredDistanceMatrix */
+#define N_DIST_POINTS 11 /* number of points used by CheckKernels to test the distance kernels (not a multiple of the lanes) */
+
+typedef void (*prtDotKernel)(const double *x, double **Y, int k, int off, int len, double *dot); /* Pointer to the code of the dot products in a given code path */
+typedef void (*prtDistanceKernel)(const double *x, double **Y, int k, int n, double *d); /* Pointer to the code of the distances to a point in a given code path */
+typedef double (*prtSquaredDistanceKernel)(const double *x, const double *y, int n); /* Pointer to the code of the squared distance between two arrays in a given code path */
+
+/* It accumulates the dot products between a chunk of an array and the same chunk of k others (portable code)
+Parameters:
+x: n-dimensional array
+Y: k n-dimensional arrays
+k: number of arrays in Y
+off, len: the chunk covers the elements off, ..., off + len - 1
+dot: output array, dot[j] is increased by the dot product between the chunks of x and Y[j] */
+static void DotScalar(const double *x, double **Y, int k, int off, int len, double *dot)
+{
+    double sum;
+    int j, p;
+
+    for (j = 0; j < k; j++)
+    {
+        sum = 0;
+        for (p = off; p < off + len; p++)
+            sum += x[p] * Y[j][p];
+        dot[j] += sum;
+    }
+}
+
+/* It computes the Euclidean distances between an array and k others (portable code)
+ * The squares are accumulated in the same order of EuclideanDistance, so the results are the same.
+Parameters:
+x: n-dimensional array
+Y: k n-dimensional arrays
+k: number of arrays in Y
+n: number of decision variables
+d: output array with k distances */
+static void DistancesScalar(const double *x, double **Y, int k, int n, double *d)
+{
+    double sum, diff;
+    int j, p;
+
+    for (j = 0; j < k; j++)
+    {
+        sum = 0;
+        for (p = 0; p < n; p++)
+        {
+            diff = x[p] - Y[j][p];
+            sum += diff * diff;
+        }
+        d[j] = sqrt(sum);
+    }
+}
+
+/* It computes the squared Euclidean distance between two arrays (portable code)
+Parameters:
+x, y: n-dimensional arrays
+n: number of decision variables */
+static double SquaredDistanceScalar(const double *x, const double *y, int n)
+{
+    double sum = 0, diff;
+    int p;
+
+    for (p = 0; p < n; p++)
+    {
+        diff = x[p] - y[p];
+        sum += diff * diff;
+    }
+
+    return sum;
+}
+
+#ifdef KERNEL_X86
+/* It accumulates the dot products between a chunk of an array and the same chunk of k others (4 lanes, 4 arrays at a time)
+Parameters: see DotScalar */
+__attribute__((target("avx2,fma")))
+static void DotAVX2(const double *x, double **Y, int k, int off, int len, double *dot)
+{
+    __m256d a0, a1, a2, a3, xv;
+    const double *y0, *y1, *y2, *y3;
+    int j = 0, p, end = off + len;
+
+    for (; j + 4 <= k; j += 4)
+    {
+        y0 = Y[j];
+        y1 = Y[j + 1];
+        y2 = Y[j + 2];
+        y3 = Y[j + 3];
+        a0 = a1 = a2 = a3 = _mm256_setzero_pd();
+        for (p = off; p + 4 <= end; p += 4)
+        {
+            xv = _mm256_loadu_pd(x + p);
+            a0 = _mm256_fmadd_pd(xv, _mm256_loadu_pd(y0 + p), a0);
+            a1 = _mm256_fmadd_pd(xv, _mm256_loadu_pd(y1 + p), a1);
+            a2 = _mm256_fmadd_pd(xv, _mm256_loadu_pd(y2 + p), a2);
+            a3 = _mm256_fmadd_pd(xv, _mm256_loadu_pd(y3 + p), a3);
+        }
+        dot[j] += Sum256(a0);
+        dot[j + 1] += Sum256(a1);
+        dot[j + 2] += Sum256(a2);
+        dot[j + 3] += Sum256(a3);
+        for (; p < end; p++)
+        {
+            dot[j] += x[p] * y0[p];
+            dot[j + 1] += x[p] * y1[p];
+            dot[j + 2] += x[p] * y2[p];
+            dot[j + 3] += x[p] * y3[p];
+        }
+    }
+
+    if (j < k)
+        DotScalar(x, Y + j, k - j, off, len, dot + j);
+}
+
+/* It computes the Euclidean distances between an array and k others (4 lanes, one array per lane)
+ * Each lane accumulates the squares of its array in the same order of EuclideanDistance, and no fused operations are used,
+ * so the results are the same of the portable code.
+Parameters: see DistancesScalar */
+__attribute__((target("avx2")))
+static void DistancesAVX2(const double *x, double **Y, int k, int n, double *d)
+{
+    __m256d sum, diff;
+    const double *y0, *y1, *y2, *y3;
+    int j = 0, p;
+
+    for (; j + 4 <= k; j += 4)
+    {
+        y0 = Y[j];
+        y1 = Y[j + 1];
+        y2 = Y[j + 2];
+        y3 = Y[j + 3];
+        sum = _mm256_setzero_pd();
+        for (p = 0; p < n; p++)
+        {
+            diff = _mm256_sub_pd(_mm256_set1_pd(x[p]), _mm256_set_pd(y3[p], y2[p], y1[p], y0[p]));
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(diff, diff));
+        }
+        _mm256_storeu_pd(d + j, _mm256_sqrt_pd(sum));
+    }
+
+    if (j < k)
+        DistancesScalar(x, Y + j, k - j, n, d + j);
+}
+
+/* It computes the squared Euclidean distance between two arrays (4 lanes, FMA)
+Parameters: see SquaredDistanceScalar */
+__attribute__((target("avx2,fma")))
+static double SquaredDistanceAVX2(const double *x, const double *y, int n)
+{
+    __m256d diff, acc_1 = _mm256_setzero_pd(), acc_2 = _mm256_setzero_pd();
+    double sum, d;
+    int p;
+
+    for (p = 0; p + 8 <= n; p += 8) /* two accumulators hide the latency of the FMA */
+    {
+        diff = _mm256_sub_pd(_mm256_loadu_pd(x + p), _mm256_loadu_pd(y + p));
+        acc_1 = _mm256_fmadd_pd(diff, diff, acc_1);
+        diff = _mm256_sub_pd(_mm256_loadu_pd(x + p + 4), _mm256_loadu_pd(y + p + 4));
+        acc_2 = _mm256_fmadd_pd(diff, diff, acc_2);
+    }
+    sum = Sum256(_mm256_add_pd(acc_1, acc_2));
+    for (; p < n; p++)
+    {
+        d = x[p] - y[p];
+        sum += d * d;
+    }
+
+    return sum;
+}
+
+/* It accumulates the dot products between a chunk of an array and the same chunk of k others (8 lanes, 4 arrays at a time)
+Parameters: see DotScalar */
+__attribute__((target("avx512f")))
+static void DotAVX512(const double *x, double **Y, int k, int off, int len, double *dot)
+{
+    __m512d a0, a1, a2, a3, xv;
+    const double *y0, *y1, *y2, *y3;
+    int j = 0, p, end = off + len;
+
+    for (; j + 4 <= k; j += 4)
+    {
+        y0 = Y[j];
+        y1 = Y[j + 1];
+        y2 = Y[j + 2];
+        y3 = Y[j + 3];
+        a0 = a1 = a2 = a3 = _mm512_setzero_pd();
+        for (p = off; p + 8 <= end; p += 8)
+        {
+            xv = _mm512_loadu_pd(x + p);
+            a0 = _mm512_fmadd_pd(xv, _mm512_loadu_pd(y0 + p), a0);
+            a1 = _mm512_fmadd_pd(xv, _mm512_loadu_pd(y1 + p), a1);
+            a2 = _mm512_fmadd_pd(xv, _mm512_loadu_pd(y2 + p), a2);
+            a3 = _mm512_fmadd_pd(xv, _mm512_loadu_pd(y3 + p), a3);
+        }
+        dot[j] += _mm512_reduce_add_pd(a0);
+        dot[j + 1] += _mm512_reduce_add_pd(a1);
+        dot[j + 2] += _mm512_reduce_add_pd(a2);
+        dot[j + 3] += _mm512_reduce_add_pd(a3);
+        for (; p < end; p++)
+        {
+            dot[j] += x[p] * y0[p];
+            dot[j + 1] += x[p] * y1[p];
+            dot[j + 2] += x[p] * y2[p];
+            dot[j + 3] += x[p] * y3[p];
+        }
+    }
+
+    if (j < k)
+        DotScalar(x, Y + j, k - j, off, len, dot + j);
+}
+
+/* It computes the squared Euclidean distance between two arrays (8 lanes, FMA)
+Parameters: see SquaredDistanceScalar */
+__attribute__((target("avx512f")))
+static double SquaredDistanceAVX512(const double *x, const double *y, int n)
+{
+    __m512d diff, acc = _mm512_setzero_pd();
+    double sum, d;
+    int p;
+
+    for (p = 0; p + 8 <= n; p += 8)
+    {
+        diff = _mm512_sub_pd(_mm512_loadu_pd(x + p), _mm512_loadu_pd(y + p));
+        acc = _mm512_fmadd_pd(diff, diff, acc);
+    }
+    sum = _mm512_reduce_add_pd(acc);
+    for (; p < n; p++)
+    {
+        d = x[p] - y[p];
+        sum += d * d;
+    }
+
+    return sum;
+}
+#endif
+
+/* Code of the dot products and of the distances to a point in each code path (AVX-512 computes the distances with AVX2) */
+static const prtDotKernel DotKernelTable[N_ISAS] = {
+#ifdef KERNEL_X86
+    DotScalar, DotAVX2, DotAVX512
+#else
+    DotScalar, NULL, NULL
+#endif
+};
+
+static const prtDistanceKernel DistanceKernelTable[N_ISAS] = {
+#ifdef KERNEL_X86
+    DistancesScalar, DistancesAVX2, DistancesAVX2
+#else
+    DistancesScalar, NULL, NULL
+#endif
+};
+
+static const prtSquaredDistanceKernel SquaredDistanceKernelTable[N_ISAS] = {
+#ifdef KERNEL_X86
+    SquaredDistanceScalar, SquaredDistanceAVX2, SquaredDistanceAVX512
+#else
+    SquaredDistanceScalar, NULL, NULL
+#endif
+};
+
+/* It computes the squared Euclidean norm of m n-dimensional arrays
+Parameters:
+X: m n-dimensional arrays
+m: number of arrays
+n: number of decision variables
+norm: output array with m squared norms */
+void SquaredNorms(double **X, int m, int n, double *norm)
+{
+    prtDotKernel f = DotKernelTable[KernelISA()];
+    int i;
+
+    for (i = 0; i < m; i++)
+    {
+        norm[i] = 0;
+        f(X[i], X + i, 1, 0, n, norm + i);
+    }
+}
+
+/* It computes the squared Euclidean distances between m and k n-dimensional arrays
+ * The distances are computed as ||x||^2 + ||y||^2 - 2 x.y, and the dot products are computed block by block (DIST_BLOCK_ROWS arrays of
+ * X and Y and DIST_BLOCK_DIMS decision variables at a time), so that the blocks are reused from the cache. Since the cancellation of
+ * this form amounts to a few ulps of the squared norms, it suits distances that are not much smaller than the norms, e.g.,
+ * the attractiveness of FA or the nearest centers of k-means, while EuclideanDistances should be used to compare distances with small thresholds.
+Parameters:
+X: m n-dimensional arrays
+m: number of arrays in X
+Y: k n-dimensional arrays (it may be X)
+k: number of arrays in Y
+n: number of decision variables
+D: output m x k matrix (row-major), D[i * k + j] is the squared distance between X[i] and Y[j] */
+void SquaredDistanceMatrix(double **X, int m, double **Y, int k, int n, double *D)
+{
+    if ((!X) || (!Y) || (!D) || (m < 0) || (k < 0) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @SquaredDistanceMatrix.\n");
+        exit(-1);
+    }
+
+    prtDotKernel f = DotKernelTable[KernelISA()];
+    double *x_norm = NULL, *y_norm = NULL, *row = NULL;
+    int i, j, i0, j0, p0, mb, kb, len;
+
+    x_norm = (double *)malloc((m + k) * sizeof(double));
+    y_norm = x_norm + m;
+    SquaredNorms(X, m, n, x_norm);
+    SquaredNorms(Y, k, n, y_norm);
+    memset(D, 0, (size_t)m * k * sizeof(double));
+
+    for (j0 = 0; j0 < k; j0 += DIST_BLOCK_ROWS)
+    {
+        kb = k - j0 < DIST_BLOCK_ROWS ? k - j0 : DIST_BLOCK_ROWS;
+        for (p0 = 0; p0 < n; p0 += DIST_BLOCK_DIMS)
+        {
+            len = n - p0 < DIST_BLOCK_DIMS ? n - p0 : DIST_BLOCK_DIMS;
+            for (i0 = 0; i0 < m; i0 += DIST_BLOCK_ROWS)
+            {
+                mb = m - i0 < DIST_BLOCK_ROWS ? m - i0 : DIST_BLOCK_ROWS;
+                for (i = i0; i < i0 + mb; i++)
+                    f(X[i], Y + j0, kb, p0, len, D + (size_t)i * k + j0);
+            }
+        }
+    }
+
+    for (i = 0; i < m; i++)
+    {
+        row = D + (size_t)i * k;
+        for (j = 0; j < k; j++)
+        {
+            row[j] = x_norm[i] + y_norm[j] - 2 * row[j];
+            if (row[j] < 0) /* it removes the rounding errors of (nearly) coincident arrays */
+                row[j] = 0;
+        }
+    }
+
+    free(x_norm);
+}
+
+/* It computes the Euclidean distances between an n-dimensional array and k others
+ * The results are the same of EuclideanDistance in every code path.
+Parameters:
+x: n-dimensional array
+Y: k n-dimensional arrays
+k: number of arrays in Y
+n: number of decision variables
+d: output array with k distances */
+void EuclideanDistances(double *x, double **Y, int k, int n, double *d)
+{
+    if ((!x) || (!Y) || (!d) || (k < 0) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @EuclideanDistances.\n");
+        exit(-1);
+    }
+
+    DistanceKernelTable[KernelISA()](x, Y, k, n, d);
+}
+
+/* It computes the squared Euclidean distance between two n-dimensional arrays
+ * Unlike EuclideanDistance, it takes no square root, and the vectorized code paths match the portable code up to rounding errors.
+Parameters:
+x, y: n-dimensional arrays
+n: number of decision variables */
+double SquaredDistance(const double *x, const double *y, int n)
+{
+    if ((!x) || (!y) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @SquaredDistance.\n");
+        exit(-1);
+    }
+
+    return SquaredDistanceKernelTable[KernelISA()](x, y, n);
+}
+/**************************/
+
+/* Tensor kernels */
+#define TENSOR_CHUNK 64 /* number of rows whose distances are kept on the stack by TensorDistanceSum */
+
+typedef void (*prtTensorKernel)(const double *T, const double *S, int n, int d, double *norm); /* Pointer to the code of the row norms in a given code path */
+
+/* It computes the Euclidean norm of each row of T - S, or of T if S is NULL (portable code)
+ * The squares are accumulated in the same order of TensorNorm and TensorEuclideanDistance, so the results are the same.
+Parameters:
+T: n x d tensor stored row by row
+S: n x d tensor stored row by row (it may be NULL)
+n: number of rows
+d: tensor space dimension
+norm: output array with n norms */
+static void TensorNormsScalar(const double *T, const double *S, int n, int d, double *norm)
+{
+    double sum, diff;
+    int j, k;
+
+    for (j = 0; j < n; j++)
+    {
+        sum = 0;
+        for (k = 0; k < d; k++)
+        {
+            diff = S ? T[j * d + k] - S[j * d + k] : T[j * d + k];
+            sum += diff * diff;
+        }
+        norm[j] = sqrt(sum);
+    }
+}
+
+#ifdef KERNEL_X86
+/* It transposes a 4 x 4 block of doubles, i.e., r[k] holds the k-th element of the 4 rows when it returns
+Parameters:
+r: 4 rows of the block */
+__attribute__((target("avx2")))
+static inline void Transpose4x4(__m256d *r)
+{
+    __m256d t0, t1, t2, t3;
+
+    t0 = _mm256_unpacklo_pd(r[0], r[1]);
+    t1 = _mm256_unpackhi_pd(r[0], r[1]);
+    t2 = _mm256_unpacklo_pd(r[2], r[3]);
+    t3 = _mm256_unpackhi_pd(r[2], r[3]);
+    r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+/* It computes the Euclidean norm of each row of T - S, or of T if S is NULL (4 lanes, one row per lane)
+ * Quaternions, octonions and any other dimension multiple of 4 are loaded as 4 x 4 blocks and transposed in registers,
+ * while the remaining dimensions gather one element per lane. Each lane accumulates the squares of its row in the same order
+ * of the portable code, and no fused operations are used, so the results are the same.
+Parameters: see TensorNormsScalar */
+__attribute__((target("avx2")))
+static void TensorNormsAVX2(const double *T, const double *S, int n, int d, double *norm)
+{
+    __m256d r[4], sum;
+    const double *t, *s;
+    int j = 0, k, p;
+
+    for (; j + 4 <= n; j += 4)
+    {
+        t = T + j * d;
+        s = S ? S + j * d : NULL;
+        sum = _mm256_setzero_pd();
+        if (!(d % 4))
+        {
+            for (p = 0; p < d; p += 4)
+            {
+                for (k = 0; k < 4; k++)
+                {
+                    r[k] = _mm256_loadu_pd(t + k * d + p);
+                    if (s)
+                        r[k] = _mm256_sub_pd(r[k], _mm256_loadu_pd(s + k * d + p));
+                }
+                Transpose4x4(r);
+                for (k = 0; k < 4; k++)
+                    sum = _mm256_add_pd(sum, _mm256_mul_pd(r[k], r[k]));
+            }
+        }
+        else
+        {
+            for (p = 0; p < d; p++)
+            {
+                r[0] = _mm256_set_pd(t[3 * d + p], t[2 * d + p], t[d + p], t[p]);
+                if (s)
+                    r[0] = _mm256_sub_pd(r[0], _mm256_set_pd(s[3 * d + p], s[2 * d + p], s[d + p], s[p]));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(r[0], r[0]));
+            }
+        }
+        _mm256_storeu_pd(norm + j, _mm256_sqrt_pd(sum));
+    }
+
+    if (j < n)
+        TensorNormsScalar(T + j * d, S ? S + j * d : NULL, n - j, d, norm + j);
+}
+#endif
+
+/* Code of the row norms in each code path (AVX-512 computes them with AVX2, since a row of an octonion fills a single register) */
+static const prtTensorKernel TensorKernelTable[N_ISAS] = {
+#ifdef KERNEL_X86
+    TensorNormsScalar, TensorNormsAVX2, TensorNormsAVX2
+#else
+    TensorNormsScalar, NULL, NULL
+#endif
+};
+
+/* It computes the norms of n tensor_dim-dimensional tensors stored row by row (see TensorNorm)
+ * The results are the same of TensorNorm in every code path.
+Parameters:
+T: n x tensor_dim tensor stored row by row, e.g., t[0] of a tensor allocated by CreateTensor
+n: number of rows
+tensor_dim: tensor space dimension
+norm: output array with n norms */
+void TensorNorms(const double *T, int n, int tensor_dim, double *norm)
+{
+    if ((!T) || (!norm) || (n < 0) || (tensor_dim <= 0))
+    {
+        fprintf(stderr, "\nInvalid input parameters @TensorNorms.\n");
+        exit(-1);
+    }
+
+    TensorKernelTable[KernelISA()](T, NULL, n, tensor_dim, norm);
+}
+
+/* It maps n tensor_dim-dimensional tensors stored row by row to real values bounded by [L,U] (see TensorSpan)
+ * The results are the same of TensorSpan in every code path.
+Parameters:
+L: n lower bounds
+U: n upper bounds
+T: n x tensor_dim tensor stored row by row
+n: number of rows
+tensor_dim: tensor space dimension
+x: output array with n real values (it must not overlap T) */
+void TensorSpans(const double *L, const double *U, const double *T, int n, int tensor_dim, double *x)
+{
+    if ((!L) || (!U) || (!T) || (!x) || (n < 0) || (tensor_dim <= 0))
+    {
+        fprintf(stderr, "\nInvalid input parameters @TensorSpans.\n");
+        exit(-1);
+    }
+
+    double root = sqrt(tensor_dim);
+    int j;
+
+    TensorKernelTable[KernelISA()](T, NULL, n, tensor_dim, x);
+    for (j = 0; j < n; j++)
+        x[j] = (U[j] - L[j]) * (x[j] / root) + L[j];
+}
+
+/* It sums the Euclidean distances between the rows of two n x tensor_dim tensors stored row by row (see TensorEuclideanDistance)
+ * The distances are summed in ascending order of rows, so the result is the same in every code path.
+Parameters:
+T, S: n x tensor_dim tensors stored row by row
+n: number of rows
+tensor_dim: tensor space dimension */
+double TensorDistanceSum(const double *T, const double *S, int n, int tensor_dim)
+{
+    if ((!T) || (!S) || (n < 0) || (tensor_dim <= 0))
+    {
+        fprintf(stderr, "\nInvalid input parameters @TensorDistanceSum.\n");
+        exit(-1);
+    }
+
+    prtTensorKernel f = TensorKernelTable[KernelISA()];
+    double sum = 0, d[TENSOR_CHUNK];
+    int j, j0, len;
+
+    for (j0 = 0; j0 < n; j0 += TENSOR_CHUNK)
+    {
+        len = n - j0 < TENSOR_CHUNK ? n - j0 : TENSOR_CHUNK;
+        f(T + (size_t)j0 * tensor_dim, S + (size_t)j0 * tensor_dim, len, tensor_dim, d);
+        for (j = 0; j < len; j++)
+            sum += d[j];
+    }
+
+    return sum;
+}
+/**************************/
+
+/* General-purpose functions */
+/* It returns the name of the code path used by the kernels (scalar, avx2 or avx512) */
+const char *GetKernelISA()
+{
+    return ISAName[KernelISA()];
+}
+
+/* It calls a benchmark function of function.h
+Parameters:
+f: benchmark function
+a: agent */
+static double CallReference(prtFun f, Agent *a, ...)
+{
+    va_list arg;
+    double fit;
+
+    va_start(arg, a);
+    fit = f(a, arg);
+    va_end(arg);
+
+    return fit;
+}
+
+/* It compares every available code path of the kernels against the functions of function.h
+ * Each kernel is evaluated at a random point within the domain of its function, and it fails if the absolute error exceeds tol * (1 + |reference|).
+ * The GP primitives are also compared against their portable code, and they fail unless the results are bitwise identical.
+ * The distances to a point must be bitwise identical to EuclideanDistance, and the squared distances and the dot products of the distance matrix are checked with tol.
+ * The norms and distances of the tensor kernels must be bitwise identical to their portable code.
+Parameters:
+n: number of decision variables (odd values also exercise the scalar tails of the vectorized paths)
+tol: relative tolerance, e.g., 1e-10
+It returns the number of failed comparisons (each one is reported to stderr). */
+int CheckKernels(int n, double tol)
+{
+    const prtFun reference[N_KERNELS] = {Ackley_First, Alpine_First, Griewank, Rastrigin, Rosenbrock, Schumer_Steiglitz, Sphere, Sum_Squares, Styblinski_Tang};
+    const char *name[N_KERNELS] = {"Ackley_First", "Alpine_First", "Griewank", "Rastrigin", "Rosenbrock", "Schumer_Steiglitz", "Sphere", "Sum_Squares", "Styblinski_Tang"};
+    const double bound[N_KERNELS][2] = {{-35, 35}, {-10, 10}, {-100, 100}, {-5.12, 5.12}, {-30, 30}, {-100, 100}, {0, 10}, {-10, 10}, {-5, 5}};
+    const int tensor_dim[3] = {_QUATERNION_, _OCTONION_, 3};
+    double ref, fit, *x = NULL, *y = NULL, *out = NULL, *ref_out = NULL, *dot = NULL, **Y = NULL;
+    int i, j, d, errors = 0;
+    Agent *a = NULL;
+
+    if (n < 2)
+    {
+        fprintf(stderr, "\nInvalid number of decision variables @CheckKernels. It must be equal or greater than two.\n");
+        return -1;
+    }
+
+    a = CreateAgent(n, _PSO_, _NOTENSOR_);
+    for (i = 0; i < N_KERNELS; i++)
+    {
+        FillUniform(a->x, n, bound[i][0], bound[i][1]);
+        ref = CallReference(reference[i], a);
+        for (j = 0; j < N_ISAS; j++)
+        {
+            if ((!KernelTable[i][j]) || (!SupportsISA(j)))
+                continue;
+            fit = KernelTable[i][j](a->x, n);
+            if (!(fabs(fit - ref) <= tol * (1 + fabs(ref))))
+            {
+                fprintf(stderr, "\n%s (%s): %.17g, expected %.17g @CheckKernels.", name[i], ISAName[j], fit, ref);
+                errors++;
+            }
+        }
+    }
+    DestroyAgent(&a, _PSO_);
+
+    /* GP primitives must give the very same results in every code path */
+    x = (double *)malloc(3 * n * sizeof(double));
+    y = x + n;
+    ref_out = y + n;
+    out = (double *)malloc(n * sizeof(double));
+    FillUniform(x, n, -10, 10);
+    FillUniform(y, n, -10, 10);
+    y[0] = 0.0; /* it exercises the protected divisions */
+    for (i = _SUM_; i <= _TDIV_; i++)
+    {
+        GPFunctionScalar(i, x, y, ref_out, n);
+        for (j = 1; j < N_ISAS; j++)
+        {
+            if ((!GPKernelTable[j]) || (!SupportsISA(j)))
+                continue;
+            GPKernelTable[j](i, x, y, out, n);
+            if (memcmp(out, ref_out, n * sizeof(double)))
+            {
+                fprintf(stderr, "\nGP function %d (%s) differs from the portable code @CheckKernels.", i, ISAName[j]);
+                errors++;
+            }
+        }
+    }
+    free(x);
+    free(out);
+
+    /* distances to a point must be the same of EuclideanDistance, while the squared distances and the dot products match up to rounding errors */
+    x = (double *)malloc((N_DIST_POINTS + 1) * n * sizeof(double));
+    Y = (double **)malloc(N_DIST_POINTS * sizeof(double *));
+    ref_out = (double *)malloc(3 * N_DIST_POINTS * sizeof(double));
+    out = ref_out + N_DIST_POINTS;
+    dot = out + N_DIST_POINTS;
+    FillUniform(x, (N_DIST_POINTS + 1) * n, -10, 10);
+    for (i = 0; i < N_DIST_POINTS; i++)
+    {
+        Y[i] = x + (i + 1) * n;
+        ref_out[i] = 0;
+        DotScalar(x, Y + i, 1, 0, n, ref_out + i);
+        dot[i] = EuclideanDistance(x, Y[i], n);
+    }
+    for (j = 0; j < N_ISAS; j++)
+    {
+        if ((!DotKernelTable[j]) || (!SupportsISA(j)))
+            continue;
+        DistanceKernelTable[j](x, Y, N_DIST_POINTS, n, out);
+        if (memcmp(out, dot, N_DIST_POINTS * sizeof(double)))
+        {
+            fprintf(stderr, "\nDistances (%s) differ from EuclideanDistance @CheckKernels.", ISAName[j]);
+            errors++;
+        }
+        for (i = 0; i < N_DIST_POINTS; i++)
+        {
+            ref = SquaredDistanceScalar(x, Y[i], n);
+            fit = SquaredDistanceKernelTable[j](x, Y[i], n);
+            if (!(fabs(fit - ref) <= tol * (1 + fabs(ref))))
+            {
+                fprintf(stderr, "\nSquared distance (%s): %.17g, expected %.17g @CheckKernels.", ISAName[j], fit, ref);
+                errors++;
+            }
+        }
+        memset(out, 0, N_DIST_POINTS * sizeof(double));
+        DotKernelTable[j](x, Y, N_DIST_POINTS, 0, n, out);
+        for (i = 0; i < N_DIST_POINTS; i++)
+        {
+            if (!(fabs(out[i] - ref_out[i]) <= tol * (1 + fabs(ref_out[i]))))
+            {
+                fprintf(stderr, "\nDot product (%s): %.17g, expected %.17g @CheckKernels.", ISAName[j], out[i], ref_out[i]);
+                errors++;
+            }
+        }
+    }
+    free(x);
+    free(Y);
+    free(ref_out);
+
+    /* row norms of quaternions, octonions and of a dimension that is not a multiple of the lanes must be the same in every code path */
+    x = (double *)malloc(2 * N_DIST_POINTS * _OCTONION_ * sizeof(double));
+    y = x + N_DIST_POINTS * _OCTONION_;
+    ref_out = (double *)malloc(2 * N_DIST_POINTS * sizeof(double));
+    out = ref_out + N_DIST_POINTS;
+    FillUniform(x, 2 * N_DIST_POINTS * _OCTONION_, 0, 1);
+    for (i = 0; i < 6; i++)
+    {
+        d = tensor_dim[i % 3];
+        TensorNormsScalar(x, i < 3 ? NULL : y, N_DIST_POINTS, d, ref_out);
+        for (j = 1; j < N_ISAS; j++)
+        {
+            if ((!TensorKernelTable[j]) || (!SupportsISA(j)))
+                continue;
+            TensorKernelTable[j](x, i < 3 ? NULL : y, N_DIST_POINTS, d, out);
+            if (memcmp(out, ref_out, N_DIST_POINTS * sizeof(double)))
+            {
+                fprintf(stderr, "\nTensor %s of dimension %d (%s) differ from the portable code @CheckKernels.", i < 3 ? "norms" : "distances", d, ISAName[j]);
+                errors++;
+            }
+        }
+    }
+    free(x);
+    free(ref_out);
+
+    return errors;
+}
+/**************************/
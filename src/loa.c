@@ -15,15 +15,16 @@ limitations under the License.
 
 
 #include "loa.h"
+#include "telemetry.h"
+#include "profile.h"
 
 /* In each pride, some females look for a prey (hunt)
 Parameters:
 s: search space
 pride: pride identification number
 selected_females: binary array (zeroed) that each index indicates if a female is hunting right now or not
-Evaluate: pointer to the function used to evaluate lionsses
-arg: list of additional arguments */
-void Hunting(SearchSpace *s, int pride, int *selected_females, prtFun Evaluate, va_list arg)
+e: fitness evaluator */
+void Hunting(SearchSpace *s, int pride, int *selected_females, Evaluator *e)
 {
   int i, j, n_selected, index, center_index;
   int *group = calloc(3, sizeof(int));               /* counter of members of each group */
@@ -139,7 +140,7 @@ void Hunting(SearchSpace *s, int pride, int *selected_females, prtFun Evaluate,
     }
     CheckAgentLimits(s, Hunters[i]);
     /* Calculating the new fitness of the lioness */
-    EvaluateAgent(s, Hunters[i], _LOA_, Evaluate, arg);
+    EvaluateAgentWith(s, Hunters[i], _LOA_, e);
 
     /* if ith lioness improves its own fitness */
     if (Hunters[i]->fit < Hunters[i]->pfit)
@@ -160,9 +161,8 @@ Parameters:
 s: search space
 pride: pride identification number
 selected_females: binary array declared (zeroed) in'runLOA()' and modified on 'hunting()' that each ith element indicates if the ith female is hunting right now or not
-Evaluate: pointer to the function used to evaluate lionsses
-arg: list of additional arguments */
-void MovingSafePlace(SearchSpace *s, int pride, int *selected_females, prtFun Evaluate, va_list arg)
+e: fitness evaluator */
+void MovingSafePlace(SearchSpace *s, int pride, int *selected_females, Evaluator *e)
 {
   int i, j;
   int tournament_size, index, pride_size, territory_index;
@@ -243,7 +243,7 @@ void MovingSafePlace(SearchSpace *s, int pride, int *selected_females, prtFun Ev
                                               GenerateUniformRandomNumber(-1, 1) * tan(theta) * distance * r2[j];
 
       CheckAgentLimits(s, s->pride_id[pride].females[i]);
-      EvaluateAgent(s, s->pride_id[pride].females[i], _LOA_, Evaluate, arg);
+      EvaluateAgentWith(s, s->pride_id[pride].females[i], _LOA_, e);
 
       /* if is not the last female */
       if (i < s->pride_id[pride].n_females - 1)
@@ -262,9 +262,8 @@ void MovingSafePlace(SearchSpace *s, int pride, int *selected_females, prtFun Ev
 Parameters:
 s: search space
 pride: pride identification number
-Evaluate: pointer to the function used to evaluate lions
-arg: list of additional arguments */
-void Roaming(SearchSpace *s, int pride, prtFun Evaluate, va_list arg)
+e: fitness evaluator */
+void Roaming(SearchSpace *s, int pride, Evaluator *e)
 {
   int i, j, k;
   int pride_size, n_territory, index;
@@ -315,7 +314,7 @@ void Roaming(SearchSpace *s, int pride, prtFun Evaluate, va_list arg)
 
         CheckAgentLimits(s, s->pride_id[pride].males[i]);
 
-        EvaluateAgent(s, s->pride_id[pride].males[i], _LOA_, Evaluate, arg);
+        EvaluateAgentWith(s, s->pride_id[pride].males[i], _LOA_, e);
       }
     }
     /* saving the last fitness value */
@@ -342,9 +341,8 @@ void Roaming(SearchSpace *s, int pride, prtFun Evaluate, va_list arg)
 Parameters:
 s: search space
 extra_male_nomads: number of extra male nomads that moved out from the prides
-Evaluate: pointer to the function used to evaluate male and female lions
-arg: list of additional arguments */
-void NomadMovingRandom(SearchSpace *s, int extra_male_nomads, prtFun Evaluate, va_list arg)
+e: fitness evaluator */
+void NomadMovingRandom(SearchSpace *s, int extra_male_nomads, Evaluator *e)
 {
   int i, j;
   double pr, randj;
@@ -363,7 +361,7 @@ void NomadMovingRandom(SearchSpace *s, int extra_male_nomads, prtFun Evaluate, v
     }
 
     CheckAgentLimits(s, s->female_nomads[i]);
-    EvaluateAgent(s, s->female_nomads[i], _LOA_, Evaluate, arg);
+    EvaluateAgentWith(s, s->female_nomads[i], _LOA_, e);
   }
 
   /* for each nomad male */
@@ -380,7 +378,7 @@ void NomadMovingRandom(SearchSpace *s, int extra_male_nomads, prtFun Evaluate, v
     }
 
     CheckAgentLimits(s, s->male_nomads[i]);
-    EvaluateAgent(s, s->male_nomads[i], _LOA_, Evaluate, arg);
+    EvaluateAgentWith(s, s->male_nomads[i], _LOA_, e);
   }
 }
 
@@ -389,9 +387,8 @@ Parameters:
 s: search space
 pride: pride identification number
 n_offsprings: number of offsprings that will be generated by matting
-Evaluate: pointer to the function used to evaluate the cubs
-arg: list of additional arguments */
-void Mating(SearchSpace *s, int pride, int *n_offsprings, prtFun Evaluate, va_list arg)
+e: fitness evaluator */
+void Mating(SearchSpace *s, int pride, int *n_offsprings, Evaluator *e)
 {
   int i, j, k;
   int n_matting_females = 0, n_matting_males = 0;
@@ -525,8 +522,8 @@ void Mating(SearchSpace *s, int pride, int *n_offsprings, prtFun Evaluate, va_li
       CheckAgentLimits(s, offspring1);
       CheckAgentLimits(s, offspring2);
       /* evaluating the offsprings */
-      EvaluateAgent(s, offspring1, _LOA_, Evaluate, arg);
-      EvaluateAgent(s, offspring2, _LOA_, Evaluate, arg);
+      EvaluateAgentWith(s, offspring1, _LOA_, e);
+      EvaluateAgentWith(s, offspring2, _LOA_, e);
       /* moving the idexes */
       male_index++;
       female_index++;
@@ -552,9 +549,8 @@ Parameters:
 s: search space
 n_offsprings: number of offsprings that will be generated by nomad matting
 extra_male_nomads: number of extra male nomads that moved out from the prides
-Evaluate: pointer to the function used to evaluate the cubs
-arg: list of additional arguments */
-void NomadMating(SearchSpace *s, int *n_offsprings, int extra_male_nomads, prtFun Evaluate, va_list arg)
+e: fitness evaluator */
+void NomadMating(SearchSpace *s, int *n_offsprings, int extra_male_nomads, Evaluator *e)
 {
   int i, j, k;
   int n_matting_females = 0;
@@ -667,8 +663,8 @@ void NomadMating(SearchSpace *s, int *n_offsprings, int extra_male_nomads, prtFu
       CheckAgentLimits(s, offspring1);
       CheckAgentLimits(s, offspring2);
       /* evaluating the offsprings */
-      EvaluateAgent(s, offspring1, _LOA_, Evaluate, arg);
-      EvaluateAgent(s, offspring2, _LOA_, Evaluate, arg);
+      EvaluateAgentWith(s, offspring1, _LOA_, e);
+      EvaluateAgentWith(s, offspring2, _LOA_, e);
       /* moving the idexes */
       male_index++;
       female_index++;
@@ -693,7 +689,9 @@ void Defense(SearchSpace *s, int pride, int n_male_offsprings, int extra_male_no
   Agent **temp_nomads = NULL;
 
   /* sorting male lions by fitness */
+  PROFILE_BEGIN(_PROFILE_SORT_);
   qsort(s->pride_id[pride].males, s->pride_id[pride].n_males + n_male_offsprings, sizeof(Agent **), SortAgent);
+  PROFILE_END(_PROFILE_SORT_);
 
   /* allocating the new arrays of agents*/
   new_residents = (Agent **)malloc(s->pride_id[pride].n_males * sizeof(Agent *));
@@ -833,13 +831,12 @@ void Migration(SearchSpace *s, int *n_offsprings, int n_nomad_female_offspring,
   }
 }
 
-/* It executes the Lion Optimization Algorithm for function minimization
+/* It executes the Lion Optimization Algorithm with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate the cubs */
-void runLOA(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void LOA(SearchSpace *s, Evaluator *e)
 {
-  va_list arg;
   int i, k;
   int *selected_females = NULL; /* binary array indicating if a female is hunting or not */
   int n_nomad_offspring, extra_male_nomads, extra_female_nomads, n_fill, pride_index;
@@ -847,28 +844,26 @@ void runLOA(SearchSpace *s, prtFun Evaluate, ...)
   int n_pride_offspring[s->n_prides]; /* array that each index indicates the number of offsprings generated by a pride */
   int n_migrating[s->n_prides];       /* array that indicates the number of females that will migrate from the pride indicated by the index (will be filled in 'Migration')*/
   Agent **new_nomads = NULL;
-  va_start(arg, Evaluate);
 
-  EvaluateSearchSpace(s, _LOA_, Evaluate, arg); /* Initial evaluation */
+  EvaluateSearchSpaceWith(s, _LOA_, e); /* Initial evaluation */
   for (k = 0; k < s->iterations; k++)
   {
-    fprintf(stderr, "\nRunning iteration %d/%d ... ", k + 1, s->iterations);
     /* For each pride */
     extra_male_nomads = 0;
     for (i = 0; i < s->n_prides; i++)
     {
       selected_females = (int *)calloc(s->pride_id[i].n_females, sizeof(int));
-      Hunting(s, i, selected_females, Evaluate, arg); /* Random selected females go hunting */
-      MovingSafePlace(s, i, selected_females, Evaluate, arg); /* the rest of females go toward a safe place*/
-      Roaming(s, i, Evaluate, arg); /* each male in a pride roams in that pride's territory */
-      Mating(s, i, &n_pride_offspring[i], Evaluate, arg);
+      Hunting(s, i, selected_females, e); /* Random selected females go hunting */
+      MovingSafePlace(s, i, selected_females, e); /* the rest of females go toward a safe place*/
+      Roaming(s, i, e); /* each male in a pride roams in that pride's territory */
+      Mating(s, i, &n_pride_offspring[i], e);
       Defense(s, i, (int)(n_pride_offspring[i] / 2), extra_male_nomads);
       extra_male_nomads += (int)(n_pride_offspring[i] / 2);
       free(selected_females);
     }
     /* For Nomads */
-    NomadMovingRandom(s, extra_male_nomads, Evaluate, arg);
-    NomadMating(s, &n_nomad_offspring, extra_male_nomads, Evaluate, arg);
+    NomadMovingRandom(s, extra_male_nomads, e);
+    NomadMating(s, &n_nomad_offspring, extra_male_nomads, e);
     /* nomad lions atack pride lions */
     AtackPride(s, (int)(n_nomad_offspring / 2), extra_male_nomads);
     /* females in pride become nomads */
@@ -877,7 +872,9 @@ void runLOA(SearchSpace *s, prtFun Evaluate, ...)
     /**** POPULATION EQUILIBRIUM ****/
     /* some nomad females will become pride females, and the worst nomad females will die */
     /* sorting nomad females */
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(s->female_nomads, s->n_female_nomads + (int)(n_nomad_offspring / 2) + extra_female_nomads, sizeof(Agent **), SortAgent);
+    PROFILE_END(_PROFILE_SORT_);
     /* determinig the number of empty places in each pride and the total number of empty places */
     n_fill = 0;
     for (i = 0; i < s->n_prides; i++)
@@ -912,7 +909,9 @@ void runLOA(SearchSpace *s, prtFun Evaluate, ...)
 
     /* the worst males will die */
     /* sorting nomad males */
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(s->male_nomads, s->n_male_nomads + (int)(n_nomad_offspring / 2) + extra_male_nomads, sizeof(Agent **), SortAgent);
+    PROFILE_END(_PROFILE_SORT_);
     /* Allocating the new array of male nomads */
     new_nomads = (Agent **)malloc(s->n_male_nomads * sizeof(Agent *));
     /* saving the best nomads (will remain nomads) */
@@ -926,7 +925,40 @@ void runLOA(SearchSpace *s, prtFun Evaluate, ...)
     /* pointing to the new one */
     s->male_nomads = new_nomads;
 
-    fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+    ReportIteration(s, _LOA_, e, k + 1, s->gfit);
   }
+}
+
+/* It executes the Lion Optimization Algorithm for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate the cubs */
+void runLOA(SearchSpace *s, prtFun Evaluate, ...)
+{
+  va_list arg;
+  Evaluator e;
+
+  va_start(arg, Evaluate);
+  InitEvaluator(&e, s, Evaluate, arg);
+  PROFILE_BEGIN_RUN();
+  LOA(s, &e);
+  PROFILE_END_RUN("LOA", &e);
+  DestroyEvaluator(&e);
   va_end(arg);
+}
+
+/* It executes the Lion Optimization Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runLOA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+  Evaluator e;
+
+  InitEvaluator_r(&e, s, Evaluate, ctx);
+  PROFILE_BEGIN_RUN();
+  LOA(s, &e);
+  PROFILE_END_RUN("LOA", &e);
+  DestroyEvaluator(&e);
 }
\ No newline at end of file
@@ -15,15 +15,16 @@ limitations under the License.
 
 
 #include "mbo.h"
+#include "telemetry.h"
+#include "profile.h"
 
 /* It updates the neighbours of a single bird
 Parameters:
 s: search space
 b: current bird
 k: number of neighbours updated
-Evaluate: pointer to the function used to evaluate birds
-arg: list of additional arguments */
-void UpdateNeighbours(SearchSpace *s, int b, int k, prtFun Evaluate, va_list arg)
+e: fitness evaluator */
+void UpdateNeighbours(SearchSpace *s, int b, int k, Evaluator *e)
 {
     if (!s)
     {
@@ -32,21 +33,18 @@ void UpdateNeighbours(SearchSpace *s, int b, int k, prtFun Evaluate, va_list arg
     }
     int i, j;
     double f;
-    va_list argtmp;
-
-    va_copy(argtmp, arg);
 
     for (i = 0; i < k; i++)
     {
         for (j = 0; j < s->n; j++)
             s->a[b]->nb[i]->x[j] = GenerateUniformRandomNumber(s->LB[j], s->UB[j]);
 
-        f = Evaluate(s->a[b]->nb[i], arg); /* It executes the fitness function for neighbour i */
+        f = ComputeFitness(e, s->a[b]->nb[i]); /* It executes the fitness function for neighbour i */
         s->a[b]->nb[i]->fit = f;           /* It updates the fitness value of actual neighbour i */
-
-        va_copy(arg, argtmp);
     }
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(s->a[b]->nb, s->k, sizeof(Agent **), SortAgent); /* It sorts the neighbours */
+    PROFILE_END(_PROFILE_SORT_);
 }
 
 /* It shares the neighbours to the following bird
@@ -67,8 +65,10 @@ void ShareNeighbours(SearchSpace *s)
             s->a[1]->nb[(s->k) - (s->X) + i]->x[j] = s->a[2]->nb[(s->k) - (s->X) + i]->x[j] = s->a[0]->nb[i + 1]->x[j];
         s->a[1]->nb[(s->k) - (s->X) + i]->fit = s->a[2]->nb[(s->k) - (s->X) + i]->fit = s->a[0]->nb[i + 1]->fit;
     }
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(s->a[1]->nb, s->k, sizeof(Agent **), SortAgent); /* It sorts the new neighbours */
     qsort(s->a[2]->nb, s->k, sizeof(Agent **), SortAgent);
+    PROFILE_END(_PROFILE_SORT_);
 
     if (s->m > 3)
     {
@@ -80,7 +80,9 @@ void ShareNeighbours(SearchSpace *s)
                     s->a[k + 2]->nb[(s->k) - (s->X) + i]->x[j] = s->a[k]->nb[i + 1]->x[j];
                 s->a[k + 2]->nb[(s->k) - (s->X) + i]->fit = s->a[k]->nb[i + 1]->fit;
             }
+            PROFILE_BEGIN(_PROFILE_SORT_);
             qsort(s->a[k + 2]->nb, s->k, sizeof(Agent **), SortAgent); /* It sorts the new neighbours */
+            PROFILE_END(_PROFILE_SORT_);
         }
     }
 }
@@ -108,53 +110,81 @@ void ImproveBirds(SearchSpace *s)
     }
 }
 
-/* It executes the Migrating Birds Optimization for function minimization
+/* It executes the Migrating Birds Optimization with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate birds
-arg: list of additional arguments */
-void runMBO(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void MBO(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int i, j, t, k, tour;
     double beta, prob;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runMBO.\n");
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _MBO_, Evaluate, arg);   /* Initial evaluation */
+    EvaluateSearchSpaceWith(s, _MBO_, e);   /* Initial evaluation */
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Initial bird sort */
+    PROFILE_END(_PROFILE_SORT_);
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-        va_copy(arg, argtmp);
-
         /* for each tour */
         for (tour = 0; tour < s->M; tour++)
         {
-            UpdateNeighbours(s, 0, s->k, Evaluate, arg); /* It generates the k neighbours of leader */
+            UpdateNeighbours(s, 0, s->k, e); /* It generates the k neighbours of leader */
 
             for (k = 1; k < s->m; k++)
             { /* It generates the k-X neighbours of each bird */
-                UpdateNeighbours(s, k, s->k - s->X, Evaluate, arg);
-                va_copy(arg, argtmp);
+                UpdateNeighbours(s, k, s->k - s->X, e);
             }
 
             ShareNeighbours(s);
             ImproveBirds(s);
         }
 
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* It replaces the leader with the best bird and sorts the birds flock*/
+        PROFILE_END(_PROFILE_SORT_);
         //ShowSearchSpace(s, _MBO_);
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->a[0]->fit);
+        ReportIteration(s, _MBO_, e, t, s->a[0]->fit);
     }
+}
 
+/* It executes the Migrating Birds Optimization for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate birds
+arg: list of additional arguments */
+void runMBO(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    MBO(s, &e);
+    PROFILE_END_RUN("MBO", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
+}
+
+/* It executes the Migrating Birds Optimization for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runMBO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    MBO(s, &e);
+    PROFILE_END_RUN("MBO", &e);
+    DestroyEvaluator(&e);
 }
\ No newline at end of file
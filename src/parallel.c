@@ -0,0 +1,210 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <unistd.h>
+
+#include "parallel.h"
+
+/* It executes the iterations of the current loop until there is no iteration left
+Parameters:
+p: thread pool
+The pool's lock must be held by the caller, and it is still held when this function returns */
+static void ConsumeTasks(ThreadPool *p) {
+    int i;
+
+    while (p->next < p->n_tasks) {
+        i = p->next++;
+        pthread_mutex_unlock(&p->lock);
+        p->task(i, p->arg);
+        pthread_mutex_lock(&p->lock);
+    }
+}
+
+/* It implements the main loop of a worker thread
+Parameters:
+arg: thread pool */
+static void *Worker(void *arg) {
+    ThreadPool *p = (ThreadPool *) arg;
+    int round = 0;
+
+    pthread_mutex_lock(&p->lock);
+    while (1) {
+        while ((!p->stop) && (p->round == round))
+            pthread_cond_wait(&p->work, &p->lock);
+        if (p->stop)
+            break;
+
+        round = p->round;
+        ConsumeTasks(p);
+
+        p->busy--;
+        if (!p->busy)
+            pthread_cond_signal(&p->done);
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
+}
+
+/* Thread pool-related functions */
+/* It creates a pool of threads
+Parameters:
+n_threads: number of threads, the calling thread included (n_threads - 1 worker threads are spawned) */
+ThreadPool *CreateThreadPool(int n_threads) {
+    if (n_threads < 1) {
+        fprintf(stderr, "\nInvalid number of threads @CreateThreadPool.\n");
+        return NULL;
+    }
+
+    ThreadPool *p = NULL;
+    int i;
+
+    p = (ThreadPool *) malloc(sizeof(ThreadPool));
+    p->n_threads = n_threads;
+    p->task = NULL;
+    p->arg = NULL;
+    p->n_tasks = p->next = p->busy = p->round = 0;
+    p->stop = 0;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work, NULL);
+    pthread_cond_init(&p->done, NULL);
+
+    p->thread = (pthread_t *) malloc(n_threads * sizeof(pthread_t));
+    for (i = 0; i < n_threads - 1; i++) {
+        if (pthread_create(&(p->thread[i]), NULL, Worker, p)) {
+            fprintf(stderr, "\nUnable to create thread #%d @CreateThreadPool. Running with %d threads.\n", i, i + 1);
+            p->n_threads = i + 1;
+            break;
+        }
+    }
+
+    return p;
+}
+
+/* It deallocates a pool of threads
+Parameters:
+p: address of the thread pool to be deallocated */
+void DestroyThreadPool(ThreadPool **p) {
+    ThreadPool *tmp = NULL;
+    int i;
+
+    tmp = *p;
+    if (!tmp) {
+        fprintf(stderr, "\nThread pool not allocated @DestroyThreadPool.\n");
+        exit(-1);
+    }
+
+    pthread_mutex_lock(&tmp->lock);
+    tmp->stop = 1;
+    pthread_cond_broadcast(&tmp->work);
+    pthread_mutex_unlock(&tmp->lock);
+
+    for (i = 0; i < tmp->n_threads - 1; i++)
+        pthread_join(tmp->thread[i], NULL);
+
+    pthread_cond_destroy(&tmp->work);
+    pthread_cond_destroy(&tmp->done);
+    pthread_mutex_destroy(&tmp->lock);
+    free(tmp->thread);
+    free(tmp);
+    *p = NULL;
+}
+
+/* It executes task(i, arg) for i = 0, ..., n_tasks-1 using the pool
+ * The iterations are distributed dynamically among the threads, and the calling thread takes part of the work.
+ * This function only returns after all iterations have been finished.
+Parameters:
+p: thread pool
+n_tasks: number of iterations
+task: function executed at each iteration
+arg: additional argument of the task */
+void RunThreadPool(ThreadPool *p, int n_tasks, prtTask task, void *arg) {
+    if ((!p) || (!task)) {
+        fprintf(stderr, "\nInvalid input parameters @RunThreadPool.\n");
+        exit(-1);
+    }
+
+    pthread_mutex_lock(&p->lock);
+    p->task = task;
+    p->arg = arg;
+    p->n_tasks = n_tasks;
+    p->next = 0;
+    p->busy = p->n_threads - 1;
+    p->round++;
+    pthread_cond_broadcast(&p->work);
+
+    ConsumeTasks(p);
+
+    while (p->busy)
+        pthread_cond_wait(&p->done, &p->lock);
+    p->task = NULL;
+    p->arg = NULL;
+    pthread_mutex_unlock(&p->lock);
+}
+/**************************/
+
+/* General-purpose functions */
+/* It returns the number of threads defined by the environment variable OPT_NUM_THREADS
+ * If the variable is not set, it returns 1 (serial execution). If it is set to 0, it returns the number of online processors. */
+int GetDefaultNumberOfThreads() {
+    char *env = getenv("OPT_NUM_THREADS");
+    int n_threads;
+
+    if ((!env) || (!*env))
+        return 1;
+
+    n_threads = atoi(env);
+    if (n_threads == 0)
+        n_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_threads < 1) {
+        fprintf(stderr, "\nInvalid value for OPT_NUM_THREADS @GetDefaultNumberOfThreads. Running with 1 thread.\n");
+        n_threads = 1;
+    }
+
+    return n_threads;
+}
+
+/* It executes a parallel loop with the threads of a search space
+ * The pool is created on demand, and it is re-created whenever s->n_threads changes.
+ * If s->n_threads <= 1, the loop is executed serially by the calling thread, in ascending order of i.
+Parameters:
+s: search space
+n_tasks: number of iterations
+task: function executed at each iteration
+arg: additional argument of the task */
+void ParallelFor(SearchSpace *s, int n_tasks, prtTask task, void *arg) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @ParallelFor.\n");
+        exit(-1);
+    }
+
+    int i;
+
+    if ((s->n_threads <= 1) || (n_tasks < 2)) {
+        for (i = 0; i < n_tasks; i++)
+            task(i, arg);
+        return;
+    }
+
+    if ((s->pool) && (s->pool->n_threads != s->n_threads))
+        DestroyThreadPool(&(s->pool));
+    if (!s->pool) {
+        s->pool = CreateThreadPool(s->n_threads);
+        s->n_threads = s->pool->n_threads; /* in case some thread could not be created */
+    }
+
+    RunThreadPool(s->pool, n_tasks, task, arg);
+}
+/**************************/
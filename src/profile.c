@@ -0,0 +1,195 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "profile.h"
+
+static Profile profile; /* profile of the current (or latest) run */
+static int hw_fd[N_PROFILE_HW_COUNTERS] = {-1, -1, -1, -1}; /* file descriptors of the hardware counters */
+static const char *phase_name[N_PROFILE_PHASES] = {"technique", "fitness", "evaluation", "limits", "sort", "copy", "random"};
+
+/* It defines a phase being timed by a thread */
+typedef struct ProfileFrame_{
+    uint64_t start; /* time at which the phase started, in nanoseconds */
+    uint64_t child; /* time spent in the phases nested in it so far, in nanoseconds */
+}ProfileFrame;
+
+static __thread ProfileFrame frame[PROFILE_MAX_DEPTH]; /* phases being timed by the thread, from the outermost one */
+static __thread int depth = 0; /* number of phases being timed by the thread (it may exceed PROFILE_MAX_DEPTH, which are not timed) */
+
+/* It returns the time of a monotonic clock in nanoseconds */
+static uint64_t GetProfileTime() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* It opens and starts the hardware counters, if the environment variable OPT_PROFILE_HW is set
+ * The counters follow the calling thread and the threads it creates afterwards (the ones of an existing thread pool are not counted). */
+static void StartHardwareCounters() {
+    int i;
+
+    for (i = 0; i < N_PROFILE_HW_COUNTERS; i++)
+        profile.hw[i] = -1;
+    if (!getenv("OPT_PROFILE_HW"))
+        return;
+
+#ifdef __linux__
+    static const uint64_t config[N_PROFILE_HW_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                           PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    struct perf_event_attr attr;
+
+    for (i = 0; i < N_PROFILE_HW_COUNTERS; i++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[i];
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        hw_fd[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (hw_fd[i] >= 0) {
+            ioctl(hw_fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(hw_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+/* It reads and closes the hardware counters */
+static void StopHardwareCounters() {
+    int i;
+    int64_t v;
+
+    for (i = 0; i < N_PROFILE_HW_COUNTERS; i++) {
+        if (hw_fd[i] < 0)
+            continue;
+#ifdef __linux__
+        ioctl(hw_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+#endif
+        if (read(hw_fd[i], &v, sizeof(v)) == sizeof(v))
+            profile.hw[i] = v;
+        close(hw_fd[i]);
+        hw_fd[i] = -1;
+    }
+}
+
+/* Profiler-related functions */
+/* It resets the profile and starts the timer of a run, which is the outermost phase of the calling thread */
+void BeginProfileRun() {
+    memset(&profile, 0, sizeof(Profile));
+    StartHardwareCounters();
+    BeginProfilePhase();
+}
+
+/* It stops the timer of a run and prints its summary to stderr (unless the environment variable OPT_PROFILE_QUIET is set)
+Parameters:
+name: name of the technique
+e: fitness evaluator of the run (its number of evaluations is reported) */
+void EndProfileRun(const char *name, Evaluator *e) {
+    EndProfilePhase(_PROFILE_RUN_);
+    StopHardwareCounters();
+    profile.name = name;
+    if (e)
+        profile.counter[_PROFILE_EVALUATIONS_] = __atomic_load_n(&e->evaluations, __ATOMIC_RELAXED);
+
+    if (!getenv("OPT_PROFILE_QUIET"))
+        PrintProfile(&profile, stderr);
+}
+
+/* It starts the timer of a phase, which is nested in the latest phase started by the calling thread, if any */
+void BeginProfilePhase() {
+    if (depth < PROFILE_MAX_DEPTH) {
+        frame[depth].start = GetProfileTime();
+        frame[depth].child = 0;
+    }
+    depth++;
+}
+
+/* It stops the timer of the latest phase started by the calling thread
+ * Its time is added to the phase and to the time of the nested phases of its parent phase.
+Parameters:
+phase: identifier of the phase */
+void EndProfilePhase(int phase) {
+    uint64_t elapsed;
+
+    if (depth < 1) {
+        fprintf(stderr, "\nNo phase has been started @EndProfilePhase.\n");
+        return;
+    }
+
+    depth--;
+    if (depth >= PROFILE_MAX_DEPTH)
+        return;
+
+    elapsed = GetProfileTime() - frame[depth].start;
+    __atomic_fetch_add(&profile.calls[phase], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&profile.total[phase], elapsed, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&profile.self[phase], elapsed - frame[depth].child, __ATOMIC_RELAXED);
+    if (depth)
+        frame[depth - 1].child += elapsed;
+}
+
+/* It adds k to a counter
+Parameters:
+counter: identifier of the counter
+k: value to be added */
+void AddProfileCounter(int counter, uint64_t k) {
+    __atomic_fetch_add(&profile.counter[counter], k, __ATOMIC_RELAXED);
+}
+
+/* It returns the profile of the current (or latest) run */
+const Profile *GetProfile() {
+    return &profile;
+}
+
+/* It prints the summary of a profile
+Parameters:
+p: profile
+fp: output file */
+void PrintProfile(const Profile *p, FILE *fp) {
+    double run = p->total[_PROFILE_RUN_] * 1e-9;
+    int i;
+
+    fprintf(fp, "\nProfile of %s: %.6lf s, %llu evaluations\n", p->name ? p->name : "run", run,
+            (unsigned long long) p->counter[_PROFILE_EVALUATIONS_]);
+    fprintf(fp, "%-12s %12s %14s %14s %8s\n", "phase", "calls", "self (s)", "total (s)", "self %");
+    for (i = 0; i < N_PROFILE_PHASES; i++) {
+        if (!p->calls[i])
+            continue;
+        fprintf(fp, "%-12s %12llu %14.6lf %14.6lf %7.2lf%%\n", phase_name[i], (unsigned long long) p->calls[i], p->self[i] * 1e-9,
+                p->total[i] * 1e-9, run > 0 ? 100 * p->self[i] * 1e-9 / run : 0);
+    }
+    fprintf(fp, "allocations %llu, bytes copied %llu, random draws %llu\n", (unsigned long long) p->counter[_PROFILE_ALLOCATIONS_],
+            (unsigned long long) p->counter[_PROFILE_BYTES_COPIED_], (unsigned long long) p->counter[_PROFILE_RANDOM_DRAWS_]);
+    if (p->hw[_PROFILE_CYCLES_] >= 0)
+        fprintf(fp, "cycles %lld, instructions %lld (%.2lf per cycle), cache misses %lld, branch misses %lld\n",
+                (long long) p->hw[_PROFILE_CYCLES_], (long long) p->hw[_PROFILE_INSTRUCTIONS_],
+                p->hw[_PROFILE_CYCLES_] > 0 ? (double) p->hw[_PROFILE_INSTRUCTIONS_] / p->hw[_PROFILE_CYCLES_] : 0,
+                (long long) p->hw[_PROFILE_CACHE_MISSES_], (long long) p->hw[_PROFILE_BRANCH_MISSES_]);
+    else if (getenv("OPT_PROFILE_HW"))
+        fprintf(fp, "hardware counters not available\n");
+}
+/**************************/
@@ -15,6 +15,8 @@ limitations under the License.
 
 
 #include "pso.h"
+#include "telemetry.h"
+#include "profile.h"
 
 /* PSO-related functions */
 /* It updates the velocity of an agent (particle)
@@ -23,7 +25,7 @@ s: search space
 i: particle's index */
 void UpdateParticleVelocity(SearchSpace *s, int i)
 {
-    double r1, r2;
+    double r1, r2, *x, *v, *xl;
     int j;
 
     if (!s)
@@ -35,8 +37,12 @@ void UpdateParticleVelocity(SearchSpace *s, int i)
     r1 = GenerateUniformRandomNumber(0, 1);
     r2 = GenerateUniformRandomNumber(0, 1);
 
+    /* rows of the search space's blocks, so that the loop below streams through contiguous memory */
+    x = s->a[i]->x;
+    v = s->a[i]->v;
+    xl = s->a[i]->xl;
     for (j = 0; j < s->n; j++)
-        s->a[i]->v[j] = s->w * s->a[i]->v[j] + s->c1 * r1 * (s->a[i]->xl[j] - s->a[i]->x[j]) + s->c2 * r2 * (s->g[j] - s->a[i]->x[j]);
+        v[j] = s->w * v[j] + s->c1 * r1 * (xl[j] - x[j]) + s->c2 * r2 * (s->g[j] - x[j]);
 }
 
 /* It updates the position of an agent (particle)
@@ -45,6 +51,7 @@ s: search space
 i: particle's index */
 void UpdateParticlePosition(SearchSpace *s, int i)
 {
+    double *x, *v;
     int j;
 
     if (!s)
@@ -53,37 +60,31 @@ void UpdateParticlePosition(SearchSpace *s, int i)
         exit(-1);
     }
 
+    x = s->a[i]->x;
+    v = s->a[i]->v;
     for (j = 0; j < s->n; j++)
-        s->a[i]->x[j] = s->a[i]->x[j] + s->a[i]->v[j];
+        x[j] = x[j] + v[j];
 }
 
-/* It executes the Particle Swarm Optimization for function minimization
+/* It executes the Particle Swarm Optimization with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runPSO(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void PSO(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i;
     double beta, prob;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runPSO.\n");
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _PSO_, Evaluate, arg); /* Initial evaluation */
+    EvaluateSearchSpaceWith(s, _PSO_, e); /* Initial evaluation */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-        va_copy(arg, argtmp);
-
         /* for each particle */
         for (i = 0; i < s->m; i++)
         {
@@ -92,46 +93,71 @@ void runPSO(SearchSpace *s, prtFun Evaluate, ...)
             CheckAgentLimits(s, s->a[i]);
         }
 
-        EvaluateSearchSpace(s, _PSO_, Evaluate, arg);
+        EvaluateSearchSpaceWith(s, _PSO_, e);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _PSO_, e, t, s->gfit);
     }
+}
 
+/* It executes the Particle Swarm Optimization for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runPSO(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    PSO(s, &e);
+    PROFILE_END_RUN("PSO", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Particle Swarm Optimization for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runPSO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    PSO(s, &e);
+    PROFILE_END_RUN("PSO", &e);
+    DestroyEvaluator(&e);
+}
 /*************************/
 
 /* AIWPSO-related functions */
-/* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization
+/* It executes the Particle Swarm Optimization with Adaptive Inertia Weight with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runAIWPSO(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void AIWPSO(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i;
     double beta, prob;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runAIWPSO.\n");
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _PSO_, Evaluate, arg); /* Initial evaluation */
+    EvaluateSearchSpaceWith(s, _PSO_, e); /* Initial evaluation */
 
     for (i = 0; i < s->m; i++)
         s->a[i]->pfit = s->a[i]->fit;
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-        va_copy(arg, argtmp);
-
         /* for each particle */
         for (i = 0; i < s->m; i++)
         {
@@ -140,21 +166,52 @@ void runAIWPSO(SearchSpace *s, prtFun Evaluate, ...)
             CheckAgentLimits(s, s->a[i]);
         }
 
-        EvaluateSearchSpace(s, _PSO_, Evaluate, arg);
+        EvaluateSearchSpaceWith(s, _PSO_, e);
         prob = ComputeSuccess(s);                       /* Equations 17 and 18 */
         s->w = (s->w_max - s->w_min) * prob + s->w_min; /* Equation 20 */
 
-        va_copy(arg, argtmp);
-
         for (i = 0; i < s->m; i++)
             s->a[i]->pfit = s->a[i]->fit;
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _PSO_, e, t, s->gfit);
     }
+}
 
+/* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runAIWPSO(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    AIWPSO(s, &e);
+    PROFILE_END_RUN("AIWPSO", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
 
+/* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runAIWPSO_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    AIWPSO(s, &e);
+    PROFILE_END_RUN("AIWPSO", &e);
+    DestroyEvaluator(&e);
+}
+
 /* It computes the percentage of success concerning the whole search space
 Parameters:
 s: search space */
@@ -228,65 +285,86 @@ void UpdateTensorParticlePosition(SearchSpace *s, int i, int tensor_id)
             s->a[i]->t[j][k] = s->a[i]->t[j][k] + s->a[i]->t_v[j][k];
 }
 
-/* It executes the Tensor-based Particle Swarm Optimization for function minimization
+/* It executes the Tensor-based Particle Swarm Optimization with a given fitness evaluator
 Parameters:
 s: search space
 tensor_id: identifier of tensor's dimension
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runTensorPSO(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void TensorPSO(SearchSpace *s, int tensor_id, Evaluator *e)
 {
-    va_list arg, argtmp;
-    int t, i, j;
+    int t, i;
     double beta, prob;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runTensorPSO.\n");
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _PSO_, tensor_id, Evaluate, arg); /* Initial evaluation */
+    EvaluateTensorSearchSpaceWith(s, _PSO_, tensor_id, e); /* Initial evaluation */
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-        va_copy(arg, argtmp);
-
         /* for each particle */
         for (i = 0; i < s->m; i++)
         {
             UpdateTensorParticleVelocity(s, i, tensor_id);
             UpdateTensorParticlePosition(s, i, tensor_id);
             CheckTensorLimits(s, s->a[i]->t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                s->a[i]->x[j] = TensorSpan(s->LB[j], s->UB[j], s->a[i]->t[j], tensor_id);
         }
 
-        EvaluateTensorSearchSpace(s, _PSO_, tensor_id, Evaluate, arg);
+        EvaluateTensorSearchSpaceWith(s, _PSO_, tensor_id, e);
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _PSO_, e, t, s->gfit);
     }
-
-    va_end(arg);
 }
 
-/* It executes the Tensor-based Particle Swarm Optimization with Adaptive Inertia Weight for function minimization
+/* It executes the Tensor-based Particle Swarm Optimization for function minimization
 Parameters:
 s: search space
+tensor_id: identifier of tensor's dimension
 Evaluate: pointer to the function used to evaluate particles
 arg: list of additional arguments */
-void runTensorAIWPSO(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+void runTensorPSO(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
 {
-    va_list arg, argtmp;
-    int t, i, j;
-    double beta, prob;
+    va_list arg;
+    Evaluator e;
 
     va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorPSO(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorPSO", &e);
+    DestroyEvaluator(&e);
+    va_end(arg);
+}
+
+/* It executes the Tensor-based Particle Swarm Optimization for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorPSO_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorPSO(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorPSO", &e);
+    DestroyEvaluator(&e);
+}
+
+/* It executes the Particle Swarm Optimization with Adaptive Inertia Weight with a given fitness evaluator
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+e: fitness evaluator */
+static void TensorAIWPSO(SearchSpace *s, int tensor_id, Evaluator *e)
+{
+    int t, i;
+    double beta, prob;
 
     if (!s)
     {
@@ -294,38 +372,65 @@ void runTensorAIWPSO(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
         exit(-1);
     }
 
-    EvaluateTensorSearchSpace(s, _PSO_, tensor_id, Evaluate, arg); /* Initial evaluation */
+    EvaluateTensorSearchSpaceWith(s, _PSO_, tensor_id, e); /* Initial evaluation */
 
     for (i = 0; i < s->m; i++)
         s->a[i]->pfit = s->a[i]->fit;
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-        va_copy(arg, argtmp);
-
         /* for each particle */
         for (i = 0; i < s->m; i++)
         {
             UpdateTensorParticleVelocity(s, i, tensor_id);
             UpdateTensorParticlePosition(s, i, tensor_id);
             CheckTensorLimits(s, s->a[i]->t, tensor_id);
-            for (j = 0; j < s->n; j++)
-                s->a[i]->x[j] = TensorSpan(s->LB[j], s->UB[j], s->a[i]->t[j], tensor_id);
         }
 
-        EvaluateTensorSearchSpace(s, _PSO_, tensor_id, Evaluate, arg);
+        EvaluateTensorSearchSpaceWith(s, _PSO_, tensor_id, e);
         prob = ComputeSuccess(s);                       /* Equations 17 and 18 */
         s->w = (s->w_max - s->w_min) * prob + s->w_min; /* Equation 20 */
 
-        va_copy(arg, argtmp);
-
         for (i = 0; i < s->m; i++)
             s->a[i]->pfit = s->a[i]->fit;
 
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _PSO_, e, t, s->gfit);
     }
+}
+
+/* It executes the Tensor-based Particle Swarm Optimization with Adaptive Inertia Weight for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runTensorAIWPSO(SearchSpace *s, int tensor_id, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
 
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    TensorAIWPSO(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorAIWPSO", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Particle Swarm Optimization with Adaptive Inertia Weight for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+tensor_id: identifier of tensor's dimension
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runTensorAIWPSO_r(SearchSpace *s, int tensor_id, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    TensorAIWPSO(s, tensor_id, &e);
+    PROFILE_END_RUN("TensorAIWPSO", &e);
+    DestroyEvaluator(&e);
+}
 /****************************/
@@ -15,92 +15,412 @@ limitations under the License.
 
 
 #include "random.h"
+#include "profile.h"
 
-/* The source code to generate random numbers was taken from http://www.physics.drexel.edu/courses/Comp_Phys/Physics-306/random.c. */
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RANDOM_X86
+#endif
 
-double ran2(int *idum)
+static uint64_t seed_x = 0; /* seed of the generator (internal use only) */
+static int seed_id = 0; /* it changes whenever the generator is seeded, so that each thread re-creates its stream */
+static int n_streams = 0; /* number of streams handed out to threads since the last seed */
+static __thread RandomStream thread_stream; /* stream of the calling thread */
+static __thread int thread_seed_id = 0; /* value of seed_id when thread_stream was created (0 stands for not created) */
+static __thread int thread_stream_id = 0; /* index of thread_stream */
+static __thread uint64_t thread_lanes[4][RANDOM_LANES] __attribute__((aligned(64))); /* states of the bulk generator (word w of lane k is at [w][k]) */
+static __thread int thread_lanes_seed_id = 0; /* value of seed_id when thread_lanes were created (0 stands for not created) */
+static __thread double *thread_levy = NULL; /* scratch array of FillLevy (it is only reallocated when it grows) */
+static __thread int thread_levy_size = 0; /* capacity of thread_levy */
+
+/* It returns the next output of splitmix64, which is used to expand a 64-bit seed
+Parameters:
+x: state of splitmix64 */
+static uint64_t SplitMix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* It rotates a 64-bit word to the left
+Parameters:
+x: word
+k: number of bits */
+static inline uint64_t Rotl(const uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+/* Stream-related functions */
+/* It initializes a stream of random numbers
+Parameters:
+r: stream
+seed: 64-bit seed */
+void SeedRandomStream(RandomStream *r, uint64_t seed)
+{
+    int i;
+
+    if (!r)
+    {
+        fprintf(stderr, "\nStream not allocated @SeedRandomStream.\n");
+        exit(-1);
+    }
+
+    for (i = 0; i < 4; i++)
+        r->state[i] = SplitMix64(&seed);
+    r->has_gaussian = 0;
+    r->gaussian = 0;
+}
+
+/* It advances a stream by 2^128 numbers, which is equivalent to 2^128 calls to NextRandom
+Parameters:
+r: stream */
+void JumpRandomStream(RandomStream *r)
 {
-    int j;
-    int k;
-    static int idum2 = 123456789;
-    static int iy = 0;
-    static int iv[NTAB];
-    double temp;
+    static const uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int i, b;
 
-    if (*idum <= 0)
-    { // *idum < 0 ==> initialize
-        if (-(*idum) < 1)
-            *idum = 1;
-        else
-            *idum = -(*idum);
-        idum2 = (*idum);
+    if (!r)
+    {
+        fprintf(stderr, "\nStream not allocated @JumpRandomStream.\n");
+        exit(-1);
+    }
 
-        for (j = NTAB + 7; j >= 0; j--)
+    for (i = 0; i < 4; i++)
+        for (b = 0; b < 64; b++)
         {
-            k = (*idum) / IQ1;
-            *idum = IA1 * (*idum - k * IQ1) - k * IR1;
-            if (*idum < 0)
-                *idum += IM1;
-            if (j < NTAB)
-                iv[j] = *idum;
+            if (JUMP[i] & (1ULL << b))
+            {
+                s0 ^= r->state[0];
+                s1 ^= r->state[1];
+                s2 ^= r->state[2];
+                s3 ^= r->state[3];
+            }
+            NextRandom(r);
         }
-        iy = iv[0];
+
+    r->state[0] = s0;
+    r->state[1] = s1;
+    r->state[2] = s2;
+    r->state[3] = s3;
+    r->has_gaussian = 0;
+}
+
+/* It initializes n non-overlapping streams, e.g., one per agent or per thread
+ * Stream i is the seeded stream advanced by i jumps, so the same seed always yields the same streams.
+Parameters:
+r: array of n streams
+n: number of streams
+seed: 64-bit seed */
+void CreateRandomStreams(RandomStream *r, int n, uint64_t seed)
+{
+    int i;
+
+    if ((!r) || (n < 1))
+    {
+        fprintf(stderr, "\nInvalid input parameters @CreateRandomStreams.\n");
+        exit(-1);
+    }
+
+    SeedRandomStream(&r[0], seed);
+    for (i = 1; i < n; i++)
+    {
+        r[i] = r[i - 1];
+        JumpRandomStream(&r[i]);
+    }
+}
+
+/* It returns the next 64-bit random number of a stream (xoshiro256**)
+Parameters:
+r: stream */
+uint64_t NextRandom(RandomStream *r)
+{
+    uint64_t *s = r->state;
+    const uint64_t result = Rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = Rotl(s[3], 45);
+
+    return result;
+}
+
+/* It returns a random number uniformly distributed within [a,b)
+Parameters:
+r: stream
+a: lower bound
+b: upper bound */
+double UniformRandom(RandomStream *r, double a, double b)
+{
+    return a + (b - a) * ((NextRandom(r) >> 11) * 0x1.0p-53); /* the 53 upper bits fill the mantissa of a double in [0,1) */
+}
+
+/* It returns a number drawn from a Gaussian distribution by the polar method of Marsaglia
+ * Each rejection loop yields two independent deviates, so the second one is kept in the stream for the next call.
+Parameters:
+r: stream
+mean: mean of the distribution
+variance: variance of the distribution */
+double GaussianRandom(RandomStream *r, double mean, double variance)
+{
+    double x, y, q;
+
+    if (r->has_gaussian)
+    {
+        r->has_gaussian = 0;
+        return r->gaussian * sqrt(variance) + mean;
+    }
+
+    do
+    {
+        x = UniformRandom(r, -1, 1);
+        y = UniformRandom(r, -1, 1);
+        q = x * x + y * y;
+    } while ((q >= 1) || (q == 0));
+
+    q = sqrt(-2 * log(q) / q);
+    r->gaussian = y * q;
+    r->has_gaussian = 1;
+
+    return x * q * sqrt(variance) + mean;
+}
+
+/* It returns the stream of the calling thread
+ * The stream is (re-)created on its first use after each call to srandinter: the first thread to draw gets stream 0,
+ * the next one gets stream 1, and so on. If the generator has never been seeded, it is seeded from the system clock. */
+RandomStream *GetRandomStream()
+{
+    int i, id;
+
+    if (!seed_id)
+        srandinter(0);
+
+    if (thread_seed_id != seed_id)
+    {
+        id = __atomic_fetch_add(&n_streams, 1, __ATOMIC_RELAXED);
+        SeedRandomStream(&thread_stream, seed_x);
+        for (i = 0; i < id; i++)
+            JumpRandomStream(&thread_stream);
+        thread_stream_id = id;
+        thread_seed_id = seed_id;
     }
-    k = (*idum) / IQ1;
-    *idum = IA1 * (*idum - k * IQ1) - k * IR1;
-    if (*idum < 0)
-        *idum += IM1;
-
-    k = idum2 / IQ2;
-    idum2 = IA2 * (idum2 - k * IQ2) - k * IR2;
-    if (idum2 < 0)
-        idum2 += IM2;
-
-    j = iy / NDIV;
-    iy = iv[j] - idum2;
-    iv[j] = *idum;
-    if (iy < 1)
-        iy += IMM1;
-
-    if ((temp = AM * iy) > RNMX)
-        return RNMX;
-    else
-        return temp;
-}
-
-#undef IM1
-#undef IM2
-#undef AM
-#undef IMM1
-#undef IA1
-#undef IA2
-#undef IQ1
-#undef IQ2
-#undef IR1
-#undef IR2
-#undef NTAB
-#undef NDIV
-#undef EPS
-#undef RNMX
-
-static int randx = 0; /* copy of random seed (internal use only) */
-
-/* It initializes the random number generator */
+
+    return &thread_stream;
+}
+/**************************/
+
+/* Bulk generator-related functions */
+/* It converts a 64-bit random number into a double uniformly distributed within [0,1)
+ * The 52 upper bits become the mantissa of a double within [1,2), which needs no integer-to-double conversion (AVX2 has none). */
+static inline double ToUnit(uint64_t x)
+{
+    union {
+        uint64_t i;
+        double d;
+    } c;
+
+    c.i = (x >> 12) | 0x3FF0000000000000ULL;
+    return c.d - 1.0;
+}
+
+/* It generates n_blocks blocks of RANDOM_LANES uniform numbers within [0,1) (portable version)
+ * Each block holds the next output of lanes 0, 1, ..., RANDOM_LANES-1, in this order. The vectorized versions below
+ * compute exactly the same operations, so the three of them output the very same numbers.
+Parameters:
+lanes: states of the bulk generator
+u: output array with n_blocks*RANDOM_LANES numbers
+n_blocks: number of blocks */
+static void UniformBlocksScalar(uint64_t lanes[4][RANDOM_LANES], double *u, int n_blocks)
+{
+    uint64_t r, t;
+    int b, k;
+
+    for (b = 0; b < n_blocks; b++)
+        for (k = 0; k < RANDOM_LANES; k++)
+        {
+            r = Rotl(lanes[1][k] * 5, 7) * 9;
+            t = lanes[1][k] << 17;
+            lanes[2][k] ^= lanes[0][k];
+            lanes[3][k] ^= lanes[1][k];
+            lanes[1][k] ^= lanes[2][k];
+            lanes[0][k] ^= lanes[3][k];
+            lanes[2][k] ^= t;
+            lanes[3][k] = Rotl(lanes[3][k], 45);
+            u[b * RANDOM_LANES + k] = ToUnit(r);
+        }
+}
+
+#ifdef RANDOM_X86
+/* It rotates each 64-bit word of an AVX2 register to the left */
+#define ROTL256(x, k) _mm256_or_si256(_mm256_slli_epi64((x), (k)), _mm256_srli_epi64((x), 64 - (k)))
+
+/* It generates n_blocks blocks of RANDOM_LANES uniform numbers within [0,1) (AVX2 version, two registers of 4 lanes)
+Parameters:
+lanes: states of the bulk generator
+u: output array with n_blocks*RANDOM_LANES numbers
+n_blocks: number of blocks */
+__attribute__((target("avx2")))
+static void UniformBlocksAVX2(uint64_t lanes[4][RANDOM_LANES], double *u, int n_blocks)
+{
+    __m256i s[2][4], r, t, x;
+    const __m256i exponent = _mm256_set1_epi64x(0x3FF0000000000000LL);
+    const __m256d one = _mm256_set1_pd(1.0);
+    int b, h, w;
+
+    for (h = 0; h < 2; h++)
+        for (w = 0; w < 4; w++)
+            s[h][w] = _mm256_load_si256((const __m256i *) &lanes[w][4 * h]);
+
+    for (b = 0; b < n_blocks; b++)
+        for (h = 0; h < 2; h++)
+        {
+            x = _mm256_add_epi64(s[h][1], _mm256_slli_epi64(s[h][1], 2)); /* s1 * 5 */
+            x = ROTL256(x, 7);
+            r = _mm256_add_epi64(x, _mm256_slli_epi64(x, 3)); /* (...) * 9 */
+            t = _mm256_slli_epi64(s[h][1], 17);
+            s[h][2] = _mm256_xor_si256(s[h][2], s[h][0]);
+            s[h][3] = _mm256_xor_si256(s[h][3], s[h][1]);
+            s[h][1] = _mm256_xor_si256(s[h][1], s[h][2]);
+            s[h][0] = _mm256_xor_si256(s[h][0], s[h][3]);
+            s[h][2] = _mm256_xor_si256(s[h][2], t);
+            s[h][3] = ROTL256(s[h][3], 45);
+            x = _mm256_or_si256(_mm256_srli_epi64(r, 12), exponent);
+            _mm256_storeu_pd(u + b * RANDOM_LANES + 4 * h, _mm256_sub_pd(_mm256_castsi256_pd(x), one));
+        }
+
+    for (h = 0; h < 2; h++)
+        for (w = 0; w < 4; w++)
+            _mm256_store_si256((__m256i *) &lanes[w][4 * h], s[h][w]);
+}
+
+/* It generates n_blocks blocks of RANDOM_LANES uniform numbers within [0,1) (AVX-512 version, one register of 8 lanes)
+Parameters:
+lanes: states of the bulk generator
+u: output array with n_blocks*RANDOM_LANES numbers
+n_blocks: number of blocks */
+__attribute__((target("avx512f")))
+static void UniformBlocksAVX512(uint64_t lanes[4][RANDOM_LANES], double *u, int n_blocks)
+{
+    __m512i s[4], r, t, x;
+    const __m512i exponent = _mm512_set1_epi64(0x3FF0000000000000LL);
+    const __m512d one = _mm512_set1_pd(1.0);
+    int b, w;
+
+    for (w = 0; w < 4; w++)
+        s[w] = _mm512_load_si512((const void *) lanes[w]);
+
+    for (b = 0; b < n_blocks; b++)
+    {
+        x = _mm512_add_epi64(s[1], _mm512_slli_epi64(s[1], 2)); /* s1 * 5 */
+        x = _mm512_rol_epi64(x, 7);
+        r = _mm512_add_epi64(x, _mm512_slli_epi64(x, 3)); /* (...) * 9 */
+        t = _mm512_slli_epi64(s[1], 17);
+        s[2] = _mm512_xor_si512(s[2], s[0]);
+        s[3] = _mm512_xor_si512(s[3], s[1]);
+        s[1] = _mm512_xor_si512(s[1], s[2]);
+        s[0] = _mm512_xor_si512(s[0], s[3]);
+        s[2] = _mm512_xor_si512(s[2], t);
+        s[3] = _mm512_rol_epi64(s[3], 45);
+        x = _mm512_or_si512(_mm512_srli_epi64(r, 12), exponent);
+        _mm512_storeu_pd(u + b * RANDOM_LANES, _mm512_sub_pd(_mm512_castsi512_pd(x), one));
+    }
+
+    for (w = 0; w < 4; w++)
+        _mm512_store_si512((void *) lanes[w], s[w]);
+}
+
+#undef ROTL256
+#endif
+
+typedef void (*prtUniformBlocks)(uint64_t lanes[4][RANDOM_LANES], double *u, int n_blocks); /* Pointer to a bulk generator */
+
+/* It returns the bulk generator best suited to the running CPU
+ * The choice can be overridden by the environment variable OPT_RANDOM_ISA (scalar, avx2 or avx512), e.g., for testing. */
+static prtUniformBlocks SelectUniformBlocks()
+{
+    char *env = getenv("OPT_RANDOM_ISA");
+
+    if ((env) && (!strcmp(env, "scalar")))
+        return UniformBlocksScalar;
+#ifdef RANDOM_X86
+    __builtin_cpu_init();
+    if ((__builtin_cpu_supports("avx512f")) && ((!env) || (!strcmp(env, "avx512"))))
+        return UniformBlocksAVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return UniformBlocksAVX2;
+#endif
+    return UniformBlocksScalar;
+}
+
+/* It fills an array with uniform numbers within [0,1) drawn by the bulk generator of the calling thread
+ * The lanes of thread i are seeded from the seed and i, so they do not depend on how many numbers the thread's stream has drawn.
+ * If n is not a multiple of RANDOM_LANES, the remaining numbers of the last block are discarded.
+Parameters:
+u: n-dimensional array
+n: dimension of the array */
+void FillUnitBlocks(double *u, int n)
+{
+    static prtUniformBlocks UniformBlocks = NULL;
+    double tail[RANDOM_LANES];
+    uint64_t x;
+    int k, w;
+
+    GetRandomStream(); /* it (re-)creates the thread's stream, if needed */
+    if (thread_lanes_seed_id != seed_id)
+    {
+        for (k = 0; k < RANDOM_LANES; k++)
+        {
+            x = seed_x ^ (0x9e3779b97f4a7c15ULL * (uint64_t) (thread_stream_id * RANDOM_LANES + k + 1));
+            for (w = 0; w < 4; w++)
+                thread_lanes[w][k] = SplitMix64(&x);
+        }
+        thread_lanes_seed_id = seed_id;
+    }
+    if (!UniformBlocks)
+        UniformBlocks = SelectUniformBlocks();
+
+    PROFILE_BEGIN(_PROFILE_RANDOM_);
+    UniformBlocks(thread_lanes, u, n / RANDOM_LANES);
+    if (n % RANDOM_LANES)
+    {
+        UniformBlocks(thread_lanes, tail, 1);
+        memcpy(u + n - n % RANDOM_LANES, tail, (n % RANDOM_LANES) * sizeof(double));
+    }
+    PROFILE_COUNT(_PROFILE_RANDOM_DRAWS_, n);
+    PROFILE_END(_PROFILE_RANDOM_);
+}
+/**************************/
+
+/* General-purpose functions */
+/* It initializes the random number generator
+ * It should not be called while other threads are drawing numbers. The calling thread gets stream 0.
+Parameters:
+seed: seed (if it is 0, the seed is taken from the system clock) */
 int srandinter(int seed)
 {
     if (seed == 0)
         seed = (int)time(NULL); /* initialize from the system
 						   clock if seed = 0 */
-    randx = -abs(seed);
+    seed_x = (uint64_t) abs(seed);
+    seed_id++;
+    n_streams = 0;
+    GetRandomStream();
     return seed; /* return seed in case we need to repeat */
 }
 
-/* It returns a random number uniformly distributed within [a,b] */
+/* It returns a random number uniformly distributed within [a,b) */
 double randinter(double a, double b)
 {
-    if (randx == 0)
-        srandinter(0);
-    return a + (b - a) * ((double)ran2(&randx));
+    PROFILE_COUNT(_PROFILE_RANDOM_DRAWS_, 1);
+    return UniformRandom(GetRandomStream(), a, b);
 }
 
 /* It returns a number drawn from a Gaussian distribution
@@ -109,18 +429,8 @@ mean: mean of the distribution
 variance: variance of the distribution */
 double randGaussian(double mean, double variance)
 {
-    double v, x, y, r;
-
-    do
-    {
-        x = (double)2 * randinter(1, 100) / 99;
-        y = (double)2 * randinter(1, 100) / 99;
-        r = x * x + y * y;
-    } while (r >= 1 || r == 0);
-
-    v = x * sqrt(-2 * log(r) / r) * variance + mean;
-
-    return v;
+    PROFILE_COUNT(_PROFILE_RANDOM_DRAWS_, 1);
+    return GaussianRandom(GetRandomStream(), mean, variance);
 }
 
 /* It returns a number  number drawn from a Cauchy distribution
@@ -150,5 +460,79 @@ double randCauchy(double location, double scale)
 	return F;
 }
 
+/* It fills an array with random numbers uniformly distributed within [lo,hi) using the bulk generator
+Parameters:
+x: n-dimensional array
+n: dimension of the array
+lo: lower bound
+hi: upper bound */
+void FillUniform(double *x, int n, double lo, double hi)
+{
+    int i;
 
+    FillUnitBlocks(x, n);
+    for (i = 0; i < n; i++)
+        x[i] = lo + (hi - lo) * x[i];
+}
 
+/* It fills an array with numbers drawn from a Gaussian distribution using the bulk generator
+ * Each pair of uniform numbers becomes a pair of normal deviates by the Box-Muller transform, which needs no rejection.
+Parameters:
+x: n-dimensional array
+n: dimension of the array
+mean: mean of the distribution
+variance: variance of the distribution */
+void FillGaussian(double *x, int n, double mean, double variance)
+{
+    double sd = sqrt(variance), r, theta, pair[2];
+    int i;
+
+    FillUnitBlocks(x, n);
+    if (n % 2) { /* the last deviate needs a pair of its own */
+        pair[0] = x[n - 1];
+        FillUnitBlocks(&pair[1], 1);
+    }
+
+    for (i = 0; i < n; i += 2)
+    {
+        if (i == n - 1) {
+            r = sqrt(-2 * log(1 - pair[0]));
+            theta = 2 * M_PI * pair[1];
+            x[i] = r * cos(theta) * sd + mean;
+            break;
+        }
+        r = sqrt(-2 * log(1 - x[i])); /* 1 - u lies within (0,1] */
+        theta = 2 * M_PI * x[i + 1];
+        x[i] = r * cos(theta) * sd + mean;
+        x[i + 1] = r * sin(theta) * sd + mean;
+    }
+}
+
+/* It fills an array with steps drawn from a Levy distribution (Mantegna's algorithm) using the bulk generator
+ * The formulation used here is based on the paper "Multiobjective Cuckoo Search for Design Optimization", X.-S. Yang and S. Deb, Computers & Operations Research, 2013.
+ * The deviates of the denominator are drawn into a thread-local scratch array, so no memory is allocated once it is large enough.
+Parameters:
+x: n-dimensional array
+n: dimension of the array
+beta: input parameter used in the formulation */
+void FillLevy(double *x, int n, double beta)
+{
+    double sigma_u, *v = NULL;
+    int i;
+
+    sigma_u = pow((tgamma(1 + beta) * sin(M_PI * beta / 2)) / (tgamma((1 + beta) / 2) * beta * pow(2, (beta - 1) / 2)),
+                  1 / beta); /* Equation 16 */
+
+    if (thread_levy_size < n)
+    {
+        free(thread_levy);
+        thread_levy_size = n;
+        thread_levy = (double *) malloc(n * sizeof(double));
+    }
+    v = thread_levy;
+    FillGaussian(x, n, 0, sigma_u * sigma_u);
+    FillGaussian(v, n, 0, 1);
+    for (i = 0; i < n; i++)
+        x[i] = 0.01 * (x[i] / pow(fabs(v[i]), 1 / beta)); /* It computes Equation 14 (part of it) */
+}
+/**************************/
@@ -14,6 +14,8 @@ limitations under the License.
 */
 
 #include "sa.h"
+#include "telemetry.h"
+#include "profile.h"
 
 /**
  * It calculates the new temperature of the system according to the Boltzmann annealing
@@ -54,13 +56,12 @@ double fastScheduleAnnealing(double T, double alpha)
     return T * alpha;
 }
 
-void runSA(SearchSpace *s, prtFun Evaluate, ...)
+/* It executes the Simulated Annealing with a given fitness evaluator
+Parameters:
+s: search space
+e: fitness evaluator */
+static void SA(SearchSpace *s, Evaluator *e)
 {
-  va_list arg, argtmp;
-
-  va_start(arg, Evaluate);
-  va_copy(argtmp, arg);
-
   if (!s)
   {
     fprintf(stderr, "\nSearch space not allocated @runSA.\n");
@@ -89,11 +90,12 @@ void runSA(SearchSpace *s, prtFun Evaluate, ...)
   double T0; /* parameter for the Boltzmann annealing */
   double *new_pos = (double*)malloc(s->n * sizeof(double)); /* array that will store the next position of the particles */
   double *aux_ptr = NULL; /* temporary pointer to store the address of the agent position vector (better explanation below). */
+  double *buffer = new_pos; /* the array allocated here, which may end up as the position of some agent */
   double prev_fit;
   int i, j;
 
   /* first evaluation of the search space */
-  EvaluateSearchSpace(s, _SA_, Evaluate, arg);
+  EvaluateSearchSpaceWith(s, _SA_, e);
 
   int t = 1; /* time */
   switch (s->cooling_schedule_id)
@@ -117,12 +119,13 @@ void runSA(SearchSpace *s, prtFun Evaluate, ...)
       /* storing the address of the x array of the agent */
       aux_ptr = s->a[i]->x;
       /* calculating next random position for the agent */
+      FillUniform(new_pos, s->n, 0, 1);
       for (j = 0; j < s->n; j++)
-          new_pos[j] = GenerateUniformRandomNumber(s->a[i]->LB[j], s->a[i]->UB[j]);
+          new_pos[j] = s->a[i]->LB[j] + (s->a[i]->UB[j] - s->a[i]->LB[j]) * new_pos[j];
       /* poiting the x array of the agent to the new_pos random valued array */
       s->a[i]->x = new_pos; /* new_pos is the new position of the particle right now. */
       /* Evaluating the funcion at new_pos position */
-      EvaluateAgent(s, s->a[i], _SA_, Evaluate, arg);
+      EvaluateAgentWith(s, s->a[i], _SA_, e);
       /* checking if the the next position is an improvement over the last one */
       /* if the next position is better, just update it. */
       if(s->a[i]->fit < prev_fit)
@@ -159,8 +162,47 @@ void runSA(SearchSpace *s, prtFun Evaluate, ...)
           current_temp = fastScheduleAnnealing(current_temp, s->func_param);
           break;
     }
-    fprintf(stderr, "Iteration %d: OK (minimum fitness value %lf). Temperature: %lf\n", t, s->gfit, current_temp);
+    ReportIteration(s, _SA_, e, t, s->gfit);
+  }
+  /* the agents' positions are rows of the search space's block, so the one holding our array gets its row back */
+  if (new_pos != buffer)
+  {
+    for (i = 0; i < s->m; i++)
+      if (s->a[i]->x == buffer)
+      {
+        memcpy(new_pos, buffer, s->n * sizeof(double));
+        s->a[i]->x = new_pos;
+      }
   }
-  free(new_pos);
+  free(buffer);
+}
+
+void runSA(SearchSpace *s, prtFun Evaluate, ...)
+{
+  va_list arg;
+  Evaluator e;
+
+  va_start(arg, Evaluate);
+  InitEvaluator(&e, s, Evaluate, arg);
+  PROFILE_BEGIN_RUN();
+  SA(s, &e);
+  PROFILE_END_RUN("SA", &e);
+  DestroyEvaluator(&e);
   va_end(arg);
 }
+
+/* It executes the Simulated Annealing for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runSA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+  Evaluator e;
+
+  InitEvaluator_r(&e, s, Evaluate, ctx);
+  PROFILE_BEGIN_RUN();
+  SA(s, &e);
+  PROFILE_END_RUN("SA", &e);
+  DestroyEvaluator(&e);
+}
@@ -0,0 +1,269 @@
+/*Copyright 2018 LibOpt Authors
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <time.h>
+
+#include "telemetry.h"
+
+/* Telemetry-related functions */
+/* It sets the observer defined by the environment variable OPT_PROGRESS
+ * If the variable is set to k > 0, every k-th iteration is printed to stderr (see PrintIteration). Otherwise, there is no observer,
+ * i.e., the runs are silent.
+Parameters:
+s: search space */
+void SetDefaultObserver(SearchSpace *s) {
+    if (!s) {
+        fprintf(stderr, "\nSearch space not allocated @SetDefaultObserver.\n");
+        exit(-1);
+    }
+
+    char *env = getenv("OPT_PROGRESS");
+    int every = ((env) && (*env)) ? atoi(env) : 0;
+
+    s->observer = every > 0 ? PrintIteration : NULL;
+    s->observer_arg = NULL;
+    s->report_every = every > 0 ? every : 1;
+}
+
+/* It computes the mean Euclidean distance between the positions of the agents and their centroid
+ * The centroid is kept in s->centroid, which is allocated at the first reported iteration and reused by the following ones.
+Parameters:
+s: search space */
+static double Diversity(SearchSpace *s) {
+    double *c = NULL, sum = 0, d, diff;
+    int i, j;
+
+    if (!s->centroid)
+        s->centroid = (double *) malloc(s->n * sizeof(double));
+    c = s->centroid;
+    for (j = 0; j < s->n; j++)
+        c[j] = 0;
+    for (i = 0; i < s->m; i++)
+        for (j = 0; j < s->n; j++)
+            c[j] += s->a[i]->x[j];
+    for (j = 0; j < s->n; j++)
+        c[j] /= s->m;
+
+    for (i = 0; i < s->m; i++) {
+        d = 0;
+        for (j = 0; j < s->n; j++) {
+            diff = s->a[i]->x[j] - c[j];
+            d += diff * diff;
+        }
+        sum += sqrt(d);
+    }
+
+    return sum / s->m;
+}
+
+/* It hands the record of an iteration to the observer of a search space
+ * The record is only built when the iteration is reported, i.e., if there is an observer and t is a multiple of s->report_every or
+ * the last iteration, so that silent runs pay a single comparison per iteration.
+Parameters:
+s: search space
+opt_id: identifier of the optimization technique
+e: fitness evaluator of the run (its number of evaluations and its initialization time are reported)
+t: current iteration
+fit: best fitness value found so far */
+void ReportIteration(SearchSpace *s, int opt_id, Evaluator *e, int t, double fit) {
+    IterationRecord r;
+
+    if ((!s) || (!s->observer))
+        return;
+    if ((s->report_every > 1) && (t % s->report_every) && (t != s->iterations))
+        return;
+
+    r.iteration = t;
+    r.iterations = s->iterations;
+    r.fit = fit;
+    r.evaluations = e ? __atomic_load_n(&e->evaluations, __ATOMIC_RELAXED) : -1;
+    r.time = e ? GetWallTime() - e->start : -1;
+    if ((opt_id == _GP_) || (opt_id == _TGP_) || (opt_id == _CGP_) || (opt_id == _LOA_))
+        r.diversity = -1; /* the agents of GP and TGP are terminals, CGP's positions are outputs of programs, and LOA's lions live in its prides and nomad groups */
+    else
+        r.diversity = Diversity(s);
+
+    s->observer(&r, s->observer_arg);
+}
+
+/* It prints the record of an iteration to stderr, as the techniques used to do at each iteration
+Parameters:
+r: record of the iteration
+arg: not used */
+void PrintIteration(const IterationRecord *r, void *arg) {
+    fprintf(stderr, "\nRunning iteration %d/%d ... OK (minimum fitness value %lf)", r->iteration, r->iterations, r->fit);
+}
+
+/* It returns the wall-clock time in seconds (from an arbitrary starting point) */
+double GetWallTime() {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+/**************************/
+
+/* It writes a set of records to the file of a trace sink
+Parameters:
+t: trace sink
+r: records
+n: number of records */
+static void FlushRecords(TraceSink *t, IterationRecord *r, int n) {
+    int i;
+
+    if (t->format == _TRACE_BINARY_) {
+        fwrite(r, sizeof(IterationRecord), n, t->fp);
+        return;
+    }
+
+    for (i = 0; i < n; i++)
+        fprintf(t->fp, "%d,%ld,%.9g,%.17g,%.17g\n", r[i].iteration, r[i].evaluations, r[i].time, r[i].fit, r[i].diversity);
+}
+
+/* It implements the main loop of the background thread of a trace sink
+ * The queued records are moved to a second buffer, so that the observer can keep queueing while they are written.
+Parameters:
+arg: trace sink */
+static void *TraceWorker(void *arg) {
+    TraceSink *t = (TraceSink *) arg;
+    int i, n;
+
+    pthread_mutex_lock(&t->lock);
+    while (1) {
+        while ((!t->size) && (!t->stop))
+            pthread_cond_wait(&t->not_empty, &t->lock);
+        if (!t->size)
+            break; /* it only stops after the queue is empty */
+
+        n = t->size;
+        for (i = 0; i < n; i++)
+            t->buffer[i] = t->queue[(t->head + i) % t->capacity];
+        t->head = (t->head + n) % t->capacity;
+        t->size = 0;
+        pthread_cond_broadcast(&t->not_full);
+        pthread_mutex_unlock(&t->lock);
+
+        FlushRecords(t, t->buffer, n);
+
+        pthread_mutex_lock(&t->lock);
+        t->written += n;
+    }
+    pthread_mutex_unlock(&t->lock);
+
+    return NULL;
+}
+
+/* Trace sink-related functions */
+/* It creates a trace sink and its background thread
+ * To use it, set s->observer = WriteTrace and s->observer_arg to the sink. A sink may be shared by several search spaces.
+Parameters:
+file: output file (it is overwritten)
+format: trace format (_TRACE_CSV_ or _TRACE_BINARY_)
+capacity: maximum number of records waiting to be written (the observer waits when the queue is full, so no record is lost) */
+TraceSink *CreateTraceSink(char *file, int format, int capacity) {
+    if ((!file) || ((format != _TRACE_CSV_) && (format != _TRACE_BINARY_)) || (capacity < 1)) {
+        fprintf(stderr, "\nInvalid input parameters @CreateTraceSink.\n");
+        return NULL;
+    }
+
+    TraceSink *t = NULL;
+    FILE *fp = NULL;
+
+    fp = fopen(file, format == _TRACE_BINARY_ ? "wb" : "w");
+    if (!fp) {
+        fprintf(stderr, "\nUnable to open file %s @CreateTraceSink.\n", file);
+        return NULL;
+    }
+    if (format == _TRACE_CSV_)
+        fprintf(fp, "iteration,evaluations,time,fit,diversity\n");
+
+    t = (TraceSink *) malloc(sizeof(TraceSink));
+    t->fp = fp;
+    t->format = format;
+    t->queue = (IterationRecord *) malloc(capacity * sizeof(IterationRecord));
+    t->buffer = (IterationRecord *) malloc(capacity * sizeof(IterationRecord));
+    t->capacity = capacity;
+    t->head = t->size = 0;
+    t->written = 0;
+    t->stop = 0;
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_cond_init(&t->not_empty, NULL);
+    pthread_cond_init(&t->not_full, NULL);
+
+    if (pthread_create(&t->thread, NULL, TraceWorker, t)) {
+        fprintf(stderr, "\nUnable to create the background thread @CreateTraceSink.\n");
+        pthread_cond_destroy(&t->not_empty);
+        pthread_cond_destroy(&t->not_full);
+        pthread_mutex_destroy(&t->lock);
+        fclose(fp);
+        free(t->queue);
+        free(t->buffer);
+        free(t);
+        return NULL;
+    }
+
+    return t;
+}
+
+/* It writes the pending records and deallocates a trace sink
+Parameters:
+t: address of the trace sink to be deallocated */
+void DestroyTraceSink(TraceSink **t) {
+    TraceSink *tmp = NULL;
+
+    tmp = *t;
+    if (!tmp) {
+        fprintf(stderr, "\nTrace sink not allocated @DestroyTraceSink.\n");
+        exit(-1);
+    }
+
+    pthread_mutex_lock(&tmp->lock);
+    tmp->stop = 1;
+    pthread_cond_signal(&tmp->not_empty);
+    pthread_mutex_unlock(&tmp->lock);
+    pthread_join(tmp->thread, NULL);
+
+    pthread_cond_destroy(&tmp->not_empty);
+    pthread_cond_destroy(&tmp->not_full);
+    pthread_mutex_destroy(&tmp->lock);
+    fclose(tmp->fp);
+    free(tmp->queue);
+    free(tmp->buffer);
+    free(tmp);
+    *t = NULL;
+}
+
+/* It queues the record of an iteration into a trace sink (it is an observer, see prtObserver)
+Parameters:
+r: record of the iteration
+arg: trace sink */
+void WriteTrace(const IterationRecord *r, void *arg) {
+    TraceSink *t = (TraceSink *) arg;
+
+    if ((!r) || (!t)) {
+        fprintf(stderr, "\nInvalid input parameters @WriteTrace.\n");
+        exit(-1);
+    }
+
+    pthread_mutex_lock(&t->lock);
+    while (t->size == t->capacity)
+        pthread_cond_wait(&t->not_full, &t->lock);
+    t->queue[(t->head + t->size) % t->capacity] = *r;
+    t->size++;
+    pthread_cond_signal(&t->not_empty);
+    pthread_mutex_unlock(&t->lock);
+}
+/**************************/
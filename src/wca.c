@@ -15,6 +15,9 @@ limitations under the License.
 
 
 #include "wca.h"
+#include "telemetry.h"
+#include "profile.h"
+#include "kernel.h"
 
 int *FlowIntensity(SearchSpace *s)
 {
@@ -88,78 +91,111 @@ void UpdateRiverPosition(SearchSpace *s, double c)
     }
 }
 
-void RainingProcess(SearchSpace *s, int *flow)
+void RainingProcess(SearchSpace *s, int *flow, double *dist, double **X)
 {
-    int i, j;
-    double tmp, rand, dist;
+    int i, k;
+    double rand;
+
+    k = flow[0] > s->nsr + 1 ? flow[0] : s->nsr + 1; /* rivers and streams are the agents 1, ..., k-1 (dist and X have room for s->m of them) */
+    for (i = 1; i < k; i++)
+        X[i] = s->a[i]->x;
+    EuclideanDistances(s->a[0]->x, X + 1, k - 1, s->n, dist + 1); /* It obtains the euclidean distances to the sea for further use */
 
     for (i = 1; i < s->nsr + 1; i++)
     {
         rand = GenerateUniformRandomNumber(0, 1);
-        dist = EuclideanDistance(s->a[0]->x, s->a[i]->x, s->n); /* It obtains the euclidean distance for further use */
-        if ((dist < s->dmax) || (rand < 0.1))
-        {
-            DestroyAgent(&(s->a[i]), _WCA_);
-            s->a[i] = GenerateNewAgent(s, _WCA_);
-        }
+        if ((dist[i] < s->dmax) || (rand < 0.1))
+            ResetAgent(s->a[i]); /* the river is replaced by a new raindrop */
     }
 
     for (i = s->nsr + 1; i < flow[0]; i++)
     {
         rand = GenerateUniformRandomNumber(0, 1);
-        dist = EuclideanDistance(s->a[0]->x, s->a[i]->x, s->n); /* It obtains the euclidean distance for further use */
-        if ((dist < s->dmax) || (rand < 0.1))
-        {
-            DestroyAgent(&(s->a[i]), _WCA_);
-            s->a[i] = GenerateNewAgent(s, _WCA_);
-        }
+        if ((dist[i] < s->dmax) || (rand < 0.1))
+            ResetAgent(s->a[i]); /* the stream is replaced by a new raindrop */
     }
 }
 
-/* It executes the Water Cycle Algorithm for function minimization
+/* It executes the Water Cycle Algorithm with a given fitness evaluator
 Parameters:
 s: search space
-Evaluate: pointer to the function used to evaluate particles
-arg: list of additional arguments */
-void runWCA(SearchSpace *s, prtFun Evaluate, ...)
+e: fitness evaluator */
+static void WCA(SearchSpace *s, Evaluator *e)
 {
-    va_list arg, argtmp;
     int t, i, *flow = NULL;
     double c = 2; /* c = [1,2]. The author recommends 2 as the best value */
+    double *dist = NULL, **X = NULL;
     Agent *tmp = NULL;
 
-    va_start(arg, Evaluate);
-    va_copy(argtmp, arg);
-
     if (!s)
     {
         fprintf(stderr, "\nSearch space not allocated @runWCA.\n");
         exit(-1);
     }
 
-    EvaluateSearchSpace(s, _WCA_, Evaluate, arg); /* Initial evaluation of the search space */
+    dist = (double *)malloc(s->m * sizeof(double));
+    X = (double **)malloc(s->m * sizeof(double *));
 
+    EvaluateSearchSpaceWith(s, _WCA_, e); /* Initial evaluation of the search space */
+
+    PROFILE_BEGIN(_PROFILE_SORT_);
     qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all raindrops according to their fitness. First position gets the sea. */
+    PROFILE_END(_PROFILE_SORT_);
 
     flow = FlowIntensity(s);
 
     for (t = 1; t <= s->iterations; t++)
     {
-        fprintf(stderr, "\nRunning iteration %d/%d ... ", t, s->iterations);
-        va_copy(arg, argtmp);
-
         UpdateStreamPosition(s, flow, c);
         UpdateRiverPosition(s, c);
         for (i = 0; i < s->m; i++)
         {
             CheckAgentLimits(s, s->a[i]);
         }
-        EvaluateSearchSpace(s, _WCA_, Evaluate, arg);   /* Initial evaluation of the search space */
+        EvaluateSearchSpaceWith(s, _WCA_, e);   /* Initial evaluation of the search space */
+        PROFILE_BEGIN(_PROFILE_SORT_);
         qsort(s->a, s->m, sizeof(Agent **), SortAgent); /* Sorts all raindrops according to their fitness. First position gets the sea. */
-        RainingProcess(s, flow);
+        PROFILE_END(_PROFILE_SORT_);
+        RainingProcess(s, flow, dist, X);
         s->dmax = s->dmax - (s->dmax / s->iterations);
-        fprintf(stderr, "OK (minimum fitness value %lf)", s->gfit);
+        ReportIteration(s, _WCA_, e, t, s->gfit);
     }
     free(flow);
+    free(dist);
+    free(X);
+}
+
+/* It executes the Water Cycle Algorithm for function minimization
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate particles
+arg: list of additional arguments */
+void runWCA(SearchSpace *s, prtFun Evaluate, ...)
+{
+    va_list arg;
+    Evaluator e;
+
+    va_start(arg, Evaluate);
+    InitEvaluator(&e, s, Evaluate, arg);
+    PROFILE_BEGIN_RUN();
+    WCA(s, &e);
+    PROFILE_END_RUN("WCA", &e);
+    DestroyEvaluator(&e);
     va_end(arg);
 }
+
+/* It executes the Water Cycle Algorithm for function minimization using a reentrant fitness function
+Parameters:
+s: search space
+Evaluate: pointer to the function used to evaluate decision vectors
+ctx: context forwarded to each call of Evaluate */
+void runWCA_r(SearchSpace *s, prtFun_r Evaluate, void *ctx)
+{
+    Evaluator e;
+
+    InitEvaluator_r(&e, s, Evaluate, ctx);
+    PROFILE_BEGIN_RUN();
+    WCA(s, &e);
+    PROFILE_END_RUN("WCA", &e);
+    DestroyEvaluator(&e);
+}